@@ -0,0 +1,70 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/Arena.h"
+
+namespace nebula {
+
+Arena::~Arena() {
+    while (chunks_ != nullptr) {
+        auto* next = chunks_->next;
+        free(chunks_);
+        chunks_ = next;
+    }
+}
+
+
+void* Arena::allocate(size_t size) {
+    size = alignUp(std::max(size, sizeof(FreeBlock)));
+    for (auto& list : freeLists_) {
+        if (list.first == size && list.second != nullptr) {
+            auto* block = list.second;
+            list.second = block->next;
+            return block;
+        }
+    }
+    if (pos_ == nullptr || static_cast<size_t>(end_ - pos_) < size) {
+        newChunk(size);
+    }
+    auto* ptr = pos_;
+    pos_ += size;
+    return ptr;
+}
+
+
+void Arena::recycle(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    size = alignUp(std::max(size, sizeof(FreeBlock)));
+    auto* block = reinterpret_cast<FreeBlock*>(ptr);
+    for (auto& list : freeLists_) {
+        if (list.first == size) {
+            block->next = list.second;
+            list.second = block;
+            return;
+        }
+    }
+    block->next = nullptr;
+    freeLists_.emplace_back(size, block);
+}
+
+
+void Arena::newChunk(size_t minSize) {
+    // Oversized allocations take a chunk of their own
+    auto header = alignUp(sizeof(Chunk));
+    auto size = std::max(chunkSize_, header + minSize);
+    auto* chunk = reinterpret_cast<Chunk*>(malloc(size));
+    CHECK(chunk) << "Out of memory";
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    allocatedBytes_ += size;
+    pos_ = reinterpret_cast<char*>(chunk) + header;
+    end_ = reinterpret_cast<char*>(chunk) + size;
+}
+
+}  // namespace nebula
@@ -0,0 +1,75 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_ARENA_H_
+#define COMMON_BASE_ARENA_H_
+
+#include "base/Base.h"
+
+namespace nebula {
+
+/**
+ * A monotonic arena for the short-lived allocations of one request.
+ *
+ * Memory is carved out of chunks taken from the heap on demand, and all the
+ * chunks are given back at once when the arena is destroyed. Fixed-size blocks
+ * could be recycled, so that the next allocation of the same size reuses them,
+ * which keeps the arena from growing with the number of rows when every row
+ * takes and drops the same blocks (e.g. Cord blocks).
+ *
+ * The arena is not thread-safe.
+ * */
+class Arena final {
+public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+    explicit Arena(size_t chunkSize = kDefaultChunkSize)
+        : chunkSize_(chunkSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena();
+
+    // The memory is aligned to max_align_t
+    void* allocate(size_t size);
+
+    // Keep the block for the next allocation of the same size
+    void recycle(void* ptr, size_t size);
+
+    // The bytes taken from the heap
+    size_t allocatedBytes() const {
+        return allocatedBytes_;
+    }
+
+private:
+    struct Chunk {
+        Chunk* next;
+    };
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static size_t alignUp(size_t size) {
+        constexpr size_t kAlign = alignof(std::max_align_t);
+        return (size + kAlign - 1) & ~(kAlign - 1);
+    }
+
+    void newChunk(size_t minSize);
+
+private:
+    const size_t chunkSize_;
+    Chunk* chunks_{nullptr};
+    char* pos_{nullptr};
+    char* end_{nullptr};
+    size_t allocatedBytes_{0};
+    // The recycled blocks by size, there are only a few sizes in practice
+    std::vector<std::pair<size_t, FreeBlock*>> freeLists_;
+};
+
+}  // namespace nebula
+#endif  // COMMON_BASE_ARENA_H_
@@ -16,6 +16,10 @@ Cord::Cord(int32_t blockSize)
 }
 
 
+Cord::Cord(Arena* arena) : arena_(arena) {
+}
+
+
 Cord::~Cord() {
     clear();
 }
@@ -23,7 +27,9 @@ Cord::~Cord() {
 
 void Cord::allocateBlock() {
     DCHECK_EQ(blockPt_, blockContentSize_);
-    char* blk = reinterpret_cast<char*>(malloc(blockSize_ * sizeof(char)));
+    char* blk = arena_ != nullptr
+        ? reinterpret_cast<char*>(arena_->allocate(blockSize_ * sizeof(char)))
+        : reinterpret_cast<char*>(malloc(blockSize_ * sizeof(char)));
     CHECK(blk) << "Out of memory";
 
     if (tail_) {
@@ -39,6 +45,15 @@ void Cord::allocateBlock() {
 }
 
 
+void Cord::freeBlock(char* blk) {
+    if (arena_ != nullptr) {
+        arena_->recycle(blk, blockSize_);
+    } else {
+        free(blk);
+    }
+}
+
+
 size_t Cord::size() const noexcept {
     return len_;
 }
@@ -60,11 +75,11 @@ void Cord::clear() {
             memcpy(reinterpret_cast<char*>(&next),
                    p + blockContentSize_,
                    sizeof(char*));
-            free(p);
+            freeBlock(p);
             p = next;
         }
         // Free the last block
-        free(p);
+        freeBlock(p);
     }
 
     blockPt_ = blockContentSize_;
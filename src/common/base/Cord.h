@@ -8,6 +8,7 @@
 #define COMMON_BASE_CORD_H_
 
 #include "base/Base.h"
+#include "base/Arena.h"
 
 namespace nebula {
 
@@ -15,6 +16,9 @@ class Cord {
 public:
     Cord() = default;
     explicit Cord(int32_t blockSize);
+    // The blocks are taken from the arena and recycled to it on clear(),
+    // or from the heap if the arena is null. The arena must outlive the cord
+    explicit Cord(Arena* arena);
     virtual ~Cord();
 
     size_t size() const noexcept;
@@ -67,7 +71,10 @@ private:
     char* head_ = nullptr;
     char* tail_ = nullptr;
 
+    Arena* arena_ = nullptr;
+
     void allocateBlock();
+    void freeBlock(char* blk);
 };
 
 }  // namespace nebula
@@ -5,9 +5,15 @@
  */
 
 #include "base/NebulaKeyUtils.h"
+#include <folly/lang/Bits.h>
 
 namespace nebula {
 
+constexpr char NebulaKeyUtils::kIndexPrefix[];
+constexpr int32_t NebulaKeyUtils::kIndexHeadLen;
+constexpr int32_t NebulaKeyUtils::kVertexIndexSuffixLen;
+constexpr int32_t NebulaKeyUtils::kEdgeIndexSuffixLen;
+
 // static
 std::string NebulaKeyUtils::vertexKey(PartitionID partId, VertexID vId,
                                       TagID tagId, TagVersion ts) {
@@ -38,6 +44,32 @@ std::string NebulaKeyUtils::edgeKey(PartitionID partId,
     return key;
 }
 
+// static
+std::string NebulaKeyUtils::vertexKey(PartitionID partId, VertexID vId, TagID tagId) {
+    std::string key;
+    key.reserve(kVertexLenNoVersion);
+    key.append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID))
+       .append(reinterpret_cast<const char*>(&vId), sizeof(VertexID))
+       .append(reinterpret_cast<const char*>(&tagId), sizeof(TagID));
+    return key;
+}
+
+// static
+std::string NebulaKeyUtils::edgeKey(PartitionID partId,
+                                    VertexID srcId,
+                                    EdgeType type,
+                                    EdgeRanking rank,
+                                    VertexID dstId) {
+    std::string key;
+    key.reserve(kEdgeLenNoVersion);
+    key.append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID))
+       .append(reinterpret_cast<const char*>(&srcId), sizeof(VertexID))
+       .append(reinterpret_cast<const char*>(&type), sizeof(EdgeType))
+       .append(reinterpret_cast<const char*>(&rank), sizeof(EdgeRanking))
+       .append(reinterpret_cast<const char*>(&dstId), sizeof(VertexID));
+    return key;
+}
+
 // static
 std::string NebulaKeyUtils::prefix(PartitionID partId, VertexID srcId, EdgeType type) {
     std::string key;
@@ -71,5 +103,89 @@ std::string NebulaKeyUtils::prefix(PartitionID partId, VertexID src, EdgeType ty
     return key;
 }
 
-}  // namespace nebula
+// static
+std::string NebulaKeyUtils::indexPrefix(PartitionID partId, bool isEdge,
+                                        int32_t schemaId, const std::string& prop) {
+    int32_t propLen = prop.size();
+    char kind = isEdge ? kEdgeIndex : kVertexIndex;
+    std::string key;
+    key.reserve(kIndexHeadLen + prop.size());
+    key.append(kIndexPrefix, sizeof(kIndexPrefix) - 1)
+       .append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID))
+       .append(&kind, sizeof(char))
+       .append(reinterpret_cast<const char*>(&schemaId), sizeof(int32_t))
+       .append(reinterpret_cast<const char*>(&propLen), sizeof(int32_t))
+       .append(prop);
+    return key;
+}
+
+// static
+std::string NebulaKeyUtils::vertexIndexKey(PartitionID partId, TagID tagId,
+                                           const std::string& prop, const std::string& value,
+                                           VertexID vId) {
+    std::string key = indexPrefix(partId, false, tagId, prop);
+    key.reserve(key.size() + value.size() + kVertexIndexSuffixLen);
+    key.append(value)
+       .append(reinterpret_cast<const char*>(&vId), sizeof(VertexID));
+    return key;
+}
 
+// static
+std::string NebulaKeyUtils::edgeIndexKey(PartitionID partId, EdgeType type,
+                                         const std::string& prop, const std::string& value,
+                                         VertexID srcId, EdgeRanking rank, VertexID dstId) {
+    std::string key = indexPrefix(partId, true, type, prop);
+    key.reserve(key.size() + value.size() + kEdgeIndexSuffixLen);
+    key.append(value)
+       .append(reinterpret_cast<const char*>(&srcId), sizeof(VertexID))
+       .append(reinterpret_cast<const char*>(&rank), sizeof(EdgeRanking))
+       .append(reinterpret_cast<const char*>(&dstId), sizeof(VertexID));
+    return key;
+}
+
+// static
+std::string NebulaKeyUtils::encodeIndexValue(const VariantType& value) {
+    std::string encoded;
+    switch (value.which()) {
+        case 0: {
+            // Flip the sign bit, so the negatives go before the positives
+            uint64_t v = static_cast<uint64_t>(boost::get<int64_t>(value)) ^ (1ULL << 63);
+            v = folly::Endian::big(v);
+            encoded.append(reinterpret_cast<const char*>(&v), sizeof(uint64_t));
+            break;
+        }
+        case 1: {
+            // -0.0 equals 0.0
+            double d = boost::get<double>(value) == 0.0 ? 0.0 : boost::get<double>(value);
+            uint64_t v;
+            memcpy(&v, &d, sizeof(double));
+            // Flip all the bits of the negatives, and the sign bit of the others
+            v = (v & (1ULL << 63)) ? ~v : (v | (1ULL << 63));
+            v = folly::Endian::big(v);
+            encoded.append(reinterpret_cast<const char*>(&v), sizeof(uint64_t));
+            break;
+        }
+        case 2: {
+            encoded.append(1, boost::get<bool>(value) ? '\x01' : '\x00');
+            break;
+        }
+        case 3: {
+            // Escape '\0' as "\0\xFF", and end with "\0\x01"
+            auto& str = boost::get<std::string>(value);
+            encoded.reserve(str.size() + 2);
+            for (auto c : str) {
+                encoded.append(1, c);
+                if (c == '\x00') {
+                    encoded.append(1, '\xFF');
+                }
+            }
+            encoded.append(1, '\x00').append(1, '\x01');
+            break;
+        }
+        default:
+            LOG(FATAL) << "Unknown VariantType: " << value.which();
+    }
+    return encoded;
+}
+
+}  // namespace nebula
@@ -18,6 +18,16 @@ namespace nebula {
  * EdgeKeyUtils:
  * partId(4) + srcId(8) + edgeType(4) + edgeRank(8) + dstId(8) + version(8)
  *
+ * In single-version spaces the trailing version is omitted.
+ *
+ * IndexKeyUtils:
+ * kIndexPrefix(2) + partId(4) + kind(1) + tagId/edgeType(4) + propLen(4) + prop + value
+ *   + vertexId(8) for the tag indexes
+ *   + srcId(8) + edgeRank(8) + dstId(8) for the edge indexes
+ *
+ * The value is encoded by encodeIndexValue, so the keys are sorted by the values.
+ * The index keys start with kSysPrefix, they are not data keys.
+ *
  * */
 
 /**
@@ -39,6 +49,17 @@ public:
                                EdgeType type, EdgeRanking rank,
                                VertexID dstId, EdgeVersion ts);
 
+    /**
+     * Generate vertex key without version, used by single-version spaces
+     * */
+    static std::string vertexKey(PartitionID partId, VertexID vId, TagID tagId);
+
+    /**
+     * Generate edge key without version, used by single-version spaces
+     * */
+    static std::string edgeKey(PartitionID partId, VertexID srcId,
+                               EdgeType type, EdgeRanking rank, VertexID dstId);
+
     /**
      * Prefix for srcId edges with some edgeType
      * */
@@ -53,46 +74,54 @@ public:
                               EdgeRanking ranking, VertexID dst);
 
     static bool isVertex(const folly::StringPiece& rawKey) {
-        return rawKey.size() == kVertexLen;
+        return rawKey.size() == kVertexLen || rawKey.size() == kVertexLenNoVersion;
     }
 
     static TagID getTagId(const folly::StringPiece& rawKey) {
-        CHECK_EQ(rawKey.size(), kVertexLen);
+        CHECK(isVertex(rawKey));
         auto offset = sizeof(PartitionID) + sizeof(VertexID);
         return readInt<TagID>(rawKey.data() + offset, sizeof(TagID));
     }
 
     static bool isEdge(const folly::StringPiece& rawKey) {
-        return rawKey.size() == kEdgeLen;
+        return rawKey.size() == kEdgeLen || rawKey.size() == kEdgeLenNoVersion;
     }
 
     static VertexID getSrcId(const folly::StringPiece& rawKey) {
-        CHECK_EQ(rawKey.size(), kEdgeLen);
+        CHECK(isEdge(rawKey));
         return readInt<VertexID>(rawKey.data() + sizeof(PartitionID),
                                  rawKey.size() - sizeof(PartitionID));
     }
 
     static VertexID getDstId(const folly::StringPiece& rawKey) {
-        CHECK_EQ(rawKey.size(), kEdgeLen);
-        auto offset = kEdgeLen - sizeof(EdgeVersion) - sizeof(VertexID);
+        CHECK(isEdge(rawKey));
+        auto offset = sizeof(PartitionID) + sizeof(VertexID)
+                    + sizeof(EdgeType) + sizeof(EdgeRanking);
         return readInt<VertexID>(rawKey.data() + offset,
                                  rawKey.size() - offset);
     }
 
     static EdgeType getEdgeType(const folly::StringPiece& rawKey) {
-        CHECK_EQ(rawKey.size(), kEdgeLen);
+        CHECK(isEdge(rawKey));
         auto offset = sizeof(PartitionID) + sizeof(VertexID);
         return readInt<EdgeType>(rawKey.data() + offset,
                                  rawKey.size() - offset);
     }
 
     static EdgeRanking getRank(const folly::StringPiece& rawKey) {
-        CHECK_EQ(rawKey.size(), kEdgeLen);
+        CHECK(isEdge(rawKey));
         auto offset = sizeof(PartitionID) + sizeof(VertexID) + sizeof(EdgeType);
         return readInt<EdgeRanking>(rawKey.data() + offset,
                                     rawKey.size() - offset);
     }
 
+    /**
+     * Whether the data key carries a version suffix.
+     * */
+    static bool hasVersion(const folly::StringPiece& rawKey) {
+        return rawKey.size() == kVertexLen || rawKey.size() == kEdgeLen;
+    }
+
     template<typename T>
     static typename std::enable_if<std::is_integral<T>::value, T>::type
     readInt(const char* data, int32_t len) {
@@ -104,13 +133,82 @@ public:
         return !key.empty() && key[0] != kSysPrefix;
     }
 
-    static bool isIndexKey(const folly::StringPiece&) {
-        // TODO(heng) Implement the method when index merged in.
-        return false;
+    /**
+     * Prefix of the index on the prop of some tag, or edge type if isEdge
+     * */
+    static std::string indexPrefix(PartitionID partId, bool isEdge,
+                                   int32_t schemaId, const std::string& prop);
+
+    static std::string vertexIndexKey(PartitionID partId, TagID tagId,
+                                      const std::string& prop, const std::string& value,
+                                      VertexID vId);
+
+    static std::string edgeIndexKey(PartitionID partId, EdgeType type,
+                                    const std::string& prop, const std::string& value,
+                                    VertexID srcId, EdgeRanking rank, VertexID dstId);
+
+    /**
+     * Encode the value of an indexed prop, the encoded values compare bytewise
+     * in the same order as the values of the same type, and none of them is
+     * a prefix of another one.
+     * */
+    static std::string encodeIndexValue(const VariantType& value);
+
+    static bool isIndexKey(const folly::StringPiece& key) {
+        return key.size() > kIndexHeadLen
+            && key.subpiece(0, sizeof(kIndexPrefix) - 1) == kIndexPrefix;
+    }
+
+    static bool isEdgeIndex(const folly::StringPiece& key) {
+        CHECK(isIndexKey(key));
+        return key[sizeof(kIndexPrefix) - 1 + sizeof(PartitionID)] == kEdgeIndex;
+    }
+
+    static int32_t getIndexSchemaId(const folly::StringPiece& key) {
+        CHECK(isIndexKey(key));
+        auto offset = kIndexHeadLen - sizeof(int32_t) - sizeof(int32_t);
+        return readInt<int32_t>(key.data() + offset, key.size() - offset);
+    }
+
+    static folly::StringPiece getIndexProp(const folly::StringPiece& key) {
+        CHECK(isIndexKey(key));
+        auto len = readInt<int32_t>(key.data() + kIndexHeadLen - sizeof(int32_t),
+                                    sizeof(int32_t));
+        return key.subpiece(kIndexHeadLen, len);
+    }
+
+    static folly::StringPiece getIndexValue(const folly::StringPiece& key) {
+        auto offset = kIndexHeadLen + getIndexProp(key).size();
+        auto suffixLen = isEdgeIndex(key) ? kEdgeIndexSuffixLen : kVertexIndexSuffixLen;
+        return key.subpiece(offset, key.size() - offset - suffixLen);
+    }
+
+    static VertexID getIndexVertexId(const folly::StringPiece& key) {
+        CHECK(!isEdgeIndex(key));
+        return readInt<VertexID>(key.end() - sizeof(VertexID), sizeof(VertexID));
+    }
+
+    static VertexID getIndexSrcId(const folly::StringPiece& key) {
+        CHECK(isEdgeIndex(key));
+        return readInt<VertexID>(key.end() - kEdgeIndexSuffixLen, sizeof(VertexID));
+    }
+
+    static EdgeRanking getIndexRank(const folly::StringPiece& key) {
+        CHECK(isEdgeIndex(key));
+        return readInt<EdgeRanking>(key.end() - sizeof(VertexID) - sizeof(EdgeRanking),
+                                    sizeof(EdgeRanking));
+    }
+
+    static VertexID getIndexDstId(const folly::StringPiece& key) {
+        CHECK(isEdgeIndex(key));
+        return readInt<VertexID>(key.end() - sizeof(VertexID), sizeof(VertexID));
     }
 
     static folly::StringPiece keyWithNoVersion(const folly::StringPiece& rawKey) {
         // TODO(heng) We should change the method if varint data version supportted.
+        if (!hasVersion(rawKey)) {
+            return rawKey;
+        }
         return rawKey.subpiece(0, rawKey.size() - sizeof(int64_t));
     }
 
@@ -123,8 +221,20 @@ private:
     static constexpr int32_t kEdgeLen = sizeof(PartitionID) + sizeof(VertexID)
                                       + sizeof(EdgeType) + sizeof(VertexID)
                                       + sizeof(EdgeRanking) + sizeof(EdgeVersion);
+    static constexpr int32_t kVertexLenNoVersion = kVertexLen - sizeof(TagVersion);
+    static constexpr int32_t kEdgeLenNoVersion = kEdgeLen - sizeof(EdgeVersion);
 
     static const char kSysPrefix = '_';
+
+    static constexpr char kIndexPrefix[] = "_i";
+    static const char kVertexIndex = 'v';
+    static const char kEdgeIndex = 'e';
+    // kIndexPrefix + partId + kind + tagId/edgeType + propLen
+    static constexpr int32_t kIndexHeadLen = sizeof(kIndexPrefix) - 1 + sizeof(PartitionID)
+                                           + sizeof(char) + sizeof(int32_t) + sizeof(int32_t);
+    static constexpr int32_t kVertexIndexSuffixLen = sizeof(VertexID);
+    static constexpr int32_t kEdgeIndexSuffixLen = sizeof(VertexID) + sizeof(EdgeRanking)
+                                                 + sizeof(VertexID);
 };
 
 }  // namespace nebula
@@ -0,0 +1,58 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "base/Arena.h"
+
+namespace nebula {
+
+TEST(Arena, allocate) {
+    Arena arena(1024);
+    EXPECT_EQ(0, arena.allocatedBytes());
+
+    std::vector<char*> ptrs;
+    for (int i = 0; i < 100; i++) {
+        auto* p = reinterpret_cast<char*>(arena.allocate(i + 1));
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t));
+        memset(p, i, i + 1);
+        ptrs.emplace_back(p);
+    }
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j <= i; j++) {
+            ASSERT_EQ(i, ptrs[i][j]);
+        }
+    }
+    EXPECT_LT(1024, arena.allocatedBytes());
+
+    // Larger than a chunk
+    auto allocated = arena.allocatedBytes();
+    auto* p = reinterpret_cast<char*>(arena.allocate(4096));
+    memset(p, 0, 4096);
+    EXPECT_LT(allocated + 4096, arena.allocatedBytes());
+}
+
+
+TEST(Arena, recycle) {
+    Arena arena;
+    auto* p1 = arena.allocate(1024);
+    auto* p2 = arena.allocate(1024);
+    EXPECT_NE(p1, p2);
+
+    arena.recycle(p1, 1024);
+    arena.recycle(p2, 1024);
+    // Blocks of another size are not reused
+    auto* p3 = arena.allocate(512);
+    EXPECT_NE(p1, p3);
+    EXPECT_NE(p2, p3);
+
+    EXPECT_EQ(p2, arena.allocate(1024));
+    EXPECT_EQ(p1, arena.allocate(1024));
+    EXPECT_NE(p1, arena.allocate(1024));
+    EXPECT_EQ(Arena::kDefaultChunkSize, arena.allocatedBytes());
+}
+
+}   // namespace nebula
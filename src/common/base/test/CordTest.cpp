@@ -194,6 +194,24 @@ TEST(Cord, cordStream) {
     EXPECT_EQ(str1 + str2, c1.str());
 }
 
+
+TEST(Cord, arena) {
+    Arena arena;
+    std::string buf;
+    for (int i = 0; i < 200; i++) {
+        buf.append("Hello World!");
+    }
+
+    for (int i = 0; i < 100; i++) {
+        Cord cord(&arena);
+        cord << buf;
+        EXPECT_EQ(buf.size(), cord.size());
+        EXPECT_EQ(buf, cord.str());
+    }
+    // The blocks of the previous cords are reused
+    EXPECT_EQ(Arena::kDefaultChunkSize, arena.allocatedBytes());
+}
+
 }   // namespace nebula
 
 
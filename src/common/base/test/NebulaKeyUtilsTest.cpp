@@ -31,6 +31,89 @@ TEST(NebulaKeyUtilsTest, SimpleTest) {
     CHECK_EQ(rank, NebulaKeyUtils::getRank(edgeKey));
 }
 
+TEST(NebulaKeyUtilsTest, NoVersionTest) {
+    PartitionID partId = 0L;
+    VertexID srcId = 1001L, dstId = 2001L;
+    TagID tagId = 1001;
+    EdgeType type = 101;
+    EdgeRanking rank = 10L;
+
+    auto vertexKey = NebulaKeyUtils::vertexKey(partId, srcId, tagId);
+    CHECK(NebulaKeyUtils::isVertex(vertexKey));
+    CHECK(!NebulaKeyUtils::isEdge(vertexKey));
+    CHECK(!NebulaKeyUtils::hasVersion(vertexKey));
+    CHECK_EQ(tagId, NebulaKeyUtils::getTagId(vertexKey));
+    CHECK_EQ(vertexKey, NebulaKeyUtils::keyWithNoVersion(vertexKey));
+    CHECK_EQ(vertexKey, NebulaKeyUtils::keyWithNoVersion(
+                            NebulaKeyUtils::vertexKey(partId, srcId, tagId, 20L)));
+
+    auto edgeKey = NebulaKeyUtils::edgeKey(partId, srcId, type, rank, dstId);
+    CHECK(NebulaKeyUtils::isEdge(edgeKey));
+    CHECK(!NebulaKeyUtils::isVertex(edgeKey));
+    CHECK(!NebulaKeyUtils::hasVersion(edgeKey));
+    CHECK_EQ(srcId, NebulaKeyUtils::getSrcId(edgeKey));
+    CHECK_EQ(dstId, NebulaKeyUtils::getDstId(edgeKey));
+    CHECK_EQ(type, NebulaKeyUtils::getEdgeType(edgeKey));
+    CHECK_EQ(rank, NebulaKeyUtils::getRank(edgeKey));
+    CHECK_EQ(edgeKey, NebulaKeyUtils::keyWithNoVersion(
+                          NebulaKeyUtils::edgeKey(partId, srcId, type, rank, dstId, 20L)));
+}
+
+TEST(NebulaKeyUtilsTest, IndexKeyTest) {
+    PartitionID partId = 1;
+    VertexID srcId = 1001L, dstId = 2001L;
+    TagID tagId = 1001;
+    EdgeType type = 101;
+    EdgeRanking rank = 10L;
+    auto value = NebulaKeyUtils::encodeIndexValue(std::string("nebula"));
+
+    auto vertexIndexKey = NebulaKeyUtils::vertexIndexKey(partId, tagId, "name", value, srcId);
+    CHECK(NebulaKeyUtils::isIndexKey(vertexIndexKey));
+    CHECK(!NebulaKeyUtils::isDataKey(vertexIndexKey));
+    CHECK(!NebulaKeyUtils::isEdgeIndex(vertexIndexKey));
+    CHECK_EQ(tagId, NebulaKeyUtils::getIndexSchemaId(vertexIndexKey));
+    CHECK_EQ("name", NebulaKeyUtils::getIndexProp(vertexIndexKey));
+    CHECK_EQ(value, NebulaKeyUtils::getIndexValue(vertexIndexKey));
+    CHECK_EQ(srcId, NebulaKeyUtils::getIndexVertexId(vertexIndexKey));
+    CHECK(folly::StringPiece(vertexIndexKey).startsWith(
+        NebulaKeyUtils::indexPrefix(partId, false, tagId, "name")));
+
+    auto edgeIndexKey = NebulaKeyUtils::edgeIndexKey(partId, type, "name", value,
+                                                     srcId, rank, dstId);
+    CHECK(NebulaKeyUtils::isIndexKey(edgeIndexKey));
+    CHECK(NebulaKeyUtils::isEdgeIndex(edgeIndexKey));
+    CHECK_EQ(type, NebulaKeyUtils::getIndexSchemaId(edgeIndexKey));
+    CHECK_EQ("name", NebulaKeyUtils::getIndexProp(edgeIndexKey));
+    CHECK_EQ(value, NebulaKeyUtils::getIndexValue(edgeIndexKey));
+    CHECK_EQ(srcId, NebulaKeyUtils::getIndexSrcId(edgeIndexKey));
+    CHECK_EQ(rank, NebulaKeyUtils::getIndexRank(edgeIndexKey));
+    CHECK_EQ(dstId, NebulaKeyUtils::getIndexDstId(edgeIndexKey));
+    CHECK(!folly::StringPiece(edgeIndexKey).startsWith(
+        NebulaKeyUtils::indexPrefix(partId, false, type, "name")));
+
+    CHECK(!NebulaKeyUtils::isIndexKey(NebulaKeyUtils::vertexKey(partId, srcId, tagId)));
+}
+
+TEST(NebulaKeyUtilsTest, IndexValueOrderTest) {
+    auto checkOrder = [] (std::vector<VariantType> values) {
+        for (size_t i = 1; i < values.size(); i++) {
+            auto left = NebulaKeyUtils::encodeIndexValue(values[i - 1]);
+            auto right = NebulaKeyUtils::encodeIndexValue(values[i]);
+            CHECK_LT(left, right) << values[i - 1] << " vs " << values[i];
+            CHECK(!folly::StringPiece(right).startsWith(left));
+        }
+    };
+    checkOrder({std::numeric_limits<int64_t>::min(), -100L, -1L, 0L, 1L, 100L,
+                std::numeric_limits<int64_t>::max()});
+    checkOrder({-std::numeric_limits<double>::infinity(), -1e10, -1.5, -0.5, 0.0,
+                0.5, 1.5, 1e10, std::numeric_limits<double>::infinity()});
+    checkOrder({false, true});
+    checkOrder({std::string(""), std::string(1, '\0'), std::string("\0a", 2),
+                std::string("a"), std::string("a\0", 2), std::string("ab"),
+                std::string("b")});
+    CHECK_EQ(NebulaKeyUtils::encodeIndexValue(-0.0), NebulaKeyUtils::encodeIndexValue(0.0));
+}
+
 }  // namespace nebula
 
 
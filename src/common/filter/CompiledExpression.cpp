@@ -0,0 +1,514 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "filter/CompiledExpression.h"
+
+namespace nebula {
+
+namespace {
+
+bool isNumeric(CompiledExpression::Type type) {
+    return type == CompiledExpression::kInt || type == CompiledExpression::kDouble;
+}
+
+}   // namespace
+
+
+// static
+StatusOr<std::unique_ptr<CompiledExpression>>
+CompiledExpression::compile(const Expression *expr, PropResolver resolver) {
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+    compiled->resolver_ = std::move(resolver);
+    auto result = compiled->compileNode(expr);
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto operand = result.value();
+    compiled->result_ = operand.reg;
+    compiled->type_ = operand.type;
+    compiled->resolver_ = nullptr;
+    VLOG(3) << "Compiled `" << expr->toString() << "' into "
+            << compiled->code_.size() << " instructions";
+    return std::move(compiled);
+}
+
+
+VariantType CompiledExpression::eval(const PropAccessor &accessor) const {
+    run(0, code_.size(), &accessor, regs_);
+    return toVariant(regs_[result_], type_);
+}
+
+
+bool CompiledExpression::test(const PropAccessor &accessor) const {
+    run(0, code_.size(), &accessor, regs_);
+    return toBool(regs_[result_], type_);
+}
+
+
+VariantType CompiledExpression::eval(const PropAccessor &accessor, Registers *regs) const {
+    auto &own = prepare(regs);
+    run(0, code_.size(), &accessor, own);
+    return toVariant(own[result_], type_);
+}
+
+
+bool CompiledExpression::test(const PropAccessor &accessor, Registers *regs) const {
+    auto &own = prepare(regs);
+    run(0, code_.size(), &accessor, own);
+    return toBool(own[result_], type_);
+}
+
+
+std::vector<CompiledExpression::Register>&
+CompiledExpression::prepare(Registers *regs) const {
+    DCHECK(regs != nullptr);
+    if (regs->regs_.size() < regs_.size()) {
+        regs->regs_.resize(regs_.size());
+    }
+    return regs->regs_;
+}
+
+
+StatusOr<CompiledExpression::Operand> CompiledExpression::compileNode(const Expression *expr) {
+    switch (expr->kind()) {
+        case Expression::kPrimary:
+        case Expression::kEdgeType:
+            // Both evaluate to literals
+            return emitConst(expr->eval());
+        case Expression::kSourceProp:
+        case Expression::kDestProp:
+        case Expression::kEdgeProp:
+        case Expression::kEdgeRank:
+        case Expression::kEdgeSrcId:
+        case Expression::kEdgeDstId:
+        case Expression::kInputProp: {
+            auto result = resolver_(expr);
+            if (!result.ok()) {
+                return result.status();
+            }
+            auto prop = result.value();
+            auto reg = emit(kLoad, prop.type, prop.slot);
+            return Operand{reg, prop.type, false};
+        }
+        case Expression::kUnary:
+            return compileUnary(static_cast<const UnaryExpression*>(expr));
+        case Expression::kArithmetic:
+            return compileArithmetic(static_cast<const ArithmeticExpression*>(expr));
+        case Expression::kRelational:
+            return compileRelational(static_cast<const RelationalExpression*>(expr));
+        case Expression::kLogical:
+            return compileLogical(static_cast<const LogicalExpression*>(expr));
+        default:
+            break;
+    }
+    return Status::Error("`%s' could not be compiled", expr->toString().c_str());
+}
+
+
+StatusOr<CompiledExpression::Operand>
+CompiledExpression::compileUnary(const UnaryExpression *expr) {
+    auto begin = code_.size();
+    auto result = compileNode(expr->operand());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto operand = result.value();
+    switch (expr->op()) {
+        case UnaryExpression::PLUS:
+            return operand;
+        case UnaryExpression::NEGATE:
+            if (!isNumeric(operand.type)) {
+                // Left as it is, the same as UnaryExpression::eval()
+                return operand;
+            }
+            return fold(begin,
+                        Operand{emit(kNeg, operand.type, operand.reg), operand.type, false},
+                        {operand});
+        case UnaryExpression::NOT:
+            return fold(begin,
+                        Operand{emit(kNot, operand.type, operand.reg), kBool, false},
+                        {operand});
+    }
+    return Status::Error("Unknown unary operator of `%s'", expr->toString().c_str());
+}
+
+
+StatusOr<CompiledExpression::Operand>
+CompiledExpression::compileArithmetic(const ArithmeticExpression *expr) {
+    auto begin = code_.size();
+    auto result = compileNode(expr->left());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto left = result.value();
+    result = compileNode(expr->right());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto right = result.value();
+
+    Op op;
+    switch (expr->op()) {
+        case ArithmeticExpression::ADD:
+            op = kAdd;
+            break;
+        case ArithmeticExpression::SUB:
+            op = kSub;
+            break;
+        case ArithmeticExpression::MUL:
+            op = kMul;
+            break;
+        case ArithmeticExpression::DIV:
+            op = kDiv;
+            break;
+        case ArithmeticExpression::MOD:
+            op = kMod;
+            break;
+        default:
+            return Status::Error("Unknown arithmetic operator of `%s'", expr->toString().c_str());
+    }
+
+    Type type;
+    if (op == kAdd && left.type == kString && right.type == kString) {
+        type = kString;
+    } else if (op == kMod) {
+        if (left.type != kInt || right.type != kInt) {
+            return Status::Error("Illegal operands of `%s'", expr->toString().c_str());
+        }
+        type = kInt;
+    } else if (isNumeric(left.type) && isNumeric(right.type)) {
+        if (left.type == kDouble || right.type == kDouble) {
+            left = promote(left);
+            right = promote(right);
+            type = kDouble;
+        } else {
+            type = kInt;
+        }
+    } else {
+        return Status::Error("Illegal operands of `%s'", expr->toString().c_str());
+    }
+    return fold(begin, Operand{emit(op, type, left.reg, right.reg), type, false}, {left, right});
+}
+
+
+StatusOr<CompiledExpression::Operand>
+CompiledExpression::compileRelational(const RelationalExpression *expr) {
+    auto begin = code_.size();
+    auto result = compileNode(expr->left());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto left = result.value();
+    result = compileNode(expr->right());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto right = result.value();
+
+    Op op;
+    switch (expr->op()) {
+        case RelationalExpression::LT:
+            op = kLT;
+            break;
+        case RelationalExpression::LE:
+            op = kLE;
+            break;
+        case RelationalExpression::GT:
+            op = kGT;
+            break;
+        case RelationalExpression::GE:
+            op = kGE;
+            break;
+        case RelationalExpression::EQ:
+            op = kEQ;
+            break;
+        case RelationalExpression::NE:
+            op = kNE;
+            break;
+        default:
+            return Status::Error("Unknown relational operator of `%s'", expr->toString().c_str());
+    }
+
+    Type type;
+    if (left.type == right.type) {
+        type = left.type;
+    } else if (isNumeric(left.type) && isNumeric(right.type)) {
+        left = promote(left);
+        right = promote(right);
+        type = kDouble;
+    } else {
+        return Status::Error("Could not compare the operands of `%s'", expr->toString().c_str());
+    }
+    return fold(begin, Operand{emit(op, type, left.reg, right.reg), kBool, false}, {left, right});
+}
+
+
+StatusOr<CompiledExpression::Operand>
+CompiledExpression::compileLogical(const LogicalExpression *expr) {
+    auto begin = code_.size();
+    auto result = compileNode(expr->left());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto left = result.value();
+    auto dst = emit(kToBool, left.type, left.reg);
+
+    // Short-circuit, both sides write to the same register
+    auto jump = code_.size();
+    code_.emplace_back(Instruction{
+        expr->op() == LogicalExpression::AND ? kJumpIfFalse : kJumpIfTrue, kBool, dst, dst, -1});
+
+    result = compileNode(expr->right());
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto right = result.value();
+    code_.emplace_back(Instruction{kToBool, right.type, dst, right.reg, -1});
+    code_[jump].b = code_.size();
+
+    return fold(begin, Operand{dst, kBool, false}, {left, right});
+}
+
+
+CompiledExpression::Operand CompiledExpression::emitConst(VariantType value) {
+    auto type = static_cast<Type>(value.which());
+    consts_.emplace_back(std::move(value));
+    auto reg = emit(kConst, type, consts_.size() - 1);
+    return Operand{reg, type, true};
+}
+
+
+CompiledExpression::Operand CompiledExpression::promote(Operand operand) {
+    if (operand.type != kInt) {
+        return operand;
+    }
+    return Operand{emit(kToDouble, kInt, operand.reg), kDouble, operand.constant};
+}
+
+
+int32_t CompiledExpression::emit(Op op, Type type, int32_t a, int32_t b) {
+    int32_t dst = regs_.size();
+    regs_.emplace_back();
+    code_.emplace_back(Instruction{op, type, dst, a, b});
+    return dst;
+}
+
+
+CompiledExpression::Operand CompiledExpression::fold(size_t begin,
+                                                     Operand result,
+                                                     std::initializer_list<Operand> operands) {
+    for (auto &operand : operands) {
+        if (!operand.constant) {
+            return result;
+        }
+    }
+    run(begin, code_.size(), nullptr, regs_);
+    auto value = toVariant(regs_[result.reg], result.type);
+    code_.resize(begin);
+    return emitConst(std::move(value));
+}
+
+
+void CompiledExpression::run(size_t begin,
+                             size_t end,
+                             const PropAccessor *accessor,
+                             std::vector<Register> &regs) const {
+    auto pc = begin;
+    while (pc < end) {
+        const auto &ins = code_[pc++];
+        auto &dst = regs[ins.dst];
+        switch (ins.op) {
+            case kConst: {
+                const auto &value = consts_[ins.a];
+                switch (ins.type) {
+                    case kInt:
+                        dst.i = boost::get<int64_t>(value);
+                        break;
+                    case kDouble:
+                        dst.d = boost::get<double>(value);
+                        break;
+                    case kBool:
+                        dst.b = boost::get<bool>(value);
+                        break;
+                    case kString:
+                        dst.s = boost::get<std::string>(value);
+                        break;
+                }
+                break;
+            }
+            case kLoad: {
+                DCHECK(accessor != nullptr);
+                switch (ins.type) {
+                    case kInt:
+                        dst.i = accessor->getInt(ins.a);
+                        break;
+                    case kDouble:
+                        dst.d = accessor->getDouble(ins.a);
+                        break;
+                    case kBool:
+                        dst.b = accessor->getBool(ins.a);
+                        break;
+                    case kString:
+                        dst.s = accessor->getString(ins.a);
+                        break;
+                }
+                break;
+            }
+            case kToDouble:
+                dst.d = static_cast<double>(regs[ins.a].i);
+                break;
+            case kToBool:
+                dst.b = toBool(regs[ins.a], ins.type);
+                break;
+            case kAdd: {
+                const auto &left = regs[ins.a];
+                const auto &right = regs[ins.b];
+                if (ins.type == kInt) {
+                    dst.i = left.i + right.i;
+                } else if (ins.type == kDouble) {
+                    dst.d = left.d + right.d;
+                } else {
+                    dst.buf.assign(left.s.data(), left.s.size());
+                    dst.buf.append(right.s.data(), right.s.size());
+                    dst.s = dst.buf;
+                }
+                break;
+            }
+            case kSub:
+                if (ins.type == kInt) {
+                    dst.i = regs[ins.a].i - regs[ins.b].i;
+                } else {
+                    dst.d = regs[ins.a].d - regs[ins.b].d;
+                }
+                break;
+            case kMul:
+                if (ins.type == kInt) {
+                    dst.i = regs[ins.a].i * regs[ins.b].i;
+                } else {
+                    dst.d = regs[ins.a].d * regs[ins.b].d;
+                }
+                break;
+            case kDiv:
+                if (ins.type == kInt) {
+                    dst.i = regs[ins.a].i / regs[ins.b].i;
+                } else {
+                    dst.d = regs[ins.a].d / regs[ins.b].d;
+                }
+                break;
+            case kMod:
+                dst.i = regs[ins.a].i % regs[ins.b].i;
+                break;
+            case kNeg:
+                if (ins.type == kInt) {
+                    dst.i = -regs[ins.a].i;
+                } else {
+                    dst.d = -regs[ins.a].d;
+                }
+                break;
+            case kNot:
+                dst.b = !toBool(regs[ins.a], ins.type);
+                break;
+            case kLT:
+            case kLE:
+            case kGT:
+            case kGE:
+            case kEQ:
+            case kNE:
+                dst.b = compare(ins.op, ins.type, regs[ins.a], regs[ins.b]);
+                break;
+            case kJumpIfFalse:
+                if (!dst.b) {
+                    pc = ins.b;
+                }
+                break;
+            case kJumpIfTrue:
+                if (dst.b) {
+                    pc = ins.b;
+                }
+                break;
+        }
+    }
+}
+
+
+// static
+VariantType CompiledExpression::toVariant(const Register &reg, Type type) {
+    switch (type) {
+        case kInt:
+            return reg.i;
+        case kDouble:
+            return reg.d;
+        case kBool:
+            return reg.b;
+        case kString:
+            return reg.s.str();
+    }
+    return false;
+}
+
+
+// static
+bool CompiledExpression::toBool(const Register &reg, Type type) {
+    // The same as Expression::asBool()
+    switch (type) {
+        case kInt:
+            return reg.i != 0;
+        case kDouble:
+            return reg.d != 0.0;
+        case kBool:
+            return reg.b;
+        case kString:
+            return reg.s.empty();
+    }
+    return false;
+}
+
+
+// static
+bool CompiledExpression::compare(Op op, Type type, const Register &left, const Register &right) {
+    switch (type) {
+        case kInt:
+            return compare(op, left.i, right.i);
+        case kDouble:
+            if (op == kEQ) {
+                return Expression::almostEqual(left.d, right.d);
+            } else if (op == kNE) {
+                return !Expression::almostEqual(left.d, right.d);
+            }
+            return compare(op, left.d, right.d);
+        case kBool:
+            return compare(op, left.b, right.b);
+        case kString:
+            return compare(op, left.s, right.s);
+    }
+    return false;
+}
+
+
+// static
+template <typename T>
+bool CompiledExpression::compare(Op op, const T &left, const T &right) {
+    switch (op) {
+        case kLT:
+            return left < right;
+        case kLE:
+            return left <= right;
+        case kGT:
+            return left > right;
+        case kGE:
+            return left >= right;
+        case kEQ:
+            return left == right;
+        case kNE:
+            return left != right;
+        default:
+            DCHECK(false) << "Not a relational operator " << static_cast<int32_t>(op);
+    }
+    return false;
+}
+
+}   // namespace nebula
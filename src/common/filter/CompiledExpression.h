@@ -0,0 +1,178 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_FILTER_COMPILEDEXPRESSION_H_
+#define COMMON_FILTER_COMPILEDEXPRESSION_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "filter/Expressions.h"
+
+namespace nebula {
+
+/**
+ * An expression compiled into a register-based program.
+ *
+ * Compiling resolves the properties to the slots of a PropAccessor, infers
+ * the type of each node, folds the constant sub-expressions and emits typed
+ * instructions. So evaluating a row makes no virtual call but the property
+ * loads, and builds no VariantType but the result.
+ *
+ * Function calls, type castings, variables and the properties the resolver
+ * knows no type of are not supported, compiling fails and the caller keeps
+ * evaluating the expression tree then.
+ *
+ * Evaluating is not thread-safe, since the registers are reused among rows.
+ * The threads evaluating one expression concurrently bring their own Registers.
+ * */
+class CompiledExpression final {
+public:
+    // Same as VariantType::which()
+    enum Type : uint8_t {
+        kInt = 0,
+        kDouble = 1,
+        kBool = 2,
+        kString = 3,
+    };
+
+    // Read the properties of the current row, by the slots resolved when compiling
+    class PropAccessor {
+    public:
+        virtual ~PropAccessor() = default;
+
+        virtual int64_t getInt(int32_t slot) const = 0;
+        virtual double getDouble(int32_t slot) const = 0;
+        virtual bool getBool(int32_t slot) const = 0;
+        virtual folly::StringPiece getString(int32_t slot) const = 0;
+    };
+
+    struct Prop {
+        int32_t     slot;
+        Type        type;
+    };
+
+    // The registers of one evaluation at a time, reused among its rows
+    class Registers;
+
+    // Given one of kSourceProp, kDestProp, kEdgeProp, kEdgeRank, kEdgeSrcId,
+    // kEdgeDstId and kInputProp expressions, return its slot and type
+    using PropResolver = std::function<StatusOr<Prop>(const Expression *expr)>;
+
+    static StatusOr<std::unique_ptr<CompiledExpression>> compile(const Expression *expr,
+                                                                 PropResolver resolver);
+
+    VariantType eval(const PropAccessor &accessor) const;
+
+    // Evaluate as a filter, the same as Expression::asBool(eval(accessor))
+    bool test(const PropAccessor &accessor) const;
+
+    // The same as above, with the registers given rather than the own ones
+    VariantType eval(const PropAccessor &accessor, Registers *regs) const;
+    bool test(const PropAccessor &accessor, Registers *regs) const;
+
+    Type type() const {
+        return type_;
+    }
+
+    size_t numInstructions() const {
+        return code_.size();
+    }
+
+private:
+    enum Op : uint8_t {
+        kConst,
+        kLoad,
+        kToDouble,
+        kToBool,
+        kAdd,
+        kSub,
+        kMul,
+        kDiv,
+        kMod,
+        kNeg,
+        kNot,
+        kLT,
+        kLE,
+        kGT,
+        kGE,
+        kEQ,
+        kNE,
+        kJumpIfFalse,
+        kJumpIfTrue,
+    };
+
+    // `type' is the type of the operands. `a' is the constant for kConst,
+    // the slot for kLoad, and `b' is the target of the jumps
+    struct Instruction {
+        Op          op;
+        Type        type;
+        int32_t     dst;
+        int32_t     a;
+        int32_t     b;
+    };
+
+    struct Register {
+        int64_t             i{0};
+        double              d{0.0};
+        bool                b{false};
+        folly::StringPiece  s;
+        // Holds the result of string concatenations
+        std::string         buf;
+    };
+
+    struct Operand {
+        int32_t     reg;
+        Type        type;
+        bool        constant;
+    };
+
+    CompiledExpression() = default;
+
+    StatusOr<Operand> compileNode(const Expression *expr);
+    StatusOr<Operand> compileUnary(const UnaryExpression *expr);
+    StatusOr<Operand> compileArithmetic(const ArithmeticExpression *expr);
+    StatusOr<Operand> compileRelational(const RelationalExpression *expr);
+    StatusOr<Operand> compileLogical(const LogicalExpression *expr);
+
+    Operand emitConst(VariantType value);
+    // Convert an int operand to double
+    Operand promote(Operand operand);
+    int32_t emit(Op op, Type type, int32_t a, int32_t b = -1);
+    // Evaluate the instructions since `begin' once for all, if all operands are constant
+    Operand fold(size_t begin, Operand result, std::initializer_list<Operand> operands);
+
+    void run(size_t begin,
+             size_t end,
+             const PropAccessor *accessor,
+             std::vector<Register> &regs) const;
+
+    std::vector<Register>& prepare(Registers *regs) const;
+
+    static VariantType toVariant(const Register &reg, Type type);
+    static bool toBool(const Register &reg, Type type);
+    static bool compare(Op op, Type type, const Register &left, const Register &right);
+    template <typename T>
+    static bool compare(Op op, const T &left, const T &right);
+
+private:
+    PropResolver                    resolver_;
+    std::vector<Instruction>        code_;
+    std::vector<VariantType>        consts_;
+    mutable std::vector<Register>   regs_;
+    int32_t                         result_{-1};
+    Type                            type_{kBool};
+};
+
+
+class CompiledExpression::Registers final {
+private:
+    friend class CompiledExpression;
+
+    std::vector<Register>           regs_;
+};
+
+}   // namespace nebula
+
+#endif  // COMMON_FILTER_COMPILEDEXPRESSION_H_
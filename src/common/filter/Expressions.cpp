@@ -968,6 +968,26 @@ std::string RelationalExpression::toString() const {
 VariantType RelationalExpression::eval() const {
     auto left = left_->eval();
     auto right = right_->eval();
+    // An int compared with a double is promoted to double, the same as CompiledExpression
+    if (isArithmetic(left) && isArithmetic(right) && (isDouble(left) || isDouble(right))) {
+        auto l = asDouble(left);
+        auto r = asDouble(right);
+        switch (op_) {
+            case LT:
+                return l < r;
+            case LE:
+                return l <= r;
+            case GT:
+                return l > r;
+            case GE:
+                return l >= r;
+            case EQ:
+                return almostEqual(l, r);
+            case NE:
+                return !almostEqual(l, r);
+        }
+        return false;
+    }
     switch (op_) {
         case LT:
             return left < right;
@@ -978,14 +998,8 @@ VariantType RelationalExpression::eval() const {
         case GE:
             return left >= right;
         case EQ:
-            if (isDouble(left) || isDouble(right)) {
-                return almostEqual(asDouble(left), asDouble(right));
-            }
             return left == right;
         case NE:
-            if (isDouble(left) || isDouble(right)) {
-                return !almostEqual(asDouble(left), asDouble(right));
-            }
             return left != right;
     }
     return false;
@@ -337,6 +337,14 @@ public:
 
     Status MUST_USE_RESULT prepare() override;
 
+    const std::string& tag() const {
+        return *tag_;
+    }
+
+    const std::string& prop() const {
+        return *prop_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -712,6 +720,10 @@ public:
         return operand_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -805,6 +817,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -856,6 +872,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -908,6 +928,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -7,6 +7,7 @@
 #include "base/Base.h"
 #include <gtest/gtest.h>
 #include "filter/FunctionManager.h"
+#include "filter/CompiledExpression.h"
 #include "parser/GQLParser.h"
 #include "parser/SequentialSentences.h"
 
@@ -284,6 +285,13 @@ TEST_F(ExpressionTest, LiteralConstantsRelational) {
 
     TEST_EXPR(3.14 * 3 * 3 / 2 > 3.14 * 1.5 * 1.5 / 2, true);
     TEST_EXPR(3.14 * 3 * 3 / 2 < 3.14 * 1.5 * 1.5 / 2, false);
+    // An int compared with a double is promoted to double
+    TEST_EXPR(2 > 1.5, true);
+    TEST_EXPR(1.5 > 2, false);
+    TEST_EXPR(2 <= 1.5, false);
+    TEST_EXPR(1.5 < 2, true);
+    TEST_EXPR(2 == 2.0, true);
+    TEST_EXPR(2 != 2.0, false);
 
     {
         std::string query = "GO FROM 1 OVER follow WHERE 3.14 * 3 * 3 / 2 == 14.13";
@@ -576,4 +584,165 @@ TEST_F(ExpressionTest, FunctionCall) {
 #undef TEST_EXPR
 }
 
+
+TEST_F(ExpressionTest, Compiled) {
+    // Props of the row, addressed by slots
+    std::vector<std::pair<std::string, VariantType>> row = {
+        {"follow.age", 20L},
+        {"follow.name", std::string("bob")},
+        {"follow.weight", 2.5},
+        {"follow._dst", 2L},
+        {"$^.person.name", std::string("alice")},
+        {"$^.person.married", true},
+    };
+    auto slotOf = [&row] (const std::string &name) -> int32_t {
+        for (size_t i = 0; i < row.size(); i++) {
+            if (row[i].first == name) {
+                return i;
+            }
+        }
+        return -1;
+    };
+
+    class TestAccessor final : public CompiledExpression::PropAccessor {
+    public:
+        explicit TestAccessor(const std::vector<std::pair<std::string, VariantType>> &row)
+            : row_(row) {}
+
+        int64_t getInt(int32_t slot) const override {
+            return boost::get<int64_t>(row_[slot].second);
+        }
+        double getDouble(int32_t slot) const override {
+            return boost::get<double>(row_[slot].second);
+        }
+        bool getBool(int32_t slot) const override {
+            return boost::get<bool>(row_[slot].second);
+        }
+        folly::StringPiece getString(int32_t slot) const override {
+            return boost::get<std::string>(row_[slot].second);
+        }
+
+    private:
+        const std::vector<std::pair<std::string, VariantType>> &row_;
+    };
+    TestAccessor accessor(row);
+
+    auto resolver = [&] (const Expression *expr) -> StatusOr<CompiledExpression::Prop> {
+        int32_t slot = -1;
+        switch (expr->kind()) {
+            case Expression::kEdgeProp: {
+                auto *edgeExpr = static_cast<const EdgePropertyExpression*>(expr);
+                slot = slotOf(edgeExpr->alias() + "." + edgeExpr->prop());
+                break;
+            }
+            case Expression::kEdgeDstId:
+                slot = slotOf("follow._dst");
+                break;
+            case Expression::kSourceProp: {
+                auto *srcExpr = static_cast<const SourcePropertyExpression*>(expr);
+                slot = slotOf("$^." + srcExpr->tag() + "." + srcExpr->prop());
+                break;
+            }
+            default:
+                break;
+        }
+        if (slot < 0) {
+            return Status::Error("Unknown prop `%s'", expr->toString().c_str());
+        }
+        return CompiledExpression::Prop{
+            slot, static_cast<CompiledExpression::Type>(row[slot].second.which())};
+    };
+
+    auto ctx = std::make_unique<ExpressionContext>();
+    ctx->getters().getEdgeProp = [&] (auto &prop) -> VariantType {
+        return row[slotOf("follow." + prop)].second;
+    };
+    ctx->getters().getSrcTagProp = [&] (auto &tag, auto &prop) -> VariantType {
+        return row[slotOf("$^." + tag + "." + prop)].second;
+    };
+
+    GQLParser parser;
+#define TEST_EXPR(expr_arg)                                                     \
+    do {                                                                        \
+        std::string query = "GO FROM 1 OVER follow WHERE " expr_arg;            \
+        auto parsed = parser.parse(query);                                      \
+        ASSERT_TRUE(parsed.ok()) << parsed.status();                            \
+        auto *expr = getFilterExpr(parsed.value().get());                       \
+        ASSERT_NE(nullptr, expr);                                               \
+        expr->setContext(ctx.get());                                            \
+        auto compiled = CompiledExpression::compile(expr, resolver);            \
+        ASSERT_TRUE(compiled.ok()) << compiled.status();                        \
+        auto expected = expr->eval();                                           \
+        auto value = compiled.value()->eval(accessor);                          \
+        ASSERT_EQ(expected.which(), value.which()) << expr_arg;                 \
+        if (Expression::isDouble(value)) {                                      \
+            ASSERT_DOUBLE_EQ(Expression::asDouble(expected),                    \
+                             Expression::asDouble(value)) << expr_arg;          \
+        } else {                                                                \
+            ASSERT_EQ(expected, value) << expr_arg;                             \
+        }                                                                       \
+        ASSERT_EQ(Expression::asBool(expected),                                 \
+                  compiled.value()->test(accessor)) << expr_arg;                \
+        /* The same with registers of its own */                                \
+        CompiledExpression::Registers regs;                                     \
+        ASSERT_EQ(Expression::asBool(expected),                                 \
+                  compiled.value()->test(accessor, &regs)) << expr_arg;         \
+        ASSERT_EQ(value, compiled.value()->eval(accessor, &regs)) << expr_arg;  \
+    } while (false)
+
+    TEST_EXPR("follow.age > 18 && follow.name == \"bob\"");
+    TEST_EXPR("follow.age < 18 || follow._dst == 2");
+    TEST_EXPR("follow.age < 18 && follow.name == \"bob\"");
+    TEST_EXPR("follow.age + 2 * 3 >= 26");
+    TEST_EXPR("follow.age % 7");
+    TEST_EXPR("-follow.age");
+    TEST_EXPR("follow.weight * 2 + follow.age");
+    TEST_EXPR("follow.age / 3");
+    TEST_EXPR("follow.weight / 2 == 1.25");
+    TEST_EXPR("follow.weight != 2.5");
+    TEST_EXPR("follow.age > follow.weight");
+    TEST_EXPR("follow.weight < follow.age");
+    TEST_EXPR("follow.age >= 20.0");
+    TEST_EXPR("follow.age == 20.0");
+    TEST_EXPR("follow.weight <= 2");
+    TEST_EXPR("!(follow.age == 20) || follow.name + \"x\" == \"bobx\"");
+    TEST_EXPR("follow.name + \"_\" + $^.person.name");
+    TEST_EXPR("$^.person.name < follow.name");
+    TEST_EXPR("$^.person.married && !$^.person.married");
+    TEST_EXPR("$^.person.married == true");
+
+#undef TEST_EXPR
+
+    // Constants are folded
+    {
+        auto parsed = parser.parse("GO FROM 1 OVER follow WHERE (1 + 2) * 3 > 8 && 1.5 > 1");
+        ASSERT_TRUE(parsed.ok()) << parsed.status();
+        auto compiled = CompiledExpression::compile(getFilterExpr(parsed.value().get()),
+                                                    resolver);
+        ASSERT_TRUE(compiled.ok()) << compiled.status();
+        ASSERT_EQ(1UL, compiled.value()->numInstructions());
+        ASSERT_TRUE(compiled.value()->test(accessor));
+    }
+    {
+        auto parsed = parser.parse("GO FROM 1 OVER follow WHERE follow.age > 10 + 8");
+        ASSERT_TRUE(parsed.ok()) << parsed.status();
+        auto compiled = CompiledExpression::compile(getFilterExpr(parsed.value().get()),
+                                                    resolver);
+        ASSERT_TRUE(compiled.ok()) << compiled.status();
+        // Load, constant and comparison
+        ASSERT_EQ(3UL, compiled.value()->numInstructions());
+    }
+    // Unsupported ones are left to Expression::eval()
+    for (auto *filter : {"abs(follow.age) > 1",
+                         "follow.unknown > 1",
+                         "follow.name > 1",
+                         "follow.name - \"b\" == \"bo\""}) {
+        auto parsed = parser.parse(std::string("GO FROM 1 OVER follow WHERE ") + filter);
+        ASSERT_TRUE(parsed.ok()) << parsed.status();
+        auto compiled = CompiledExpression::compile(getFilterExpr(parsed.value().get()),
+                                                    resolver);
+        ASSERT_FALSE(compiled.ok()) << filter;
+    }
+}
+
 }   // namespace nebula
@@ -20,6 +20,7 @@
 #include "kvstore/NebulaStore.h"
 #include "meta/ActiveHostsMan.h"
 #include "meta/KVBasedGflagsManager.h"
+#include "meta/processors/admin/Balancer.h"
 
 using nebula::operator<<;
 using nebula::ProcessUtils;
@@ -146,6 +147,7 @@ int main(int argc, char *argv[]) {
 
     auto handler = std::make_shared<nebula::meta::MetaServiceHandler>(kvstore_);
     nebula::meta::ActiveHostsMan::instance(kvstore_);
+    nebula::meta::Balancer::instance(kvstore_)->startLeaderBalance();
     auto gflagsManager = std::make_unique<nebula::meta::KVBasedGflagsManager>(kvstore.get());
     gflagsManager->init();
 
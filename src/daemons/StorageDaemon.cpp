@@ -15,7 +15,10 @@
 #include "storage/StorageHttpAdminHandler.h"
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
+#include "kvstore/RocksEngineConfig.h"
+#include "kvstore/wal/BufferArena.h"
 #include "process/ProcessUtils.h"
+#include "stats/StatsManager.h"
 #include "storage/test/TestUtils.h"
 #include "webservice/WebService.h"
 #include "meta/SchemaManager.h"
@@ -71,6 +74,7 @@ std::unique_ptr<nebula::kvstore::KVStore> getStoreInstance(
         metaClient);
     options.cfFactory_ = std::shared_ptr<nebula::kvstore::KVCompactionFilterFactory>(
             new nebula::storage::NebulaCompactionFilterFactory(schemaMan));
+    options.multiColumnFamilies_ = FLAGS_rocksdb_multi_column_families;
     if (FLAGS_store_type == "nebula") {
         auto nbStore = std::make_unique<nebula::kvstore::NebulaStore>(std::move(options),
                                                                       ioPool,
@@ -175,6 +179,12 @@ int main(int argc, char *argv[]) {
     auto schemaMan = nebula::meta::SchemaManager::create();
     schemaMan->init(metaClient.get());
 
+    // Milliseconds the WAL appends have waited for the buffer budget
+    auto walBackPressure = nebula::stats::StatsManager::registerStats("wal_back_pressure_ms");
+    nebula::wal::BufferArena::get().setBackPressureListener([walBackPressure] (int64_t ms) {
+        nebula::stats::StatsManager::addValue(walBackPressure, ms);
+    });
+
     LOG(INFO) << "Init kvstore";
     std::unique_ptr<KVStore> kvstore = getStoreInstance(localhost,
                                                         std::move(paths),
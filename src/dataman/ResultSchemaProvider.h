@@ -50,12 +50,17 @@ public:
     std::shared_ptr<const meta::SchemaProviderIf::Field> field(
         const folly::StringPiece name) const override;
 
+    const cpp2::SchemaProp getProp() const override {
+        return schemaProp_;
+    }
+
 protected:
     SchemaVer schemaVer_{0};
 
     ColumnDefs columns_;
     // Map of Hash64(field_name) -> array index
     UnorderedMap<uint64_t, int64_t> nameIndex_;
+    cpp2::SchemaProp schemaProp_;
 
     // Default constructor, only used by SchemaWriter
     explicit ResultSchemaProvider(SchemaVer ver = 0) : schemaVer_(ver) {}
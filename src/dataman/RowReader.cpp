@@ -242,8 +242,10 @@ bool RowReader::processHeader(folly::StringPiece row) {
         LOG(ERROR) << "Rowe data is too short";
         return false;
     }
-    offsets_.resize(numFields + 1, -1);
+    // The buffers are reused when a BoundRowReader moves to the next row
+    offsets_.assign(numFields + 1, -1);
     offsets_[0] = 0;
+    blockOffsets_.clear();
     blockOffsets_.emplace_back(0, 0);
     blockOffsets_.reserve(numOffsets);
     for (uint32_t i = 0; i < numOffsets; i++) {
@@ -666,4 +668,65 @@ ResultType RowReader::getTimestamp(int64_t index, int64_t& v) const noexcept {
     return getTimestamp(index, offset, v);
 }
 
+
+/*********************************************
+ *
+ * class BoundRowReader
+ *
+ ********************************************/
+// static
+std::unique_ptr<BoundRowReader> BoundRowReader::bindTag(meta::SchemaManager* schemaMan,
+                                                        GraphSpaceID space,
+                                                        TagID tag) {
+    CHECK_NOTNULL(schemaMan);
+    return std::unique_ptr<BoundRowReader>(new BoundRowReader(schemaMan, space, tag, false));
+}
+
+
+// static
+std::unique_ptr<BoundRowReader> BoundRowReader::bindEdge(meta::SchemaManager* schemaMan,
+                                                         GraphSpaceID space,
+                                                         EdgeType edge) {
+    CHECK_NOTNULL(schemaMan);
+    return std::unique_ptr<BoundRowReader>(new BoundRowReader(schemaMan, space, edge, true));
+}
+
+
+bool BoundRowReader::reset(folly::StringPiece row) {
+    int32_t ver = getSchemaVer(row);
+    if (ver < 0) {
+        return false;
+    }
+    if (schema_ == nullptr || schema_->getVersion() != ver) {
+        auto it = schemas_.find(ver);
+        if (it == schemas_.end()) {
+            auto schema = isEdge_ ? schemaMan_->getEdgeSchema(space_, id_, ver)
+                                  : schemaMan_->getTagSchema(space_, id_, ver);
+            if (schema == nullptr) {
+                LOG(ERROR) << "No schema of version " << ver << " for "
+                           << (isEdge_ ? "edge " : "tag ") << id_ << " in space " << space_;
+                return false;
+            }
+            it = schemas_.emplace(ver, std::move(schema)).first;
+        }
+        schema_ = it->second;
+    }
+    if (!processHeader(row)) {
+        LOG(ERROR) << "Invalid row data!";
+        return false;
+    }
+    // data_.begin() points to the first field
+    data_.reset(row.begin() + headerLen_, row.size() - headerLen_);
+    return true;
+}
+
+
+const meta::SchemaProviderIf* BoundRowReader::latestSchema() {
+    if (latest_ == nullptr) {
+        latest_ = isEdge_ ? schemaMan_->getEdgeSchema(space_, id_)
+                          : schemaMan_->getTagSchema(space_, id_);
+    }
+    return latest_.get();
+}
+
 }  // namespace nebula
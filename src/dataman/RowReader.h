@@ -255,7 +255,7 @@ public:
     // TODO getMap(const std::string& name) const noexcept;
     // TODO getMap(int64_t index) const noexcept;
 
-private:
+protected:
     std::shared_ptr<const meta::SchemaProviderIf> schema_;
 
     folly::StringPiece data_;
@@ -267,9 +267,11 @@ private:
     mutable std::vector<std::pair<int64_t, uint8_t>> blockOffsets_;
     mutable std::vector<int64_t> offsets_;
 
-private:
+protected:
     static int32_t getSchemaVer(folly::StringPiece row);
 
+    RowReader() = default;
+
     RowReader(folly::StringPiece row,
               std::shared_ptr<const meta::SchemaProviderIf> schema);
 
@@ -277,6 +279,8 @@ private:
     // Returns false when the row data is invalid
     bool processHeader(folly::StringPiece row);
 
+private:
+
     // Process the block offsets (each block contains certain number of fields)
     // Returns false when the row data is invalid
     bool processBlockOffsets(folly::StringPiece row, int32_t verBytes);
@@ -324,6 +328,46 @@ private:
         const noexcept;
 };
 
+
+/**
+ * A RowReader bound to one tag or edge of a space, which is re-pointed at
+ * each row instead of being allocated for it. The offsets buffers are reused
+ * among the rows, and the schemas are cached by version, so the schema manager
+ * is asked once per version rather than once per row.
+ *
+ * It is not thread-safe, and the row must outlive the reads.
+ * */
+class BoundRowReader final : public RowReader {
+public:
+    static std::unique_ptr<BoundRowReader> bindTag(meta::SchemaManager* schemaMan,
+                                                   GraphSpaceID space,
+                                                   TagID tag);
+
+    static std::unique_ptr<BoundRowReader> bindEdge(meta::SchemaManager* schemaMan,
+                                                    GraphSpaceID space,
+                                                    EdgeType edge);
+
+    // Point the reader at the row, returns false when the row is invalid
+    // or the schema of its version is not found
+    bool reset(folly::StringPiece row);
+
+    // The newest schema of the tag or edge, on which the ttl is defined
+    const meta::SchemaProviderIf* latestSchema();
+
+private:
+    BoundRowReader(meta::SchemaManager* schemaMan, GraphSpaceID space, int32_t id, bool isEdge)
+        : schemaMan_(schemaMan), space_(space), id_(id), isEdge_(isEdge) {}
+
+private:
+    meta::SchemaManager* schemaMan_;
+    GraphSpaceID space_;
+    // The tag id or the edge type
+    int32_t id_;
+    bool isEdge_;
+    std::unordered_map<SchemaVer, std::shared_ptr<const meta::SchemaProviderIf>> schemas_;
+    std::shared_ptr<const meta::SchemaProviderIf> latest_;
+};
+
 }  // namespace nebula
 
 
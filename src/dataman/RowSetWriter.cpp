@@ -33,9 +33,9 @@ void RowSetWriter::addRow(RowWriter& writer) {
 }
 
 
-void RowSetWriter::addRow(const std::string& data) {
+void RowSetWriter::addRow(folly::StringPiece data) {
     writeRowLength(data.size());
-    data_.append(data);
+    data_.append(data.data(), data.size());
 }
 
 }  // namespace nebula
@@ -40,7 +40,7 @@ public:
     // Both schemas have to be same
     void addRow(RowWriter& writer);
     // Append the encoded row data
-    void addRow(const std::string& data);
+    void addRow(folly::StringPiece data);
 
 private:
     std::shared_ptr<const meta::SchemaProviderIf> schema_;
@@ -13,8 +13,9 @@ using cpp2::Schema;
 using cpp2::SupportedType;
 using meta::SchemaProviderIf;
 
-RowWriter::RowWriter(std::shared_ptr<const SchemaProviderIf> schema)
-        : schema_(std::move(schema)) {
+RowWriter::RowWriter(std::shared_ptr<const SchemaProviderIf> schema, Arena* arena)
+        : schema_(std::move(schema))
+        , cord_(arena) {
     if (!schema_) {
         // Need to create a new schema
         schemaWriter_.reset(new SchemaWriter());
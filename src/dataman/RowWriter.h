@@ -64,9 +64,11 @@ public:
     };
 
 public:
+    // The encoding buffer is taken from the arena when it is given
     explicit RowWriter(
         std::shared_ptr<const meta::SchemaProviderIf> schema
-            = std::shared_ptr<const meta::SchemaProviderIf>());
+            = std::shared_ptr<const meta::SchemaProviderIf>(),
+        Arena* arena = nullptr);
 
     // Encode into a binary array
     std::string encode() noexcept;
@@ -33,11 +33,16 @@ Status AssignmentExecutor::prepare() {
         onError_(std::move(s));
     };
     auto onFinish = [this] () {
+        ectx()->variableHolder()->add(*var_, std::move(result_));
         DCHECK(onFinish_);
         onFinish_();
     };
     auto onResult = [this] (std::unique_ptr<InterimResult> result) {
-        ectx()->variableHolder()->add(*var_, std::move(result));
+        if (result_ == nullptr) {
+            result_ = std::move(result);
+        } else {
+            result_->append(std::move(result));
+        }
     };
     executor_->setOnError(onError);
     executor_->setOnFinish(onFinish);
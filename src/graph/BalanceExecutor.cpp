@@ -0,0 +1,180 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "graph/BalanceExecutor.h"
+#include "network/NetworkUtils.h"
+
+namespace nebula {
+namespace graph {
+
+BalanceExecutor::BalanceExecutor(Sentence *sentence,
+                                 ExecutionContext *ectx) : Executor(ectx) {
+    sentence_ = static_cast<BalanceSentence*>(sentence);
+}
+
+Status BalanceExecutor::prepare() {
+    return Status::OK();
+}
+
+void BalanceExecutor::execute() {
+    auto subType = sentence_->subType();
+    switch (subType) {
+        case BalanceSentence::SubType::kLeader:
+            balanceLeader();
+            break;
+        case BalanceSentence::SubType::kData:
+            balanceData();
+            break;
+        case BalanceSentence::SubType::kShowBalancePlan:
+            showBalancePlan();
+            break;
+        case BalanceSentence::SubType::kUnknown:
+            onError_(Status::Error("Type unknown"));
+            break;
+    }
+}
+
+void BalanceExecutor::balanceLeader() {
+    auto future = ectx()->getMetaClient()->balanceLeader();
+    auto *runner = ectx()->rctx()->runner();
+
+    auto cb = [this] (auto &&resp) {
+        if (!resp.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(resp).status());
+            return;
+        }
+        auto ret = std::move(resp).value();
+        if (!ret) {
+            DCHECK(onError_);
+            onError_(Status::Error("Balance leaders failed"));
+            return;
+        }
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onError_);
+        onError_(Status::Error("Internal error"));
+        return;
+    };
+
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+void BalanceExecutor::balanceData() {
+    auto future = ectx()->getMetaClient()->balance();
+    auto *runner = ectx()->rctx()->runner();
+
+    auto cb = [this] (auto &&resp) {
+        if (!resp.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(resp).status());
+            return;
+        }
+
+        std::vector<std::string> header{"ID"};
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        resp_->set_column_names(std::move(header));
+
+        std::vector<cpp2::ColumnValue> row(1);
+        row[0].set_integer(std::move(resp).value());
+        std::vector<cpp2::RowValue> rows(1);
+        rows.back().set_columns(std::move(row));
+        resp_->set_rows(std::move(rows));
+
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onError_);
+        onError_(Status::Error("Internal error"));
+        return;
+    };
+
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+void BalanceExecutor::showBalancePlan() {
+    auto id = sentence_->balanceId();
+    auto future = ectx()->getMetaClient()->showBalance(id);
+    auto *runner = ectx()->rctx()->runner();
+
+    auto cb = [this, id] (auto &&resp) {
+        if (!resp.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(resp).status());
+            return;
+        }
+        auto plan = std::move(resp).value();
+
+        std::vector<std::string> header{"balanceId, spaceId:partId, src->dst",
+                                        "status", "bytes copied", "total bytes", "eta(s)"};
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        resp_->set_column_names(std::move(header));
+
+        auto hostStr = [] (const auto& host) {
+            return folly::stringPrintf("%s:%d",
+                                       network::NetworkUtils::intToIPv4(host.get_ip()).c_str(),
+                                       host.get_port());
+        };
+        std::vector<cpp2::RowValue> rows;
+        for (auto& task : plan.get_tasks()) {
+            std::vector<cpp2::ColumnValue> row(5);
+            row[0].set_str(folly::stringPrintf("[%ld, %d:%d, %s->%s]",
+                                               id,
+                                               task.get_space_id(),
+                                               task.get_part_id(),
+                                               hostStr(task.get_src()).c_str(),
+                                               hostStr(task.get_dst()).c_str()));
+            row[1].set_str(folly::stringPrintf("%s:%s",
+                                               task.get_status().c_str(),
+                                               task.get_result().c_str()));
+            row[2].set_integer(task.get_bytes_copied());
+            row[3].set_integer(task.get_total_bytes());
+            row[4].set_integer(task.get_eta_secs());
+            rows.emplace_back();
+            rows.back().set_columns(std::move(row));
+        }
+        // The summary of the whole plan
+        std::vector<cpp2::ColumnValue> row(5);
+        row[0].set_str(folly::stringPrintf("Total: %zu", plan.get_tasks().size()));
+        row[1].set_str(plan.get_status());
+        row[2].set_integer(plan.get_bytes_copied());
+        row[3].set_integer(plan.get_total_bytes());
+        row[4].set_integer(plan.get_eta_secs());
+        rows.emplace_back();
+        rows.back().set_columns(std::move(row));
+        resp_->set_rows(std::move(rows));
+
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onError_);
+        onError_(Status::Error("Internal error"));
+        return;
+    };
+
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+void BalanceExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (resp_ != nullptr) {
+        resp = std::move(*resp_);
+    } else {
+        Executor::setupResponse(resp);
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
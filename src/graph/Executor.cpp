@@ -11,6 +11,7 @@
 #include "parser/MaintainSentences.h"
 #include "parser/AdminSentences.h"
 #include "graph/GoExecutor.h"
+#include "graph/FindExecutor.h"
 #include "graph/UseExecutor.h"
 #include "graph/PipeExecutor.h"
 #include "graph/CreateTagExecutor.h"
@@ -34,6 +35,8 @@
 #include "graph/DownloadExecutor.h"
 #include "graph/OrderByExecutor.h"
 #include "graph/ConfigExecutor.h"
+#include "graph/BalanceExecutor.h"
+#include "graph/SetExecutor.h"
 
 namespace nebula {
 namespace graph {
@@ -45,6 +48,9 @@ std::unique_ptr<Executor> Executor::makeExecutor(Sentence *sentence) {
         case Sentence::Kind::kGo:
             executor = std::make_unique<GoExecutor>(sentence, ectx());
             break;
+        case Sentence::Kind::kFind:
+            executor = std::make_unique<FindExecutor>(sentence, ectx());
+            break;
         case Sentence::Kind::kUse:
             executor = std::make_unique<UseExecutor>(sentence, ectx());
             break;
@@ -114,6 +120,12 @@ std::unique_ptr<Executor> Executor::makeExecutor(Sentence *sentence) {
         case Sentence::Kind::kConfig:
             executor = std::make_unique<ConfigExecutor>(sentence, ectx());
             break;
+        case Sentence::Kind::kSet:
+            executor = std::make_unique<SetExecutor>(sentence, ectx());
+            break;
+        case Sentence::Kind::kBalance:
+            executor = std::make_unique<BalanceExecutor>(sentence, ectx());
+            break;
         case Sentence::Kind::kUnknown:
             LOG(FATAL) << "Sentence kind unknown";
             break;
@@ -0,0 +1,563 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/FindExecutor.h"
+#include "base/NebulaKeyUtils.h"
+#include "dataman/RowSetReader.h"
+#include "dataman/ResultSchemaProvider.h"
+
+DECLARE_int32(traverse_batch_rows);
+
+namespace nebula {
+namespace graph {
+
+using nebula::cpp2::SupportedType;
+
+namespace {
+
+VariantType readProp(const RowReader *reader, const std::string &prop) {
+    // getPropByName knows no TIMESTAMP, which is stored as an int
+    if (reader->getSchema()->getFieldType(prop).type == SupportedType::TIMESTAMP) {
+        int64_t v = 0;
+        CHECK(reader->getInt(prop, v) == ResultType::SUCCEEDED);
+        return v;
+    }
+    auto res = RowReader::getPropByName(reader, prop);
+    CHECK(ok(res));
+    return value(std::move(res));
+}
+
+}   // namespace
+
+
+FindExecutor::FindExecutor(Sentence *sentence, ExecutionContext *ectx)
+    : TraverseExecutor(ectx) {
+    sentence_ = static_cast<FindSentence*>(sentence);
+}
+
+
+Status FindExecutor::prepare() {
+    DCHECK(sentence_ != nullptr);
+    Status status;
+    expCtx_ = std::make_unique<ExpressionContext>();
+    do {
+        status = checkIfGraphSpaceChosen();
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareFrom();
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareWhere();
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareIndex();
+        if (!status.ok()) {
+            break;
+        }
+    } while (false);
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Preparing failed: " << status;
+        return status;
+    }
+
+    return status;
+}
+
+
+Status FindExecutor::prepareFrom() {
+    spaceId_ = ectx()->rctx()->session()->space();
+    auto *name = sentence_->type();
+    auto tagStatus = ectx()->schemaManager()->toTagID(spaceId_, *name);
+    if (tagStatus.ok()) {
+        schemaId_ = tagStatus.value();
+        schema_ = ectx()->schemaManager()->getTagSchema(spaceId_, schemaId_);
+    } else {
+        auto edgeStatus = ectx()->schemaManager()->toEdgeType(spaceId_, *name);
+        if (!edgeStatus.ok()) {
+            return Status::Error("Tag or edge `%s' not found", name->c_str());
+        }
+        isEdge_ = true;
+        schemaId_ = edgeStatus.value();
+        schema_ = ectx()->schemaManager()->getEdgeSchema(spaceId_, schemaId_);
+    }
+    if (schema_ == nullptr) {
+        return Status::Error("No schema found for `%s'", name->c_str());
+    }
+
+    for (auto *prop : sentence_->properties()) {
+        if (schema_->getFieldIndex(*prop) < 0) {
+            return Status::Error("Prop `%s' not found in `%s'", prop->c_str(), name->c_str());
+        }
+        props_.emplace_back(*prop);
+    }
+    returnProps_ = props_;
+    // The props are referred to as `name.prop' in the WHERE clause
+    expCtx_->addAlias(*name, AliasKind::Edge, *name);
+    return Status::OK();
+}
+
+
+Status FindExecutor::prepareWhere() {
+    auto *clause = sentence_->whereClause();
+    if (clause == nullptr) {
+        return Status::Error("FIND needs a WHERE clause on the indexed props");
+    }
+    filter_ = clause->filter();
+    filter_->setContext(expCtx_.get());
+    auto status = filter_->prepare();
+    if (!status.ok()) {
+        return status;
+    }
+    if (expCtx_->hasSrcTagProp() || expCtx_->hasDstTagProp()) {
+        return Status::Error("Only the props of `%s' could be referred to",
+                             sentence_->type()->c_str());
+    }
+    for (auto &prop : expCtx_->edgeProps()) {
+        if (schema_->getFieldIndex(prop) < 0) {
+            return Status::Error("Prop `%s' not found in `%s'",
+                                 prop.c_str(), sentence_->type()->c_str());
+        }
+        if (std::find(returnProps_.begin(), returnProps_.end(), prop) == returnProps_.end()) {
+            returnProps_.emplace_back(prop);
+        }
+    }
+    return Status::OK();
+}
+
+
+Status FindExecutor::prepareIndex() {
+    std::unordered_map<std::string, Range> ranges;
+    collectRanges(filter_, ranges);
+    auto schemaProp = schema_->getProp();
+    if (schemaProp.get_indexes() != nullptr) {
+        // The first index in the order defined, which has a range
+        for (auto &prop : *schemaProp.get_indexes()) {
+            auto it = ranges.find(prop);
+            if (it != ranges.end()) {
+                indexProp_ = prop;
+                range_ = std::move(it->second);
+                return Status::OK();
+            }
+        }
+    }
+    return Status::Error("No indexed prop of `%s' is compared with constants in the WHERE clause",
+                         sentence_->type()->c_str());
+}
+
+
+void FindExecutor::collectRanges(const Expression *expr,
+                                 std::unordered_map<std::string, Range> &ranges) const {
+    if (expr->kind() == Expression::kLogical) {
+        auto *logical = static_cast<const LogicalExpression*>(expr);
+        if (logical->op() == LogicalExpression::AND) {
+            collectRanges(logical->left(), ranges);
+            collectRanges(logical->right(), ranges);
+        }
+        return;
+    }
+    if (expr->kind() != Expression::kRelational) {
+        return;
+    }
+    auto *relational = static_cast<const RelationalExpression*>(expr);
+    auto op = relational->op();
+    const Expression *propExpr = relational->left();
+    const Expression *constExpr = relational->right();
+    if (propExpr->kind() != Expression::kEdgeProp) {
+        // `constant op prop', the same as `prop op' constant' with op flipped
+        std::swap(propExpr, constExpr);
+        switch (op) {
+            case RelationalExpression::LT:
+                op = RelationalExpression::GT;
+                break;
+            case RelationalExpression::LE:
+                op = RelationalExpression::GE;
+                break;
+            case RelationalExpression::GT:
+                op = RelationalExpression::LT;
+                break;
+            case RelationalExpression::GE:
+                op = RelationalExpression::LE;
+                break;
+            default:
+                break;
+        }
+    }
+    if (propExpr->kind() != Expression::kEdgeProp || !isConstant(constExpr)) {
+        return;
+    }
+    auto &prop = static_cast<const EdgePropertyExpression*>(propExpr)->prop();
+    // The values not of the same type as the prop are left to the filter
+    auto encoded = encodeBound(prop, constExpr->eval());
+    if (!encoded.ok()) {
+        VLOG(1) << "Not looked up by `" << expr->toString() << "': " << encoded.status();
+        return;
+    }
+    auto value = std::move(encoded).value();
+    auto tightenLower = [] (Range &range, const std::string &v, bool inclusive) {
+        if (!range.lower.hasValue() || v > range.lower->value
+                || (v == range.lower->value && !inclusive)) {
+            range.lower = Bound{v, inclusive};
+        }
+    };
+    auto tightenUpper = [] (Range &range, const std::string &v, bool inclusive) {
+        if (!range.upper.hasValue() || v < range.upper->value
+                || (v == range.upper->value && !inclusive)) {
+            range.upper = Bound{v, inclusive};
+        }
+    };
+    switch (op) {
+        case RelationalExpression::EQ:
+            tightenLower(ranges[prop], value, true);
+            tightenUpper(ranges[prop], value, true);
+            break;
+        case RelationalExpression::GT:
+            tightenLower(ranges[prop], value, false);
+            break;
+        case RelationalExpression::GE:
+            tightenLower(ranges[prop], value, true);
+            break;
+        case RelationalExpression::LT:
+            tightenUpper(ranges[prop], value, false);
+            break;
+        case RelationalExpression::LE:
+            tightenUpper(ranges[prop], value, true);
+            break;
+        case RelationalExpression::NE:
+            break;
+    }
+}
+
+
+StatusOr<std::string> FindExecutor::encodeBound(const std::string &prop,
+                                                const VariantType &value) const {
+    auto type = schema_->getFieldType(prop).type;
+    switch (type) {
+        case SupportedType::BOOL:
+            if (value.which() == VAR_BOOL) {
+                return NebulaKeyUtils::encodeIndexValue(value);
+            }
+            break;
+        case SupportedType::INT:
+        case SupportedType::VID:
+        case SupportedType::TIMESTAMP:
+            if (value.which() == VAR_INT64) {
+                return NebulaKeyUtils::encodeIndexValue(value);
+            }
+            break;
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            if (value.which() == VAR_INT64) {
+                return NebulaKeyUtils::encodeIndexValue(
+                    static_cast<double>(boost::get<int64_t>(value)));
+            }
+            if (value.which() == VAR_DOUBLE) {
+                return NebulaKeyUtils::encodeIndexValue(value);
+            }
+            break;
+        case SupportedType::STRING:
+            if (value.which() == VAR_STR) {
+                return NebulaKeyUtils::encodeIndexValue(value);
+            }
+            break;
+        default:
+            break;
+    }
+    return Status::Error("Type mismatched with the prop `%s'", prop.c_str());
+}
+
+
+// static
+bool FindExecutor::isConstant(const Expression *expr) {
+    switch (expr->kind()) {
+        case Expression::kPrimary:
+            return true;
+        case Expression::kUnary:
+            return isConstant(static_cast<const UnaryExpression*>(expr)->operand());
+        case Expression::kArithmetic: {
+            auto *arithmetic = static_cast<const ArithmeticExpression*>(expr);
+            return isConstant(arithmetic->left()) && isConstant(arithmetic->right());
+        }
+        default:
+            return false;
+    }
+}
+
+
+void FindExecutor::execute() {
+    FLOG_INFO("Executing Find: %s", sentence_->toString().c_str());
+    if (isEdge_) {
+        lookUpEdges();
+    } else {
+        lookUpVertices();
+    }
+}
+
+
+std::vector<storage::cpp2::PropDef> FindExecutor::getReturnProps() const {
+    std::vector<storage::cpp2::PropDef> props;
+    props.reserve(returnProps_.size());
+    for (auto &prop : returnProps_) {
+        storage::cpp2::PropDef pd;
+        if (isEdge_) {
+            pd.owner = storage::cpp2::PropOwner::EDGE;
+        } else {
+            pd.owner = storage::cpp2::PropOwner::SOURCE;
+            pd.tag_id = schemaId_;
+        }
+        pd.name = prop;
+        props.emplace_back(std::move(pd));
+    }
+    return props;
+}
+
+
+void FindExecutor::lookUpVertices() {
+    storage::cpp2::LookUpIndexRequest req;
+    req.set_schema_id(schemaId_);
+    req.set_prop(indexProp_);
+    if (range_.lower.hasValue()) {
+        req.set_lower(range_.lower->value);
+        req.set_include_lower(range_.lower->inclusive);
+    }
+    if (range_.upper.hasValue()) {
+        req.set_upper(range_.upper->value);
+        req.set_include_upper(range_.upper->inclusive);
+    }
+    req.set_return_columns(getReturnProps());
+    auto future = ectx()->storage()->lookUpVertexIndex(spaceId_, std::move(req));
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this] (auto &&result) {
+        auto completeness = result.completeness();
+        if (completeness == 0) {
+            DCHECK(onError_);
+            onError_(Status::Error("Look up the index failed"));
+            return;
+        } else if (completeness != 100) {
+            LOG(INFO) << "Look up the index partially failed: "  << completeness << "%";
+            for (auto &error : result.failedParts()) {
+                LOG(ERROR) << "part: " << error.first
+                           << "error code: " << static_cast<int>(error.second);
+            }
+        }
+        finishExecution([this, &result] (Callback &rowCb) {
+            for (auto &resp : result.responses()) {
+                if (resp.get_vertices() == nullptr || resp.get_vertex_schema() == nullptr) {
+                    continue;
+                }
+                auto schema = std::make_shared<ResultSchemaProvider>(resp.vertex_schema);
+                for (auto &vdata : resp.vertices) {
+                    DCHECK(vdata.__isset.vertex_data);
+                    auto reader = RowReader::getRowReader(vdata.vertex_data, schema);
+                    std::vector<VariantType> record;
+                    record.reserve(props_.size() + 1);
+                    record.emplace_back(vdata.vertex_id);
+                    processRow(reader.get(), std::move(record), rowCb);
+                }
+            }
+        });
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onError_(Status::Error("Internal error"));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+void FindExecutor::lookUpEdges() {
+    storage::cpp2::LookUpIndexRequest req;
+    req.set_schema_id(schemaId_);
+    req.set_prop(indexProp_);
+    if (range_.lower.hasValue()) {
+        req.set_lower(range_.lower->value);
+        req.set_include_lower(range_.lower->inclusive);
+    }
+    if (range_.upper.hasValue()) {
+        req.set_upper(range_.upper->value);
+        req.set_include_upper(range_.upper->inclusive);
+    }
+    req.set_return_columns(getReturnProps());
+    auto future = ectx()->storage()->lookUpEdgeIndex(spaceId_, std::move(req));
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this] (auto &&result) {
+        auto completeness = result.completeness();
+        if (completeness == 0) {
+            DCHECK(onError_);
+            onError_(Status::Error("Look up the index failed"));
+            return;
+        } else if (completeness != 100) {
+            LOG(INFO) << "Look up the index partially failed: "  << completeness << "%";
+            for (auto &error : result.failedParts()) {
+                LOG(ERROR) << "part: " << error.first
+                           << "error code: " << static_cast<int>(error.second);
+            }
+        }
+        finishExecution([this, &result] (Callback &rowCb) {
+            for (auto &resp : result.responses()) {
+                if (resp.get_schema() == nullptr || resp.get_data() == nullptr) {
+                    continue;
+                }
+                auto schema = std::make_shared<ResultSchemaProvider>(resp.schema);
+                auto srcIndex = schema->getFieldIndex("_src");
+                auto dstIndex = schema->getFieldIndex("_dst");
+                auto rankIndex = schema->getFieldIndex("_rank");
+                CHECK(srcIndex >= 0 && dstIndex >= 0 && rankIndex >= 0);
+                RowSetReader rsReader(schema, resp.data);
+                auto iter = rsReader.begin();
+                while (iter) {
+                    VertexID src;
+                    VertexID dst;
+                    EdgeRanking rank;
+                    CHECK(iter->getInt(srcIndex, src) == ResultType::SUCCEEDED);
+                    CHECK(iter->getInt(dstIndex, dst) == ResultType::SUCCEEDED);
+                    CHECK(iter->getInt(rankIndex, rank) == ResultType::SUCCEEDED);
+                    std::vector<VariantType> record;
+                    record.reserve(props_.size() + 3);
+                    record.emplace_back(src);
+                    record.emplace_back(dst);
+                    record.emplace_back(rank);
+                    processRow(&*iter, std::move(record), rowCb);
+                    ++iter;
+                }
+            }
+        });
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onError_(Status::Error("Internal error"));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+void FindExecutor::processRow(const RowReader *reader,
+                              std::vector<VariantType> record,
+                              Callback &cb) {
+    auto &getters = expCtx_->getters();
+    getters.getEdgeProp = [reader] (const std::string &prop) -> VariantType {
+        return readProp(reader, prop);
+    };
+    // The index only narrows the rows down, the rest conditions are checked here
+    if (!Expression::asBool(filter_->eval())) {
+        return;
+    }
+    for (auto &prop : props_) {
+        record.emplace_back(readProp(reader, prop));
+    }
+    cb(std::move(record));
+}
+
+
+void FindExecutor::finishExecution(std::function<void(Callback&)> process) {
+    std::shared_ptr<SchemaWriter> schema;
+    std::unique_ptr<RowSetWriter> rsWriter;
+    size_t numRows = 0;
+    size_t numBatches = 0;
+    auto batchRows = onResult_ ? FLAGS_traverse_batch_rows : 0;
+    Callback cb = [&] (std::vector<VariantType> record) {
+        if (schema == nullptr) {
+            schema = std::make_shared<SchemaWriter>();
+            auto colnames = getResultColumnNames();
+            for (auto i = 0u; i < record.size(); i++) {
+                SupportedType type;
+                switch (record[i].which()) {
+                    case VAR_INT64:
+                        // all integers in InterimResult are regarded as type of VID
+                        type = SupportedType::VID;
+                        break;
+                    case VAR_DOUBLE:
+                        type = SupportedType::DOUBLE;
+                        break;
+                    case VAR_BOOL:
+                        type = SupportedType::BOOL;
+                        break;
+                    case VAR_STR:
+                        type = SupportedType::STRING;
+                        break;
+                    default:
+                        LOG(FATAL) << "Unknown VariantType: " << record[i].which();
+                }
+                schema->appendCol(colnames[i], type);
+            }
+            rsWriter = std::make_unique<RowSetWriter>(schema);
+        }
+        RowWriter writer(schema);
+        for (auto &column : record) {
+            switch (column.which()) {
+                case VAR_INT64:
+                    writer << boost::get<int64_t>(column);
+                    break;
+                case VAR_DOUBLE:
+                    writer << boost::get<double>(column);
+                    break;
+                case VAR_BOOL:
+                    writer << boost::get<bool>(column);
+                    break;
+                case VAR_STR:
+                    writer << boost::get<std::string>(column);
+                    break;
+                default:
+                    LOG(FATAL) << "Unknown VariantType: " << column.which();
+            }
+        }
+        rsWriter->addRow(writer);
+        if (batchRows > 0 && ++numRows >= static_cast<size_t>(batchRows)) {
+            onResult_(std::make_unique<InterimResult>(std::move(rsWriter)));
+            rsWriter = std::make_unique<RowSetWriter>(schema);
+            numRows = 0;
+            numBatches++;
+        }
+    };
+    process(cb);
+
+    std::unique_ptr<InterimResult> outputs;
+    if (rsWriter != nullptr && (numBatches == 0 || numRows > 0)) {
+        outputs = std::make_unique<InterimResult>(std::move(rsWriter));
+    }
+    if (onResult_) {
+        if (outputs != nullptr || numBatches == 0) {
+            onResult_(std::move(outputs));
+        }
+    } else {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        resp_->set_column_names(getResultColumnNames());
+        if (outputs != nullptr) {
+            resp_->set_rows(outputs->getRows());
+        }
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
+void FindExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (resp_ == nullptr) {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+    }
+    resp = std::move(*resp_);
+}
+
+
+std::vector<std::string> FindExecutor::getResultColumnNames() const {
+    std::vector<std::string> result;
+    if (isEdge_) {
+        result.emplace_back("_src");
+        result.emplace_back("_dst");
+        result.emplace_back("_rank");
+    } else {
+        result.emplace_back("VertexID");
+    }
+    result.insert(result.end(), props_.begin(), props_.end());
+    return result;
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,108 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_FINDEXECUTOR_H_
+#define GRAPH_FINDEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/TraverseExecutor.h"
+#include "dataman/RowReader.h"
+#include "storage/client/StorageClient.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * FIND prop_list FROM tag_or_edge WHERE ...
+ *
+ * The vertices of the tag, or the edges of the type, are looked up by the
+ * index on one of the props compared with constants in the WHERE clause,
+ * then the whole WHERE clause is evaluated on them here. The props are referred
+ * to as `name.prop' in the WHERE clause.
+ */
+class FindExecutor final : public TraverseExecutor {
+public:
+    FindExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "FindExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+    void feedResult(std::unique_ptr<InterimResult> result) override {
+        // FIND takes no inputs
+        UNUSED(result);
+    }
+
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+    std::vector<std::string> getResultColumnNames() const override;
+
+private:
+    // One end of the values range, encoded the same way as the index keys
+    struct Bound {
+        std::string                 value;
+        bool                        inclusive;
+    };
+
+    struct Range {
+        folly::Optional<Bound>      lower;
+        folly::Optional<Bound>      upper;
+    };
+
+    using Callback = std::function<void(std::vector<VariantType>)>;
+
+    Status prepareFrom();
+
+    Status prepareWhere();
+
+    Status prepareIndex();
+
+    /**
+     * Collect the ranges of the props compared with constants, among the
+     * conjunctions of the WHERE clause. The others are left to the filter.
+     */
+    void collectRanges(const Expression *expr,
+                       std::unordered_map<std::string, Range> &ranges) const;
+
+    StatusOr<std::string> encodeBound(const std::string &prop, const VariantType &value) const;
+
+    static bool isConstant(const Expression *expr);
+
+    void lookUpVertices();
+
+    void lookUpEdges();
+
+    // Evaluate the WHERE clause on the row, and the record to return if it passes
+    void processRow(const RowReader *reader, std::vector<VariantType> record, Callback &cb);
+
+    void finishExecution(std::function<void(Callback&)> process);
+
+    std::vector<storage::cpp2::PropDef> getReturnProps() const;
+
+private:
+    FindSentence                               *sentence_{nullptr};
+    GraphSpaceID                                spaceId_{-1};
+    bool                                        isEdge_{false};
+    int32_t                                     schemaId_{0};
+    std::shared_ptr<const meta::SchemaProviderIf> schema_;
+    std::vector<std::string>                    props_;
+    // props_ and the props referred to in the WHERE clause
+    std::vector<std::string>                    returnProps_;
+    Expression                                 *filter_{nullptr};
+    std::unique_ptr<ExpressionContext>          expCtx_;
+    std::string                                 indexProp_;
+    Range                                       range_;
+    std::unique_ptr<cpp2::ExecutionResponse>    resp_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_FINDEXECUTOR_H_
@@ -9,6 +9,9 @@
 #include "dataman/RowReader.h"
 #include "dataman/RowSetReader.h"
 #include "dataman/ResultSchemaProvider.h"
+#include <folly/lang/Bits.h>
+
+DECLARE_int32(traverse_batch_rows);
 
 namespace nebula {
 namespace graph {
@@ -16,6 +19,234 @@ namespace graph {
 using SchemaProps = std::unordered_map<std::string, std::vector<std::string>>;
 using nebula::cpp2::SupportedType;
 
+namespace {
+
+StatusOr<CompiledExpression::Type> toCompiledType(SupportedType type) {
+    switch (type) {
+        case SupportedType::BOOL:
+            return CompiledExpression::kBool;
+        case SupportedType::INT:
+        case SupportedType::VID:
+        case SupportedType::TIMESTAMP:
+            return CompiledExpression::kInt;
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            return CompiledExpression::kDouble;
+        case SupportedType::STRING:
+            return CompiledExpression::kString;
+        default:
+            return Status::Error("Unsupported type %d", static_cast<int32_t>(type));
+    }
+}
+
+}   // namespace
+
+
+class GoExecutor::RowAccessor final : public CompiledExpression::PropAccessor {
+public:
+    RowAccessor(const GoExecutor *executor,
+                const ResultSchemaProvider *eschema,
+                const ResultSchemaProvider *vschema)
+        : executor_(executor), eschema_(eschema), vschema_(vschema) {}
+
+    StatusOr<CompiledExpression::Prop> resolve(const Expression *expr) {
+        Slot slot;
+        const ResultSchemaProvider *schema = nullptr;
+        switch (expr->kind()) {
+            case Expression::kEdgeProp: {
+                auto *edgeExp = static_cast<const EdgePropertyExpression*>(expr);
+                slot.owner = kEdge;
+                slot.index = eschema_ == nullptr ? -1 : eschema_->getFieldIndex(edgeExp->prop());
+                schema = eschema_;
+                auto *holder = executor_->edgeHolder_.get();
+                if (slot.index < 0 && holder != nullptr && holder->schema() != nullptr) {
+                    // The in-edges keep no props, read the ones of their out-edges
+                    slot.owner = kOutEdge;
+                    slot.index = holder->schema()->getFieldIndex(edgeExp->prop());
+                    schema = holder->schema();
+                    dstIndex_ = eschema_->getFieldIndex("_dst");
+                    rankIndex_ = eschema_->getFieldIndex("_rank");
+                    if (dstIndex_ < 0 || rankIndex_ < 0) {
+                        return Status::Error("No `_dst' or `_rank' in the edge schema");
+                    }
+                }
+                break;
+            }
+            case Expression::kEdgeSrcId:
+            case Expression::kEdgeDstId:
+            case Expression::kEdgeRank: {
+                auto *name = expr->kind() == Expression::kEdgeSrcId ? "_src"
+                           : expr->kind() == Expression::kEdgeDstId ? "_dst" : "_rank";
+                slot.owner = kEdge;
+                slot.index = eschema_ == nullptr ? -1 : eschema_->getFieldIndex(name);
+                schema = eschema_;
+                break;
+            }
+            case Expression::kSourceProp: {
+                auto *sourceExp = static_cast<const SourcePropertyExpression*>(expr);
+                auto &props = executor_->srcTagProps_;
+                auto it = props.find(std::make_pair(sourceExp->tag(), sourceExp->prop()));
+                slot.owner = kSrc;
+                slot.index = it == props.end() ? -1 : it->second;
+                schema = vschema_;
+                break;
+            }
+            case Expression::kDestProp: {
+                auto *destExp = static_cast<const DestPropertyExpression*>(expr);
+                auto &props = executor_->dstTagProps_;
+                auto it = props.find(std::make_pair(destExp->tag(), destExp->prop()));
+                slot.owner = kDst;
+                slot.index = it == props.end() ? -1 : it->second;
+                if (executor_->vertexHolder_ != nullptr) {
+                    schema = executor_->vertexHolder_->schema();
+                }
+                if (eschema_ != nullptr) {
+                    dstIndex_ = eschema_->getFieldIndex("_dst");
+                }
+                if (dstIndex_ < 0) {
+                    return Status::Error("No `_dst' in the edge schema");
+                }
+                break;
+            }
+            default:
+                return Status::Error("Unsupported expression kind %d",
+                                     static_cast<int32_t>(expr->kind()));
+        }
+        if (schema == nullptr || slot.index < 0) {
+            return Status::Error("Prop not found in the result schema");
+        }
+        slot.type = schema->getFieldType(slot.index).get_type();
+        auto type = toCompiledType(slot.type);
+        if (!type.ok()) {
+            return type.status();
+        }
+        slots_.emplace_back(slot);
+        strings_.emplace_back();
+        return CompiledExpression::Prop{static_cast<int32_t>(slots_.size() - 1), type.value()};
+    }
+
+    // `vid' is the vertex stepped out from
+    void reset(const RowReader *edge, const RowReader *vertex, VertexID vid) {
+        edge_ = edge;
+        vertex_ = vertex;
+        vid_ = vid;
+    }
+
+    int64_t getInt(int32_t slot) const override {
+        auto &s = slots_[slot];
+        if (s.owner == kDst) {
+            return boost::get<int64_t>(dstProp(s));
+        }
+        if (s.owner == kOutEdge) {
+            return boost::get<int64_t>(outEdgeProp(s));
+        }
+        return readInt(reader(s), s.index, s.type);
+    }
+
+    double getDouble(int32_t slot) const override {
+        auto &s = slots_[slot];
+        if (s.owner == kDst) {
+            return boost::get<double>(dstProp(s));
+        }
+        if (s.owner == kOutEdge) {
+            return boost::get<double>(outEdgeProp(s));
+        }
+        double v = 0.0;
+        auto ret = reader(s)->getDouble(s.index, v);
+        CHECK(ret == ResultType::SUCCEEDED);
+        return v;
+    }
+
+    bool getBool(int32_t slot) const override {
+        auto &s = slots_[slot];
+        if (s.owner == kDst) {
+            return boost::get<bool>(dstProp(s));
+        }
+        if (s.owner == kOutEdge) {
+            return boost::get<bool>(outEdgeProp(s));
+        }
+        bool v = false;
+        auto ret = reader(s)->getBool(s.index, v);
+        CHECK(ret == ResultType::SUCCEEDED);
+        return v;
+    }
+
+    folly::StringPiece getString(int32_t slot) const override {
+        auto &s = slots_[slot];
+        if (s.owner == kDst || s.owner == kOutEdge) {
+            // Held until the slot is read again
+            strings_[slot] = boost::get<std::string>(s.owner == kDst ? dstProp(s)
+                                                                     : outEdgeProp(s));
+            return strings_[slot];
+        }
+        folly::StringPiece v;
+        auto ret = reader(s)->getString(s.index, v);
+        CHECK(ret == ResultType::SUCCEEDED);
+        return v;
+    }
+
+private:
+    enum Owner : uint8_t {
+        kEdge,
+        kSrc,
+        kDst,
+        // The out-edge of the in-edge stepped out over
+        kOutEdge,
+    };
+
+    struct Slot {
+        Owner           owner{kEdge};
+        int64_t         index{-1};
+        SupportedType   type{SupportedType::UNKNOWN};
+    };
+
+    static int64_t readInt(const RowReader *reader, int64_t index, SupportedType type) {
+        int64_t v = 0;
+        ResultType ret;
+        switch (type) {
+            case SupportedType::VID:
+                ret = reader->getVid(index, v);
+                break;
+            case SupportedType::TIMESTAMP:
+                ret = reader->getTimestamp(index, v);
+                break;
+            default:
+                ret = reader->getInt(index, v);
+                break;
+        }
+        CHECK(ret == ResultType::SUCCEEDED);
+        return v;
+    }
+
+    const RowReader* reader(const Slot &slot) const {
+        return slot.owner == kEdge ? edge_ : vertex_;
+    }
+
+    VariantType dstProp(const Slot &slot) const {
+        auto dst = readInt(edge_, dstIndex_, eschema_->getFieldType(dstIndex_).get_type());
+        return executor_->vertexHolder_->get(dst, slot.index);
+    }
+
+    VariantType outEdgeProp(const Slot &slot) const {
+        auto src = readInt(edge_, dstIndex_, eschema_->getFieldType(dstIndex_).get_type());
+        auto rank = readInt(edge_, rankIndex_, eschema_->getFieldType(rankIndex_).get_type());
+        return executor_->edgeHolder_->get(std::make_tuple(src, vid_, rank), slot.index);
+    }
+
+private:
+    const GoExecutor                   *executor_{nullptr};
+    const ResultSchemaProvider         *eschema_{nullptr};
+    const ResultSchemaProvider         *vschema_{nullptr};
+    const RowReader                    *edge_{nullptr};
+    const RowReader                    *vertex_{nullptr};
+    VertexID                            vid_{0};
+    int64_t                             dstIndex_{-1};
+    int64_t                             rankIndex_{-1};
+    std::vector<Slot>                   slots_;
+    mutable std::vector<std::string>    strings_;
+};
+
+
 GoExecutor::GoExecutor(Sentence *sentence, ExecutionContext *ectx) : TraverseExecutor(ectx) {
     // The RTTI is guaranteed by Sentence::Kind,
     // so we use `static_cast' instead of `dynamic_cast' for the sake of efficiency.
@@ -89,6 +320,9 @@ void GoExecutor::execute() {
         }
         starts_ = std::vector<VertexID>(uniqID.begin(), uniqID.end());
     }
+    if (isUpto()) {
+        visited_.insert(starts_.begin(), starts_.end());
+    }
     stepOut();
 }
 
@@ -98,6 +332,108 @@ void GoExecutor::feedResult(std::unique_ptr<InterimResult> result) {
 }
 
 
+void GoExecutor::feedBatch(std::unique_ptr<InterimResult> batch) {
+    if (!isStreaming()) {
+        TraverseExecutor::feedBatch(std::move(batch));
+        return;
+    }
+    if (batch == nullptr) {
+        return;
+    }
+    auto executor = std::make_unique<GoExecutor>(sentence_, ectx());
+    auto status = executor->prepare();
+    if (!status.ok()) {
+        std::lock_guard<std::mutex> g(streamLock_);
+        if (batchStatus_.ok()) {
+            batchStatus_ = std::move(status);
+        }
+        return;
+    }
+    auto onResult = [this] (std::unique_ptr<InterimResult> result) {
+        // The child executors run concurrently, hand their results on one by one
+        std::lock_guard<std::mutex> g(streamLock_);
+        if (onResult_) {
+            onResult_(std::move(result));
+        } else if (batchResults_ == nullptr) {
+            batchResults_ = std::move(result);
+        } else {
+            batchResults_->append(std::move(result));
+        }
+    };
+    executor->setOnResult(onResult);
+    executor->setOnFinish([this] () {
+        onBatchDone(Status::OK());
+    });
+    executor->setOnError([this] (Status s) {
+        onBatchDone(std::move(s));
+    });
+    executor->feedResult(std::move(batch));
+
+    auto *raw = executor.get();
+    {
+        std::lock_guard<std::mutex> g(streamLock_);
+        batchesOnFly_++;
+        batchExecutors_.emplace_back(std::move(executor));
+    }
+    raw->execute();
+}
+
+
+void GoExecutor::finishBatches() {
+    if (!isStreaming()) {
+        TraverseExecutor::finishBatches();
+        return;
+    }
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> g(streamLock_);
+        batchesFinished_ = true;
+        done = batchesOnFly_ == 0;
+    }
+    if (done) {
+        finishStreaming();
+    }
+}
+
+
+void GoExecutor::onBatchDone(Status status) {
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> g(streamLock_);
+        if (!status.ok() && batchStatus_.ok()) {
+            batchStatus_ = std::move(status);
+        }
+        DCHECK_GT(batchesOnFly_, 0U);
+        batchesOnFly_--;
+        done = batchesFinished_ && batchesOnFly_ == 0;
+    }
+    if (done) {
+        finishStreaming();
+    }
+}
+
+
+void GoExecutor::finishStreaming() {
+    // Report the failure only after all the child executors are done,
+    // since this executor could be destroyed then.
+    if (!batchStatus_.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(batchStatus_));
+        return;
+    }
+    if (!onResult_) {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        // Even if no batch came, as the non-streaming path does
+        resp_->set_column_names(getResultColumnNames());
+        if (batchResults_ != nullptr) {
+            resp_->set_rows(batchResults_->getRows());
+        }
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
 Status GoExecutor::prepareStep() {
     auto *clause = sentence_->stepClause();
     if (clause != nullptr) {
@@ -105,10 +441,6 @@ Status GoExecutor::prepareStep() {
         upto_ = clause->isUpto();
     }
 
-    if (isUpto()) {
-        return Status::Error("`UPTO' not supported yet");
-    }
-
     return Status::OK();
 }
 
@@ -171,7 +503,7 @@ Status GoExecutor::prepareOver() {
             break;
         }
         edgeType_ = edgeStatus.value();
-        reversely_ = clause->isReversely();
+        direction_ = clause->direction();
         if (clause->alias() != nullptr) {
             expCtx_->addAlias(*clause->alias(), AliasKind::Edge, *clause->edge());
         } else {
@@ -179,10 +511,6 @@ Status GoExecutor::prepareOver() {
         }
     } while (false);
 
-    if (isReversely()) {
-        return Status::Error("`REVERSELY' not supported yet");
-    }
-
     return status;
 }
 
@@ -230,6 +558,26 @@ Status GoExecutor::prepareNeededProps() {
         }
     } while (false);
 
+    if (!status.ok() || direction_ == OverClause::Direction::kOut) {
+        return status;
+    }
+    // The in-edges keep no props unless the edge type has `inbound_props' set,
+    // then the props are read from the out-edges.
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto schema = ectx()->schemaManager()->getEdgeSchema(spaceId, edgeType_);
+    if (schema == nullptr) {
+        return Status::Error("No schema found for edge `%s'",
+                             sentence_->overClause()->edge()->c_str());
+    }
+    auto schemaProp = schema->getProp();
+    if (schemaProp.get_inbound_props() && *schemaProp.get_inbound_props()) {
+        return status;
+    }
+    for (auto &prop : expCtx_->edgeProps()) {
+        if (prop != "_src" && prop != "_dst" && prop != "_rank" && prop != "_type") {
+            outEdgeProps_.emplace_back(prop);
+        }
+    }
     return status;
 }
 
@@ -270,6 +618,8 @@ Status GoExecutor::setupStarts() {
         return std::move(result).status();
     }
     starts_ = std::move(result).value();
+    // The rows are of no use once the starts are taken
+    inputs_.reset();
     return Status::OK();
 }
 
@@ -283,7 +633,6 @@ void GoExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
 
 
 void GoExecutor::stepOut() {
-    auto spaceId = ectx()->rctx()->session()->space();
     auto status = getStepOutProps();
     if (!status.ok()) {
         DCHECK(onError_);
@@ -291,13 +640,25 @@ void GoExecutor::stepOut() {
         return;
     }
     auto returns = status.value();
-    auto future = ectx()->storage()->getNeighbors(spaceId,
-                                                  starts_,
-                                                  edgeType_,
-                                                  !reversely_,
-                                                  "",
-                                                  std::move(returns));
     auto *runner = ectx()->rctx()->runner();
+    std::vector<folly::Future<RpcResponse>> futures;
+    // With `BIDIRECT', step out over the out-edges here, and the in-edges below
+    if (isBidirect()) {
+        futures.emplace_back(stepOutOneWay(true, frontier_, returns).via(runner));
+    }
+    futures.emplace_back(stepOutOneWay(direction_ == OverClause::Direction::kOut,
+                                       std::move(frontier_),
+                                       std::move(returns)).via(runner));
+    auto future = futures.size() == 1
+        ? std::move(futures.front())
+        : folly::collectAll(futures).via(runner).thenValue([] (auto &&tries) {
+            // With `BIDIRECT', the responses of both ways are taken as one
+            auto result = std::move(tries.front()).value();
+            for (auto i = 1u; i < tries.size(); i++) {
+                result.merge(std::move(tries[i]).value());
+            }
+            return result;
+        });
     auto cb = [this] (auto &&result) {
         auto completeness = result.completeness();
         if (completeness == 0) {
@@ -321,27 +682,48 @@ void GoExecutor::stepOut() {
         LOG(ERROR) << "Exception caught: " << e.what();
         onError_(Status::Error("Internal error"));
     };
-    std::move(future).via(runner).thenValue(cb).thenError(error);
+    std::move(future).thenValue(cb).thenError(error);
+}
+
+
+folly::SemiFuture<GoExecutor::RpcResponse> GoExecutor::stepOutOneWay(
+        bool isOutBound,
+        storage::StorageClient::PartIds frontier,
+        std::vector<storage::cpp2::PropDef> returns) {
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto *storage = ectx()->storage();
+    if (isResultStep()) {
+        return curStep_ == 1
+            ? storage->getNeighbors(spaceId, starts_, edgeType_, isOutBound,
+                                    "", std::move(returns))
+            : storage->getNeighbors(spaceId, std::move(frontier), edgeType_, isOutBound,
+                                    "", std::move(returns));
+    }
+    // Only the frontier is needed for the intermediate steps
+    return curStep_ == 1
+        ? storage->getDstIds(spaceId, starts_, edgeType_, isOutBound)
+        : storage->getDstIds(spaceId, std::move(frontier), edgeType_, isOutBound);
 }
 
 
 void GoExecutor::onStepOutResponse(RpcResponse &&rpcResp) {
-    if (isFinalStep()) {
-        if (expCtx_->hasDstTagProp()) {
-            auto dstids = getDstIdsFromResp(rpcResp);
-            if (dstids.empty()) {
-                onEmptyInputs();
-                return;
-            }
-            fetchVertexProps(std::move(dstids), std::move(rpcResp));
+    if (isResultStep()) {
+        if (isUpto() && !isFinalStep()) {
+            setupUptoFrontier(rpcResp);
+        }
+        if (needOutEdgeProps()) {
+            fetchOutEdgeProps(std::move(rpcResp));
             return;
         }
-        finishExecution(std::move(rpcResp));
+        onEdgesReady(std::move(rpcResp));
         return;
     } else {
         curStep_++;
-        starts_ = getDstIdsFromResp(rpcResp);
-        if (starts_.empty()) {
+        // Dedup while grouping by partition, the frontier goes to the storage as is
+        auto spaceId = ectx()->rctx()->session()->space();
+        frontier_ = ectx()->storage()->partitionIds(spaceId,
+                                                    getDstIdsFromResp(rpcResp, false));
+        if (frontier_.empty()) {
             onEmptyInputs();
             return;
         }
@@ -350,47 +732,114 @@ void GoExecutor::onStepOutResponse(RpcResponse &&rpcResp) {
 }
 
 
+void GoExecutor::onEdgesReady(RpcResponse &&rpcResp) {
+    if (expCtx_->hasDstTagProp()) {
+        auto dstids = getDstIdsFromResp(rpcResp);
+        if (dstids.empty()) {
+            if (isUpto()) {
+                // Keep the results of the steps done
+                finishExecution(std::move(rpcResp));
+            } else {
+                onEmptyInputs();
+            }
+            return;
+        }
+        fetchVertexProps(std::move(dstids), std::move(rpcResp));
+        return;
+    }
+    finishExecution(std::move(rpcResp));
+}
+
+
+void GoExecutor::setupUptoFrontier(RpcResponse &rpcResp) {
+    std::vector<VertexID> ids;
+    for (auto id : getDstIdsFromResp(rpcResp)) {
+        if (visited_.emplace(id).second) {
+            ids.emplace_back(id);
+        }
+    }
+    auto spaceId = ectx()->rctx()->session()->space();
+    frontier_ = ectx()->storage()->partitionIds(spaceId, std::move(ids));
+}
+
+
 void GoExecutor::onVertexProps(RpcResponse &&rpcResp) {
     UNUSED(rpcResp);
 }
 
 
-std::vector<VertexID> GoExecutor::getDstIdsFromResp(RpcResponse &rpcResp) const {
-    std::unordered_set<VertexID> set;
+std::vector<VertexID> GoExecutor::getDstIdsFromResp(RpcResponse &rpcResp, bool dedup) const {
+    std::vector<VertexID> ids;
     for (auto &resp : rpcResp.responses()) {
+        auto *packed = resp.get_dst_ids();
+        if (packed != nullptr) {
+            auto num = packed->size() / sizeof(VertexID);
+            auto offset = ids.size();
+            ids.resize(offset + num);
+            memcpy(&ids[offset], packed->data(), num * sizeof(VertexID));
+            for (auto i = offset; i < ids.size(); i++) {
+                ids[i] = folly::Endian::little(ids[i]);
+            }
+            continue;
+        }
         auto *vertices = resp.get_vertices();
         if (vertices == nullptr) {
             continue;
         }
         auto schema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+        auto dstIndex = schema->getFieldIndex("_dst");
+        CHECK_GE(dstIndex, 0);
         for (auto &vdata : *vertices) {
             RowSetReader rsReader(schema, vdata.edge_data);
             auto iter = rsReader.begin();
             while (iter) {
                 VertexID dst;
-                auto rc = iter->getVid("_dst", dst);
+                auto rc = iter->getVid(dstIndex, dst);
                 CHECK(rc == ResultType::SUCCEEDED);
-                set.emplace(dst);
+                ids.emplace_back(dst);
                 ++iter;
             }
         }
     }
-    return std::vector<VertexID>(set.begin(), set.end());
+    if (dedup) {
+        // Sorting the plain array beats hashing by far on large frontiers,
+        // and the ids of each response are sorted already.
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    return ids;
 }
 
 
 void GoExecutor::finishExecution(RpcResponse &&rpcResp) {
-    auto outputs = setupInterimResult(std::move(rpcResp));
+    // With `UPTO', the results of each step are handed on once the step is done,
+    // until no vertex is left to expand
+    auto done = !isUpto() || isFinalStep() || frontier_.empty();
     if (onResult_) {
-        onResult_(std::move(outputs));
+        // Hand the rows on batch by batch, so the next executor could start on
+        // the first ones while the rest are being built
+        onResult_(setupInterimResult(std::move(rpcResp), FLAGS_traverse_batch_rows));
     } else {
-        resp_ = std::make_unique<cpp2::ExecutionResponse>();
-        resp_->set_column_names(getResultColumnNames());
-        if (outputs != nullptr) {
-            auto rows = outputs->getRows();
-            resp_->set_rows(std::move(rows));
+        auto outputs = setupInterimResult(std::move(rpcResp));
+        if (stepResults_ == nullptr) {
+            stepResults_ = std::move(outputs);
+        } else {
+            stepResults_->append(std::move(outputs));
+        }
+        if (done) {
+            resp_ = std::make_unique<cpp2::ExecutionResponse>();
+            resp_->set_column_names(getResultColumnNames());
+            if (stepResults_ != nullptr) {
+                auto rows = stepResults_->getRows();
+                resp_->set_rows(std::move(rows));
+            }
         }
     }
+    if (!done) {
+        curStep_++;
+        stepOut();
+        return;
+    }
     DCHECK(onFinish_);
     onFinish_();
 }
@@ -405,7 +854,7 @@ StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps() {
         props.emplace_back(std::move(pd));
     }
 
-    if (!isFinalStep()) {
+    if (!isResultStep()) {
         return props;
     }
 
@@ -433,7 +882,13 @@ StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps() {
         }
     }
 
-    for (auto &prop : expCtx_->edgeProps()) {
+    auto edgeProps = expCtx_->edgeProps();
+    if (needOutEdgeProps()
+            && std::find(edgeProps.begin(), edgeProps.end(), "_rank") == edgeProps.end()) {
+        // To tell the out-edge of each in-edge
+        edgeProps.emplace_back("_rank");
+    }
+    for (auto &prop : edgeProps) {
         storage::cpp2::PropDef pd;
         pd.owner = storage::cpp2::PropOwner::EDGE;
         pd.name = prop;
@@ -514,6 +969,85 @@ void GoExecutor::fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcRe
 }
 
 
+void GoExecutor::fetchOutEdgeProps(RpcResponse &&rpcResp) {
+    std::vector<storage::cpp2::EdgeKey> keys;
+    for (auto &resp : rpcResp.responses()) {
+        if (resp.get_vertices() == nullptr || resp.get_edge_schema() == nullptr) {
+            continue;
+        }
+        auto schema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+        // With `BIDIRECT', the responses of the out-edges have the props already
+        if (schema->getFieldIndex(outEdgeProps_.front()) >= 0) {
+            continue;
+        }
+        auto dstIndex = schema->getFieldIndex("_dst");
+        auto rankIndex = schema->getFieldIndex("_rank");
+        CHECK_GE(dstIndex, 0);
+        CHECK_GE(rankIndex, 0);
+        for (auto &vdata : resp.vertices) {
+            RowSetReader rsReader(schema, vdata.edge_data);
+            auto iter = rsReader.begin();
+            while (iter) {
+                // The dst of an in-edge is the src of its out-edge
+                VertexID src;
+                EdgeRanking rank;
+                auto rc = iter->getVid(dstIndex, src);
+                CHECK(rc == ResultType::SUCCEEDED);
+                rc = iter->getInt(rankIndex, rank);
+                CHECK(rc == ResultType::SUCCEEDED);
+                storage::cpp2::EdgeKey key;
+                key.set_src(src);
+                key.set_edge_type(edgeType_);
+                key.set_dst(vdata.vertex_id);
+                key.set_ranking(rank);
+                keys.emplace_back(std::move(key));
+                ++iter;
+            }
+        }
+    }
+    if (keys.empty()) {
+        onEdgesReady(std::move(rpcResp));
+        return;
+    }
+
+    std::vector<storage::cpp2::PropDef> returns;
+    for (auto &prop : outEdgeProps_) {
+        storage::cpp2::PropDef pd;
+        pd.owner = storage::cpp2::PropOwner::EDGE;
+        pd.name = prop;
+        returns.emplace_back(std::move(pd));
+    }
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto future = ectx()->storage()->getEdgeProps(spaceId, std::move(keys), std::move(returns));
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this, stepOutResp = std::move(rpcResp)] (auto &&result) mutable {
+        auto completeness = result.completeness();
+        if (completeness == 0) {
+            DCHECK(onError_);
+            onError_(Status::Error("Get edge props failed"));
+            return;
+        } else if (completeness != 100) {
+            LOG(INFO) << "Get edge props partially failed: "  << completeness << "%";
+            for (auto &error : result.failedParts()) {
+                LOG(ERROR) << "part: " << error.first
+                           << "error code: " << static_cast<int>(error.second);
+            }
+        }
+        // Only the out-edges of this step are needed
+        edgeHolder_ = std::make_unique<EdgeHolder>();
+        for (auto &resp : result.responses()) {
+            edgeHolder_->add(resp);
+        }
+        onEdgesReady(std::move(stepOutResp));
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onError_(Status::Error("Internal error"));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
 std::vector<std::string> GoExecutor::getResultColumnNames() const {
     std::vector<std::string> result;
     result.reserve(yields_.size());
@@ -528,11 +1062,13 @@ std::vector<std::string> GoExecutor::getResultColumnNames() const {
 }
 
 
-std::unique_ptr<InterimResult> GoExecutor::setupInterimResult(RpcResponse &&rpcResp) {
+std::unique_ptr<InterimResult> GoExecutor::setupInterimResult(RpcResponse &&rpcResp,
+                                                              size_t batchRows) {
     // Generic results
     std::shared_ptr<SchemaWriter> schema;
     std::unique_ptr<RowSetWriter> rsWriter;
-    auto uniqResult = std::make_unique<std::unordered_set<std::string>>();
+    size_t numRows = 0;
+    size_t numBatches = 0;
     auto cb = [&] (std::vector<VariantType> record) {
         if (schema == nullptr) {
             schema = std::make_shared<SchemaWriter>();
@@ -583,17 +1119,22 @@ std::unique_ptr<InterimResult> GoExecutor::setupInterimResult(RpcResponse &&rpcR
         // TODO Consider float/double, and need to reduce mem copy.
         std::string encode = writer.encode();
         if (distinct_) {
-            auto ret = uniqResult->emplace(encode);
-            if (ret.second) {
-                rsWriter->addRow(writer);
+            auto ret = uniqRows_.emplace(encode);
+            if (!ret.second) {
+                return;
             }
-        } else {
-            rsWriter->addRow(writer);
+        }
+        rsWriter->addRow(writer);
+        if (batchRows > 0 && ++numRows >= batchRows) {
+            onResult_(std::make_unique<InterimResult>(std::move(rsWriter)));
+            rsWriter = std::make_unique<RowSetWriter>(schema);
+            numRows = 0;
+            numBatches++;
         }
     };  // cb
     processFinalResult(rpcResp, cb);
     // No results populated
-    if (rsWriter == nullptr) {
+    if (rsWriter == nullptr || (numBatches > 0 && numRows == 0)) {
         return nullptr;
     }
     return std::make_unique<InterimResult>(std::move(rsWriter));
@@ -625,6 +1166,23 @@ void GoExecutor::processFinalResult(RpcResponse &rpcResp, Callback cb) const {
             eschema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
         }
 
+        RowAccessor accessor(this, eschema.get(), vschema.get());
+        std::unique_ptr<CompiledExpression> filter;
+        std::vector<std::unique_ptr<CompiledExpression>> yields;
+        auto status = compileFinalExprs(accessor, filter, yields);
+        if (!status.ok()) {
+            VLOG(1) << "Evaluate the expressions without compiling: " << status;
+        }
+        auto compiled = status.ok();
+
+        // The responses of the in-edges which keep no props, whose props are
+        // read from the out-edges
+        auto fromInEdges = needOutEdgeProps() && eschema != nullptr
+                && eschema->getFieldIndex(outEdgeProps_.front()) < 0;
+        auto dstIndex = fromInEdges ? eschema->getFieldIndex("_dst") : -1;
+        auto rankIndex = fromInEdges ? eschema->getFieldIndex("_rank") : -1;
+        EdgeHolder::Key outEdge;
+
         for (auto &vdata : resp.vertices) {
             std::unique_ptr<RowReader> vreader;
             if (vschema != nullptr) {
@@ -636,8 +1194,39 @@ void GoExecutor::processFinalResult(RpcResponse &rpcResp, Callback cb) const {
             RowSetReader rsReader(eschema, vdata.edge_data);
             auto iter = rsReader.begin();
             while (iter) {
+                if (fromInEdges) {
+                    VertexID src;
+                    EdgeRanking rank;
+                    CHECK(iter->getVid(dstIndex, src) == ResultType::SUCCEEDED);
+                    CHECK(iter->getInt(rankIndex, rank) == ResultType::SUCCEEDED);
+                    outEdge = std::make_tuple(src, vdata.vertex_id, rank);
+                    if (edgeHolder_ == nullptr || !edgeHolder_->has(outEdge)) {
+                        // The out-edge is gone, e.g. expired
+                        ++iter;
+                        continue;
+                    }
+                }
+                if (compiled) {
+                    accessor.reset(&*iter, vreader.get(), vdata.vertex_id);
+                    if (filter != nullptr && !filter->test(accessor)) {
+                        ++iter;
+                        continue;
+                    }
+                    std::vector<VariantType> record;
+                    record.reserve(yields.size());
+                    for (auto &yield : yields) {
+                        record.emplace_back(yield->eval(accessor));
+                    }
+                    cb(std::move(record));
+                    ++iter;
+                    continue;
+                }
                 auto &getters = expCtx_->getters();
                 getters.getEdgeProp = [&] (const std::string &prop) -> VariantType {
+                    if (fromInEdges && eschema->getFieldIndex(prop) < 0) {
+                        auto index = edgeHolder_->schema()->getFieldIndex(prop);
+                        return edgeHolder_->get(outEdge, index);
+                    }
                     auto res = RowReader::getPropByName(&*iter, prop);
                     CHECK(ok(res));
                     return value(std::move(res));
@@ -693,6 +1282,32 @@ void GoExecutor::processFinalResult(RpcResponse &rpcResp, Callback cb) const {
 }
 
 
+Status GoExecutor::compileFinalExprs(
+        RowAccessor &accessor,
+        std::unique_ptr<CompiledExpression> &filter,
+        std::vector<std::unique_ptr<CompiledExpression>> &yields) const {
+    auto resolver = [&accessor] (const Expression *expr) {
+        return accessor.resolve(expr);
+    };
+    if (filter_ != nullptr) {
+        auto ret = CompiledExpression::compile(filter_, resolver);
+        if (!ret.ok()) {
+            return ret.status();
+        }
+        filter = std::move(ret).value();
+    }
+    yields.reserve(yields_.size());
+    for (auto *column : yields_) {
+        auto ret = CompiledExpression::compile(column->expr(), resolver);
+        if (!ret.ok()) {
+            return ret.status();
+        }
+        yields.emplace_back(std::move(ret).value());
+    }
+    return Status::OK();
+}
+
+
 VariantType GoExecutor::VertexHolder::get(VertexID id, int64_t index) const {
     auto iter = data_.find(id);
 
@@ -707,6 +1322,49 @@ VariantType GoExecutor::VertexHolder::get(VertexID id, int64_t index) const {
 }
 
 
+VariantType GoExecutor::EdgeHolder::get(const Key &key, int64_t index) const {
+    auto iter = data_.find(key);
+    CHECK(iter != data_.end());
+    CHECK_LT(static_cast<size_t>(index), iter->second.size());
+    return iter->second[index];
+}
+
+
+void GoExecutor::EdgeHolder::add(const storage::cpp2::EdgePropResponse &resp) {
+    if (resp.get_schema() == nullptr || resp.get_data() == nullptr) {
+        return;
+    }
+    auto schema = std::make_shared<ResultSchemaProvider>(resp.schema);
+    if (schema_ == nullptr) {
+        schema_ = schema;
+    }
+    auto srcIndex = schema->getFieldIndex("_src");
+    auto dstIndex = schema->getFieldIndex("_dst");
+    auto rankIndex = schema->getFieldIndex("_rank");
+    CHECK(srcIndex >= 0 && dstIndex >= 0 && rankIndex >= 0);
+    auto numFields = schema->getNumFields();
+    RowSetReader rsReader(schema, resp.data);
+    auto iter = rsReader.begin();
+    while (iter) {
+        VertexID src;
+        VertexID dst;
+        EdgeRanking rank;
+        CHECK(iter->getInt(srcIndex, src) == ResultType::SUCCEEDED);
+        CHECK(iter->getInt(dstIndex, dst) == ResultType::SUCCEEDED);
+        CHECK(iter->getInt(rankIndex, rank) == ResultType::SUCCEEDED);
+        std::vector<VariantType> row;
+        row.reserve(numFields);
+        for (auto i = 0u; i < numFields; i++) {
+            auto res = RowReader::getPropByIndex(&*iter, i);
+            CHECK(ok(res));
+            row.emplace_back(value(std::move(res)));
+        }
+        data_[std::make_tuple(src, dst, rank)] = std::move(row);
+        ++iter;
+    }
+}
+
+
 void GoExecutor::VertexHolder::add(const storage::cpp2::QueryResponse &resp) {
     auto *vertices = resp.get_vertices();
     if (vertices == nullptr) {
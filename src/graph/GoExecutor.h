@@ -10,6 +10,8 @@
 #include "base/Base.h"
 #include "graph/TraverseExecutor.h"
 #include "storage/client/StorageClient.h"
+#include "filter/CompiledExpression.h"
+#include <folly/hash/Hash.h>
 
 namespace nebula {
 
@@ -35,8 +37,27 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    /**
+     * When streaming, each batch fed is traversed at once by a child executor of
+     * the same sentence, while the upstream keeps producing the next ones.
+     * Since the rows are traversed independently, it is the same as traversing
+     * all of them at once, except with DISTINCT.
+     */
+    void feedBatch(std::unique_ptr<InterimResult> batch) override;
+
+    void finishBatches() override;
+
+    bool isStreaming() const override {
+        return !distinct_ && varname_ == nullptr && colname_ != nullptr;
+    }
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+    /**
+     * To retrieve or generate the column names for the execution result.
+     */
+    std::vector<std::string> getResultColumnNames() const override;
+
 private:
     /**
      * To do some preparing works on the clauses
@@ -70,12 +91,42 @@ private:
         return upto_;
     }
 
+    /**
+     * To check if the results are collected in this step,
+     * i.e. the final step, or every step with `UPTO'.
+     */
+    bool isResultStep() const {
+        return isUpto() || isFinalStep();
+    }
+
+    /**
+     * With `UPTO', to take the vertices never reached before
+     * as the frontier of the next step.
+     */
+    void setupUptoFrontier(RpcResponse &rpcResp);
+
     /**
      * To check if `REVERSELY' is specified.
      * If so, we step out in a reverse manner.
      */
     bool isReversely() const {
-        return reversely_;
+        return direction_ == OverClause::Direction::kIn;
+    }
+
+    /**
+     * To check if `BIDIRECT' is specified.
+     * If so, we step out over both the out-edges and the in-edges.
+     */
+    bool isBidirect() const {
+        return direction_ == OverClause::Direction::kBoth;
+    }
+
+    /**
+     * To check if the edge props of the in-edges stepped out over are read from
+     * their out-edges, since the edge type keeps no props on the in-edges.
+     */
+    bool needOutEdgeProps() const {
+        return !outEdgeProps_.empty();
     }
 
     /**
@@ -90,6 +141,13 @@ private:
     void stepOut();
 
     using RpcResponse = storage::StorageRpcResponse<storage::cpp2::QueryResponse>;
+    /**
+     * To step out over the out-edges or the in-edges, from the given frontier after
+     * the first step.
+     */
+    folly::SemiFuture<RpcResponse> stepOutOneWay(bool isOutBound,
+                                                 storage::StorageClient::PartIds frontier,
+                                                 std::vector<storage::cpp2::PropDef> returns);
     /**
      * Callback invoked upon the response of stepping out arrives.
      */
@@ -111,14 +169,21 @@ private:
     void fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcResp);
 
     /**
-     * To retrieve or generate the column names for the execution result.
+     * To read the edge props of the in-edges stepped out over from their out-edges.
      */
-    std::vector<std::string> getResultColumnNames() const;
+    void fetchOutEdgeProps(RpcResponse &&rpcResp);
+
+    /**
+     * The edges stepped out over and their props are ready,
+     * to go on with the props of the dst vertices if needed.
+     */
+    void onEdgesReady(RpcResponse &&rpcResp);
 
     /**
      * To retrieve the dst ids from a stepping out response.
+     * Duplicates are kept unless `dedup' is set.
      */
-    std::vector<VertexID> getDstIdsFromResp(RpcResponse &rpcResp) const;
+    std::vector<VertexID> getDstIdsFromResp(RpcResponse &rpcResp, bool dedup = true) const;
 
     /**
      * All required data have arrived, finish the execution.
@@ -128,8 +193,21 @@ private:
     /**
      * To setup an intermediate representation of the execution result,
      * which is about to be piped to the next executor.
+     * If `batchRows' is not zero, every `batchRows' rows are handed to `onResult_'
+     * as soon as they are ready, and the rest are returned.
+     */
+    std::unique_ptr<InterimResult> setupInterimResult(RpcResponse &&rpcResp,
+                                                      size_t batchRows = 0);
+
+    /**
+     * A child executor is done with its batch, with `status' not ok on failure.
+     */
+    void onBatchDone(Status status);
+
+    /**
+     * All the batches fed have been traversed.
      */
-    std::unique_ptr<InterimResult> setupInterimResult(RpcResponse &&rpcResp);
+    void finishStreaming();
 
     /**
      * To setup the header of the execution result, i.e. the column names.
@@ -148,6 +226,20 @@ private:
     using Callback = std::function<void(std::vector<VariantType>)>;
     void processFinalResult(RpcResponse &rpcResp, Callback cb) const;
 
+    /**
+     * To read the props of the current row by index, for the compiled filter and yields.
+     */
+    class RowAccessor;
+
+    /**
+     * To compile the filter and yield columns against the schemas of one response.
+     * Fails if any of them is not supported by the compiler,
+     * and the expression trees are evaluated then.
+     */
+    Status compileFinalExprs(RowAccessor &accessor,
+                             std::unique_ptr<CompiledExpression> &filter,
+                             std::vector<std::unique_ptr<CompiledExpression>> &yields) const;
+
     /**
      * A container to hold the mapping from vertex id to its properties, used for lookups
      * during the final evaluation process.
@@ -169,13 +261,38 @@ private:
         std::unordered_map<VertexID, std::string>   data_;
     };
 
+    /**
+     * A container to hold the props of the out-edges, for the in-edges
+     * stepped out over, which keep no props.
+     */
+    class EdgeHolder final {
+    public:
+        // src, dst, rank of an out-edge
+        using Key = std::tuple<VertexID, VertexID, EdgeRanking>;
+
+        bool has(const Key &key) const {
+            return data_.count(key) > 0;
+        }
+        VariantType get(const Key &key, int64_t index) const;
+        void add(const storage::cpp2::EdgePropResponse &resp);
+        const auto* schema() const {
+            return schema_.get();
+        }
+
+    private:
+        std::shared_ptr<ResultSchemaProvider>                   schema_;
+        std::unordered_map<Key, std::vector<VariantType>>       data_;
+    };
+
 private:
     GoSentence                                 *sentence_{nullptr};
     uint32_t                                    steps_{1};
     uint32_t                                    curStep_{1};
     bool                                        upto_{false};
-    bool                                        reversely_{false};
+    OverClause::Direction                       direction_{OverClause::Direction::kOut};
     EdgeType                                    edgeType_;
+    // The edge props to read from the out-edges, when stepping out over the in-edges
+    std::vector<std::string>                    outEdgeProps_;
     std::string                                *varname_{nullptr};
     std::string                                *colname_{nullptr};
     Expression                                 *filter_{nullptr};
@@ -185,12 +302,30 @@ private:
     std::unique_ptr<InterimResult>              inputs_;
     std::unique_ptr<ExpressionContext>          expCtx_;
     std::vector<VertexID>                       starts_;
+    // The vertices to step out from after the first step, grouped by partition
+    storage::StorageClient::PartIds             frontier_;
+    // With `UPTO', the vertices reached so far, which are expanded at most once
+    std::unordered_set<VertexID>                visited_;
+    // With `UPTO', the results of the steps done, if this is the right most executor
+    std::unique_ptr<InterimResult>              stepResults_;
+    // The rows taken so far, with `DISTINCT'
+    std::unordered_set<std::string>             uniqRows_;
     std::unique_ptr<VertexHolder>               vertexHolder_;
+    std::unique_ptr<EdgeHolder>                 edgeHolder_;
     std::unique_ptr<cpp2::ExecutionResponse>    resp_;
     // The name of Tag or Edge, index of prop in data
     using SchemaPropIndex = std::unordered_map<std::pair<std::string, std::string>, int64_t>;
     SchemaPropIndex                              srcTagProps_;
     SchemaPropIndex                              dstTagProps_;
+
+    // The state of streaming, guarded by `streamLock_'
+    std::mutex                                  streamLock_;
+    std::vector<std::unique_ptr<GoExecutor>>    batchExecutors_;
+    size_t                                      batchesOnFly_{0};
+    bool                                        batchesFinished_{false};
+    Status                                      batchStatus_;
+    // The results of the batches, if this is the right most executor
+    std::unique_ptr<InterimResult>              batchResults_;
 };
 
 }   // namespace graph
@@ -7,6 +7,7 @@
 #include "base/Base.h"
 #include "graph/InterimResult.h"
 #include "dataman/RowReader.h"
+#include <folly/Varint.h>
 
 namespace nebula {
 namespace graph {
@@ -98,5 +99,53 @@ std::vector<cpp2::RowValue> InterimResult::getRows() const {
     return rows;
 }
 
+
+void InterimResult::append(std::unique_ptr<InterimResult> other) {
+    if (other == nullptr || (other->rsWriter_ == nullptr && other->vids_.empty())) {
+        return;
+    }
+    if (!other->vids_.empty()) {
+        DCHECK(rsWriter_ == nullptr);
+        vids_.insert(vids_.end(), other->vids_.begin(), other->vids_.end());
+        return;
+    }
+    if (rsWriter_ == nullptr) {
+        DCHECK(vids_.empty());
+        rsWriter_ = std::move(other->rsWriter_);
+    } else {
+        DCHECK_EQ(rsWriter_->schema()->getNumFields(),
+                  other->rsWriter_->schema()->getNumFields());
+        // The rows are encoded one after another, so are the row sets
+        rsWriter_->data().append(other->rsWriter_->data());
+    }
+    rsReader_ = std::make_unique<RowSetReader>(rsWriter_->schema(), rsWriter_->data());
+}
+
+
+std::vector<folly::StringPiece> InterimResult::encodedRows() const {
+    std::vector<folly::StringPiece> rows;
+    if (rsWriter_ == nullptr) {
+        return rows;
+    }
+    folly::StringPiece data = rsWriter_->data();
+    auto range = folly::ByteRange(data);
+    while (!range.empty()) {
+        auto len = folly::decodeVarint(range);
+        rows.emplace_back(reinterpret_cast<const char*>(range.begin()), len);
+        range.advance(len);
+    }
+    return rows;
+}
+
+
+std::unique_ptr<InterimResult> InterimResult::copy() const {
+    if (rsWriter_ == nullptr) {
+        return std::make_unique<InterimResult>(vids_);
+    }
+    auto rsWriter = std::make_unique<RowSetWriter>(rsWriter_->schema());
+    rsWriter->data() = rsWriter_->data();
+    return std::make_unique<InterimResult>(std::move(rsWriter));
+}
+
 }   // namespace graph
 }   // namespace nebula
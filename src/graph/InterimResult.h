@@ -40,6 +40,14 @@ public:
     StatusOr<std::vector<VertexID>> getVIDs(const std::string &col) const;
 
     std::vector<cpp2::RowValue> getRows() const;
+
+    // Append the rows of another batch of the same result
+    void append(std::unique_ptr<InterimResult> other);
+
+    // The encoded rows, valid as long as this result is
+    std::vector<folly::StringPiece> encodedRows() const;
+
+    std::unique_ptr<InterimResult> copy() const;
     // TODO(dutor) iterating interfaces on rows and columns
 
 private:
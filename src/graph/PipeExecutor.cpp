@@ -28,33 +28,42 @@ Status PipeExecutor::prepare() {
     DCHECK(right_ != nullptr);
 
     auto onError = [this] (Status s) {
-        /**
-         * TODO(dutor)
-         * If we allow concurrent execution of both sides, we must wait for all their
-         * internal on-fly async-requests' to arrive before call `onError_'.
-         * For the sake of simplicity, we don't allow the pipeline way for now.
-         */
         onError_(std::move(s));
     };
 
     // Setup dependencies
     {
         auto onFinish = [this] () {
-            // Start executing `right_' when `left_' is finished.
-            right_->execute();
+            // Start executing `right_' when `left_' is finished,
+            // unless it is streaming and has been running already.
+            right_->finishBatches();
         };
         left_->setOnFinish(onFinish);
 
         auto onResult = [this] (std::unique_ptr<InterimResult> result) {
             // Feed results from `left_' to `right_'
-            right_->feedResult(std::move(result));
+            right_->feedBatch(std::move(result));
         };
         left_->setOnResult(onResult);
 
-        left_->setOnError(onError);
+        auto onLeftError = [this] (Status s) {
+            if (!right_->isStreaming()) {
+                onError_(std::move(s));
+                return;
+            }
+            // Wait for the async requests on the fly of `right_', before
+            // this executor could be destroyed
+            leftStatus_ = std::move(s);
+            right_->finishBatches();
+        };
+        left_->setOnError(onLeftError);
     }
     {
         auto onFinish = [this] () {
+            if (!leftStatus_.ok()) {
+                onError_(std::move(leftStatus_));
+                return;
+            }
             // This executor is done when `right_' finishes.
             DCHECK(onFinish_);
             onFinish_();
@@ -103,6 +112,16 @@ void PipeExecutor::feedResult(std::unique_ptr<InterimResult> result) {
 }
 
 
+void PipeExecutor::feedBatch(std::unique_ptr<InterimResult> batch) {
+    left_->feedBatch(std::move(batch));
+}
+
+
+void PipeExecutor::finishBatches() {
+    left_->finishBatches();
+}
+
+
 void PipeExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
     /**
      * `setupResponse()' could be invoked if and only if this executor
@@ -27,12 +27,28 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    // The batches go to `left_'
+    void feedBatch(std::unique_ptr<InterimResult> batch) override;
+
+    void finishBatches() override;
+
+    bool isStreaming() const override {
+        return left_->isStreaming();
+    }
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+    std::vector<std::string> getResultColumnNames() const override {
+        return right_->getResultColumnNames();
+    }
+
 private:
     PipedSentence                              *sentence_{nullptr};
     std::unique_ptr<TraverseExecutor>           left_;
     std::unique_ptr<TraverseExecutor>           right_;
+    // The error of `left_', reported once the streaming `right_' is done with
+    // the batches already fed
+    Status                                      leftStatus_;
 };
 
 }   // namespace graph
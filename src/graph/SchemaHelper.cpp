@@ -57,6 +57,20 @@ Status SchemaHelper::createSchema(const std::vector<ColumnSpecification*>& specs
                         return status;
                     }
                     break;
+                case SchemaPropItem::INBOUND_PROPS: {
+                    auto ret = schemaProp->getInboundProps();
+                    if (!ret.ok()) {
+                        return ret.status();
+                    }
+                    schema.schema_prop.set_inbound_props(ret.value());
+                    break;
+                }
+                case SchemaPropItem::INDEXES:
+                    status = setIndexes(schemaProp, schema);
+                    if (!status.ok()) {
+                        return status;
+                    }
+                    break;
             }
         }
 
@@ -112,6 +126,46 @@ Status SchemaHelper::setTTLCol(SchemaPropItem* schemaProp, nebula::cpp2::Schema&
 }
 
 
+// static
+Status SchemaHelper::setIndexes(SchemaPropItem* schemaProp, nebula::cpp2::Schema& schema) {
+    auto ret = schemaProp->getIndexes();
+    if (!ret.ok()) {
+        return ret.status();
+    }
+
+    auto indexes = std::move(ret).value();
+    for (auto& index : indexes) {
+        auto it = std::find_if(schema.columns.begin(), schema.columns.end(),
+                               [&index] (const auto& col) { return col.name == index; });
+        if (it == schema.columns.end()) {
+            return Status::Error("Index column `%s' not exist in columns", index.c_str());
+        }
+        if (!isIndexable(it->type.type)) {
+            return Status::Error("Index column `%s' type illegal", index.c_str());
+        }
+    }
+    schema.schema_prop.set_indexes(std::move(indexes));
+    return Status::OK();
+}
+
+
+// static
+bool SchemaHelper::isIndexable(nebula::cpp2::SupportedType type) {
+    switch (type) {
+        case nebula::cpp2::SupportedType::BOOL:
+        case nebula::cpp2::SupportedType::INT:
+        case nebula::cpp2::SupportedType::VID:
+        case nebula::cpp2::SupportedType::TIMESTAMP:
+        case nebula::cpp2::SupportedType::FLOAT:
+        case nebula::cpp2::SupportedType::DOUBLE:
+        case nebula::cpp2::SupportedType::STRING:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
 // static
 Status SchemaHelper::alterSchema(const std::vector<AlterSchemaOptItem*>& schemaOpts,
                                  const std::vector<SchemaPropItem*>& schemaProps,
@@ -165,6 +219,23 @@ Status SchemaHelper::alterSchema(const std::vector<AlterSchemaOptItem*>& schemaO
                 }
                 prop.set_ttl_col(retStr.value());
                 break;
+            case SchemaPropItem::INBOUND_PROPS: {
+                auto retBool = schemaProp->getInboundProps();
+                if (!retBool.ok()) {
+                   return retBool.status();
+                }
+                prop.set_inbound_props(retBool.value());
+                break;
+            }
+            case SchemaPropItem::INDEXES: {
+                // Check the legality of the columns in meta
+                auto retIndexes = schemaProp->getIndexes();
+                if (!retIndexes.ok()) {
+                   return retIndexes.status();
+                }
+                prop.set_indexes(std::move(retIndexes).value());
+                break;
+            }
             default:
                 return Status::Error("Property type not support");
         }
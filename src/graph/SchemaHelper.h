@@ -30,6 +30,11 @@ public:
 
     static Status setTTLCol(SchemaPropItem* schemaProp, nebula::cpp2::Schema& schema);
 
+    static Status setIndexes(SchemaPropItem* schemaProp, nebula::cpp2::Schema& schema);
+
+    // Whether the secondary indexes support the type
+    static bool isIndexable(nebula::cpp2::SupportedType type);
+
     static Status alterSchema(const std::vector<AlterSchemaOptItem*>& schemaOpts,
                               const std::vector<SchemaPropItem*>& schemaProps,
                               std::vector<nebula::meta::cpp2::AlterSchemaItem>& options,
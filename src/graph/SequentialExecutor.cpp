@@ -9,6 +9,8 @@
 #include "graph/GoExecutor.h"
 #include "graph/PipeExecutor.h"
 #include "graph/UseExecutor.h"
+#include "parser/TraverseSentences.h"
+#include <regex>
 
 namespace nebula {
 namespace graph {
@@ -32,37 +34,118 @@ Status SequentialExecutor::prepare() {
         }
         executors_.emplace_back(std::move(executor));
     }
-    /**
-     * For the time being, we execute sentences one by one. We may allow concurrent
-     * or out of order execution in the future.
-     */
-    // For an executor except the last one, it executes the next one on finished.
-    // If any fails, the whole execution would abort.
-    auto onError = [this] (Status status) {
-        DCHECK(onError_);
-        onError_(std::move(status));
-    };
-    for (auto i = 0U; i < executors_.size() - 1; i++) {
-        auto onFinish = [this, next = i + 1] () {
-            executors_[next]->execute();
+    buildDependencies();
+    for (auto i = 0U; i < executors_.size(); i++) {
+        // If any fails, no more executor would start, and the whole execution
+        // aborts once the running ones are done.
+        auto onError = [this, i] (Status status) {
+            onExecutorDone(i, std::move(status));
+        };
+        auto onFinish = [this, i] () {
+            onExecutorDone(i, Status::OK());
         };
         executors_[i]->setOnFinish(onFinish);
         executors_[i]->setOnError(onError);
     }
-    // The whole execution is done upon the last executor finishes.
-    auto onFinish = [this] () {
-        DCHECK(onFinish_);
-        onFinish_();
-    };
-    executors_.back()->setOnFinish(onFinish);
-    executors_.back()->setOnError(onError);
 
     return Status::OK();
 }
 
 
+void SequentialExecutor::buildDependencies() {
+    static const std::regex varRegex("\\$([A-Za-z_][A-Za-z0-9_]*)");
+    auto num = executors_.size();
+    std::vector<bool> traversals(num);
+    std::vector<std::unordered_set<std::string>> refs(num);
+    std::vector<const std::string*> assigns(num, nullptr);
+    for (auto i = 0U; i < num; i++) {
+        auto *sentence = sentences_->sentences_[i].get();
+        auto kind = sentence->kind();
+        traversals[i] = kind == Sentence::Kind::kGo
+                     || kind == Sentence::Kind::kPipe
+                     || kind == Sentence::Kind::kOrderBy
+                     || kind == Sentence::Kind::kSet
+                     || kind == Sentence::Kind::kAssignment;
+        if (kind == Sentence::Kind::kAssignment) {
+            assigns[i] = static_cast<AssignmentSentence*>(sentence)->var();
+        }
+        // Conservatively, anything alike a variable is regarded as a reference
+        auto text = sentence->toString();
+        auto it = std::sregex_iterator(text.begin(), text.end(), varRegex);
+        for (; it != std::sregex_iterator(); ++it) {
+            refs[i].emplace((*it)[1].str());
+        }
+    }
+
+    successors_.assign(num, {});
+    numPendingDeps_.assign(num, 0);
+    for (auto i = 0U; i < num; i++) {
+        for (auto j = 0U; j < i; j++) {
+            auto depends = !traversals[i]
+                || !traversals[j]
+                || (assigns[j] != nullptr && refs[i].count(*assigns[j]) > 0)
+                || (assigns[i] != nullptr && refs[j].count(*assigns[i]) > 0);
+            if (depends) {
+                successors_[j].emplace_back(i);
+                numPendingDeps_[i]++;
+            }
+        }
+    }
+}
+
+
 void SequentialExecutor::execute() {
-    executors_.front()->execute();
+    std::vector<size_t> ready;
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        for (auto i = 0U; i < executors_.size(); i++) {
+            if (numPendingDeps_[i] == 0) {
+                ready.emplace_back(i);
+            }
+        }
+        numRunning_ = ready.size();
+    }
+    for (auto i : ready) {
+        executors_[i]->execute();
+    }
+}
+
+
+void SequentialExecutor::onExecutorDone(size_t index, Status status) {
+    std::vector<size_t> ready;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        numRunning_--;
+        numFinished_++;
+        if (!status.ok()) {
+            if (status_.ok()) {
+                status_ = std::move(status);
+            }
+        } else if (status_.ok()) {
+            for (auto next : successors_[index]) {
+                if (--numPendingDeps_[next] == 0) {
+                    ready.emplace_back(next);
+                }
+            }
+            numRunning_ += ready.size();
+        }
+        done = numRunning_ == 0 && (!status_.ok() || numFinished_ == executors_.size());
+    }
+    if (done) {
+        // The whole execution is done upon all the executors finish.
+        if (!status_.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(status_));
+        } else {
+            DCHECK(onFinish_);
+            onFinish_();
+        }
+        return;
+    }
+    for (auto next : ready) {
+        executors_[next]->execute();
+    }
 }
 
 
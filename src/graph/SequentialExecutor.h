@@ -28,9 +28,34 @@ public:
 
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+private:
+    /**
+     * To find out the executors each one has to wait for.
+     * A statement waits for the earlier ones assigning the variables it refers to,
+     * and for the earlier ones referring to the variable it assigns. Any statement
+     * other than the traversals waits for all the earlier ones, and is waited by
+     * all the later ones.
+     */
+    void buildDependencies();
+
+    /**
+     * The executor `index' is done, with `status' not ok on failure.
+     * The executors whose dependencies are all done start then.
+     */
+    void onExecutorDone(size_t index, Status status);
+
 private:
     SequentialSentences                        *sentences_{nullptr};
     std::vector<std::unique_ptr<Executor>>      executors_;
+    // The executors waiting for each one
+    std::vector<std::vector<size_t>>            successors_;
+    // Guards the state of execution below
+    std::mutex                                  lock_;
+    // How many executors each one is still waiting for
+    std::vector<size_t>                         numPendingDeps_;
+    size_t                                      numRunning_{0};
+    size_t                                      numFinished_{0};
+    Status                                      status_;
 };
 
 
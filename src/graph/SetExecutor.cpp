@@ -0,0 +1,337 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/SetExecutor.h"
+
+namespace nebula {
+namespace graph {
+
+SetExecutor::SetExecutor(Sentence *sentence,
+                         ExecutionContext *ectx) : TraverseExecutor(ectx) {
+    sentence_ = static_cast<SetSentence*>(sentence);
+}
+
+
+Status SetExecutor::prepare() {
+    auto status = checkIfGraphSpaceChosen();
+    if (!status.ok()) {
+        return status;
+    }
+
+    left_ = makeTraverseExecutor(sentence_->left());
+    right_ = makeTraverseExecutor(sentence_->right());
+    DCHECK(left_ != nullptr);
+    DCHECK(right_ != nullptr);
+
+    left_->setOnResult([this] (std::unique_ptr<InterimResult> result) {
+        onSideResult(kLeft, std::move(result));
+    });
+    right_->setOnResult([this] (std::unique_ptr<InterimResult> result) {
+        onSideResult(kRight, std::move(result));
+    });
+    left_->setOnFinish([this] () {
+        onSideDone(kLeft, Status::OK());
+    });
+    left_->setOnError([this] (Status s) {
+        onSideDone(kLeft, std::move(s));
+    });
+    right_->setOnFinish([this] () {
+        onSideDone(kRight, Status::OK());
+    });
+    right_->setOnError([this] (Status s) {
+        onSideDone(kRight, std::move(s));
+    });
+
+    status = left_->prepare();
+    if (!status.ok()) {
+        FLOG_ERROR("Prepare executor `%s' failed: %s",
+                    left_->name(), status.toString().c_str());
+        return status;
+    }
+
+    status = right_->prepare();
+    if (!status.ok()) {
+        FLOG_ERROR("Prepare executor `%s' failed: %s",
+                    right_->name(), status.toString().c_str());
+        return status;
+    }
+
+    return Status::OK();
+}
+
+
+void SetExecutor::execute() {
+    FLOG_INFO("Executing Set: %s", sentence_->toString().c_str());
+    // Both sides send their requests, then wait for the responses concurrently
+    left_->execute();
+    right_->execute();
+}
+
+
+void SetExecutor::feedResult(std::unique_ptr<InterimResult> result) {
+    left_->feedResult(result == nullptr ? nullptr : result->copy());
+    right_->feedResult(std::move(result));
+}
+
+
+void SetExecutor::onSideResult(Side side, std::unique_ptr<InterimResult> result) {
+    if (result == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> g(lock_);
+    if (!status_.ok()) {
+        return;
+    }
+    if (probeSide_ == side) {
+        probe(std::move(result));
+    } else if (results_[side] == nullptr) {
+        results_[side] = std::move(result);
+    } else {
+        results_[side]->append(std::move(result));
+    }
+}
+
+
+void SetExecutor::onSideDone(Side side, Status status) {
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        if (!status.ok() && status_.ok()) {
+            status_ = std::move(status);
+        }
+        if (++numSidesDone_ < 2) {
+            if (!status_.ok()) {
+                return;
+            }
+            // Start probing the other side if this one is to be hashed
+            auto other = side == kLeft ? kRight : kLeft;
+            auto numRows = [this] (Side s) {
+                return results_[s] == nullptr ? 0UL : results_[s]->encodedRows().size();
+            };
+            if (sentence_->op() == SetSentence::MINUS && side == kRight) {
+                startProbing(kLeft);
+            } else if (sentence_->op() == SetSentence::INTERSECT
+                    && numRows(side) <= numRows(other)) {
+                startProbing(other);
+            }
+            return;
+        }
+    }
+
+    // Report the failure only after both sides are done,
+    // since this executor could be destroyed then.
+    if (!status_.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status_));
+        return;
+    }
+    auto result = combine();
+    if (!result.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(result).status());
+        return;
+    }
+    if (onResult_) {
+        onResult_(std::move(result).value());
+    } else {
+        result_ = std::move(result).value();
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
+void SetExecutor::startProbing(Side side) {
+    auto other = side == kLeft ? kRight : kLeft;
+    probeSide_ = side;
+    if (results_[other] != nullptr) {
+        auto rows = results_[other]->encodedRows();
+        hashed_.insert(rows.begin(), rows.end());
+    }
+    // The rows of `side' so far are probed as a batch
+    probe(std::move(results_[side]));
+}
+
+
+void SetExecutor::probe(std::unique_ptr<InterimResult> batch) {
+    if (batch == nullptr) {
+        return;
+    }
+    auto &hashedSide = results_[*probeSide_ == kLeft ? kRight : kLeft];
+    if (hashedSide != nullptr) {
+        auto status = checkSchemas(*hashedSide, *batch);
+        if (!status.ok()) {
+            status_ = std::move(status);
+            return;
+        }
+    }
+    if (writer_ == nullptr) {
+        // The columns are named after the left side
+        auto *named = *probeSide_ == kLeft || hashedSide == nullptr
+                    ? batch.get() : hashedSide.get();
+        writer_ = std::make_unique<RowSetWriter>(named->schema());
+    }
+    bool taken = false;
+    for (auto &row : batch->encodedRows()) {
+        if (sentence_->op() == SetSentence::INTERSECT) {
+            // Each row is taken at most once
+            if (hashed_.erase(row) > 0) {
+                writer_->addRow(row);
+            }
+        } else if (hashed_.emplace(row).second) {
+            // Each row taken is excluded from then on
+            writer_->addRow(row);
+            taken = true;
+        }
+    }
+    if (taken) {
+        // The rows taken are in `hashed_' from now on
+        probed_.emplace_back(std::move(batch));
+    }
+}
+
+
+StatusOr<std::unique_ptr<InterimResult>> SetExecutor::combine() {
+    if (probeSide_) {
+        // Release the rows of both sides as early as possible
+        hashed_.clear();
+        probed_.clear();
+        results_[kLeft].reset();
+        results_[kRight].reset();
+        if (writer_ == nullptr || writer_->data().empty()) {
+            return std::unique_ptr<InterimResult>();
+        }
+        return std::make_unique<InterimResult>(std::move(writer_));
+    }
+
+    auto &leftResult = results_[kLeft];
+    auto &rightResult = results_[kRight];
+    std::shared_ptr<const meta::SchemaProviderIf> schema;
+    if (leftResult != nullptr && rightResult != nullptr) {
+        auto status = checkSchemas(*leftResult, *rightResult);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    if (leftResult != nullptr) {
+        schema = leftResult->schema();
+    } else if (rightResult != nullptr) {
+        schema = rightResult->schema();
+    } else {
+        return std::unique_ptr<InterimResult>();
+    }
+
+    std::vector<folly::StringPiece> left;
+    std::vector<folly::StringPiece> right;
+    if (leftResult != nullptr) {
+        left = leftResult->encodedRows();
+    }
+    if (rightResult != nullptr) {
+        right = rightResult->encodedRows();
+    }
+    auto rsWriter = std::make_unique<RowSetWriter>(schema);
+    switch (sentence_->op()) {
+        case SetSentence::UNION:
+            doUnion(left, right, *rsWriter);
+            break;
+        case SetSentence::INTERSECT:
+            doIntersect(left, right, *rsWriter);
+            break;
+        case SetSentence::MINUS:
+            doMinus(left, right, *rsWriter);
+            break;
+    }
+    // Release the rows of both sides as early as possible
+    leftResult.reset();
+    rightResult.reset();
+    if (rsWriter->data().empty()) {
+        return std::unique_ptr<InterimResult>();
+    }
+    return std::make_unique<InterimResult>(std::move(rsWriter));
+}
+
+
+Status SetExecutor::checkSchemas(const InterimResult &left, const InterimResult &right) {
+    auto lschema = left.schema();
+    auto rschema = right.schema();
+    if (lschema->getNumFields() != rschema->getNumFields()) {
+        return Status::Error("Both sides have different number of columns: %zu vs %zu",
+                             lschema->getNumFields(), rschema->getNumFields());
+    }
+    for (size_t i = 0; i < lschema->getNumFields(); i++) {
+        if (lschema->getFieldType(i).type != rschema->getFieldType(i).type) {
+            return Status::Error("Column `%s' has different types on both sides",
+                                 lschema->getFieldName(i));
+        }
+    }
+    return Status::OK();
+}
+
+
+void SetExecutor::doUnion(std::vector<folly::StringPiece> &left,
+                          std::vector<folly::StringPiece> &right,
+                          RowSetWriter &writer) const {
+    RowSet rows;
+    rows.reserve(left.size() + right.size());
+    for (auto *side : {&left, &right}) {
+        for (auto &row : *side) {
+            if (rows.emplace(row).second) {
+                writer.addRow(row);
+            }
+        }
+    }
+}
+
+
+void SetExecutor::doIntersect(std::vector<folly::StringPiece> &left,
+                              std::vector<folly::StringPiece> &right,
+                              RowSetWriter &writer) const {
+    auto &build = left.size() <= right.size() ? left : right;
+    auto &probe = left.size() <= right.size() ? right : left;
+    RowSet rows(build.begin(), build.end());
+    for (auto &row : probe) {
+        // Each row is taken at most once
+        if (rows.erase(row) > 0) {
+            writer.addRow(row);
+        }
+    }
+}
+
+
+void SetExecutor::doMinus(std::vector<folly::StringPiece> &left,
+                          std::vector<folly::StringPiece> &right,
+                          RowSetWriter &writer) const {
+    RowSet rows(right.begin(), right.end());
+    for (auto &row : left) {
+        // Each row taken is excluded from then on
+        if (rows.emplace(row).second) {
+            writer.addRow(row);
+        }
+    }
+}
+
+
+void SetExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (result_ == nullptr) {
+        // No rows, but the columns are still there
+        resp.set_column_names(getResultColumnNames());
+        return;
+    }
+
+    auto schema = result_->schema();
+    std::vector<std::string> columnNames;
+    columnNames.reserve(schema->getNumFields());
+    auto field = schema->begin();
+    while (field) {
+        columnNames.emplace_back(field->getName());
+        ++field;
+    }
+    resp.set_column_names(std::move(columnNames));
+    resp.set_rows(result_->getRows());
+}
+
+}   // namespace graph
+}   // namespace nebula
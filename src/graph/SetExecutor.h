@@ -0,0 +1,124 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_SETEXECUTOR_H_
+#define GRAPH_SETEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/TraverseExecutor.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * UNION, INTERSECT and MINUS of the rows of both sides, which are executed
+ * concurrently, and are combined by hashing the encoded rows. The result has
+ * no duplicated rows.
+ *
+ * For INTERSECT and MINUS, once the side to hash is done, the rows of the other
+ * side are probed batch by batch as they come, rather than held until it is done.
+ * MINUS always hashes the right side. INTERSECT hashes the side done first if it
+ * is no larger than the other one is so far, otherwise the smaller one once both
+ * are done. UNION keeps every row anyway, so it combines both sides at the end.
+ */
+class SetExecutor final : public TraverseExecutor {
+public:
+    SetExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "SetExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+    // Both sides are fed with the input
+    void feedResult(std::unique_ptr<InterimResult> result) override;
+
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+    std::vector<std::string> getResultColumnNames() const override {
+        return left_->getResultColumnNames();
+    }
+
+private:
+    enum Side : size_t {
+        kLeft = 0,
+        kRight = 1,
+    };
+
+    /**
+     * A batch of rows of one side, probed at once if that side is being probed.
+     */
+    void onSideResult(Side side, std::unique_ptr<InterimResult> result);
+
+    /**
+     * One side is done, with `status' not ok on failure.
+     */
+    void onSideDone(Side side, Status status);
+
+    /**
+     * Hash the rows of the other side, then probe the rows of `side' held so far.
+     * `lock_' is held.
+     */
+    void startProbing(Side side);
+
+    // `lock_' is held.
+    void probe(std::unique_ptr<InterimResult> batch);
+
+    StatusOr<std::unique_ptr<InterimResult>> combine();
+
+    static Status checkSchemas(const InterimResult &left, const InterimResult &right);
+
+    using RowSet = std::unordered_set<folly::StringPiece>;
+
+    /**
+     * The rows of either side.
+     */
+    void doUnion(std::vector<folly::StringPiece> &left,
+                 std::vector<folly::StringPiece> &right,
+                 RowSetWriter &writer) const;
+
+    /**
+     * The rows of both sides. The smaller side is hashed, the larger one probes it.
+     */
+    void doIntersect(std::vector<folly::StringPiece> &left,
+                     std::vector<folly::StringPiece> &right,
+                     RowSetWriter &writer) const;
+
+    /**
+     * The rows of the left side but not of the right side.
+     */
+    void doMinus(std::vector<folly::StringPiece> &left,
+                 std::vector<folly::StringPiece> &right,
+                 RowSetWriter &writer) const;
+
+private:
+    SetSentence                                *sentence_{nullptr};
+    std::unique_ptr<TraverseExecutor>           left_;
+    std::unique_ptr<TraverseExecutor>           right_;
+    std::mutex                                  lock_;
+    // The rows of each side held until combined, or hashed
+    std::unique_ptr<InterimResult>              results_[2];
+    size_t                                      numSidesDone_{0};
+    Status                                      status_;
+    // The side probed batch by batch, if any
+    folly::Optional<Side>                       probeSide_;
+    // The rows hashed, and for MINUS the rows taken
+    RowSet                                      hashed_;
+    // The batches probed holding some of the rows taken
+    std::vector<std::unique_ptr<InterimResult>> probed_;
+    std::unique_ptr<RowSetWriter>               writer_;
+    // The result, if this is the right most executor
+    std::unique_ptr<InterimResult>              result_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+
+#endif  // GRAPH_SETEXECUTOR_H_
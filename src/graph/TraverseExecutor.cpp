@@ -8,12 +8,33 @@
 #include "graph/TraverseExecutor.h"
 #include "parser/TraverseSentences.h"
 #include "graph/GoExecutor.h"
+#include "graph/FindExecutor.h"
 #include "graph/PipeExecutor.h"
 #include "graph/OrderByExecutor.h"
+#include "graph/SetExecutor.h"
+
+DEFINE_int32(traverse_batch_rows, 10000,
+             "Max rows of a batch handed from one executor to the next inside a pipeline, "
+             "so that the next one could start on the first batches early");
 
 namespace nebula {
 namespace graph {
 
+void TraverseExecutor::feedBatch(std::unique_ptr<InterimResult> batch) {
+    if (pendingBatches_ == nullptr) {
+        pendingBatches_ = std::move(batch);
+    } else {
+        pendingBatches_->append(std::move(batch));
+    }
+}
+
+
+void TraverseExecutor::finishBatches() {
+    feedResult(std::move(pendingBatches_));
+    execute();
+}
+
+
 std::unique_ptr<TraverseExecutor> TraverseExecutor::makeTraverseExecutor(Sentence *sentence) {
     return makeTraverseExecutor(sentence, ectx());
 }
@@ -28,12 +49,18 @@ TraverseExecutor::makeTraverseExecutor(Sentence *sentence, ExecutionContext *ect
         case Sentence::Kind::kGo:
             executor = std::make_unique<GoExecutor>(sentence, ectx);
             break;
+        case Sentence::Kind::kFind:
+            executor = std::make_unique<FindExecutor>(sentence, ectx);
+            break;
         case Sentence::Kind::kPipe:
             executor = std::make_unique<PipeExecutor>(sentence, ectx);
             break;
         case Sentence::Kind::kOrderBy:
             executor = std::make_unique<OrderByExecutor>(sentence, ectx);
             break;
+        case Sentence::Kind::kSet:
+            executor = std::make_unique<SetExecutor>(sentence, ectx);
+            break;
         case Sentence::Kind::kUnknown:
             LOG(FATAL) << "Sentence kind unknown";
             break;
@@ -56,6 +56,24 @@ public:
 
     virtual void feedResult(std::unique_ptr<InterimResult> result) = 0;
 
+    /**
+     * Inside a pipeline, the results of the left executor are fed to the right one
+     * batch by batch via `feedBatch()', then `finishBatches()' is invoked once the
+     * left one is finished.
+     *
+     * By default, the batches are held until all of them arrive, then fed as a
+     * whole via `feedResult()' and the executor starts. The streaming executors
+     * start working on each batch as it comes instead. The batches are never fed
+     * concurrently.
+     */
+    virtual void feedBatch(std::unique_ptr<InterimResult> batch);
+
+    virtual void finishBatches();
+
+    virtual bool isStreaming() const {
+        return false;
+    }
+
     /**
      * `onResult_' must be set except for the right most executor
      * inside the chain of pipeline.
@@ -65,11 +83,22 @@ public:
      * it means that this executor is the right most one, whose results must
      * be cached during its execution and are to be used to fill `ExecutionResponse'
      * upon `setupResponse()'s invoke.
+     *
+     * `onResult_' might be invoked several times, each with a batch of
+     * no more than `traverse_batch_rows' rows, but never concurrently.
      */
     void setOnResult(OnResult onResult) {
         onResult_ = std::move(onResult);
     }
 
+    /**
+     * The names of the result columns, known once prepared, so the response
+     * has them even without any row. Empty if only the rows tell them.
+     */
+    virtual std::vector<std::string> getResultColumnNames() const {
+        return {};
+    }
+
     static std::unique_ptr<TraverseExecutor>
     makeTraverseExecutor(Sentence *sentence, ExecutionContext *ectx);
 
@@ -78,6 +107,8 @@ protected:
 
 protected:
     OnResult                                    onResult_;
+    // The batches held until `finishBatches()'
+    std::unique_ptr<InterimResult>              pendingBatches_;
 };
 
 }   // namespace graph
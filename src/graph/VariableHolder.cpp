@@ -34,11 +34,13 @@ VariableHolder& VariableHolder::operator=(VariableHolder &&rhs) noexcept {
 
 
 void VariableHolder::add(const std::string &var, std::unique_ptr<InterimResult> result) {
+    std::lock_guard<std::mutex> g(lock_);
     holder_[var] = std::move(result);
 }
 
 
 const InterimResult* VariableHolder::get(const std::string &var, bool *existing) const {
+    std::lock_guard<std::mutex> g(lock_);
     auto iter = holder_.find(var);
     if (iter == holder_.end()) {
         if (existing != nullptr) {
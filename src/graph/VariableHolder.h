@@ -27,6 +27,8 @@ public:
     const InterimResult* get(const std::string &var, bool *existing = nullptr) const;
 
 private:
+    // The statements independent of each other might run concurrently
+    mutable std::mutex                                               lock_;
     std::unordered_map<std::string, std::unique_ptr<InterimResult>> holder_;
 };
 
@@ -11,6 +11,7 @@
 #include "meta/test/TestUtils.h"
 
 DECLARE_int32(load_data_interval_secs);
+DECLARE_int32(traverse_batch_rows);
 
 namespace nebula {
 namespace graph {
@@ -115,6 +116,117 @@ TEST_F(GoTest, OneStepOutBound) {
 }
 
 
+TEST_F(GoTest, StreamingPipe) {
+    // Every row goes down the pipeline in a batch of its own
+    FLAGS_traverse_batch_rows = 1;
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto *fmt = "GO FROM %ld OVER like "
+                    "| GO FROM $-.id OVER like | GO FROM $-.id OVER serve";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {teams_["Spurs"].vid()},
+            {teams_["Spurs"].vid()},
+            {teams_["Spurs"].vid()},
+            {teams_["Spurs"].vid()},
+            {teams_["Spurs"].vid()},
+            {teams_["Hornets"].vid()},
+            {teams_["Trail Blazers"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tracy McGrady"];
+        auto *fmt = "$var = (GO FROM %ld OVER like | GO FROM $- OVER like);"
+                    "GO FROM $var OVER like";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<uint64_t>> expected = {
+            {players_["Kobe Bryant"].vid()},
+            {players_["Grant Hill"].vid()},
+            {players_["Rudy Gay"].vid()},
+            {players_["Tony Parker"].vid()},
+            {players_["Tim Duncan"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like "
+                    "| GO FROM $-.id OVER like | GO FROM $-.id OVER serve";
+        auto query = folly::stringPrintf(fmt, -1L);
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like "
+                    "| GO FROM $-.id OVER serve YIELD serve._dst AS team";
+        auto query = folly::stringPrintf(fmt, -1L);
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        // The columns are there even if no row is
+        ASSERT_NE(nullptr, resp.get_column_names());
+        ASSERT_EQ(std::vector<std::string>{"team"}, *resp.get_column_names());
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+    FLAGS_traverse_batch_rows = 10000;
+}
+
+
+TEST_F(GoTest, UptoSteps) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO UPTO 2 STEPS FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        // Tim Duncan is not expanded again in the second step
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Tony Parker"].vid()},
+            {players_["Manu Ginobili"].vid()},
+            {players_["Tim Duncan"].vid()},
+            {players_["Manu Ginobili"].vid()},
+            {players_["LaMarcus Aldridge"].vid()},
+            {players_["Tim Duncan"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO UPTO 2 STEPS FROM %ld OVER like YIELD DISTINCT like._dst";
+        auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Tony Parker"].vid()},
+            {players_["Manu Ginobili"].vid()},
+            {players_["Tim Duncan"].vid()},
+            {players_["LaMarcus Aldridge"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        // Stops once no vertex is left to expand
+        auto *fmt = "GO UPTO 5 STEPS FROM %ld OVER serve";
+        auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {teams_["Spurs"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
+
 TEST_F(GoTest, AssignmentSimple) {
     {
         cpp2::ExecutionResponse resp;
@@ -154,6 +266,31 @@ TEST_F(GoTest, AssignmentPipe) {
 }
 
 
+TEST_F(GoTest, AssignmentIndependent) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tracy McGrady"];
+        // `$other' runs along with the first one, `$var' is reassigned
+        // only after it has been read
+        auto *fmt = "$var = GO FROM %ld OVER like;"
+                    "$other = GO FROM %ld OVER serve;"
+                    "$var = GO FROM $var.id OVER like;"
+                    "GO FROM $var.id OVER like";
+        auto query = folly::stringPrintf(fmt, player.vid(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<uint64_t>> expected = {
+            {players_["Kobe Bryant"].vid()},
+            {players_["Grant Hill"].vid()},
+            {players_["Rudy Gay"].vid()},
+            {players_["Tony Parker"].vid()},
+            {players_["Tim Duncan"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
+
 TEST_F(GoTest, VariableUndefined) {
     {
         cpp2::ExecutionResponse resp;
@@ -178,8 +315,7 @@ TEST_F(GoTest, AssignmentEmptyResult) {
 }
 
 
-// REVERSELY not supported yet
-TEST_F(GoTest, DISABLED_OneStepInBound) {
+TEST_F(GoTest, OneStepInBound) {
     {
         cpp2::ExecutionResponse resp;
         auto *fmt = "GO FROM %ld OVER serve REVERSELY";
@@ -191,13 +327,49 @@ TEST_F(GoTest, DISABLED_OneStepInBound) {
             {players_["Russell Westbrook"].vid()},
             {players_["Kevin Durant"].vid()},
             {players_["James Harden"].vid()},
+            {players_["Carmelo Anthony"].vid()},
+            {players_["Paul George"].vid()},
+            {players_["Ray Allen"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        // The props of the in-edges are read from the out-edges
+        auto *fmt = "GO FROM %ld OVER serve REVERSELY "
+                    "YIELD serve._dst, serve.start_year, serve.end_year";
+        auto &team = teams_["Thunders"];
+        auto query = folly::stringPrintf(fmt, team.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t, int64_t, int64_t>> expected = {
+            {players_["Russell Westbrook"].vid(), 2008, 2019},
+            {players_["Kevin Durant"].vid(), 2007, 2016},
+            {players_["James Harden"].vid(), 2009, 2012},
+            {players_["Carmelo Anthony"].vid(), 2017, 2018},
+            {players_["Paul George"].vid(), 2017, 2019},
+            {players_["Ray Allen"].vid(), 2003, 2007},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like REVERSELY "
+                    "WHERE like.likeness > 80 YIELD like._dst, like.likeness";
+        auto &player = players_["Tim Duncan"];
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t, int64_t>> expected = {
+            {players_["Tony Parker"].vid(), 95},
+            {players_["Manu Ginobili"].vid(), 90},
+            {players_["Dejounte Murray"].vid(), 99},
         };
         ASSERT_TRUE(verifyResult(resp, expected));
     }
 }
 
-// REVERSELY not supported yet
-TEST_F(GoTest, DISABLED_OneStepInOutBound) {
+TEST_F(GoTest, OneStepInOutBound) {
     // Ever served in the same team
     {
         cpp2::ExecutionResponse resp;
@@ -210,11 +382,36 @@ TEST_F(GoTest, DISABLED_OneStepInOutBound) {
             {players_["LeBron James"].vid()},
             {players_["Rajon Rondo"].vid()},
             {players_["Kobe Bryant"].vid()},
+            {players_["Steve Nash"].vid()},
+            {players_["Paul Gasol"].vid()},
+            {players_["Shaquile O'Neal"].vid()},
+            {players_["JaVale McGee"].vid()},
+            {players_["Dwight Howard"].vid()},
         };
         ASSERT_TRUE(verifyResult(resp, expected));
     }
-    // Ever been teammates
+}
+
+TEST_F(GoTest, OneStepBidirect) {
     {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like BIDIRECT YIELD like._dst, like.likeness";
+        auto &player = players_["Tim Duncan"];
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t, int64_t>> expected;
+        for (auto &like : player.likes()) {
+            expected.emplace_back(players_[std::get<0>(like)].vid(), std::get<1>(like));
+        }
+        for (auto &other : players_) {
+            for (auto &like : other.likes()) {
+                if (std::get<0>(like) == player.name()) {
+                    expected.emplace_back(other.vid(), std::get<1>(like));
+                }
+            }
+        }
+        ASSERT_TRUE(verifyResult(resp, expected));
     }
 }
 
@@ -0,0 +1,202 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "meta/test/TestUtils.h"
+
+DECLARE_int32(load_data_interval_secs);
+DECLARE_int32(traverse_batch_rows);
+
+namespace nebula {
+namespace graph {
+
+class SetTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(SetTest, Union) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like UNION GO FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Tony Parker"].vid()},
+            {players_["Manu Ginobili"].vid()},
+            {players_["Tim Duncan"].vid()},
+            {players_["LaMarcus Aldridge"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve YIELD $$.team.name "
+                    "UNION GO FROM %ld OVER serve YIELD $$.team.name "
+                    "UNION GO FROM %ld OVER serve YIELD $$.team.name";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid(),
+                                         players_["Manu Ginobili"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string>> expected = {
+            {"Spurs"},
+            {"Hornets"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
+TEST_F(SetTest, Intersect) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like INTERSECT GO FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Manu Ginobili"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve INTERSECT GO FROM %ld OVER serve";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tony Parker"].vid(),
+                                         players_["Boris Diaw"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {teams_["Spurs"].vid()},
+            {teams_["Hornets"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
+TEST_F(SetTest, Minus) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like MINUS GO FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tony Parker"].vid(),
+                                         players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Tim Duncan"].vid()},
+            {players_["LaMarcus Aldridge"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve MINUS GO FROM %ld OVER serve";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve YIELD serve._dst AS team "
+                    "MINUS GO FROM %ld OVER serve YIELD serve._dst AS team";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        // The columns are there even if no row is
+        ASSERT_NE(nullptr, resp.get_column_names());
+        ASSERT_EQ(std::vector<std::string>{"team"}, *resp.get_column_names());
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+}
+
+TEST_F(SetTest, Batches) {
+    // Every row comes in a batch of its own, so the probe side is probed row by row
+    FLAGS_traverse_batch_rows = 1;
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like INTERSECT GO FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Manu Ginobili"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like MINUS GO FROM %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tony Parker"].vid(),
+                                         players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {players_["Tim Duncan"].vid()},
+            {players_["LaMarcus Aldridge"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    FLAGS_traverse_batch_rows = 10000;
+}
+
+TEST_F(SetTest, Piped) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER like "
+                    "| (GO FROM $-.id OVER serve UNION GO FROM $-.id OVER serve)";
+        auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {teams_["Spurs"].vid()},
+            {teams_["Hornets"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
+TEST_F(SetTest, ColumnsMismatch) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve YIELD serve.start_year, serve.end_year "
+                    "UNION GO FROM %ld OVER serve";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_NE(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -71,6 +71,12 @@ struct ColumnDef {
 struct SchemaProp {
     1: optional i64      ttl_duration,
     2: optional string   ttl_col,
+    // Only for edges. Keep a copy of the props on the in-edges as well, so reading
+    // them reversely costs no lookup of the out-edges, at the price of the space.
+    // Otherwise the in-edges are written without props, unless the edge has a ttl
+    3: optional bool     inbound_props,
+    // The columns indexed, each one by a secondary index of its own
+    4: optional list<string> indexes,
 }
 
 struct Schema {
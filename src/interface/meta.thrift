@@ -84,6 +84,8 @@ struct SpaceProperties {
     1: string               space_name,
     2: i32                  partition_num,
     3: i32                  replica_factor,
+    // If true, keys carry no version suffix and every write overwrites in place.
+    4: bool                 single_version,
 }
 
 struct SpaceItem {
@@ -291,6 +293,8 @@ struct GetPartsAllocResp {
     // Valid if ret equals E_LEADER_CHANGED.
     2: common.HostAddr  leader,
     3: map<common.PartitionID, list<common.HostAddr>>(cpp.template = "std::unordered_map") parts,
+    // The properties of the space, so the clients loading it need no getSpace.
+    4: SpaceProperties  properties,
 }
 
 struct MultiPutReq {
@@ -350,8 +354,38 @@ struct HBResp {
     2: common.HostAddr  leader,
 }
 
+// The load of one partition replica on the host
+struct PartStats {
+    1: common.PartitionID part_id,
+    // Estimated bytes on disk
+    2: i64 disk_size,
+    3: i64 read_qps,
+    4: i64 write_qps,
+    5: bool is_leader,
+}
+
 struct HBReq {
     1: common.HostAddr host,
+    // Only sent by the storage hosts
+    2: optional map<common.GraphSpaceID, list<PartStats>>
+        (cpp.template = "std::unordered_map") part_stats,
+}
+
+struct GetMetaChangesReq {
+    // The meta version the client loaded, 0 if nothing loaded yet
+    1: i64 since_version,
+}
+
+struct GetMetaChangesResp {
+    1: ErrorCode code,
+    // Valid if ret equals E_LEADER_CHANGED.
+    2: common.HostAddr  leader,
+    // The current meta version
+    3: i64 version,
+    // True if the changes since the version are not kept, the client should reload all
+    4: bool full_reload,
+    // The spaces whose properties, parts allocation or schemas changed since the version
+    5: list<common.GraphSpaceID> spaces,
 }
 
 struct CreateUserReq {
@@ -426,11 +460,38 @@ struct BalanceReq {
     2: optional i64 id,
 }
 
+// The progress of moving one part replica in a balance plan
+struct BalanceTaskProgress {
+    1: common.GraphSpaceID  space_id,
+    2: common.PartitionID   part_id,
+    3: common.HostAddr      src,
+    4: common.HostAddr      dst,
+    5: string               status,
+    6: string               result,
+    // Estimated by the part sizes on src and dst reported by heartbeats
+    7: i64                  bytes_copied,
+    8: i64                  total_bytes,
+    // Estimated seconds to finish, -1 if unknown
+    9: i64                  eta_secs,
+    10: i64                 start_time,
+    11: i64                 end_time,
+}
+
 struct BalanceResp {
     1: ErrorCode        code,
     2: i64              id,
     // Valid if code equals E_LEADER_CHANGED.
     3: common.HostAddr  leader,
+    // The fields below are only valid when checking the status of a balance plan
+    4: string           status,
+    5: list<BalanceTaskProgress> tasks,
+    6: i64              bytes_copied,
+    7: i64              total_bytes,
+    // Estimated seconds to finish, -1 if unknown
+    8: i64              eta_secs,
+}
+
+struct LeaderBalanceReq {
 }
 
 enum ConfigModule {
@@ -534,7 +595,9 @@ service MetaService {
     ExecResp checkPassword(1: CheckPasswordReq req);
 
     HBResp           heartBeat(1: HBReq req);
+    GetMetaChangesResp getMetaChanges(1: GetMetaChangesReq req);
     BalanceResp      balance(1: BalanceReq req);
+    ExecResp         leaderBalance(1: LeaderBalanceReq req);
 
     ExecResp regConfig(1: RegConfigReq req);
     GetConfigResp getConfig(1: GetConfigReq req);
@@ -53,6 +53,9 @@ struct AskForVoteRequest {
     5: TermID       term;               // Proposed term
     6: LogID        last_log_id;        // The last received log id
     7: TermID       last_log_term;      // The term receiving the last log
+    // The leader asked the candidate to take over, so the voters still
+    // hearing from the leader vote for it anyway
+    8: bool         leader_transfer = false;
 }
 
 
@@ -122,9 +125,62 @@ struct AppendLogResponse {
 }
 
 
+/*
+  HeartbeatRequest carries the heartbeats of all the partitions led by one
+  host and followed by another, so the idle partitions between the two hosts
+  cost one request per heartbeat interval, instead of one request each.
+
+  A partition only takes it when it follows the same leader in the same term,
+  otherwise the leader falls back to AppendLogRequest.
+*/
+struct HeartbeatItem {
+    1: GraphSpaceID space;
+    2: PartitionID  part;
+    3: TermID       current_term;
+    4: LogID        committed_log_id;   // Last committed Log ID
+    5: LogID        last_log_id;        // The leader's last log id
+    6: TermID       last_log_term;      // The leader's last log term
+}
+
+
+struct HeartbeatRequest {
+    1: IPv4                 leader_ip;
+    2: Port                 leader_port;
+    3: list<HeartbeatItem>  items;
+}
+
+
+struct HeartbeatResponse {
+    // One for each item of the request, in the same order
+    1: list<ErrorCode> results;
+}
+
+
+/*
+  TransferLeaderRequest is sent by the leader to the peer taking over the
+  leadership. The peer starts an election at once, if it has received all
+  the logs up to last_log_id in the current term.
+*/
+struct TransferLeaderRequest {
+    1: GraphSpaceID space;
+    2: PartitionID  part;
+    3: TermID       current_term;
+    4: IPv4         leader_ip;
+    5: Port         leader_port;
+    6: LogID        last_log_id;        // The leader's last log id
+}
+
+
+struct TransferLeaderResponse {
+    1: ErrorCode error_code;
+}
+
+
 service RaftexService {
     AskForVoteResponse askForVote(1: AskForVoteRequest req);
     AppendLogResponse appendLog(1: AppendLogRequest req);
+    HeartbeatResponse heartbeat(1: HeartbeatRequest req);
+    TransferLeaderResponse transferLeader(1: TransferLeaderRequest req);
 }
 
 
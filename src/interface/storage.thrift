@@ -79,6 +79,9 @@ struct QueryResponse {
     2: optional common.Schema vertex_schema,   // vertex related props
     3: optional common.Schema edge_schema,     // edge related props
     4: optional list<VertexData> vertices,
+    // Set instead of vertices when the request asks for dst_ids_only.
+    // The sorted and unique dst ids, packed as an array of little-endian int64
+    5: optional binary dst_ids,
 }
 
 struct ExecResponse {
@@ -130,12 +133,20 @@ struct GetNeighborsRequest {
     3: common.EdgeType edge_type,
     4: binary filter,
     5: list<PropDef> return_columns,
+    // When positive, the request could be served by a follower lagging behind
+    // no longer than that, otherwise only by the leader
+    6: i64 max_staleness_ms = 0,
+    // Only the dst ids of the edges are returned, in QueryResponse.dst_ids.
+    // It is meant for the intermediate steps of a traversal, the tag props
+    // and the props other than _dst are not returned then
+    7: bool dst_ids_only = false,
 }
 
 struct VertexPropRequest {
     1: common.GraphSpaceID space_id,
     2: map<common.PartitionID, list<common.VertexID>>(cpp.template = "std::unordered_map") parts,
     3: list<PropDef> return_columns,
+    4: i64 max_staleness_ms = 0,
 }
 
 struct EdgePropRequest {
@@ -145,6 +156,25 @@ struct EdgePropRequest {
     3: common.EdgeType edge_type,
     4: binary filter,
     5: list<PropDef> return_columns,
+    6: i64 max_staleness_ms = 0,
+}
+
+// Scan the index on the prop of a tag, or an edge type if is_edge, for the values
+// within [lower, upper]. Bounds not set are unbounded. Both are encoded the same
+// way as the index keys.
+struct LookUpIndexRequest {
+    1: common.GraphSpaceID space_id,
+    // Only the partIds are used, the lists are empty
+    2: map<common.PartitionID, list<common.VertexID>>(cpp.template = "std::unordered_map") parts,
+    3: i32 schema_id,
+    4: bool is_edge,
+    5: string prop,
+    6: optional binary lower,
+    7: bool include_lower = true,
+    8: optional binary upper,
+    9: bool include_upper = true,
+    10: list<PropDef> return_columns,
+    11: i64 max_staleness_ms = 0,
 }
 
 struct AddVerticesRequest {
@@ -215,6 +245,10 @@ service StorageService {
     QueryResponse getProps(1: VertexPropRequest req);
     EdgePropResponse getEdgeProps(1: EdgePropRequest req)
 
+    // Props of the vertices, or the edges, found by the index
+    QueryResponse lookUpVertexIndex(1: LookUpIndexRequest req);
+    EdgePropResponse lookUpEdgeIndex(1: LookUpIndexRequest req);
+
     ExecResponse addVertices(1: AddVerticesRequest req);
     ExecResponse addEdges(1: AddEdgesRequest req);
 
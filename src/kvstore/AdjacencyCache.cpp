@@ -0,0 +1,381 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "kvstore/AdjacencyCache.h"
+#include <folly/ScopeGuard.h>
+#include "base/NebulaKeyUtils.h"
+
+DEFINE_int32(adjacency_cache_delta_percent, 10,
+             "Merge the edges added to the adjacency cache into its snapshot "
+             "once they exceed this percentage of the snapshot");
+
+namespace nebula {
+namespace kvstore {
+
+namespace {
+
+// Below this the delta is cheap enough to look up, no matter how small the snapshot is
+constexpr size_t kMinDeltaToMerge = 4096;
+
+// Insert into the sorted edges, false if it is there already
+bool insertSorted(std::vector<AdjacencyCache::Edge>& edges, const AdjacencyCache::Edge& edge) {
+    auto it = std::lower_bound(edges.begin(), edges.end(), edge);
+    if (it != edges.end() && *it == edge) {
+        return false;
+    }
+    edges.insert(it, edge);
+    return true;
+}
+
+// Erase from the sorted edges, false if it is not there
+bool eraseSorted(std::vector<AdjacencyCache::Edge>& edges, const AdjacencyCache::Edge& edge) {
+    auto it = std::lower_bound(edges.begin(), edges.end(), edge);
+    if (it == edges.end() || !(*it == edge)) {
+        return false;
+    }
+    edges.erase(it);
+    return true;
+}
+
+}  // Anonymous namespace
+
+
+void AdjacencyCache::Csr::append(VertexID vId, const std::vector<Edge>& edges) {
+    if (edges.empty()) {
+        return;
+    }
+    vids_.emplace_back(vId);
+    for (auto& edge : edges) {
+        types_.emplace_back(edge.type_);
+        ranks_.emplace_back(edge.rank_);
+        dsts_.emplace_back(edge.dst_);
+    }
+    offsets_.emplace_back(types_.size());
+}
+
+
+std::pair<size_t, size_t> AdjacencyCache::Csr::find(VertexID vId) const {
+    auto it = std::lower_bound(vids_.begin(), vids_.end(), vId);
+    if (it == vids_.end() || *it != vId) {
+        return std::make_pair(0, 0);
+    }
+    auto index = it - vids_.begin();
+    return std::make_pair(offsets_[index], offsets_[index + 1]);
+}
+
+
+bool AdjacencyCache::Csr::contains(VertexID vId, const Edge& edge) const {
+    auto range = find(vId);
+    // Binary search on the indexes of the vertex's edges
+    size_t lo = range.first;
+    size_t hi = range.second;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (Edge{types_[mid], ranks_[mid], dsts_[mid]} < edge) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < range.second && Edge{types_[lo], ranks_[lo], dsts_[lo]} == edge;
+}
+
+
+ResultCode AdjacencyCache::build(KVEngine* engine) {
+    bool expected = false;
+    if (!building_.compare_exchange_strong(expected, true)) {
+        VLOG(1) << "Part " << partId_ << " adjacency cache is being built";
+        return ResultCode::SUCCEEDED;
+    }
+    // Cleared along with setting ready_ on success, otherwise here.
+    bool built = false;
+    SCOPE_EXIT {
+        if (!built) {
+            building_.store(false, std::memory_order_release);
+        }
+    };
+
+    int64_t generation = 0;
+    {
+        folly::RWSpinLock::WriteHolder wh(lock_);
+        generation = generation_;
+        pending_.clear();
+    }
+
+    while (true) {
+        // Changes committed from now on are either in pending_ or seen by the scan, or both.
+        Csr csr;
+        auto ret = scan(engine, &csr);
+        if (ret != ResultCode::SUCCEEDED) {
+            return ret;
+        }
+
+        folly::RWSpinLock::WriteHolder wh(lock_);
+        if (generation != generation_) {
+            // Nobody else would build it while we are building, so scan again.
+            LOG(INFO) << "Part " << partId_ << " adjacency cache invalidated while building";
+            generation = generation_;
+            pending_.clear();
+            continue;
+        }
+        csr_ = std::move(csr);
+        delta_.clear();
+        deltaSize_ = 0;
+        tombstones_.clear();
+        tombstonesSize_ = 0;
+        for (auto& change : pending_) {
+            if (change.removed_) {
+                removeEdge(change.vId_, change.edge_);
+            } else {
+                addEdge(change.vId_, change.edge_);
+            }
+        }
+        pending_.clear();
+        // Under lock_, so any invalidate() from now on sees needBuild()
+        ready_.store(true, std::memory_order_release);
+        building_.store(false, std::memory_order_release);
+        built = true;
+        LOG(INFO) << "Part " << partId_ << " adjacency cache built, " << csr_.vids_.size()
+                  << " vertices, " << csr_.types_.size() + deltaSize_ - tombstonesSize_
+                  << " edges";
+        return ResultCode::SUCCEEDED;
+    }
+}
+
+
+ResultCode AdjacencyCache::scan(KVEngine* engine, Csr* csr) const {
+    std::string prefix(reinterpret_cast<const char*>(&partId_), sizeof(PartitionID));
+    std::unique_ptr<KVIterator> iter;
+    auto ret = engine->prefix(prefix, &iter, ScanType::EDGE);
+    if (ret != ResultCode::SUCCEEDED) {
+        LOG(ERROR) << "Part " << partId_ << " failed to scan the edges, ret " << ret;
+        return ret;
+    }
+    std::vector<std::pair<VertexID, Edge>> edges;
+    for (; iter->valid(); iter->next()) {
+        auto key = iter->key();
+        if (!NebulaKeyUtils::isEdge(key)) {
+            continue;
+        }
+        edges.emplace_back(NebulaKeyUtils::getSrcId(key),
+                           Edge{NebulaKeyUtils::getEdgeType(key),
+                                NebulaKeyUtils::getRank(key),
+                                NebulaKeyUtils::getDstId(key)});
+    }
+    // Different versions of one edge collapse into one entry
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<Edge> vEdges;
+    for (size_t i = 0; i < edges.size(); i++) {
+        vEdges.emplace_back(edges[i].second);
+        if (i + 1 == edges.size() || edges[i + 1].first != edges[i].first) {
+            csr->append(edges[i].first, vEdges);
+            vEdges.clear();
+        }
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
+void AdjacencyCache::addEdges(const std::vector<std::pair<VertexID, Edge>>& edges) {
+    if (edges.empty()) {
+        return;
+    }
+    folly::RWSpinLock::WriteHolder wh(lock_);
+    if (!ready()) {
+        if (building_.load(std::memory_order_acquire)) {
+            for (auto& edge : edges) {
+                pending_.emplace_back(Change{edge.first, edge.second, false});
+            }
+        }
+        return;
+    }
+    for (auto& edge : edges) {
+        addEdge(edge.first, edge.second);
+    }
+    mergeIfNeeded();
+}
+
+
+void AdjacencyCache::removeEdges(const std::vector<std::pair<VertexID, Edge>>& edges) {
+    if (edges.empty()) {
+        return;
+    }
+    folly::RWSpinLock::WriteHolder wh(lock_);
+    if (!ready()) {
+        if (building_.load(std::memory_order_acquire)) {
+            for (auto& edge : edges) {
+                pending_.emplace_back(Change{edge.first, edge.second, true});
+            }
+        }
+        return;
+    }
+    for (auto& edge : edges) {
+        removeEdge(edge.first, edge.second);
+    }
+    mergeIfNeeded();
+}
+
+
+void AdjacencyCache::addEdge(VertexID vId, const Edge& edge) {
+    if (csr_.contains(vId, edge)) {
+        // Added back after being removed
+        auto it = tombstones_.find(vId);
+        if (it != tombstones_.end() && eraseSorted(it->second, edge)) {
+            tombstonesSize_--;
+            if (it->second.empty()) {
+                tombstones_.erase(it);
+            }
+        }
+        return;
+    }
+    if (insertSorted(delta_[vId], edge)) {
+        deltaSize_++;
+    }
+}
+
+
+void AdjacencyCache::removeEdge(VertexID vId, const Edge& edge) {
+    if (csr_.contains(vId, edge)) {
+        if (insertSorted(tombstones_[vId], edge)) {
+            tombstonesSize_++;
+        }
+        return;
+    }
+    auto it = delta_.find(vId);
+    if (it != delta_.end() && eraseSorted(it->second, edge)) {
+        deltaSize_--;
+        if (it->second.empty()) {
+            delta_.erase(it);
+        }
+    }
+}
+
+
+void AdjacencyCache::mergeIfNeeded() {
+    auto threshold = csr_.types_.size() * FLAGS_adjacency_cache_delta_percent / 100;
+    if (deltaSize_ + tombstonesSize_ > std::max(kMinDeltaToMerge, threshold)) {
+        merge();
+    }
+}
+
+
+void AdjacencyCache::merge() {
+    std::vector<VertexID> deltaVids;
+    deltaVids.reserve(delta_.size());
+    for (auto& d : delta_) {
+        deltaVids.emplace_back(d.first);
+    }
+    std::sort(deltaVids.begin(), deltaVids.end());
+
+    Csr csr;
+    csr.vids_.reserve(csr_.vids_.size() + deltaVids.size());
+    auto total = csr_.types_.size() + deltaSize_ - tombstonesSize_;
+    csr.types_.reserve(total);
+    csr.ranks_.reserve(total);
+    csr.dsts_.reserve(total);
+
+    size_t i = 0;
+    size_t j = 0;
+    std::vector<Edge> vEdges;
+    while (i < csr_.vids_.size() || j < deltaVids.size()) {
+        bool fromCsr = i < csr_.vids_.size()
+                    && (j == deltaVids.size() || csr_.vids_[i] <= deltaVids[j]);
+        bool fromDelta = j < deltaVids.size()
+                      && (i == csr_.vids_.size() || deltaVids[j] <= csr_.vids_[i]);
+        VertexID vId = 0;
+        vEdges.clear();
+        if (fromCsr) {
+            vId = csr_.vids_[i];
+            auto it = tombstones_.find(vId);
+            for (auto k = csr_.offsets_[i]; k < csr_.offsets_[i + 1]; k++) {
+                Edge edge{csr_.types_[k], csr_.ranks_[k], csr_.dsts_[k]};
+                if (it == tombstones_.end()
+                        || !std::binary_search(it->second.begin(), it->second.end(), edge)) {
+                    vEdges.emplace_back(edge);
+                }
+            }
+            i++;
+        }
+        if (fromDelta) {
+            vId = deltaVids[j];
+            auto& dEdges = delta_[vId];
+            auto middle = vEdges.size();
+            vEdges.insert(vEdges.end(), dEdges.begin(), dEdges.end());
+            std::inplace_merge(vEdges.begin(), vEdges.begin() + middle, vEdges.end());
+            j++;
+        }
+        csr.append(vId, vEdges);
+    }
+
+    VLOG(1) << "Part " << partId_ << " merged " << deltaSize_ << " added and "
+            << tombstonesSize_ << " removed edges into the adjacency cache snapshot";
+    csr_ = std::move(csr);
+    delta_.clear();
+    deltaSize_ = 0;
+    tombstones_.clear();
+    tombstonesSize_ = 0;
+}
+
+
+void AdjacencyCache::invalidate() {
+    folly::RWSpinLock::WriteHolder wh(lock_);
+    ready_.store(false, std::memory_order_release);
+    generation_++;
+    csr_ = Csr();
+    delta_.clear();
+    deltaSize_ = 0;
+    tombstones_.clear();
+    tombstonesSize_ = 0;
+    pending_.clear();
+}
+
+
+bool AdjacencyCache::getEdges(VertexID vId, EdgeType type, std::vector<Edge>* edges) const {
+    folly::RWSpinLock::ReadHolder rh(lock_);
+    if (!ready()) {
+        return false;
+    }
+    auto start = edges->size();
+    auto range = csr_.find(vId);
+    // The edges of one vertex are sorted by type first
+    auto typesBegin = csr_.types_.begin() + range.first;
+    auto typesEnd = csr_.types_.begin() + range.second;
+    auto lo = std::lower_bound(typesBegin, typesEnd, type) - csr_.types_.begin();
+    auto hi = std::upper_bound(typesBegin, typesEnd, type) - csr_.types_.begin();
+    auto removed = tombstones_.find(vId);
+    for (auto k = lo; k < hi; k++) {
+        Edge edge{type, csr_.ranks_[k], csr_.dsts_[k]};
+        if (removed == tombstones_.end()
+                || !std::binary_search(removed->second.begin(), removed->second.end(), edge)) {
+            edges->emplace_back(edge);
+        }
+    }
+
+    auto it = delta_.find(vId);
+    if (it != delta_.end()) {
+        auto middle = edges->size();
+        for (auto& edge : it->second) {
+            if (edge.type_ == type) {
+                edges->emplace_back(edge);
+            }
+        }
+        std::inplace_merge(edges->begin() + start,
+                           edges->begin() + middle,
+                           edges->end());
+    }
+    return true;
+}
+
+
+size_t AdjacencyCache::size() const {
+    folly::RWSpinLock::ReadHolder rh(lock_);
+    return csr_.types_.size() + deltaSize_ - tombstonesSize_;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
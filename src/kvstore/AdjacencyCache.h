@@ -0,0 +1,135 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_ADJACENCYCACHE_H_
+#define KVSTORE_ADJACENCYCACHE_H_
+
+#include "base/Base.h"
+#include <folly/RWSpinLock.h>
+#include "kvstore/Common.h"
+#include "kvstore/KVEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * Read-optimized in-memory adjacency lists of one partition, only the edge keys
+ * are kept, never the props.
+ *
+ * The bulk of the edges lives in a CSR snapshot: the edges of vids_[i] are
+ * [offsets_[i], offsets_[i + 1]) of the edge arrays, sorted by (type, rank, dst).
+ * Edges committed after the snapshot was built go to a small delta, and the
+ * snapshot edges removed since are kept as tombstones. Both are merged into a
+ * new snapshot once they grow beyond a fraction of the snapshot.
+ * */
+class AdjacencyCache final {
+public:
+    struct Edge {
+        EdgeType    type_;
+        EdgeRanking rank_;
+        VertexID    dst_;
+
+        bool operator<(const Edge& rhs) const {
+            return std::tie(type_, rank_, dst_) < std::tie(rhs.type_, rhs.rank_, rhs.dst_);
+        }
+
+        bool operator==(const Edge& rhs) const {
+            return type_ == rhs.type_ && rank_ == rhs.rank_ && dst_ == rhs.dst_;
+        }
+    };
+
+    explicit AdjacencyCache(PartitionID partId) : partId_(partId) {}
+
+    /**
+     * Load all the edges of the partition from the engine. Edges added or removed
+     * meanwhile are kept, if the cache is invalidated meanwhile it starts over.
+     * */
+    ResultCode build(KVEngine* engine);
+
+    bool ready() const {
+        return ready_.load(std::memory_order_acquire);
+    }
+
+    // Whether someone needs to call build()
+    bool needBuild() const {
+        return !ready() && !building_.load(std::memory_order_acquire);
+    }
+
+    // Record the edges committed to the engine, keyed by src
+    void addEdges(const std::vector<std::pair<VertexID, Edge>>& edges);
+
+    // Record the edges removed from the engine, keyed by src
+    void removeEdges(const std::vector<std::pair<VertexID, Edge>>& edges);
+
+    void invalidate();
+
+    /**
+     * Append the edges of vId with the given type to "edges", sorted by (rank, dst).
+     * Returns false if the cache is not ready.
+     * */
+    bool getEdges(VertexID vId, EdgeType type, std::vector<Edge>* edges) const;
+
+    // Total number of the cached edges
+    size_t size() const;
+
+private:
+    struct Csr {
+        std::vector<VertexID>    vids_;
+        std::vector<size_t>      offsets_{0};
+        std::vector<EdgeType>    types_;
+        std::vector<EdgeRanking> ranks_;
+        std::vector<VertexID>    dsts_;
+
+        void append(VertexID vId, const std::vector<Edge>& edges);
+        // [begin, end) of vId in the edge arrays, begin == end if vId is absent
+        std::pair<size_t, size_t> find(VertexID vId) const;
+        // Whether the edge of vId is in the snapshot
+        bool contains(VertexID vId, const Edge& edge) const;
+    };
+
+    // An edge added or removed while building
+    struct Change {
+        VertexID vId_;
+        Edge     edge_;
+        bool     removed_;
+    };
+
+    // Load the snapshot of all the edges in the engine
+    ResultCode scan(KVEngine* engine, Csr* csr) const;
+
+    // Insert into delta_ unless the edge is cached already, lock_ is held.
+    void addEdge(VertexID vId, const Edge& edge);
+
+    // Drop from delta_, or tombstone it in the snapshot, lock_ is held.
+    void removeEdge(VertexID vId, const Edge& edge);
+
+    // Merge once delta_ and tombstones_ grow large, lock_ is held.
+    void mergeIfNeeded();
+
+    // Fold delta_ and tombstones_ into a new snapshot, lock_ is held.
+    void merge();
+
+private:
+    PartitionID partId_;
+    mutable folly::RWSpinLock lock_;
+    std::atomic<bool> ready_{false};
+    std::atomic<bool> building_{false};
+    // Bumped by invalidate(), so a build started before knows to give up.
+    int64_t generation_ = 0;
+    Csr csr_;
+    // src -> sorted edges committed after the snapshot
+    std::unordered_map<VertexID, std::vector<Edge>> delta_;
+    size_t deltaSize_ = 0;
+    // src -> sorted edges of the snapshot removed since
+    std::unordered_map<VertexID, std::vector<Edge>> tombstones_;
+    size_t tombstonesSize_ = 0;
+    // Changes made while building, applied in order once the snapshot is in place
+    std::vector<Change> pending_;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_ADJACENCYCACHE_H_
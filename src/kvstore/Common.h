@@ -24,6 +24,7 @@ enum ResultCode {
     ERR_INVALID_ARGUMENT    = -6,
     ERR_IO_ERROR            = -7,
     ERR_UNSUPPORTED         = -8,
+    ERR_LEADER_LEASE_EXPIRED = -9,
     ERR_UNKNOWN             = -100,
 };
 
@@ -40,9 +41,32 @@ public:
                         const folly::StringPiece& val) const = 0;
 };
 
+/**
+ * What a prefix scan is looking for. The prefix of a vertex's tag and the one of
+ * its out-edges of a type are alike, so the engine storing vertices and edges
+ * apart needs it to look in one place only.
+ * */
+enum class ScanType : uint8_t {
+    ANY     = 0,
+    VERTEX  = 1,
+    EDGE    = 2,
+};
+
 using KV = std::pair<std::string, std::string>;
 using KVCallback = folly::Function<void(ResultCode code)>;
 
+/**
+ * A key to remove only if the first key/value under the guard prefix is still
+ * the one read when the key was found removable, or there is still none if
+ * the guard is empty. Whatever was written in between is not undone then.
+ * */
+struct GuardedKey {
+    std::string key;
+    std::string prefix;
+    ScanType    type{ScanType::ANY};
+    KV          guard;
+};
+
 inline rocksdb::Slice toSlice(const folly::StringPiece& str) {
     return rocksdb::Slice(str.begin(), str.size());
 }
@@ -59,7 +59,8 @@ public:
 
     // Get all results with 'prefix' str as prefix.
     virtual ResultCode prefix(const std::string& prefix,
-                              std::unique_ptr<KVIterator>* iter) = 0;
+                              std::unique_ptr<KVIterator>* iter,
+                              ScanType type = ScanType::ANY) = 0;
 
     // Get all results in range [start, end)
     virtual ResultCode put(std::string key, std::string value) = 0;
@@ -92,6 +93,9 @@ public:
     // Return total parts num
     virtual int32_t totalPartsNum() = 0;
 
+    // Return the estimated bytes the data of the part takes
+    virtual int64_t partSize(PartitionID partId) = 0;
+
     // Ingest sst files
     virtual ResultCode ingest(const std::vector<std::string>& files) = 0;
 
@@ -41,6 +41,10 @@ struct KVOptions {
      * Custom CompactionFilter used in compaction.
      * */
     std::shared_ptr<KVCompactionFilterFactory> cfFactory_{nullptr};
+
+    // Place vertices, out-edges, in-edges and system keys in separate column families.
+    // It is only meant for the graph data, the key layout is taken from NebulaKeyUtils.
+    bool multiColumnFamilies_{false};
 };
 
 
@@ -70,6 +74,14 @@ public:
         return nullptr;
     }
 
+    // Check whether the partition could serve reads locally, the leader
+    // holding its lease could, and so could a replica lagging behind no
+    // longer than maxStalenessMs if it is positive. Return ERR_LEADER_CHANGED,
+    // or ERR_LEADER_LEASE_EXPIRED if it is the leader, when it could not.
+    virtual ResultCode checkReadable(GraphSpaceID spaceId,
+                                     PartitionID partId,
+                                     int64_t maxStalenessMs) = 0;
+
     // Read a single key
     virtual ResultCode get(GraphSpaceID spaceId,
                            PartitionID  partId,
@@ -97,17 +109,20 @@ public:
                              std::string&& end,
                              std::unique_ptr<KVIterator>* iter) = delete;
 
-    // Get all results with prefix.
+    // Get all results with prefix. The type tells the vertices from the edges
+    // the scan is looking for.
     virtual ResultCode prefix(GraphSpaceID spaceId,
                               PartitionID  partId,
                               const std::string& prefix,
-                              std::unique_ptr<KVIterator>* iter) = 0;
+                              std::unique_ptr<KVIterator>* iter,
+                              ScanType type = ScanType::ANY) = 0;
 
     // To forbid to pass rvalue via the `prefix' parameter.
     virtual ResultCode prefix(GraphSpaceID spaceId,
                               PartitionID  partId,
                               std::string&& prefix,
-                              std::unique_ptr<KVIterator>* iter) = delete;
+                              std::unique_ptr<KVIterator>* iter,
+                              ScanType type = ScanType::ANY) = delete;
 
     virtual void asyncMultiPut(GraphSpaceID spaceId,
                                PartitionID  partId,
@@ -131,11 +146,30 @@ public:
                                   const std::string& end,
                                   KVCallback cb) = 0;
 
+    /**
+     * Remove the keys and put the key/values in one log, so they are applied
+     * atomically, e.g. the data along with its index entries.
+     * */
+    virtual void asyncMultiPutAndRemove(GraphSpaceID spaceId,
+                                        PartitionID partId,
+                                        std::vector<KV> keyValues,
+                                        std::vector<std::string> keys,
+                                        KVCallback cb) = 0;
+
     virtual void asyncRemovePrefix(GraphSpaceID spaceId,
                                    PartitionID partId,
                                    const std::string& prefix,
                                    KVCallback cb) = 0;
 
+    /**
+     * Remove the keys whose guards are unchanged. The guards are checked in the
+     * order of the log, after all the writes before are applied.
+     * */
+    virtual void asyncGuardedRemove(GraphSpaceID spaceId,
+                                    PartitionID partId,
+                                    std::vector<GuardedKey> keys,
+                                    KVCallback cb) = 0;
+
     virtual ErrorOr<ResultCode, std::shared_ptr<Part>> part(GraphSpaceID spaceId,
                                                             PartitionID partId) = 0;
 
@@ -126,6 +126,53 @@ std::string encodeMultiValues(LogType type,
 }
 
 
+std::string encodeMultiPutRemove(const std::vector<KV>& kvs,
+                                 const std::vector<std::string>& keys) {
+    size_t totalLen = 2 * sizeof(uint32_t);
+    for (auto& kv : kvs) {
+        totalLen += (2 * sizeof(uint32_t) + kv.first.size() + kv.second.size());
+    }
+    for (auto& k : keys) {
+        totalLen += (sizeof(uint32_t) + k.size());
+    }
+
+    std::string encoded;
+    encoded.reserve(totalLen + kHeadLen);
+
+    // Timestamp (8 bytes)
+    int64_t ts = time::WallClock::fastNowInMilliSec();
+    encoded.append(reinterpret_cast<char*>(&ts), sizeof(int64_t));
+    // Log type
+    LogType type = OP_MULTI_PUT_REMOVE;
+    encoded.append(reinterpret_cast<char*>(&type), 1);
+    // Number of total strings: 1 + #keys + #values + #keys removed
+    uint32_t num = 1 + 2 * kvs.size() + keys.size();
+    encoded.append(reinterpret_cast<char*>(&num), sizeof(uint32_t));
+    // Number of key/value pairs
+    uint32_t len = sizeof(uint32_t);
+    encoded.append(reinterpret_cast<char*>(&len), sizeof(uint32_t));
+    uint32_t pairs = kvs.size();
+    encoded.append(reinterpret_cast<char*>(&pairs), sizeof(uint32_t));
+    // Key/value pairs
+    for (auto& kv : kvs) {
+        len = kv.first.size();
+        encoded.append(reinterpret_cast<char*>(&len), sizeof(uint32_t));
+        encoded.append(kv.first.data(), len);
+        len = kv.second.size();
+        encoded.append(reinterpret_cast<char*>(&len), sizeof(uint32_t));
+        encoded.append(kv.second.data(), len);
+    }
+    // Keys removed
+    for (auto& k : keys) {
+        len = k.size();
+        encoded.append(reinterpret_cast<char*>(&len), sizeof(uint32_t));
+        encoded.append(k.data(), len);
+    }
+
+    return encoded;
+}
+
+
 std::vector<folly::StringPiece> decodeMultiValues(folly::StringPiece encoded) {
     // Skip the timestamp and the first type byte
     auto* p = encoded.begin() + sizeof(int64_t) + 1;
@@ -144,6 +191,39 @@ std::vector<folly::StringPiece> decodeMultiValues(folly::StringPiece encoded) {
     return values;
 }
 
+std::string encodeGuardedRemove(const std::vector<GuardedKey>& keys) {
+    // Five values for each key: the key, the prefix, the scan type and the guard
+    std::vector<std::string> values;
+    values.reserve(5 * keys.size());
+    for (auto& k : keys) {
+        values.emplace_back(k.key);
+        values.emplace_back(k.prefix);
+        values.emplace_back(1, static_cast<char>(k.type));
+        values.emplace_back(k.guard.first);
+        values.emplace_back(k.guard.second);
+    }
+    return encodeMultiValues(OP_GUARDED_REMOVE, values);
+}
+
+
+std::vector<GuardedKey> decodeGuardedRemove(folly::StringPiece encoded) {
+    auto values = decodeMultiValues(encoded);
+    DCHECK_EQ(0, values.size() % 5);
+    std::vector<GuardedKey> keys;
+    keys.reserve(values.size() / 5);
+    for (size_t i = 0; i + 4 < values.size(); i += 5) {
+        DCHECK_EQ(1, values[i + 2].size());
+        GuardedKey k;
+        k.key = values[i].str();
+        k.prefix = values[i + 1].str();
+        k.type = static_cast<ScanType>(values[i + 2][0]);
+        k.guard = std::make_pair(values[i + 3].str(), values[i + 4].str());
+        keys.emplace_back(std::move(k));
+    }
+    return keys;
+}
+
+
 std::string encodeLearner(const HostAddr& learner) {
     std::string encoded;
     encoded.reserve(kHeadLen + sizeof(HostAddr));
@@ -20,6 +20,9 @@ enum LogType : char {
     OP_REMOVE_PREFIX  = 0x5,
     OP_REMOVE_RANGE   = 0x6,
     OP_ADD_LEARNER    = 0x07,
+    OP_MULTI_PUT_REMOVE = 0x08,
+    // Only proposed, it is committed as the OP_MULTI_REMOVE of the keys still removable
+    OP_GUARDED_REMOVE = 0x09,
 };
 
 
@@ -33,6 +36,20 @@ std::string encodeMultiValues(LogType type,
                               folly::StringPiece v2);
 std::vector<folly::StringPiece> decodeMultiValues(folly::StringPiece encoded);
 
+/**
+ * Encode the key/values to put and the keys to remove into one OP_MULTI_PUT_REMOVE log.
+ * It is decoded by decodeMultiValues, the first value is the number of the pairs (uint32_t),
+ * followed by the key/values, then the keys.
+ * */
+std::string encodeMultiPutRemove(const std::vector<KV>& kvs, const std::vector<std::string>& keys);
+
+/**
+ * Encode the guarded keys into one OP_GUARDED_REMOVE log. It is decoded by
+ * decodeGuardedRemove.
+ * */
+std::string encodeGuardedRemove(const std::vector<GuardedKey>& keys);
+std::vector<GuardedKey> decodeGuardedRemove(folly::StringPiece encoded);
+
 std::string encodeLearner(const HostAddr& learner);
 HostAddr decodeLearner(const std::string& encoded);
 
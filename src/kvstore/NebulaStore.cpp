@@ -11,6 +11,7 @@
 #include <cstdint>
 #include "network/NetworkUtils.h"
 #include "fs/FileUtils.h"
+#include "time/WallClock.h"
 #include "kvstore/RocksEngine.h"
 
 DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
@@ -49,6 +50,7 @@ NebulaStore::~NebulaStore() {
 }
 
 bool NebulaStore::init() {
+    lastStatsTimeMs_ = time::WallClock::fastNowInMilliSec();
     LOG(INFO) << "Start the raft service...";
     workers_ = std::make_shared<thread::GenericThreadPool>();
     workers_->start(FLAGS_num_workers);
@@ -142,7 +144,8 @@ std::unique_ptr<KVEngine> NebulaStore::newEngine(GraphSpaceID spaceId,
         return std::make_unique<RocksEngine>(spaceId,
                                              path,
                                              options_.mergeOp_,
-                                             options_.cfFactory_);
+                                             options_.cfFactory_,
+                                             options_.multiColumnFamilies_);
     } else {
         LOG(FATAL) << "Unknown engine type " << FLAGS_engine_type;
         return nullptr;
@@ -270,6 +273,44 @@ void NebulaStore::removePart(GraphSpaceID spaceId, PartitionID partId) {
 }
 
 
+void NebulaStore::fetchPartStats(meta::PartStatsMap& stats) {
+    auto now = time::WallClock::fastNowInMilliSec();
+    auto elapsedMs = std::max<int64_t>(now - lastStatsTimeMs_.exchange(now), 1);
+    folly::RWSpinLock::ReadHolder rh(&lock_);
+    for (auto& spaceEntry : spaces_) {
+        auto& partsStats = stats[spaceEntry.first];
+        for (auto& partEntry : spaceEntry.second->parts_) {
+            auto& part = partEntry.second;
+            auto requests = part->takeRequests();
+            meta::cpp2::PartStats partStats;
+            partStats.set_part_id(partEntry.first);
+            partStats.set_disk_size(part->engine()->partSize(partEntry.first));
+            partStats.set_read_qps(requests.first * 1000 / elapsedMs);
+            partStats.set_write_qps(requests.second * 1000 / elapsedMs);
+            partStats.set_is_leader(part->isLeader());
+            partsStats.emplace_back(std::move(partStats));
+        }
+    }
+}
+
+
+ResultCode NebulaStore::checkReadable(GraphSpaceID spaceId,
+                                      PartitionID partId,
+                                      int64_t maxStalenessMs) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        return error(ret);
+    }
+    auto part = nebula::value(ret);
+    if (!part->canRead(maxStalenessMs)) {
+        VLOG(2) << "Part " << partId << " of space " << spaceId << " could not serve reads";
+        return part->isLeader() ? ResultCode::ERR_LEADER_LEASE_EXPIRED
+                                : ResultCode::ERR_LEADER_CHANGED;
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
 ResultCode NebulaStore::get(GraphSpaceID spaceId,
                             PartitionID partId,
                             const std::string& key,
@@ -313,13 +354,14 @@ ResultCode NebulaStore::range(GraphSpaceID spaceId,
 ResultCode NebulaStore::prefix(GraphSpaceID spaceId,
                                PartitionID partId,
                                const std::string& prefix,
-                               std::unique_ptr<KVIterator>* iter) {
+                               std::unique_ptr<KVIterator>* iter,
+                               ScanType type) {
     auto ret = engine(spaceId, partId);
     if (!ok(ret)) {
         return error(ret);
     }
     auto* e = nebula::value(ret);
-    return e->prefix(prefix, iter);
+    return e->prefix(prefix, iter, type);
 }
 
 void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
@@ -379,6 +421,21 @@ void NebulaStore::asyncRemoveRange(GraphSpaceID spaceId,
 }
 
 
+void NebulaStore::asyncMultiPutAndRemove(GraphSpaceID spaceId,
+                                         PartitionID partId,
+                                         std::vector<KV> keyValues,
+                                         std::vector<std::string> keys,
+                                         KVCallback cb) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        cb(error(ret));
+        return;
+    }
+    auto part = nebula::value(ret);
+    return part->asyncMultiPutAndRemove(std::move(keyValues), std::move(keys), std::move(cb));
+}
+
+
 void NebulaStore::asyncRemovePrefix(GraphSpaceID spaceId,
                                     PartitionID partId,
                                     const std::string& prefix,
@@ -392,6 +449,20 @@ void NebulaStore::asyncRemovePrefix(GraphSpaceID spaceId,
     return part->asyncRemovePrefix(prefix, std::move(cb));
 }
 
+
+void NebulaStore::asyncGuardedRemove(GraphSpaceID spaceId,
+                                     PartitionID partId,
+                                     std::vector<GuardedKey> keys,
+                                     KVCallback cb) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        cb(error(ret));
+        return;
+    }
+    auto part = nebula::value(ret);
+    return part->asyncGuardedRemove(std::move(keys), std::move(cb));
+}
+
 ErrorOr<ResultCode, std::shared_ptr<Part>> NebulaStore::part(GraphSpaceID spaceId,
                                                              PartitionID partId) {
     folly::RWSpinLock::ReadHolder rh(&lock_);
@@ -530,6 +601,7 @@ ErrorOr<ResultCode, KVEngine*> NebulaStore::engine(GraphSpaceID spaceId, Partiti
     if (UNLIKELY(partIt == parts.end())) {
         return ResultCode::ERR_PART_NOT_FOUND;
     }
+    partIt->second->onRead();
     return partIt->second->engine();
 }
 
@@ -87,6 +87,10 @@ public:
         return options_.partMan_.get();
     }
 
+    ResultCode checkReadable(GraphSpaceID spaceId,
+                             PartitionID partId,
+                             int64_t maxStalenessMs) override;
+
     ResultCode get(GraphSpaceID spaceId,
                    PartitionID  partId,
                    const std::string& key,
@@ -108,7 +112,8 @@ public:
     ResultCode prefix(GraphSpaceID spaceId,
                       PartitionID  partId,
                       const std::string& prefix,
-                      std::unique_ptr<KVIterator>* iter) override;
+                      std::unique_ptr<KVIterator>* iter,
+                      ScanType type = ScanType::ANY) override;
 
     // async batch put.
     void asyncMultiPut(GraphSpaceID spaceId,
@@ -132,11 +137,22 @@ public:
                           const std::string& end,
                           KVCallback cb) override;
 
+    void asyncMultiPutAndRemove(GraphSpaceID spaceId,
+                                PartitionID partId,
+                                std::vector<KV> keyValues,
+                                std::vector<std::string> keys,
+                                KVCallback cb) override;
+
     void asyncRemovePrefix(GraphSpaceID spaceId,
                            PartitionID partId,
                            const std::string& prefix,
                            KVCallback cb) override;
 
+    void asyncGuardedRemove(GraphSpaceID spaceId,
+                            PartitionID partId,
+                            std::vector<GuardedKey> keys,
+                            KVCallback cb) override;
+
     ErrorOr<ResultCode, std::shared_ptr<Part>> part(GraphSpaceID spaceId,
                                                     PartitionID partId) override;
 
@@ -160,7 +176,7 @@ public:
 
 private:
     /**
-     * Implement four interfaces in Handler.
+     * Implement the interfaces in Handler.
      * */
     void addSpace(GraphSpaceID spaceId) override;
 
@@ -170,12 +186,15 @@ private:
 
     void removePart(GraphSpaceID spaceId, PartitionID partId) override;
 
+    void fetchPartStats(meta::PartStatsMap& stats) override;
+
     std::unique_ptr<KVEngine> newEngine(GraphSpaceID spaceId, const std::string& path);
 
     std::shared_ptr<Part> newPart(GraphSpaceID spaceId,
                                   PartitionID partId,
                                   KVEngine* engine);
 
+    // Return the engine to read the part, the read is counted into the load of the part
     ErrorOr<ResultCode, KVEngine*> engine(GraphSpaceID spaceId, PartitionID partId);
 
     ErrorOr<ResultCode, std::shared_ptr<SpacePartInfo>> space(GraphSpaceID spaceId);
@@ -193,6 +212,8 @@ private:
 
     std::shared_ptr<raftex::RaftexService> raftService_;
     std::unique_ptr<wal::BufferFlusher> flusher_;
+    // When the part stats were fetched last time
+    std::atomic<int64_t> lastStatsTimeMs_{0};
 };
 
 }  // namespace kvstore
@@ -6,8 +6,11 @@
 
 #include "kvstore/Part.h"
 #include "kvstore/LogEncoder.h"
+#include "base/NebulaKeyUtils.h"
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
+DEFINE_string(adjacency_cache_spaces, "",
+              "Comma separated ids of the spaces whose adjacency lists are cached in memory");
 
 namespace nebula {
 namespace kvstore {
@@ -29,6 +32,21 @@ ResultCode toResultCode(AppendLogResult res) {
     }
 }
 
+bool adjacencyCacheEnabled(GraphSpaceID spaceId) {
+    if (FLAGS_adjacency_cache_spaces.empty()) {
+        return false;
+    }
+    std::vector<folly::StringPiece> spaces;
+    folly::split(",", FLAGS_adjacency_cache_spaces, spaces, true);
+    for (auto& space : spaces) {
+        auto id = folly::tryTo<GraphSpaceID>(folly::trimWhitespace(space));
+        if (id.hasValue() && id.value() == spaceId) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // Anonymous namespace
 
 
@@ -52,6 +70,29 @@ Part::Part(GraphSpaceID spaceId,
         , partId_(partId)
         , walPath_(walPath)
         , engine_(engine) {
+    if (adjacencyCacheEnabled(spaceId)) {
+        adjCache_ = std::make_unique<AdjacencyCache>(partId);
+    }
+}
+
+
+void Part::start(std::vector<HostAddr>&& peers, bool asLearner) {
+    RaftPart::start(std::move(peers), asLearner);
+    buildAdjacencyCache();
+}
+
+
+void Part::buildAdjacencyCache() {
+    if (adjCache_ == nullptr || !adjCache_->needBuild()) {
+        return;
+    }
+    auto self = std::static_pointer_cast<Part>(shared_from_this());
+    workers_->addTask([self] {
+        auto ret = self->adjCache_->build(self->engine_);
+        if (ret != ResultCode::SUCCEEDED) {
+            LOG(ERROR) << self->idStr_ << "Failed to build the adjacency cache, ret " << ret;
+        }
+    });
 }
 
 
@@ -111,6 +152,33 @@ void Part::asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb)
 }
 
 
+void Part::asyncMultiPutAndRemove(const std::vector<KV>& keyValues,
+                                  const std::vector<std::string>& keys,
+                                  KVCallback cb) {
+    std::string log = encodeMultiPutRemove(keyValues, keys);
+
+    appendAsync(FLAGS_cluster_id, std::move(log))
+        .then([callback = std::move(cb)] (AppendLogResult res) mutable {
+            callback(toResultCode(res));
+        });
+}
+
+
+void Part::asyncGuardedRemove(const std::vector<GuardedKey>& keys, KVCallback cb) {
+    std::string log = encodeGuardedRemove(keys);
+
+    casAsync(std::move(log))
+        .then([callback = std::move(cb)] (AppendLogResult res) mutable {
+            // All the guards have changed, nothing to remove
+            if (res == AppendLogResult::E_CAS_FAILURE) {
+                callback(ResultCode::SUCCEEDED);
+                return;
+            }
+            callback(toResultCode(res));
+        });
+}
+
+
 void Part::asyncRemovePrefix(folly::StringPiece prefix, KVCallback cb) {
     std::string log = encodeSingleValue(OP_REMOVE_PREFIX, prefix);
 
@@ -151,14 +219,61 @@ void Part::onElected(TermID term) {
 
 
 std::string Part::compareAndSet(const std::string& log) {
-    UNUSED(log);
-    LOG(FATAL) << "To be implemented";
+    // The logs before are all committed, so the engine is up to date
+    switch (log[sizeof(int64_t)]) {
+        case OP_GUARDED_REMOVE: {
+            std::vector<std::string> removed;
+            for (auto& k : decodeGuardedRemove(log)) {
+                std::unique_ptr<KVIterator> iter;
+                if (engine_->prefix(k.prefix, &iter, k.type) != ResultCode::SUCCEEDED) {
+                    LOG(ERROR) << idStr_ << "Failed to read the guard, keep the key";
+                    continue;
+                }
+                bool unchanged = iter->valid()
+                    ? iter->key() == k.guard.first && iter->val() == k.guard.second
+                    : k.guard.first.empty();
+                if (unchanged) {
+                    removed.emplace_back(std::move(k.key));
+                } else {
+                    VLOG(3) << idStr_ << "The guard has changed, keep the key";
+                }
+            }
+            if (removed.empty()) {
+                return "";
+            }
+            return encodeMultiValues(OP_MULTI_REMOVE, removed);
+        }
+        default: {
+            LOG(FATAL) << idStr_ << "Unknown CAS operation: "
+                       << static_cast<int32_t>(log[sizeof(int64_t)]);
+        }
+    }
+    return "";
 }
 
 
 bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
     auto batch = engine_->startBatchWrite();
     LogID lastId = -1;
+    int64_t numWrites = 0;
+    // Edges written by the logs, handed to the adjacency cache once committed
+    std::vector<std::pair<VertexID, AdjacencyCache::Edge>> edges;
+    // Edges with some version removed by the logs
+    std::vector<std::pair<VertexID, AdjacencyCache::Edge>> removedEdges;
+    // Whether a prefix or a range is removed, which the cache could not follow
+    bool removedAll = false;
+    auto collectEdge = [this] (folly::StringPiece key,
+                               std::vector<std::pair<VertexID, AdjacencyCache::Edge>>& to) {
+        // Index and system keys could be as long as the edge keys
+        if (adjCache_ != nullptr
+                && NebulaKeyUtils::isDataKey(key)
+                && NebulaKeyUtils::isEdge(key)) {
+            to.emplace_back(NebulaKeyUtils::getSrcId(key),
+                            AdjacencyCache::Edge{NebulaKeyUtils::getEdgeType(key),
+                                                 NebulaKeyUtils::getRank(key),
+                                                 NebulaKeyUtils::getDstId(key)});
+        }
+    };
     while (iter->valid()) {
         lastId = iter->logId();
         auto log = iter->logMsg();
@@ -167,6 +282,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             ++(*iter);
             continue;
         }
+        ++numWrites;
         DCHECK_GE(log.size(), sizeof(int64_t) + 1 + sizeof(uint32_t));
         // Skip the timestamp (type of int64_t)
         switch (log[sizeof(int64_t)]) {
@@ -177,6 +293,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << "Failed to call WriteBatch::put()";
                 return false;
             }
+            collectEdge(pieces[0], edges);
             break;
         }
         case OP_MULTI_PUT: {
@@ -188,11 +305,13 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                     LOG(ERROR) << "Failed to call WriteBatch::put()";
                     return false;
                 }
+                collectEdge(kvs[i], edges);
             }
             break;
         }
         case OP_REMOVE: {
             auto key = decodeSingleValue(log);
+            collectEdge(key, removedEdges);
             if (batch->remove(key) != ResultCode::SUCCEEDED) {
                 LOG(ERROR) << "Failed to call WriteBatch::remove()";
                 return false;
@@ -202,6 +321,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
         case OP_MULTI_REMOVE: {
             auto keys = decodeMultiValues(log);
             for (auto k : keys) {
+                collectEdge(k, removedEdges);
                 if (batch->remove(k) != ResultCode::SUCCEEDED) {
                     LOG(ERROR) << "Failed to call WriteBatch::remove()";
                     return false;
@@ -210,6 +330,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             break;
         }
         case OP_REMOVE_PREFIX: {
+            removedAll = true;
             auto prefix = decodeSingleValue(log);
             if (batch->removePrefix(prefix) != ResultCode::SUCCEEDED) {
                 LOG(ERROR) << "Failed to call WriteBatch::removePrefix()";
@@ -218,6 +339,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             break;
         }
         case OP_REMOVE_RANGE: {
+            removedAll = true;
             auto range = decodeMultiValues(log);
             DCHECK_EQ(2, range.size());
             if (batch->removeRange(range[0], range[1]) != ResultCode::SUCCEEDED) {
@@ -226,6 +348,27 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             }
             break;
         }
+        case OP_MULTI_PUT_REMOVE: {
+            auto values = decodeMultiValues(log);
+            DCHECK(!values.empty());
+            auto pairs = NebulaKeyUtils::readInt<uint32_t>(values[0].data(), values[0].size());
+            // Remove first, in case some keys are put again
+            for (size_t i = 1 + 2 * pairs; i < values.size(); i++) {
+                collectEdge(values[i], removedEdges);
+                if (batch->remove(values[i]) != ResultCode::SUCCEEDED) {
+                    LOG(ERROR) << "Failed to call WriteBatch::remove()";
+                    return false;
+                }
+            }
+            for (size_t i = 1; i < 1 + 2 * pairs; i += 2) {
+                if (batch->put(values[i], values[i + 1]) != ResultCode::SUCCEEDED) {
+                    LOG(ERROR) << "Failed to call WriteBatch::put()";
+                    return false;
+                }
+                collectEdge(values[i], edges);
+            }
+            break;
+        }
         case OP_ADD_LEARNER: {
             break;
         }
@@ -242,9 +385,49 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                    folly::StringPiece(reinterpret_cast<char*>(&lastId), sizeof(LogID)));
     }
 
-    return engine_->commitBatchWrite(std::move(batch)) == ResultCode::SUCCEEDED;
+    if (engine_->commitBatchWrite(std::move(batch)) != ResultCode::SUCCEEDED) {
+        return false;
+    }
+    writes_.fetch_add(numWrites, std::memory_order_relaxed);
+    if (adjCache_ != nullptr) {
+        if (removedAll) {
+            adjCache_->invalidate();
+            buildAdjacencyCache();
+        } else {
+            // The removals are checked against the engine, so their order with the puts
+            // within the batch does not matter.
+            adjCache_->addEdges(edges);
+            adjCache_->removeEdges(edgesGone(std::move(removedEdges)));
+        }
+    }
+    return true;
 }
 
+std::vector<std::pair<VertexID, AdjacencyCache::Edge>>
+Part::edgesGone(std::vector<std::pair<VertexID, AdjacencyCache::Edge>> edges) {
+    std::vector<std::pair<VertexID, AdjacencyCache::Edge>> gone;
+    for (auto& edge : edges) {
+        auto prefix = NebulaKeyUtils::prefix(partId_,
+                                             edge.first,
+                                             edge.second.type_,
+                                             edge.second.rank_,
+                                             edge.second.dst_);
+        std::unique_ptr<KVIterator> iter;
+        if (engine_->prefix(prefix, &iter, ScanType::EDGE) != ResultCode::SUCCEEDED) {
+            // Unsure, so start over
+            LOG(ERROR) << idStr_ << "Failed to check the removed edges, rebuild the cache";
+            adjCache_->invalidate();
+            buildAdjacencyCache();
+            return {};
+        }
+        if (!iter->valid()) {
+            gone.emplace_back(std::move(edge));
+        }
+    }
+    return gone;
+}
+
+
 bool Part::preProcessLog(LogID logId,
                          TermID termId,
                          ClusterID clusterId,
@@ -11,6 +11,7 @@
 #include "raftex/RaftPart.h"
 #include "kvstore/Common.h"
 #include "kvstore/KVEngine.h"
+#include "kvstore/AdjacencyCache.h"
 
 namespace nebula {
 namespace kvstore {
@@ -34,6 +35,24 @@ public:
         return engine_;
     }
 
+    // nullptr unless the adjacency cache is enabled for the space
+    AdjacencyCache* adjacencyCache() {
+        return adjCache_.get();
+    }
+
+    void onRead() {
+        reads_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Return the reads and writes served since the last call, for the load
+    // reported by heartbeats
+    std::pair<int64_t, int64_t> takeRequests() {
+        return std::make_pair(reads_.exchange(0, std::memory_order_relaxed),
+                              writes_.exchange(0, std::memory_order_relaxed));
+    }
+
+    void start(std::vector<HostAddr>&& peers, bool asLearner = false) override;
+
     void asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback cb);
     void asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb);
 
@@ -43,6 +62,11 @@ public:
     void asyncRemoveRange(folly::StringPiece start,
                           folly::StringPiece end,
                           KVCallback cb);
+    void asyncMultiPutAndRemove(const std::vector<KV>& keyValues,
+                                const std::vector<std::string>& keys,
+                                KVCallback cb);
+    // Proposed as a CAS log, the guards are checked by compareAndSet()
+    void asyncGuardedRemove(const std::vector<GuardedKey>& keys, KVCallback cb);
 
     void asyncAddLearner(const HostAddr& learner, KVCallback cb);
     /**
@@ -63,11 +87,22 @@ public:
                        ClusterID clusterId,
                        const std::string& log) override;
 
+private:
+    // Build the adjacency cache in the background
+    void buildAdjacencyCache();
+
+    // The removed edges of which no version is left in the engine
+    std::vector<std::pair<VertexID, AdjacencyCache::Edge>>
+    edgesGone(std::vector<std::pair<VertexID, AdjacencyCache::Edge>> edges);
+
 protected:
     GraphSpaceID spaceId_;
     PartitionID partId_;
     std::string walPath_;
     KVEngine* engine_ = nullptr;
+    std::unique_ptr<AdjacencyCache> adjCache_;
+    std::atomic<int64_t> reads_{0};
+    std::atomic<int64_t> writes_{0};
 };
 
 }  // namespace kvstore
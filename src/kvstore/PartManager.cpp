@@ -103,5 +103,13 @@ void MetaServerBasedPartManager::onPartUpdated(const PartMeta& partMeta) {
     UNUSED(partMeta);
 }
 
+void MetaServerBasedPartManager::fetchPartStats(meta::PartStatsMap& stats) {
+    if (handler_ != nullptr) {
+        handler_->fetchPartStats(stats);
+    } else {
+        VLOG(1) << "handler_ is nullptr!";
+    }
+}
+
 }  // namespace kvstore
 }  // namespace nebula
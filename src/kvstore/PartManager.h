@@ -21,6 +21,7 @@ public:
     virtual void addPart(GraphSpaceID spaceId, PartitionID partId) = 0;
     virtual void removeSpace(GraphSpaceID spaceId) = 0;
     virtual void removePart(GraphSpaceID spaceId, PartitionID partId) = 0;
+    virtual void fetchPartStats(meta::PartStatsMap& stats) = 0;
 };
 
 
@@ -156,6 +157,8 @@ public:
 
      void onPartUpdated(const PartMeta& partMeta) override;
 
+     void fetchPartStats(meta::PartStatsMap& stats) override;
+
      HostAddr getLocalHost() {
         return localHost_;
      }
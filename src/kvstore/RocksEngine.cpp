@@ -8,6 +8,7 @@
 #include "kvstore/RocksEngine.h"
 #include <folly/String.h>
 #include "fs/FileUtils.h"
+#include "base/NebulaKeyUtils.h"
 #include "kvstore/KVStore.h"
 #include "kvstore/RocksEngineConfig.h"
 
@@ -18,9 +19,81 @@ using fs::FileUtils;
 using fs::FileType;
 
 const char* kSystemParts = "__system__parts__";
+const char* kSystemLayout = "__system__layout__";
+const char* kMultiCFLayout = "multi_cf";
 
 namespace {
 
+// Index of the column families in RocksEngine::handles_ for the multi column family layout
+enum CFIndex : size_t {
+    kSystemCFIndex  = 0,
+    kVertexCFIndex  = 1,
+    kOutEdgeCFIndex = 2,
+    kInEdgeCFIndex  = 3,
+    kNumCFs         = 4,
+};
+
+// partId + vertexId + tagId/edgeType
+constexpr size_t kDataPrefixLen = sizeof(PartitionID) + sizeof(VertexID) + sizeof(int32_t);
+constexpr size_t kVertexKeyLen = kDataPrefixLen + sizeof(TagVersion);
+
+int32_t tagOrEdgeType(folly::StringPiece key) {
+    return NebulaKeyUtils::readInt<int32_t>(key.data() + sizeof(PartitionID) + sizeof(VertexID),
+                                            key.size() - sizeof(PartitionID) - sizeof(VertexID));
+}
+
+CFIndex cfIndex(folly::StringPiece key) {
+    if (!NebulaKeyUtils::isDataKey(key) ||
+        (!NebulaKeyUtils::isVertex(key) && !NebulaKeyUtils::isEdge(key))) {
+        return kSystemCFIndex;
+    }
+    if (tagOrEdgeType(key) < 0) {
+        return kInEdgeCFIndex;
+    }
+    return NebulaKeyUtils::isVertex(key) ? kVertexCFIndex : kOutEdgeCFIndex;
+}
+
+/**
+ * Vertex and out-edge prefixes can't be told apart unless the prefix is longer
+ * than a vertex key, so both column families are returned for them, unless the
+ * caller tells which it is looking for.
+ * Keys other than vertices, edges and system keys are only reachable
+ * through prefixes shorter than kDataPrefixLen.
+ * */
+std::vector<CFIndex> cfIndexes(folly::StringPiece prefix, ScanType type = ScanType::ANY) {
+    if (!prefix.empty() && !NebulaKeyUtils::isDataKey(prefix)) {
+        return {kSystemCFIndex};
+    }
+    if (prefix.size() < kDataPrefixLen) {
+        switch (type) {
+            case ScanType::VERTEX:
+                return {kVertexCFIndex};
+            case ScanType::EDGE:
+                return {kOutEdgeCFIndex, kInEdgeCFIndex};
+            default:
+                return {kSystemCFIndex, kVertexCFIndex, kOutEdgeCFIndex, kInEdgeCFIndex};
+        }
+    }
+    if (tagOrEdgeType(prefix) < 0) {
+        return {kInEdgeCFIndex};
+    }
+    if (prefix.size() > kVertexKeyLen || type == ScanType::EDGE) {
+        return {kOutEdgeCFIndex};
+    }
+    if (type == ScanType::VERTEX) {
+        return {kVertexCFIndex};
+    }
+    return {kVertexCFIndex, kOutEdgeCFIndex};
+}
+
+folly::StringPiece commonPrefix(folly::StringPiece start, folly::StringPiece end) {
+    size_t len = 0;
+    while (len < start.size() && len < end.size() && start[len] == end[len]) {
+        len++;
+    }
+    return start.subpiece(0, len);
+}
+
 /***************************************
  *
  * Implementation of WriteBatch
@@ -30,14 +103,36 @@ class RocksWriteBatch : public WriteBatch {
 private:
     rocksdb::WriteBatch batch_;
     rocksdb::DB* db_{nullptr};
+    const std::vector<rocksdb::ColumnFamilyHandle*>& handles_;
+    bool multiCFs_ = false;
+
+    rocksdb::ColumnFamilyHandle* cfHandle(folly::StringPiece key) const {
+        return multiCFs_ ? handles_[cfIndex(key)] : handles_[kSystemCFIndex];
+    }
+
+    std::vector<rocksdb::ColumnFamilyHandle*> cfHandles(folly::StringPiece prefix) const {
+        if (!multiCFs_) {
+            return {handles_[kSystemCFIndex]};
+        }
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
+        for (auto index : cfIndexes(prefix)) {
+            handles.emplace_back(handles_[index]);
+        }
+        return handles;
+    }
 
 public:
-    explicit RocksWriteBatch(rocksdb::DB* db) : db_(db) {}
+    RocksWriteBatch(rocksdb::DB* db,
+                    const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+                    bool multiCFs)
+        : db_(db)
+        , handles_(handles)
+        , multiCFs_(multiCFs) {}
 
     virtual ~RocksWriteBatch() = default;
 
     ResultCode put(folly::StringPiece key, folly::StringPiece value) override {
-        if (batch_.Put(toSlice(key), toSlice(value)).ok()) {
+        if (batch_.Put(cfHandle(key), toSlice(key), toSlice(value)).ok()) {
             return ResultCode::SUCCEEDED;
         } else {
             return ResultCode::ERR_UNKNOWN;
@@ -45,7 +140,7 @@ public:
     }
 
     ResultCode remove(folly::StringPiece key) override {
-        if (batch_.Delete(toSlice(key)).ok()) {
+        if (batch_.Delete(cfHandle(key), toSlice(key)).ok()) {
             return ResultCode::SUCCEEDED;
         } else {
             return ResultCode::ERR_UNKNOWN;
@@ -55,29 +150,32 @@ public:
     ResultCode removePrefix(folly::StringPiece prefix) override {
         rocksdb::Slice pre(prefix.begin(), prefix.size());
         rocksdb::ReadOptions options;
-        std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(options));
-        iter->Seek(pre);
-        while (iter->Valid()) {
-            if (iter->key().starts_with(pre)) {
-                if (!batch_.Delete(iter->key()).ok()) {
-                    return ResultCode::ERR_UNKNOWN;
+        for (auto* handle : cfHandles(prefix)) {
+            std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(options, handle));
+            iter->Seek(pre);
+            while (iter->Valid()) {
+                if (iter->key().starts_with(pre)) {
+                    if (!batch_.Delete(handle, iter->key()).ok()) {
+                        return ResultCode::ERR_UNKNOWN;
+                    }
+                } else {
+                    // Done
+                    break;
                 }
-            } else {
-                // Done
-                break;
+                iter->Next();
             }
-            iter->Next();
         }
         return ResultCode::SUCCEEDED;
     }
 
     // Remove all keys in the range [start, end)
     ResultCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
-        if (batch_.DeleteRange(toSlice(start), toSlice(end)).ok()) {
-            return ResultCode::SUCCEEDED;
-        } else {
-            return ResultCode::ERR_UNKNOWN;
+        for (auto* handle : cfHandles(commonPrefix(start, end))) {
+            if (!batch_.DeleteRange(handle, toSlice(start), toSlice(end)).ok()) {
+                return ResultCode::ERR_UNKNOWN;
+            }
         }
+        return ResultCode::SUCCEEDED;
     }
 
     rocksdb::WriteBatch* data() {
@@ -96,9 +194,11 @@ public:
 RocksEngine::RocksEngine(GraphSpaceID spaceId,
                          const std::string& dataPath,
                          std::shared_ptr<rocksdb::MergeOperator> mergeOp,
-                         std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory)
+                         std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory,
+                         bool multiColumnFamilies)
         : KVEngine(spaceId)
-        , dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId)) {
+        , dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId))
+        , multiCFs_(multiColumnFamilies) {
     auto path = folly::stringPrintf("%s/data", dataPath_.c_str());
     if (FileUtils::fileType(path.c_str()) == FileType::NOTEXIST) {
         FileUtils::makeDir(path);
@@ -115,15 +215,145 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
     if (cfFactory != nullptr) {
         options.compaction_filter_factory = cfFactory;
     }
-    status = rocksdb::DB::Open(options, path, &db);
-    CHECK(status.ok());
+
+    std::vector<std::string> cfNames{rocksdb::kDefaultColumnFamilyName};
+    if (multiCFs_) {
+        cfNames.emplace_back(kVertexCF);
+        cfNames.emplace_back(kOutEdgeCF);
+        cfNames.emplace_back(kInEdgeCF);
+    }
+    // All the existing column families have to be opened,
+    // the ones left from the other layout are dropped after migration.
+    std::vector<std::string> existingNames;
+    if (rocksdb::DB::ListColumnFamilies(options, path, &existingNames).ok()) {
+        for (auto& name : existingNames) {
+            if (std::find(cfNames.begin(), cfNames.end(), name) == cfNames.end()) {
+                cfNames.emplace_back(name);
+            }
+        }
+    }
+    std::vector<rocksdb::ColumnFamilyDescriptor> cfDescs;
+    for (auto& name : cfNames) {
+        rocksdb::ColumnFamilyOptions cfOpts(options);
+        if (multiCFs_) {
+            status = initRocksdbCFOptions(name, options, cfOpts);
+            CHECK(status.ok()) << "Bad options for column family " << name
+                               << ": " << status.ToString();
+        }
+        cfDescs.emplace_back(name, cfOpts);
+    }
+    options.create_missing_column_families = true;
+    status = rocksdb::DB::Open(options, path, cfDescs, &handles_, &db);
+    CHECK(status.ok()) << status.ToString();
     db_.reset(db);
+    CHECK_EQ(ResultCode::SUCCEEDED, migrateLayout());
     partsNum_ = allParts().size();
 }
 
 
+rocksdb::ColumnFamilyHandle* RocksEngine::cfHandle(folly::StringPiece key) const {
+    return multiCFs_ ? handles_[cfIndex(key)] : handles_[kSystemCFIndex];
+}
+
+
+std::vector<rocksdb::ColumnFamilyHandle*>
+RocksEngine::cfHandles(folly::StringPiece prefix, ScanType type) const {
+    if (!multiCFs_) {
+        return {handles_[kSystemCFIndex]};
+    }
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    for (auto index : cfIndexes(prefix, type)) {
+        handles.emplace_back(handles_[index]);
+    }
+    return handles;
+}
+
+
+ResultCode RocksEngine::relocate(rocksdb::ColumnFamilyHandle* handle) {
+    static const uint32_t kMaxBatchCount = 1024;
+    rocksdb::WriteOptions writeOptions;
+    rocksdb::WriteBatch batch(FLAGS_batch_reserved_bytes);
+    int64_t moved = 0;
+    std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(rocksdb::ReadOptions(), handle));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        auto* target = cfHandle(folly::StringPiece(iter->key().data(), iter->key().size()));
+        if (target == handle) {
+            continue;
+        }
+        // Put and delete in the same batch, so that a crash in the middle is harmless.
+        batch.Put(target, iter->key(), iter->value());
+        batch.Delete(handle, iter->key());
+        moved++;
+        if (batch.Count() >= kMaxBatchCount) {
+            if (!db_->Write(writeOptions, &batch).ok()) {
+                return ResultCode::ERR_UNKNOWN;
+            }
+            batch.Clear();
+        }
+    }
+    if (!iter->status().ok()) {
+        LOG(ERROR) << "Relocate failed: " << iter->status().ToString();
+        return ResultCode::ERR_IO_ERROR;
+    }
+    if (batch.Count() > 0 && !db_->Write(writeOptions, &batch).ok()) {
+        return ResultCode::ERR_UNKNOWN;
+    }
+    LOG(INFO) << "Moved " << moved << " keys out of column family " << handle->GetName();
+    return ResultCode::SUCCEEDED;
+}
+
+
+ResultCode RocksEngine::migrateLayout() {
+    std::string layout;
+    auto status = db_->Get(rocksdb::ReadOptions(),
+                           handles_[kSystemCFIndex],
+                           kSystemLayout,
+                           &layout);
+    if (!status.ok() && !status.IsNotFound()) {
+        LOG(ERROR) << "Read layout failed: " << status.ToString();
+        return ResultCode::ERR_IO_ERROR;
+    }
+    size_t expectedCFs = multiCFs_ ? kNumCFs : 1;
+    bool isMultiCFs = status.ok() && layout == kMultiCFLayout;
+    if (isMultiCFs == multiCFs_ && handles_.size() == expectedCFs) {
+        return ResultCode::SUCCEEDED;
+    }
+
+    LOG(INFO) << "Migrate " << dataPath_ << " to the "
+              << (multiCFs_ ? "multi" : "single") << " column family layout";
+    for (auto* handle : handles_) {
+        auto ret = relocate(handle);
+        if (ret != ResultCode::SUCCEEDED) {
+            return ret;
+        }
+    }
+    rocksdb::WriteOptions writeOptions;
+    if (multiCFs_) {
+        status = db_->Put(writeOptions, handles_[kSystemCFIndex], kSystemLayout, kMultiCFLayout);
+    } else {
+        status = db_->Delete(writeOptions, handles_[kSystemCFIndex], kSystemLayout);
+    }
+    if (!status.ok()) {
+        LOG(ERROR) << "Write layout failed: " << status.ToString();
+        return ResultCode::ERR_UNKNOWN;
+    }
+    while (handles_.size() > expectedCFs) {
+        auto* handle = handles_.back();
+        LOG(INFO) << "Drop column family " << handle->GetName();
+        status = db_->DropColumnFamily(handle);
+        if (!status.ok()) {
+            LOG(ERROR) << "Drop column family failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
+        delete handle;
+        handles_.pop_back();
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
 std::unique_ptr<WriteBatch> RocksEngine::startBatchWrite() {
-    return std::make_unique<RocksWriteBatch>(db_.get());
+    return std::make_unique<RocksWriteBatch>(db_.get(), handles_, multiCFs_);
 }
 
 
@@ -141,7 +371,7 @@ ResultCode RocksEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch) {
 
 ResultCode RocksEngine::get(const std::string& key, std::string* value) {
     rocksdb::ReadOptions options;
-    rocksdb::Status status = db_->Get(options, rocksdb::Slice(key), value);
+    rocksdb::Status status = db_->Get(options, cfHandle(key), rocksdb::Slice(key), value);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else if (status.IsNotFound()) {
@@ -158,11 +388,13 @@ ResultCode RocksEngine::multiGet(const std::vector<std::string>& keys,
                                  std::vector<std::string>* values) {
     rocksdb::ReadOptions options;
     std::vector<rocksdb::Slice> slices;
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
     for (size_t index = 0; index < keys.size(); index++) {
         slices.emplace_back(keys[index]);
+        handles.emplace_back(cfHandle(keys[index]));
     }
 
-    std::vector<rocksdb::Status> status = db_->MultiGet(options, slices, values);
+    std::vector<rocksdb::Status> status = db_->MultiGet(options, handles, slices, values);
     auto code = std::all_of(status.begin(), status.end(),
                             [](rocksdb::Status s) {
                                 return s.ok();
@@ -179,23 +411,40 @@ ResultCode RocksEngine::range(const std::string& start,
                               const std::string& end,
                               std::unique_ptr<KVIterator>* storageIter) {
     rocksdb::ReadOptions options;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
-    if (iter) {
-        iter->Seek(rocksdb::Slice(start));
+    std::vector<std::unique_ptr<KVIterator>> iters;
+    for (auto* handle : cfHandles(commonPrefix(start, end))) {
+        rocksdb::Iterator* iter = db_->NewIterator(options, handle);
+        if (iter) {
+            iter->Seek(rocksdb::Slice(start));
+        }
+        iters.emplace_back(new RocksRangeIter(iter, start, end));
+    }
+    if (iters.size() == 1) {
+        *storageIter = std::move(iters[0]);
+    } else {
+        storageIter->reset(new RocksMergedIter(std::move(iters)));
     }
-    storageIter->reset(new RocksRangeIter(iter, start, end));
     return ResultCode::SUCCEEDED;
 }
 
 
 ResultCode RocksEngine::prefix(const std::string& prefix,
-                               std::unique_ptr<KVIterator>* storageIter) {
+                               std::unique_ptr<KVIterator>* storageIter,
+                               ScanType type) {
     rocksdb::ReadOptions options;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
-    if (iter) {
-        iter->Seek(rocksdb::Slice(prefix));
+    std::vector<std::unique_ptr<KVIterator>> iters;
+    for (auto* handle : cfHandles(prefix, type)) {
+        rocksdb::Iterator* iter = db_->NewIterator(options, handle);
+        if (iter) {
+            iter->Seek(rocksdb::Slice(prefix));
+        }
+        iters.emplace_back(new RocksPrefixIter(iter, prefix));
+    }
+    if (iters.size() == 1) {
+        *storageIter = std::move(iters[0]);
+    } else {
+        storageIter->reset(new RocksMergedIter(std::move(iters)));
     }
-    storageIter->reset(new RocksPrefixIter(iter, prefix));
     return ResultCode::SUCCEEDED;
 }
 
@@ -203,7 +452,7 @@ ResultCode RocksEngine::prefix(const std::string& prefix,
 ResultCode RocksEngine::put(std::string key, std::string value) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    rocksdb::Status status = db_->Put(options, key, value);
+    rocksdb::Status status = db_->Put(options, cfHandle(key), key, value);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -216,7 +465,7 @@ ResultCode RocksEngine::put(std::string key, std::string value) {
 ResultCode RocksEngine::multiPut(std::vector<KV> keyValues) {
     rocksdb::WriteBatch updates(FLAGS_batch_reserved_bytes);
     for (size_t i = 0; i < keyValues.size(); i++) {
-        updates.Put(keyValues[i].first, keyValues[i].second);
+        updates.Put(cfHandle(keyValues[i].first), keyValues[i].first, keyValues[i].second);
     }
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -233,7 +482,7 @@ ResultCode RocksEngine::multiPut(std::vector<KV> keyValues) {
 ResultCode RocksEngine::remove(const std::string& key) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    auto status = db_->Delete(options, key);
+    auto status = db_->Delete(options, cfHandle(key), key);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -246,7 +495,7 @@ ResultCode RocksEngine::remove(const std::string& key) {
 ResultCode RocksEngine::multiRemove(std::vector<std::string> keys) {
     rocksdb::WriteBatch deletes(FLAGS_batch_reserved_bytes);
     for (size_t i = 0; i < keys.size(); i++) {
-        deletes.Delete(keys[i]);
+        deletes.Delete(cfHandle(keys[i]), keys[i]);
     }
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -266,13 +515,14 @@ ResultCode RocksEngine::removeRange(const std::string& start,
     options.disableWAL = FLAGS_rocksdb_disable_wal;
     // TODO(sye) Given the RocksDB version we are using,
     // we should avoud using DeleteRange
-    auto status = db_->DeleteRange(options, db_->DefaultColumnFamily(), start, end);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
-        VLOG(3) << "RemoveRange Failed: " << status.ToString();
-        return ResultCode::ERR_UNKNOWN;
+    for (auto* handle : cfHandles(commonPrefix(start, end))) {
+        auto status = db_->DeleteRange(options, handle, start, end);
+        if (!status.ok()) {
+            VLOG(3) << "RemoveRange Failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
     }
+    return ResultCode::SUCCEEDED;
 }
 
 
@@ -280,19 +530,21 @@ ResultCode RocksEngine::removePrefix(const std::string& prefix) {
     rocksdb::Slice pre(prefix.data(), prefix.size());
     rocksdb::ReadOptions readOptions;
     rocksdb::WriteBatch batch;
-    std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(readOptions));
-    iter->Seek(pre);
-    while (iter->Valid()) {
-        if (iter->key().starts_with(pre)) {
-            auto status = batch.Delete(iter->key());
-            if (!status.ok()) {
-                return ResultCode::ERR_UNKNOWN;
+    for (auto* handle : cfHandles(prefix)) {
+        std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(readOptions, handle));
+        iter->Seek(pre);
+        while (iter->Valid()) {
+            if (iter->key().starts_with(pre)) {
+                auto status = batch.Delete(handle, iter->key());
+                if (!status.ok()) {
+                    return ResultCode::ERR_UNKNOWN;
+                }
+            } else {
+                // Done
+                break;
             }
-        } else {
-            // Done
-            break;
+            iter->Next();
         }
-        iter->Next();
     }
 
     rocksdb::WriteOptions writeOptions;
@@ -327,7 +579,8 @@ void RocksEngine::addPart(PartitionID partId) {
 void RocksEngine::removePart(PartitionID partId) {
      rocksdb::WriteOptions options;
      options.disableWAL = FLAGS_rocksdb_disable_wal;
-     auto status = db_->Delete(options, partKey(partId));
+     auto key = partKey(partId);
+     auto status = db_->Delete(options, cfHandle(key), key);
      if (status.ok()) {
          partsNum_--;
          CHECK_GE(partsNum_, 0);
@@ -358,15 +611,45 @@ int32_t RocksEngine::totalPartsNum() {
 }
 
 
+int64_t RocksEngine::partSize(PartitionID partId) {
+    // All data keys of the part start with the partId, so they are in [start, end),
+    // where end is the smallest string greater than all strings with the prefix
+    std::string start(reinterpret_cast<const char*>(&partId), sizeof(PartitionID));
+    std::string end = start;
+    while (!end.empty() && static_cast<uint8_t>(end.back()) == 0xFF) {
+        end.pop_back();
+    }
+    if (end.empty()) {
+        return 0;
+    }
+    end.back() = static_cast<char>(static_cast<uint8_t>(end.back()) + 1);
+
+    rocksdb::Range range(start, end);
+    uint8_t flags = rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES
+                  | rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES;
+    int64_t total = 0;
+    for (auto* handle : cfHandles(start)) {
+        uint64_t size = 0;
+        db_->GetApproximateSizes(handle, &range, 1, &size, flags);
+        total += size;
+    }
+    return total;
+}
+
+
 ResultCode RocksEngine::ingest(const std::vector<std::string>& files) {
     rocksdb::IngestExternalFileOptions options;
-    rocksdb::Status status = db_->IngestExternalFile(files, options);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
+    // The sst files are not split by column family, so they go to the default one
+    // and the data keys are moved to their own column families afterwards.
+    rocksdb::Status status = db_->IngestExternalFile(handles_[kSystemCFIndex], files, options);
+    if (!status.ok()) {
         LOG(ERROR) << "Ingest Failed: " << status.ToString();
         return ResultCode::ERR_UNKNOWN;
     }
+    if (multiCFs_) {
+        return relocate(handles_[kSystemCFIndex]);
+    }
+    return ResultCode::SUCCEEDED;
 }
 
 
@@ -376,13 +659,14 @@ ResultCode RocksEngine::setOption(const std::string& configKey,
         {configKey, configValue}
     };
 
-    rocksdb::Status status = db_->SetOptions(configOptions);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
-        LOG(ERROR) << "SetOption Failed: " << configKey << ":" << configValue;
-        return ResultCode::ERR_INVALID_ARGUMENT;
+    for (auto* handle : handles_) {
+        rocksdb::Status status = db_->SetOptions(handle, configOptions);
+        if (!status.ok()) {
+            LOG(ERROR) << "SetOption Failed: " << configKey << ":" << configValue;
+            return ResultCode::ERR_INVALID_ARGUMENT;
+        }
     }
+    return ResultCode::SUCCEEDED;
 }
 
 
@@ -404,24 +688,26 @@ ResultCode RocksEngine::setDBOption(const std::string& configKey,
 
 ResultCode RocksEngine::compact() {
     rocksdb::CompactRangeOptions options;
-    rocksdb::Status status = db_->CompactRange(options, nullptr, nullptr);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
-        LOG(ERROR) << "CompactAll Failed: " << status.ToString();
-        return ResultCode::ERR_UNKNOWN;
+    for (auto* handle : handles_) {
+        rocksdb::Status status = db_->CompactRange(options, handle, nullptr, nullptr);
+        if (!status.ok()) {
+            LOG(ERROR) << "CompactAll Failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
     }
+    return ResultCode::SUCCEEDED;
 }
 
 ResultCode RocksEngine::flush() {
     rocksdb::FlushOptions options;
-    rocksdb::Status status = db_->Flush(options);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
-        LOG(ERROR) << "Flush Failed: " << status.ToString();
-        return ResultCode::ERR_UNKNOWN;
+    for (auto* handle : handles_) {
+        rocksdb::Status status = db_->Flush(options, handle);
+        if (!status.ok()) {
+            LOG(ERROR) << "Flush Failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
     }
+    return ResultCode::SUCCEEDED;
 }
 
 }  // namespace kvstore
@@ -86,6 +86,57 @@ private:
 };
 
 
+/**
+ * Merges the iterators over several column families into one iterator in key order.
+ * Only forward iteration is supported.
+ * */
+class RocksMergedIter : public KVIterator {
+public:
+    explicit RocksMergedIter(std::vector<std::unique_ptr<KVIterator>> iters)
+        : iters_(std::move(iters)) {
+        pick();
+    }
+
+    ~RocksMergedIter()  = default;
+
+    bool valid() const override {
+        return current_ != nullptr;
+    }
+
+    void next() override {
+        current_->next();
+        pick();
+    }
+
+    void prev() override {
+        LOG(FATAL) << "Backward iteration across column families is not supported";
+    }
+
+    folly::StringPiece key() const override {
+        return current_->key();
+    }
+
+    folly::StringPiece val() const override {
+        return current_->val();
+    }
+
+private:
+    void pick() {
+        current_ = nullptr;
+        for (auto& iter : iters_) {
+            if (iter->valid() &&
+                (current_ == nullptr || iter->key().compare(current_->key()) < 0)) {
+                current_ = iter.get();
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<KVIterator>> iters_;
+    KVIterator* current_{nullptr};
+};
+
+
 /**************************************************************************
  *
  * An implementation of KVEngine based on Rocksdb
@@ -93,14 +144,24 @@ private:
  *************************************************************************/
 class RocksEngine : public KVEngine {
     FRIEND_TEST(RocksEngineTest, SimpleTest);
+    FRIEND_TEST(RocksEngineTest, MultiColumnFamiliesTest);
 
 public:
+    /**
+     * When multiColumnFamilies is true, vertices, out-edges and in-edges are kept
+     * in their own column families, and system keys in the default one.
+     * Data written with the other layout is moved over when the engine opens.
+     * */
     RocksEngine(GraphSpaceID spaceId,
                 const std::string& dataPath,
                 std::shared_ptr<rocksdb::MergeOperator> mergeOp = nullptr,
-                std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory = nullptr);
+                std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory = nullptr,
+                bool multiColumnFamilies = false);
 
     ~RocksEngine() {
+        for (auto* handle : handles_) {
+            delete handle;
+        }
         LOG(INFO) << "Release rocksdb on " << dataPath_;
     }
 
@@ -124,7 +185,8 @@ public:
                      std::unique_ptr<KVIterator>* iter) override;
 
     ResultCode prefix(const std::string& prefix,
-                      std::unique_ptr<KVIterator>* iter) override;
+                      std::unique_ptr<KVIterator>* iter,
+                      ScanType type = ScanType::ANY) override;
 
     /*********************
      * Data modification
@@ -153,6 +215,8 @@ public:
 
     int32_t totalPartsNum() override;
 
+    int64_t partSize(PartitionID partId) override;
+
     ResultCode ingest(const std::vector<std::string>& files) override;
 
     ResultCode setOption(const std::string& configKey,
@@ -168,9 +232,26 @@ public:
 private:
     std::string partKey(PartitionID partId);
 
+    // The column family the key belongs to
+    rocksdb::ColumnFamilyHandle* cfHandle(folly::StringPiece key) const;
+
+    // All column families which may hold keys of the type starting with the prefix
+    std::vector<rocksdb::ColumnFamilyHandle*> cfHandles(folly::StringPiece prefix,
+                                                        ScanType type = ScanType::ANY) const;
+
+    // Move the keys which don't belong to the given column family to the right one
+    ResultCode relocate(rocksdb::ColumnFamilyHandle* handle);
+
+    // Bring the data written with the other layout to the current one
+    ResultCode migrateLayout();
+
 private:
     std::string  dataPath_;
     std::unique_ptr<rocksdb::DB> db_{nullptr};
+    // handles_[0] is the default column family. In the multi column family layout,
+    // it is followed by the vertex, out-edge and in-edge column families.
+    std::vector<rocksdb::ColumnFamilyHandle*> handles_;
+    bool multiCFs_ = false;
     int32_t partsNum_ = -1;
 };
 
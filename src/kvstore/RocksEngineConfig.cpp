@@ -42,6 +42,39 @@ DEFINE_int32(batch_reserved_bytes,
 DEFINE_string(part_man_type,
               "memory",
               "memory, meta");
+
+DEFINE_bool(rocksdb_multi_column_families,
+            false,
+            "Whether to place vertices, out-edges, in-edges and system keys "
+            "in separate column families. Existing data is migrated on startup");
+
+// [CFOptions/TableOptions] for each column family of the multi column family layout,
+// they are applied on top of rocksdb_column_family_options
+// and rocksdb_block_based_table_options.
+DEFINE_string(rocksdb_system_cf_options, "",
+              "ColumnFamilyOptions of system keys");
+DEFINE_string(rocksdb_system_table_options, "",
+              "BlockBasedTableOptions of system keys");
+DEFINE_string(rocksdb_vertex_cf_options, "",
+              "ColumnFamilyOptions of vertices");
+DEFINE_string(rocksdb_vertex_table_options, "",
+              "BlockBasedTableOptions of vertices");
+DEFINE_string(rocksdb_out_edge_cf_options, "",
+              "ColumnFamilyOptions of out-edges");
+// Keys in a block are delta encoded against the previous one and fully stored
+// every block_restart_interval keys. Edges of one (src, type) run share their
+// leading 16 bytes, partId(4) + src(8) + type(4), and are mostly read by prefix
+// scans, so longer intervals pay off.
+// These defaults only apply to the multi column family layout. In the single one,
+// edges share the default column family with the vertices and system keys, which
+// are mostly point lookups, so it is left at rocksdb_block_based_table_options.
+DEFINE_string(rocksdb_out_edge_table_options, "block_restart_interval=32",
+              "BlockBasedTableOptions of out-edges");
+DEFINE_string(rocksdb_in_edge_cf_options, "",
+              "ColumnFamilyOptions of in-edges");
+DEFINE_string(rocksdb_in_edge_table_options, "block_restart_interval=64",
+              "BlockBasedTableOptions of in-edges");
+
 /*
  * For these un-supported string options as below, will need to specify them with gflag.
  */
@@ -87,5 +120,48 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts) {
     return s;
 }
 
+rocksdb::Status initRocksdbCFOptions(const std::string& cfName,
+                                     const rocksdb::Options& baseOpts,
+                                     rocksdb::ColumnFamilyOptions& cfOpts) {
+    const std::string* cfOptsStr = nullptr;
+    const std::string* tableOptsStr = nullptr;
+    if (cfName == rocksdb::kDefaultColumnFamilyName) {
+        cfOptsStr = &FLAGS_rocksdb_system_cf_options;
+        tableOptsStr = &FLAGS_rocksdb_system_table_options;
+    } else if (cfName == kVertexCF) {
+        cfOptsStr = &FLAGS_rocksdb_vertex_cf_options;
+        tableOptsStr = &FLAGS_rocksdb_vertex_table_options;
+    } else if (cfName == kOutEdgeCF) {
+        cfOptsStr = &FLAGS_rocksdb_out_edge_cf_options;
+        tableOptsStr = &FLAGS_rocksdb_out_edge_table_options;
+    } else if (cfName == kInEdgeCF) {
+        cfOptsStr = &FLAGS_rocksdb_in_edge_cf_options;
+        tableOptsStr = &FLAGS_rocksdb_in_edge_table_options;
+    } else {
+        cfOpts = rocksdb::ColumnFamilyOptions(baseOpts);
+        return rocksdb::Status::OK();
+    }
+
+    rocksdb::Status s = GetColumnFamilyOptionsFromString(rocksdb::ColumnFamilyOptions(baseOpts),
+                                                         *cfOptsStr, &cfOpts);
+    if (!s.ok() || tableOptsStr->empty()) {
+        return s;
+    }
+
+    // Share the block cache and the rest of the base table options
+    auto* baseBbtOpts = static_cast<rocksdb::BlockBasedTableOptions*>(
+        baseOpts.table_factory->GetOptions());
+    if (baseBbtOpts == nullptr) {
+        return rocksdb::Status::InvalidArgument("Not a block based table");
+    }
+    rocksdb::BlockBasedTableOptions bbtOpts;
+    s = GetBlockBasedTableOptionsFromString(*baseBbtOpts, *tableOptsStr, &bbtOpts);
+    if (!s.ok()) {
+        return s;
+    }
+    cfOpts.table_factory.reset(NewBlockBasedTableFactory(bbtOpts));
+    return s;
+}
+
 }  // namespace kvstore
 }  // namespace nebula
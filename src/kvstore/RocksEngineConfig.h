@@ -35,12 +35,34 @@ DECLARE_int32(batch_reserved_bytes);
 
 DECLARE_string(part_man_type);
 
+// Multi column family layout and the per column family tunings
+DECLARE_bool(rocksdb_multi_column_families);
+DECLARE_string(rocksdb_system_cf_options);
+DECLARE_string(rocksdb_system_table_options);
+DECLARE_string(rocksdb_vertex_cf_options);
+DECLARE_string(rocksdb_vertex_table_options);
+DECLARE_string(rocksdb_out_edge_cf_options);
+DECLARE_string(rocksdb_out_edge_table_options);
+DECLARE_string(rocksdb_in_edge_cf_options);
+DECLARE_string(rocksdb_in_edge_table_options);
+
 
 namespace nebula {
 namespace kvstore {
 
+// Column families used by the multi column family layout.
+// System keys stay in the default column family.
+constexpr char kVertexCF[] = "vertex";
+constexpr char kOutEdgeCF[] = "out_edge";
+constexpr char kInEdgeCF[] = "in_edge";
+
 rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts);
 
+// Apply the tunings of the column family "cfName" on top of baseOpts
+rocksdb::Status initRocksdbCFOptions(const std::string& cfName,
+                                     const rocksdb::Options& baseOpts,
+                                     rocksdb::ColumnFamilyOptions& cfOpts);
+
 }  // namespace kvstore
 }  // namespace nebula
 #endif  // KVSTORE_ROCKSENGINECONFIG_H_
@@ -267,8 +267,10 @@ ResultCode HBaseStore::range(GraphSpaceID spaceId,
 ResultCode HBaseStore::prefix(GraphSpaceID spaceId,
                               PartitionID partId,
                               const std::string& prefix,
-                              std::unique_ptr<KVIterator>* iter) {
+                              std::unique_ptr<KVIterator>* iter,
+                              ScanType type) {
     UNUSED(partId);
+    UNUSED(type);
     return this->prefix(spaceId, prefix, iter);
 }
 
@@ -352,6 +354,21 @@ void HBaseStore::asyncRemoveRange(GraphSpaceID spaceId,
 }
 
 
+void HBaseStore::asyncMultiPutAndRemove(GraphSpaceID spaceId,
+                                        PartitionID partId,
+                                        std::vector<KV> keyValues,
+                                        std::vector<std::string> keys,
+                                        KVCallback cb) {
+    if (!keys.empty()) {
+        auto code = this->multiRemove(spaceId, keys);
+        if (code != ResultCode::SUCCEEDED) {
+            return cb(code);
+        }
+    }
+    asyncMultiPut(spaceId, partId, std::move(keyValues), std::move(cb));
+}
+
+
 void HBaseStore::asyncRemovePrefix(GraphSpaceID spaceId,
                                    PartitionID partId,
                                    const std::string& prefix,
@@ -380,6 +397,32 @@ void HBaseStore::asyncRemovePrefix(GraphSpaceID spaceId,
 }
 
 
+void HBaseStore::asyncGuardedRemove(GraphSpaceID spaceId,
+                                    PartitionID partId,
+                                    std::vector<GuardedKey> keys,
+                                    KVCallback cb) {
+    UNUSED(partId);
+    std::vector<std::string> removed;
+    for (auto& k : keys) {
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto code = this->prefix(spaceId, k.prefix, &iter);
+        if (code != ResultCode::SUCCEEDED) {
+            return cb(code);
+        }
+        bool unchanged = iter->valid()
+            ? iter->key() == k.guard.first && iter->val() == k.guard.second
+            : k.guard.first.empty();
+        if (unchanged) {
+            removed.emplace_back(std::move(k.key));
+        }
+    }
+    if (removed.empty()) {
+        return cb(ResultCode::SUCCEEDED);
+    }
+    return cb(this->multiRemove(spaceId, removed));
+}
+
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -76,6 +76,16 @@ public:
         return {-1, -1};
     }
 
+    // HBase takes care of its replicas itself
+    ResultCode checkReadable(GraphSpaceID spaceId,
+                             PartitionID partId,
+                             int64_t maxStalenessMs) override {
+        UNUSED(spaceId);
+        UNUSED(partId);
+        UNUSED(maxStalenessMs);
+        return ResultCode::SUCCEEDED;
+    }
+
     ResultCode get(GraphSpaceID spaceId,
                    PartitionID  partId,
                    const std::string& key,
@@ -97,7 +107,8 @@ public:
     ResultCode prefix(GraphSpaceID spaceId,
                       PartitionID  partId,
                       const std::string& prefix,
-                      std::unique_ptr<KVIterator>* iter) override;
+                      std::unique_ptr<KVIterator>* iter,
+                      ScanType type = ScanType::ANY) override;
 
     // async batch put.
     void asyncMultiPut(GraphSpaceID spaceId,
@@ -121,11 +132,24 @@ public:
                           const std::string& end,
                           KVCallback cb) override;
 
+    // The keys are removed before the key/values put, but not atomically
+    void asyncMultiPutAndRemove(GraphSpaceID spaceId,
+                                PartitionID partId,
+                                std::vector<KV> keyValues,
+                                std::vector<std::string> keys,
+                                KVCallback cb) override;
+
     void asyncRemovePrefix(GraphSpaceID spaceId,
                            PartitionID partId,
                            const std::string& prefix,
                            KVCallback cb) override;
 
+    // The guards are checked before the keys are removed, but not atomically
+    void asyncGuardedRemove(GraphSpaceID spaceId,
+                            PartitionID partId,
+                            std::vector<GuardedKey> keys,
+                            KVCallback cb) override;
+
     ErrorOr<ResultCode, std::shared_ptr<Part>> part(GraphSpaceID,
                                                     PartitionID) override {
         return ResultCode::ERR_UNSUPPORTED;
@@ -9,12 +9,16 @@
 #include "kvstore/raftex/RaftPart.h"
 #include "kvstore/wal/FileBasedWal.h"
 #include <folly/io/async/EventBase.h>
+#include <folly/TokenBucket.h>
 #include "network/NetworkUtils.h"
 
 DEFINE_uint32(max_appendlog_batch_size, 128,
               "The max number of logs in each appendLog request batch");
 DEFINE_uint32(max_outstanding_requests, 1024,
               "The max number of outstanding appendLog requests");
+DEFINE_uint32(learner_catch_up_rate_mb, 0,
+              "The max bytes per second sent to all learners of this host in MB, "
+              "which throttles the data copied when moving parts. 0 means no limit");
 
 
 namespace nebula {
@@ -22,6 +26,16 @@ namespace raftex {
 
 using nebula::network::NetworkUtils;
 
+namespace {
+
+// Shared by all learners, so the total rate is bounded however many parts are moved
+folly::DynamicTokenBucket& learnerRateLimiter() {
+    static folly::DynamicTokenBucket bucket;
+    return bucket;
+}
+
+}  // Anonymous namespace
+
 Host::Host(const HostAddr& addr, std::shared_ptr<RaftPart> part, bool isLearner)
         : part_(std::move(part))
         , addr_(addr)
@@ -81,6 +95,24 @@ folly::Future<cpp2::AskForVoteResponse> Host::askForVote(
 }
 
 
+folly::Future<cpp2::TransferLeaderResponse> Host::transferLeader(
+        const cpp2::TransferLeaderRequest& req) {
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        auto res = checkStatus();
+        if (res != cpp2::ErrorCode::SUCCEEDED) {
+            VLOG(2) << idStr_
+                    << "The Host is not in a proper status, do not send";
+            cpp2::TransferLeaderResponse resp;
+            resp.set_error_code(res);
+            return resp;
+        }
+    }
+    auto client = tcManager().client(addr_);
+    return client->future_transferLeader(req);
+}
+
+
 folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
         folly::EventBase* eb,
         TermID term,
@@ -376,6 +408,26 @@ folly::Future<cpp2::AppendLogResponse> Host::sendAppendLogRequest(
               << ", committed_id " << req->get_committed_log_id()
               << ", last_log_term_sent" << req->get_last_log_term_sent()
               << ", last_log_id_sent " << req->get_last_log_id_sent();
+    if (isLearner_ && FLAGS_learner_catch_up_rate_mb > 0) {
+        size_t bytes = 0;
+        for (auto& log : req->get_log_str_list()) {
+            bytes += log.get_log_str().size();
+        }
+        double rate = FLAGS_learner_catch_up_rate_mb * 1024.0 * 1024.0;
+        auto waitSecs = learnerRateLimiter().consumeWithBorrowNonBlocking(
+            bytes, rate, std::max(rate, static_cast<double>(bytes)));
+        if (waitSecs.hasValue() && waitSecs.value() > 0) {
+            VLOG(2) << idStr_ << "Throttle the learner for " << waitSecs.value() << " secs";
+            auto delay = std::chrono::microseconds(
+                static_cast<int64_t>(waitSecs.value() * 1000 * 1000));
+            return folly::futures::sleep(delay).via(eb).thenValue(
+                    [eb, req, self = shared_from_this()] (auto&&) {
+                auto client = self->tcManager().client(self->addr_, eb);
+                return client->future_appendLog(*req);
+            });
+        }
+    }
+
     // Get client connection
     auto client = tcManager().client(addr_, eb);
     return client->future_appendLog(*req);
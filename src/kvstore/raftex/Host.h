@@ -61,6 +61,9 @@ public:
     folly::Future<cpp2::AskForVoteResponse> askForVote(
         const cpp2::AskForVoteRequest& req);
 
+    folly::Future<cpp2::TransferLeaderResponse> transferLeader(
+        const cpp2::TransferLeaderRequest& req);
+
     // When logId == lastLogIdSent, it is a heartbeat
     folly::Future<cpp2::AppendLogResponse> appendLogs(
         folly::EventBase* eb,
@@ -25,6 +25,11 @@ DEFINE_bool(accept_log_append_during_pulling, false,
 DEFINE_uint32(heartbeat_interval, 5,
              "Seconds between each heartbeat");
 DEFINE_uint32(max_batch_size, 256, "The max number of logs in a batch");
+DEFINE_double(leader_lease_ratio, 0.8,
+              "The leader lease in the ratio of the election timeout, "
+              "the rest is left for the clock drift");
+
+DECLARE_bool(raft_coalesce_heartbeats);
 
 
 namespace nebula {
@@ -366,6 +371,71 @@ folly::Future<AppendLogResult> RaftPart::sendCommandAsync(std::string log) {
     return appendLogAsync(clusterId_, LogType::COMMAND, std::move(log));
 }
 
+folly::Future<cpp2::ErrorCode> RaftPart::transferLeader(const HostAddr& target) {
+    std::shared_ptr<Host> host;
+    cpp2::TransferLeaderRequest req;
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        if (status_ != Status::RUNNING) {
+            VLOG(2) << idStr_ << "The partition is not running";
+            return cpp2::ErrorCode::E_NOT_READY;
+        }
+        if (role_ != Role::LEADER) {
+            VLOG(2) << idStr_ << "The partition is not a leader";
+            return cpp2::ErrorCode::E_NOT_A_LEADER;
+        }
+        if (target == addr_) {
+            return cpp2::ErrorCode::SUCCEEDED;
+        }
+        for (auto& h : hosts_) {
+            // Any voting peer would do, if no target is given
+            if (!h->isLearner() && (target == HostAddr(0, 0) || h->address() == target)) {
+                host = h;
+                break;
+            }
+        }
+        if (host == nullptr) {
+            LOG(ERROR) << idStr_ << "The target " << target
+                       << " is not a voting peer of the partition";
+            return cpp2::ErrorCode::E_BAD_STATE;
+        }
+
+        // The peers vote for the target even if they are hearing from us,
+        // so their acks no longer extend the lease
+        leaseExpireTime_ = std::chrono::steady_clock::time_point();
+        noLeaseUntil_ = std::chrono::steady_clock::now()
+                      + std::chrono::seconds(FLAGS_heartbeat_interval);
+
+        req.set_space(spaceId_);
+        req.set_part(partId_);
+        req.set_current_term(term_);
+        req.set_leader_ip(addr_.first);
+        req.set_leader_port(addr_.second);
+        req.set_last_log_id(lastLogId_);
+    }
+
+    LOG(INFO) << idStr_ << "Transfer the leadership to " << host->idStr();
+    auto eb = ioThreadPool_->getEventBase();
+    return folly::via(eb, [host, req = std::move(req)] {
+        return host->transferLeader(req);
+    }).then([self = shared_from_this()] (folly::Try<cpp2::TransferLeaderResponse>&& t) {
+        if (t.hasException()) {
+            LOG(ERROR) << self->idStr_ << t.exception().what();
+            return cpp2::ErrorCode::E_EXCEPTION;
+        }
+        auto code = t.value().get_error_code();
+        if (code != cpp2::ErrorCode::SUCCEEDED) {
+            LOG(ERROR) << self->idStr_ << "The target refused to take over, error "
+                       << static_cast<int32_t>(code);
+            // It will not run, so the lease could be extended again
+            std::lock_guard<std::mutex> g(self->raftLock_);
+            self->noLeaseUntil_ = std::chrono::steady_clock::time_point();
+        }
+        return code;
+    });
+}
+
+
 folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
                                                         LogType logType,
                                                         std::string log) {
@@ -555,6 +625,8 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
 
     VLOG(2) << idStr_ << "About to replicate logs to all peer hosts";
 
+    // The lease starts before any follower could have received the logs
+    auto sentTime = std::chrono::steady_clock::now();
     collectNSucceeded(
         gen::from(hosts)
         | gen::map([self = shared_from_this(),
@@ -594,7 +666,8 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
                    committedId,
                    prevLogId,
                    prevLogTerm,
-                   pHosts = std::move(hosts)] (folly::Try<AppendLogResponses>&& result) mutable {
+                   pHosts = std::move(hosts),
+                   sentTime] (folly::Try<AppendLogResponses>&& result) mutable {
             VLOG(2) << self->idStr_ << "Received enough response";
             CHECK(!result.hasException());
 
@@ -606,7 +679,8 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
                                             committedId,
                                             prevLogTerm,
                                             prevLogId,
-                                            std::move(pHosts));
+                                            std::move(pHosts),
+                                            sentTime);
 
             return *result;
         });
@@ -622,7 +696,8 @@ void RaftPart::processAppendLogResponses(
         LogID committedId,
         TermID prevLogTerm,
         LogID prevLogId,
-        std::vector<std::shared_ptr<Host>> hosts) {
+        std::vector<std::shared_ptr<Host>> hosts,
+        std::chrono::steady_clock::time_point sentTime) {
     // Make sure majority have succeeded
     size_t numSucceeded = 0;
     for (auto& res : resps) {
@@ -664,6 +739,7 @@ void RaftPart::processAppendLogResponses(
             lastLogTerm_ = currTerm;
 
             lastMsgSentDur_.reset();
+            extendLease(sentTime);
 
             auto walIt = wal_->iterator(committedId + 1, lastLogId);
             // Step 3: Commit the batch
@@ -731,6 +807,26 @@ void RaftPart::processAppendLogResponses(
 }
 
 
+bool RaftPart::canRead(int64_t maxStalenessMs) const {
+    std::lock_guard<std::mutex> g(raftLock_);
+    if (status_ != Status::RUNNING) {
+        return false;
+    }
+    if (role_ == Role::LEADER) {
+        // Nobody else could be elected
+        if (quorum_ == 0) {
+            return true;
+        }
+        return std::chrono::steady_clock::now() < leaseExpireTime_;
+    }
+    if (maxStalenessMs > 0 && (role_ == Role::FOLLOWER || role_ == Role::LEARNER)) {
+        return caughtUp_
+            && caughtUpDur_.elapsedInMSec() <= static_cast<uint64_t>(maxStalenessMs);
+    }
+    return false;
+}
+
+
 bool RaftPart::needToSendHeartbeat() {
     std::lock_guard<std::mutex> g(raftLock_);
     return status_ == Status::RUNNING &&
@@ -744,7 +840,8 @@ bool RaftPart::needToStartElection() {
     if (status_ == Status::RUNNING &&
         role_ == Role::FOLLOWER &&
         (lastMsgRecvDur_.elapsedInSec() >= FLAGS_heartbeat_interval ||
-         term_ == 0)) {
+         term_ == 0 ||
+         leaderTransferTerm_ == term_)) {
         role_ = Role::CANDIDATE;
     }
 
@@ -776,6 +873,9 @@ bool RaftPart::prepareElectionRequest(
     req.set_term(++proposedTerm_);  // Bump up the proposed term
     req.set_last_log_id(lastLogId_);
     req.set_last_log_term(lastLogTerm_);
+    // Only the first round of the election is asked for by the leader
+    req.set_leader_transfer(leaderTransferTerm_ == term_);
+    leaderTransferTerm_ = -1;
 
     hosts = followers();
 
@@ -815,6 +915,8 @@ typename RaftPart::Role RaftPart::processElectionResponses(
                   << proposedTerm_;
         term_ = proposedTerm_;
         role_ = Role::LEADER;
+        // No lease until a quorum accepts the logs of the new term
+        leaseExpireTime_ = std::chrono::steady_clock::time_point();
     }
 
     return role_;
@@ -935,7 +1037,8 @@ void RaftPart::statusPolling() {
             VLOG(2) << idStr_ << "Wait for a while and continue the leader election";
             delay = folly::Random::rand32(1500) + 500;
         }
-    } else if (needToSendHeartbeat()) {
+    } else if (!FLAGS_raft_coalesce_heartbeats && needToSendHeartbeat()) {
+        // RaftexService sends the heartbeats for all the partitions when coalesced
         VLOG(2) << idStr_ << "Need to send heartbeat";
         sendHeartbeat();
     }
@@ -994,6 +1097,19 @@ void RaftPart::processAskForVoteRequest(
         return;
     }
 
+    // A follower still hearing from its leader never votes, unless the leader
+    // asked the candidate to take over, otherwise a new leader could be
+    // elected while the old one still holds the lease
+    if (!req.get_leader_transfer()
+            && role_ == Role::FOLLOWER
+            && leader_ != HostAddr(0, 0)
+            && lastMsgRecvDur_.elapsedInSec() < FLAGS_heartbeat_interval) {
+        VLOG(2) << idStr_ << "The partition's leader " << leader_
+                << " is still alive, so the candidate will be rejected";
+        resp.set_error_code(cpp2::ErrorCode::E_WRONG_LEADER);
+        return;
+    }
+
     // Check the last term to receive a log
     if (req.get_last_log_term() < lastLogTerm_) {
         VLOG(2) << idStr_
@@ -1194,6 +1310,11 @@ void RaftPart::processAppendLogRequest(
         }
     }
 
+    if (committedLogId_ >= req.get_committed_log_id()) {
+        caughtUp_ = true;
+        caughtUpDur_.reset();
+    }
+
     resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
 
     if (oldRole == Role::LEADER) {
@@ -1206,6 +1327,160 @@ void RaftPart::processAppendLogRequest(
 }
 
 
+void RaftPart::processTransferLeaderRequest(
+        const cpp2::TransferLeaderRequest& req,
+        cpp2::TransferLeaderResponse& resp) {
+    LOG(INFO) << idStr_
+              << "Received a request to take over the leadership"
+              << ": term = " << req.get_current_term()
+              << ", leader = "
+              << NetworkUtils::intToIPv4(req.get_leader_ip()) << ":"
+              << req.get_leader_port()
+              << ", lastLogId = " << req.get_last_log_id();
+
+    std::lock_guard<std::mutex> g(raftLock_);
+
+    if (status_ != Status::RUNNING) {
+        VLOG(2) << idStr_ << "The partition is not running";
+        resp.set_error_code(cpp2::ErrorCode::E_NOT_READY);
+        return;
+    }
+    // Learners never run, and candidates are running already
+    if (role_ != Role::FOLLOWER) {
+        VLOG(2) << idStr_ << "The partition currently is a " << roleStr(role_);
+        resp.set_error_code(cpp2::ErrorCode::E_BAD_STATE);
+        return;
+    }
+    if (req.get_current_term() != term_
+            || leader_ != HostAddr(req.get_leader_ip(), req.get_leader_port())) {
+        VLOG(2) << idStr_ << "Not following the leader in term "
+                << req.get_current_term();
+        resp.set_error_code(cpp2::ErrorCode::E_WRONG_LEADER);
+        return;
+    }
+    // Otherwise the peers having all the logs will not vote for it
+    if (lastLogId_ < req.get_last_log_id()) {
+        VLOG(2) << idStr_ << "The local last log is " << lastLogId_
+                << ". Need to catch up";
+        resp.set_error_code(cpp2::ErrorCode::E_LOG_GAP);
+        return;
+    }
+
+    // The election starts on the next status polling
+    leaderTransferTerm_ = term_;
+    resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+}
+
+
+cpp2::ErrorCode RaftPart::processHeartbeat(IPv4 leaderIp,
+                                           Port leaderPort,
+                                           const cpp2::HeartbeatItem& item) {
+    VLOG(3) << idStr_
+            << "Received heartbeat"
+            << ": current_term = " << item.get_current_term()
+            << ", committedLogId = " << item.get_committed_log_id()
+            << ", lastLogId = " << item.get_last_log_id()
+            << ", lastLogTerm = " << item.get_last_log_term();
+
+    std::lock_guard<std::mutex> g(raftLock_);
+
+    if (UNLIKELY(status_ != Status::RUNNING)) {
+        VLOG(2) << idStr_ << "The partition is not running";
+        return cpp2::ErrorCode::E_NOT_READY;
+    }
+    if (item.get_current_term() < term_) {
+        VLOG(2) << idStr_ << "The local term is " << term_
+                << ". The remote term is not newer";
+        return cpp2::ErrorCode::E_TERM_OUT_OF_DATE;
+    }
+    // Only AppendLogRequest could change the leadership
+    if ((role_ != Role::FOLLOWER && role_ != Role::LEARNER)
+            || item.get_current_term() != term_
+            || leader_ != HostAddr(leaderIp, leaderPort)) {
+        VLOG(2) << idStr_ << "Not following the leader in term "
+                << item.get_current_term() << " yet";
+        return cpp2::ErrorCode::E_WRONG_LEADER;
+    }
+
+    // Reset the timeout timer
+    lastMsgRecvDur_.reset();
+
+    // The logs are the same as the leader's only when the last ones are
+    if (lastLogId_ != item.get_last_log_id() || lastLogTerm_ != item.get_last_log_term()) {
+        VLOG(2) << idStr_ << "The local last log is " << lastLogId_
+                << " in term " << lastLogTerm_ << ". Need to catch up";
+        return cpp2::ErrorCode::E_LOG_GAP;
+    }
+
+    if (item.get_committed_log_id() > committedLogId_) {
+        LogID lastLogIdCanCommit = item.get_committed_log_id();
+        if (!commitLogs(wal_->iterator(committedLogId_ + 1, lastLogIdCanCommit))) {
+            LOG(ERROR) << idStr_ << "Failed to commit log "
+                       << committedLogId_ + 1 << " to " << lastLogIdCanCommit;
+            return cpp2::ErrorCode::E_WAL_FAIL;
+        }
+        VLOG(2) << idStr_ << "Follower succeeded committing log "
+                          << committedLogId_ + 1 << " to "
+                          << lastLogIdCanCommit;
+        committedLogId_ = lastLogIdCanCommit;
+    }
+
+    caughtUp_ = true;
+    caughtUpDur_.reset();
+    return cpp2::ErrorCode::SUCCEEDED;
+}
+
+
+bool RaftPart::prepareHeartbeat(cpp2::HeartbeatItem& item,
+                                std::vector<std::shared_ptr<Host>>& hosts,
+                                size_t& quorum) {
+    std::lock_guard<std::mutex> g(raftLock_);
+    if (status_ != Status::RUNNING || role_ != Role::LEADER || hosts_.empty()) {
+        return false;
+    }
+    if (replicatingLogs_ ||
+            lastMsgSentDur_.elapsedInSec() < FLAGS_heartbeat_interval * 2 / 5) {
+        return false;
+    }
+
+    item.set_space(spaceId_);
+    item.set_part(partId_);
+    item.set_current_term(term_);
+    item.set_committed_log_id(committedLogId_);
+    item.set_last_log_id(lastLogId_);
+    item.set_last_log_term(lastLogTerm_);
+    hosts = hosts_;
+    quorum = quorum_;
+    return true;
+}
+
+
+void RaftPart::onHeartbeatAccepted(TermID term,
+                                   std::chrono::steady_clock::time_point sentTime) {
+    std::lock_guard<std::mutex> g(raftLock_);
+    if (status_ != Status::RUNNING || role_ != Role::LEADER || term != term_) {
+        return;
+    }
+    VLOG(3) << idStr_ << "The heartbeat has been accepted by the quorum";
+    lastMsgSentDur_.reset();
+    extendLease(sentTime);
+}
+
+
+void RaftPart::onHeartbeatRejected(TermID term) {
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        if (status_ != Status::RUNNING || role_ != Role::LEADER || term != term_) {
+            return;
+        }
+    }
+    VLOG(2) << idStr_ << "The heartbeat has been rejected, send an empty log instead";
+    workers_->addTask([self = shared_from_this()] {
+        self->sendHeartbeat();
+    });
+}
+
+
 cpp2::ErrorCode RaftPart::verifyLeader(
         const cpp2::AppendLogRequest& req,
         std::lock_guard<std::mutex>& lck) {
@@ -1285,6 +1560,17 @@ std::vector<std::shared_ptr<Host>> RaftPart::followers() const {
 }
 
 
+void RaftPart::extendLease(std::chrono::steady_clock::time_point sentTime) {
+    CHECK(!raftLock_.try_lock());
+    if (sentTime < noLeaseUntil_) {
+        return;
+    }
+    auto expireTime = sentTime + std::chrono::milliseconds(static_cast<int64_t>(
+        FLAGS_heartbeat_interval * 1000 * FLAGS_leader_lease_ratio));
+    leaseExpireTime_ = std::max(leaseExpireTime_, expireTime);
+}
+
+
 }  // namespace raftex
 }  // namespace nebula
 
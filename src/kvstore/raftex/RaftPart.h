@@ -109,6 +109,18 @@ public:
         return leader_;
     }
 
+    /**
+     * Whether the partition could serve reads locally.
+     *
+     * The leader could, as long as it holds the lease, that is, a quorum has
+     * accepted its logs or heartbeats within leader_lease_ratio of the
+     * election timeout, so no one else could have been elected meanwhile.
+     *
+     * When maxStalenessMs > 0, a follower or a learner could too, if no longer
+     * than maxStalenessMs ago it had applied all the logs its leader had committed.
+     * */
+    bool canRead(int64_t maxStalenessMs = 0) const;
+
     std::shared_ptr<wal::FileBasedWal> wal() const {
         return wal_;
     }
@@ -150,6 +162,16 @@ public:
      * */
     folly::Future<AppendLogResult> sendCommandAsync(std::string log);
 
+    /**
+     * Hand the leadership over to the peer target, or any voting peer if the
+     * target is (0, 0). Only the leader could.
+     *
+     * The target starts an election at once, if it has received all the logs,
+     * and the peers vote for it even if they are still hearing from the leader.
+     * The future is fulfilled when the target agrees to run, not when elected.
+     * */
+    folly::Future<cpp2::ErrorCode> transferLeader(const HostAddr& target);
+
     /*****************************************************
      *
      * Methods to process incoming raft requests
@@ -165,6 +187,35 @@ public:
         const cpp2::AppendLogRequest& req,
         cpp2::AppendLogResponse& resp);
 
+    // Process the leader's request to take over the leadership
+    void processTransferLeaderRequest(
+        const cpp2::TransferLeaderRequest& req,
+        cpp2::TransferLeaderResponse& resp);
+
+    // Process the partition's item of a heartbeat coalesced by the leader's host
+    cpp2::ErrorCode processHeartbeat(IPv4 leaderIp,
+                                     Port leaderPort,
+                                     const cpp2::HeartbeatItem& item);
+
+    /*****************************************************
+     *
+     * Methods used by RaftexService to coalesce the heartbeats
+     *
+     ****************************************************/
+    // Fill up the partition's heartbeat item and the peers to send it to.
+    // Return false if no heartbeat is due, i.e. it is not the leader, or it
+    // is replicating logs, which serve as heartbeats anyway
+    bool prepareHeartbeat(cpp2::HeartbeatItem& item,
+                          std::vector<std::shared_ptr<Host>>& hosts,
+                          size_t& quorum);
+
+    // A quorum of the peers has accepted the heartbeat sent at sentTime
+    void onHeartbeatAccepted(TermID term, std::chrono::steady_clock::time_point sentTime);
+
+    // Some peer could not take the heartbeat, so send an empty log instead,
+    // which catches the peer up or settles the leadership
+    void onHeartbeatRejected(TermID term);
+
 
 protected:
     // Protected constructor to prevent from instantiating directly
@@ -317,10 +368,15 @@ private:
         LogID committedId,
         TermID prevLogTerm,
         LogID prevLogId,
-        std::vector<std::shared_ptr<Host>> hosts);
+        std::vector<std::shared_ptr<Host>> hosts,
+        std::chrono::steady_clock::time_point sentTime);
 
     std::vector<std::shared_ptr<Host>> followers() const;
 
+    // Extend the leader lease by a quorum's ack of the message sent at sentTime
+    // Pre-condition: The caller needs to hold the raftLock_
+    void extendLease(std::chrono::steady_clock::time_point sentTime);
+
 protected:
     template<class ValueType>
     class PromiseSet final {
@@ -448,6 +504,18 @@ protected:
     // was sent
     time::Duration lastMsgSentDur_;
 
+    // The leader serves reads until then
+    std::chrono::steady_clock::time_point leaseExpireTime_;
+    // After handing the leadership over, the leader could be replaced while
+    // the peers are still hearing from it, so no lease until then
+    std::chrono::steady_clock::time_point noLeaseUntil_;
+    // The term in which the leader asked the partition to take over
+    TermID leaderTransferTerm_{-1};
+    // To record how long ago when the follower had applied all the logs
+    // committed by the leader
+    bool caughtUp_{false};
+    time::Duration caughtUpDur_;
+
     // Write-ahead Log
     std::shared_ptr<wal::FileBasedWal> wal_;
 
@@ -7,11 +7,97 @@
 #include "base/Base.h"
 #include "kvstore/raftex/RaftexService.h"
 #include <folly/ScopeGuard.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include "kvstore/raftex/RaftPart.h"
+#include "kvstore/raftex/Host.h"
+
+DEFINE_bool(raft_coalesce_heartbeats, true,
+            "Send the heartbeats of all the idle partitions between two hosts "
+            "in one request, instead of an empty log for each partition");
+
+DECLARE_uint32(heartbeat_interval);
 
 namespace nebula {
 namespace raftex {
 
+namespace {
+
+// The heartbeats sent in one round. The lease of a partition is extended
+// as soon as a quorum of its peers has accepted, no matter how slow the others are
+struct HeartbeatRound {
+    struct PartState {
+        std::shared_ptr<RaftPart> part_;
+        TermID term_{0};
+        size_t quorum_{0};
+        size_t accepted_{0};
+        bool rejected_{false};
+    };
+
+    std::chrono::steady_clock::time_point sentTime_;
+    std::mutex lock_;
+    std::vector<PartState> parts_;
+};
+
+// The heartbeat items sent to one peer, with the partitions they belong to
+struct HeartbeatBatch {
+    cpp2::HeartbeatRequest req_;
+    // Moved into req_ once the batch is complete
+    std::vector<cpp2::HeartbeatItem> items_;
+    // Index of the partition in HeartbeatRound::parts_
+    std::vector<size_t> parts_;
+    std::vector<bool> isLearner_;
+};
+
+
+void processHeartbeatResponse(const HostAddr& addr,
+                              const HeartbeatBatch& batch,
+                              HeartbeatRound& round,
+                              folly::Try<cpp2::HeartbeatResponse>&& t) {
+    // The parts of a failed batch fall back to their own heartbeats, the same
+    // as if the peer had rejected them, instead of waiting for the lease to lapse
+    bool failed = false;
+    if (t.hasException()) {
+        LOG(ERROR) << "Failed to send heartbeats to " << addr
+                   << ": " << t.exception().what();
+        failed = true;
+    } else if (t.value().get_results().size() != batch.parts_.size()) {
+        LOG(ERROR) << "Host " << addr << " answered " << t.value().get_results().size()
+                   << " heartbeats out of " << batch.parts_.size();
+        failed = true;
+    }
+
+    std::vector<HeartbeatRound::PartState*> accepted;
+    std::vector<HeartbeatRound::PartState*> rejected;
+    {
+        std::lock_guard<std::mutex> g(round.lock_);
+        for (size_t i = 0; i < batch.parts_.size(); i++) {
+            auto& state = round.parts_[batch.parts_[i]];
+            auto code = failed ? cpp2::ErrorCode::E_EXCEPTION
+                               : t.value().get_results()[i];
+            if (code == cpp2::ErrorCode::SUCCEEDED) {
+                if (!batch.isLearner_[i] && ++state.accepted_ == state.quorum_) {
+                    accepted.emplace_back(&state);
+                }
+            } else if (!state.rejected_) {
+                VLOG(2) << "Host " << addr << " rejected the heartbeat of space "
+                        << batch.req_.get_items()[i].get_space() << ", part "
+                        << batch.req_.get_items()[i].get_part() << ", error "
+                        << static_cast<int32_t>(code);
+                state.rejected_ = true;
+                rejected.emplace_back(&state);
+            }
+        }
+    }
+    for (auto* state : accepted) {
+        state->part_->onHeartbeatAccepted(state->term_, round.sentTime_);
+    }
+    for (auto* state : rejected) {
+        state->part_->onHeartbeatRejected(state->term_);
+    }
+}
+
+}  // Anonymous namespace
+
 /*******************************************************
  *
  * Implementation of RaftexService
@@ -96,6 +182,16 @@ void RaftexService::serve() {
         server_->cleanUp();
     };
 
+    if (FLAGS_raft_coalesce_heartbeats) {
+        heartbeatWorker_ = std::make_unique<thread::GenericWorker>();
+        auto ok = heartbeatWorker_->start("raft-heartbeat");
+        DCHECK(ok);
+        // Idle leaders send a heartbeat every 2/5 of the interval
+        size_t intervalMs = std::max(FLAGS_heartbeat_interval * 1000 / 5, 100U);
+        auto bound = std::bind(&RaftexService::sendHeartbeats, this);
+        heartbeatWorker_->addRepeatTask(intervalMs, std::move(bound));
+    }
+
     status_.store(STATUS_RUNNING);
     LOG(INFO) << "Start the Raftex Service successfully";
     server_->getEventBaseManager()->getEventBase()->loopForever();
@@ -118,6 +214,11 @@ void RaftexService::stop() {
 
     // stop service
     LOG(INFO) << "Stopping the raftex service on port " << serverPort_;
+    if (heartbeatWorker_ != nullptr) {
+        heartbeatWorker_->stop();
+        heartbeatWorker_->wait();
+        heartbeatWorker_.reset();
+    }
     {
         folly::RWSpinLock::WriteHolder wh(partsLock_);
         for (auto& p : parts_) {
@@ -201,6 +302,91 @@ void RaftexService::appendLog(
     part->processAppendLogRequest(req, resp);
 }
 
+
+void RaftexService::transferLeader(
+        cpp2::TransferLeaderResponse& resp,
+        const cpp2::TransferLeaderRequest& req) {
+    auto part = findPart(req.get_space(), req.get_part());
+    if (!part) {
+        // Not found
+        resp.set_error_code(cpp2::ErrorCode::E_UNKNOWN_PART);
+        return;
+    }
+
+    part->processTransferLeaderRequest(req, resp);
+}
+
+
+void RaftexService::heartbeat(
+        cpp2::HeartbeatResponse& resp,
+        const cpp2::HeartbeatRequest& req) {
+    std::vector<cpp2::ErrorCode> results;
+    results.reserve(req.get_items().size());
+    for (auto& item : req.get_items()) {
+        auto part = findPart(item.get_space(), item.get_part());
+        if (!part) {
+            results.emplace_back(cpp2::ErrorCode::E_UNKNOWN_PART);
+            continue;
+        }
+        results.emplace_back(part->processHeartbeat(req.get_leader_ip(),
+                                                    req.get_leader_port(),
+                                                    item));
+    }
+    resp.set_results(std::move(results));
+}
+
+
+void RaftexService::sendHeartbeats() {
+    decltype(parts_) parts;
+    {
+        folly::RWSpinLock::ReadHolder rh(partsLock_);
+        parts = parts_;
+    }
+
+    auto round = std::make_shared<HeartbeatRound>();
+    round->sentTime_ = std::chrono::steady_clock::now();
+    std::unordered_map<HostAddr, HeartbeatBatch> batches;
+    for (auto& p : parts) {
+        auto& part = p.second;
+        cpp2::HeartbeatItem item;
+        std::vector<std::shared_ptr<Host>> hosts;
+        HeartbeatRound::PartState state;
+        if (!part->prepareHeartbeat(item, hosts, state.quorum_)) {
+            continue;
+        }
+        state.part_ = part;
+        state.term_ = item.get_current_term();
+        for (auto& host : hosts) {
+            auto& batch = batches[host->address()];
+            batch.req_.set_leader_ip(part->address().first);
+            batch.req_.set_leader_port(part->address().second);
+            batch.items_.emplace_back(item);
+            batch.parts_.emplace_back(round->parts_.size());
+            batch.isLearner_.emplace_back(host->isLearner());
+        }
+        round->parts_.emplace_back(std::move(state));
+    }
+    if (batches.empty()) {
+        return;
+    }
+    VLOG(2) << "Send the heartbeats of " << round->parts_.size()
+            << " partitions to " << batches.size() << " hosts";
+
+    auto ioPool = getIOThreadPool();
+    for (auto& b : batches) {
+        auto addr = b.first;
+        auto batch = std::make_shared<HeartbeatBatch>(std::move(b.second));
+        batch->req_.set_items(std::move(batch->items_));
+        auto* evb = ioPool->getEventBase();
+        folly::via(evb, [evb, addr, batch] {
+            auto client = tcManager().client(addr, evb);
+            return client->future_heartbeat(batch->req_);
+        }).then(evb, [addr, batch, round] (folly::Try<cpp2::HeartbeatResponse>&& t) {
+            processHeartbeatResponse(addr, *batch, *round, std::move(t));
+        });
+    }
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
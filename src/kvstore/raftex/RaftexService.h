@@ -11,7 +11,9 @@
 #include <folly/RWSpinLock.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 #include "gen-cpp2/RaftexService.h"
+#include "gen-cpp2/RaftexServiceAsyncClient.h"
 #include "thread/GenericThreadPool.h"
+#include "thrift/ThriftClientManager.h"
 
 namespace nebula {
 namespace raftex {
@@ -43,6 +45,12 @@ public:
     void appendLog(cpp2::AppendLogResponse& resp,
                    const cpp2::AppendLogRequest& req) override;
 
+    void heartbeat(cpp2::HeartbeatResponse& resp,
+                   const cpp2::HeartbeatRequest& req) override;
+
+    void transferLeader(cpp2::TransferLeaderResponse& resp,
+                        const cpp2::TransferLeaderRequest& req) override;
+
     void addPartition(std::shared_ptr<RaftPart> part);
     void removePartition(std::shared_ptr<RaftPart> part);
 
@@ -59,6 +67,15 @@ private:
     std::shared_ptr<RaftPart> findPart(GraphSpaceID spaceId,
                                        PartitionID partId);
 
+    // Send one heartbeat to each peer host, for all the idle partitions
+    // it shares with the local leaders
+    void sendHeartbeats();
+
+    static thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>& tcManager() {
+        static thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient> manager;
+        return manager;
+    }
+
 private:
     std::unique_ptr<apache::thrift::ThriftServer> server_;
     std::unique_ptr<std::thread> serverThread_;
@@ -74,6 +91,8 @@ private:
     folly::RWSpinLock partsLock_;
     std::unordered_map<std::pair<GraphSpaceID, PartitionID>,
                        std::shared_ptr<RaftPart>> parts_;
+
+    std::unique_ptr<thread::GenericWorker> heartbeatWorker_;
 };
 
 }  // namespace raftex
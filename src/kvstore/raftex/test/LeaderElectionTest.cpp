@@ -124,6 +124,51 @@ TEST(LeaderElection, LeaderCrash) {
     LOG(INFO) << "<===== Done LeaderCrash test";
 }
 
+
+TEST(LeaderElection, TransferLeader) {
+    LOG(INFO) << "=====> Start TransferLeader test";
+    fs::TempDir walRoot("/tmp/transfer_leader.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    // The followers are still hearing from the leader, so only the transfer
+    // could get the target elected
+    auto oldLeader = leader;
+    size_t target = (oldLeader->index() + 1) % copies.size();
+    LOG(INFO) << "=====> Now let's transfer the leadership to copy " << target;
+    auto code = oldLeader->transferLeader(copies[target]->address()).get();
+    ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+
+    // The target runs on its next status polling
+    for (int i = 0; i < 50 && !copies[target]->isLeader(); i++) {
+        usleep(100000);
+    }
+    ASSERT_TRUE(copies[target]->isLeader());
+    EXPECT_FALSE(oldLeader->isLeader());
+
+    // Wait untill all copies agree on the new leader
+    waitUntilLeaderElected(copies, leader);
+    checkLeadership(copies, target, leader);
+    checkLeadership(copies, leader);
+
+    // A follower could not hand the leadership over
+    EXPECT_EQ(cpp2::ErrorCode::E_NOT_A_LEADER,
+              oldLeader->transferLeader(copies[target]->address()).get());
+
+    finishRaft(services, copies, workers, leader);
+
+    LOG(INFO) << "<===== Done TransferLeader test";
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -12,6 +12,7 @@
 #include "thread/GenericThreadPool.h"
 #include "network/NetworkUtils.h"
 #include "kvstore/wal/BufferFlusher.h"
+#include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/raftex/RaftexService.h"
 #include "kvstore/raftex/test/RaftexTestBase.h"
 #include "kvstore/raftex/test/TestShard.h"
@@ -168,6 +169,72 @@ TEST_F(ThreeRaftTest, Persistance) {
     LOG(INFO) << "<===== Done persistance test";
 }
 
+TEST_F(ThreeRaftTest, LeaderLease) {
+    LOG(INFO) << "=====> Start leader lease test";
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 4, leader_, msgs);
+    checkConsensus(copies_, 0, 4, msgs);
+    ASSERT_TRUE(leader_->canRead());
+
+    // Followers learn the committed id from the next heartbeat
+    sleep(FLAGS_heartbeat_interval);
+    for (auto& c : copies_) {
+        if (c != leader_) {
+            ASSERT_FALSE(c->canRead());
+            ASSERT_TRUE(c->canRead(FLAGS_heartbeat_interval * 1000));
+        }
+    }
+
+    LOG(INFO) << "=====> Now followers disconnect, leader loses its lease";
+    auto leader = leader_;
+    for (size_t i = 0; i < copies_.size(); i++) {
+        if (copies_[i] != leader) {
+            killOneCopy(services_, copies_, leader_, i);
+        }
+    }
+    sleep(FLAGS_heartbeat_interval + 1);
+    ASSERT_FALSE(leader->canRead());
+
+    for (size_t i = 0; i < copies_.size(); i++) {
+        if (!copies_[i]->isRunning_) {
+            rebootOneCopy(services_, copies_, allHosts_, i);
+        }
+    }
+    LOG(INFO) << "<===== Done leader lease test";
+}
+
+TEST_F(ThreeRaftTest, QuiescedHeartbeat) {
+    LOG(INFO) << "=====> Start quiesced heartbeat test";
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 4, leader_, msgs);
+    checkConsensus(copies_, 0, 4, msgs);
+
+    // Idle partitions keep the leadership without writing any log
+    auto lastLogId = leader_->wal()->lastLogId();
+    sleep(2 * FLAGS_heartbeat_interval);
+    checkLeadership(copies_, leader_);
+    ASSERT_EQ(lastLogId, leader_->wal()->lastLogId());
+    ASSERT_TRUE(leader_->canRead());
+
+    appendLogs(5, 9, leader_, msgs);
+    checkConsensus(copies_, 5, 9, msgs);
+
+    LOG(INFO) << "=====> Now one follower is down, its heartbeats fail";
+    size_t idx = (leader_->index() + 1) % copies_.size();
+    killOneCopy(services_, copies_, leader_, idx);
+    sleep(2 * FLAGS_heartbeat_interval);
+    // The other follower still makes a quorum
+    ASSERT_TRUE(leader_->isLeader());
+    ASSERT_TRUE(leader_->canRead());
+    appendLogs(10, 14, leader_, msgs);
+    checkConsensus(copies_, 10, 14, msgs);
+
+    rebootOneCopy(services_, copies_, allHosts_, idx);
+    LOG(INFO) << "<===== Done quiesced heartbeat test";
+}
+
 // this ut will lead to crash in some case, see issue #685
 TEST_F(FiveRaftTest, DISABLED_Figure8) {
     // Test the scenarios described in Figure 8 of the extended Raft paper.
@@ -0,0 +1,187 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "fs/TempDir.h"
+#include "base/NebulaKeyUtils.h"
+#include "kvstore/RocksEngine.h"
+#include "kvstore/AdjacencyCache.h"
+
+namespace nebula {
+namespace kvstore {
+
+using Edge = AdjacencyCache::Edge;
+
+TEST(AdjacencyCacheTest, BuildTest) {
+    fs::TempDir rootPath("/tmp/AdjacencyCacheTest_BuildTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (VertexID vId = 0; vId < 10; vId++) {
+        data.emplace_back(NebulaKeyUtils::vertexKey(1, vId, 100, 0), "");
+        for (VertexID dst = 10; dst > 0; dst--) {
+            // Two versions of each out-edge, and the in-edge
+            data.emplace_back(NebulaKeyUtils::edgeKey(1, vId, 101, 0, dst, 0), "");
+            data.emplace_back(NebulaKeyUtils::edgeKey(1, vId, 101, 0, dst, 1), "");
+            data.emplace_back(NebulaKeyUtils::edgeKey(1, dst, -101, 0, vId, 0), "");
+        }
+        // Edges of another part
+        data.emplace_back(NebulaKeyUtils::edgeKey(2, vId, 101, 0, 0, 0), "");
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    AdjacencyCache cache(1);
+    std::vector<Edge> edges;
+    EXPECT_FALSE(cache.getEdges(0, 101, &edges));
+    // Nothing to do before the cache is built
+    cache.addEdges({{0, Edge{101, 0, 100}}});
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, cache.build(engine.get()));
+    ASSERT_TRUE(cache.ready());
+    EXPECT_EQ(200UL, cache.size());
+    for (VertexID vId = 0; vId < 10; vId++) {
+        edges.clear();
+        ASSERT_TRUE(cache.getEdges(vId, 101, &edges));
+        ASSERT_EQ(10UL, edges.size());
+        for (size_t i = 0; i < edges.size(); i++) {
+            EXPECT_EQ(101, edges[i].type_);
+            EXPECT_EQ(static_cast<VertexID>(i + 1), edges[i].dst_);
+        }
+        edges.clear();
+        ASSERT_TRUE(cache.getEdges(vId, 102, &edges));
+        EXPECT_TRUE(edges.empty());
+    }
+    edges.clear();
+    ASSERT_TRUE(cache.getEdges(1, -101, &edges));
+    ASSERT_EQ(10UL, edges.size());
+    EXPECT_EQ(0, edges[0].dst_);
+
+    cache.invalidate();
+    EXPECT_FALSE(cache.ready());
+    EXPECT_TRUE(cache.needBuild());
+    EXPECT_FALSE(cache.getEdges(0, 101, &edges));
+}
+
+
+TEST(AdjacencyCacheTest, AddEdgesTest) {
+    fs::TempDir rootPath("/tmp/AdjacencyCacheTest_AddEdgesTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (VertexID dst = 0; dst < 10; dst += 2) {
+        data.emplace_back(NebulaKeyUtils::edgeKey(1, 0, 101, 0, dst, 0), "");
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    AdjacencyCache cache(1);
+    EXPECT_EQ(ResultCode::SUCCEEDED, cache.build(engine.get()));
+    EXPECT_EQ(5UL, cache.size());
+
+    // The existing edges are ignored
+    std::vector<std::pair<VertexID, Edge>> added;
+    for (VertexID dst = 0; dst < 10; dst++) {
+        added.emplace_back(0, Edge{101, 0, dst});
+    }
+    cache.addEdges(added);
+    EXPECT_EQ(10UL, cache.size());
+    std::vector<Edge> edges;
+    ASSERT_TRUE(cache.getEdges(0, 101, &edges));
+    ASSERT_EQ(10UL, edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        EXPECT_EQ(static_cast<VertexID>(i), edges[i].dst_);
+    }
+
+    // Large enough to be merged into the snapshot
+    added.clear();
+    for (VertexID vId = 1000; vId > 0; vId--) {
+        for (EdgeRanking rank = 0; rank < 5; rank++) {
+            added.emplace_back(vId, Edge{101, rank, vId});
+        }
+    }
+    cache.addEdges(added);
+    EXPECT_EQ(5010UL, cache.size());
+    edges.clear();
+    ASSERT_TRUE(cache.getEdges(0, 101, &edges));
+    EXPECT_EQ(10UL, edges.size());
+    for (VertexID vId = 1; vId <= 1000; vId++) {
+        edges.clear();
+        ASSERT_TRUE(cache.getEdges(vId, 101, &edges));
+        ASSERT_EQ(5UL, edges.size());
+        for (size_t i = 0; i < edges.size(); i++) {
+            EXPECT_EQ(static_cast<EdgeRanking>(i), edges[i].rank_);
+            EXPECT_EQ(vId, edges[i].dst_);
+        }
+    }
+}
+
+
+TEST(AdjacencyCacheTest, RemoveEdgesTest) {
+    fs::TempDir rootPath("/tmp/AdjacencyCacheTest_RemoveEdgesTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (VertexID dst = 0; dst < 10; dst += 2) {
+        data.emplace_back(NebulaKeyUtils::edgeKey(1, 0, 101, 0, dst, 0), "");
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    AdjacencyCache cache(1);
+    EXPECT_EQ(ResultCode::SUCCEEDED, cache.build(engine.get()));
+    EXPECT_EQ(5UL, cache.size());
+
+    // Edges of the snapshot, of the delta, and the unknown ones
+    cache.addEdges({{0, Edge{101, 0, 1}}, {0, Edge{101, 0, 3}}});
+    EXPECT_EQ(7UL, cache.size());
+    cache.removeEdges({{0, Edge{101, 0, 0}},
+                       {0, Edge{101, 0, 1}},
+                       {0, Edge{101, 0, 5}},
+                       {1, Edge{101, 0, 0}}});
+    EXPECT_EQ(5UL, cache.size());
+    std::vector<Edge> edges;
+    ASSERT_TRUE(cache.getEdges(0, 101, &edges));
+    std::vector<VertexID> dsts;
+    for (auto& edge : edges) {
+        dsts.emplace_back(edge.dst_);
+    }
+    EXPECT_EQ((std::vector<VertexID>{2, 3, 4, 6, 8}), dsts);
+
+    // Added back after being removed
+    cache.addEdges({{0, Edge{101, 0, 0}}});
+    EXPECT_EQ(6UL, cache.size());
+    edges.clear();
+    ASSERT_TRUE(cache.getEdges(0, 101, &edges));
+    ASSERT_EQ(6UL, edges.size());
+    EXPECT_EQ(0, edges[0].dst_);
+
+    // Large enough to be merged into the snapshot
+    std::vector<std::pair<VertexID, Edge>> changed;
+    for (VertexID vId = 1; vId <= 5000; vId++) {
+        changed.emplace_back(vId, Edge{101, 0, vId});
+    }
+    cache.addEdges(changed);
+    EXPECT_EQ(5006UL, cache.size());
+    changed.resize(4000);
+    cache.removeEdges(changed);
+    EXPECT_EQ(1006UL, cache.size());
+    for (VertexID vId = 1; vId <= 5000; vId++) {
+        edges.clear();
+        ASSERT_TRUE(cache.getEdges(vId, 101, &edges));
+        EXPECT_EQ(vId > 4000 ? 1UL : 0UL, edges.size());
+    }
+    edges.clear();
+    ASSERT_TRUE(cache.getEdges(0, 101, &edges));
+    EXPECT_EQ(6UL, edges.size());
+}
+
+}  // namespace kvstore
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
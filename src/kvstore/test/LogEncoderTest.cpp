@@ -114,6 +114,60 @@ TEST(LogEncoderTest, MultiValuesTest) {
     }
 }
 
+
+TEST(LogEncoderTest, MultiPutRemoveTest) {
+    std::vector<KV> kvs;
+    for (int i = 0; i < 2; i++) {
+        kvs.emplace_back(folly::stringPrintf("Key%03d", i),
+                         folly::stringPrintf("Value%03d", i));
+    }
+    std::vector<std::string> keys;
+    for (int i = 0; i < 3; i++) {
+        keys.emplace_back(folly::stringPrintf("Removed%03d", i));
+    }
+    auto encoded = encodeMultiPutRemove(kvs, keys);
+    ASSERT_EQ(OP_MULTI_PUT_REMOVE, encoded[sizeof(int64_t)]);
+
+    auto decoded = decodeMultiValues(encoded);
+    // The number of pairs, 2 pairs, then 3 keys
+    ASSERT_EQ(1 + 4 + 3, decoded.size());
+    ASSERT_EQ(2, *reinterpret_cast<const uint32_t*>(decoded[0].data()));
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(folly::stringPrintf("Key%03d", i), decoded[1 + i * 2].toString());
+        ASSERT_EQ(folly::stringPrintf("Value%03d", i), decoded[2 + i * 2].toString());
+    }
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(folly::stringPrintf("Removed%03d", i), decoded[5 + i].toString());
+    }
+}
+
+
+TEST(LogEncoderTest, GuardedRemoveTest) {
+    std::vector<GuardedKey> keys(2);
+    keys[0].key = "Key000";
+    keys[0].prefix = "Prefix000";
+    keys[0].type = ScanType::VERTEX;
+    keys[0].guard = std::make_pair("Guard000", "Value000");
+    // No guard
+    keys[1].key = "Key001";
+    keys[1].prefix = "Prefix001";
+    auto encoded = encodeGuardedRemove(keys);
+    ASSERT_EQ(OP_GUARDED_REMOVE, encoded[sizeof(int64_t)]);
+
+    auto decoded = decodeGuardedRemove(encoded);
+    ASSERT_EQ(2, decoded.size());
+    EXPECT_EQ("Key000", decoded[0].key);
+    EXPECT_EQ("Prefix000", decoded[0].prefix);
+    EXPECT_EQ(ScanType::VERTEX, decoded[0].type);
+    EXPECT_EQ("Guard000", decoded[0].guard.first);
+    EXPECT_EQ("Value000", decoded[0].guard.second);
+    EXPECT_EQ("Key001", decoded[1].key);
+    EXPECT_EQ("Prefix001", decoded[1].prefix);
+    EXPECT_EQ(ScanType::ANY, decoded[1].type);
+    EXPECT_TRUE(decoded[1].guard.first.empty());
+    EXPECT_TRUE(decoded[1].guard.second.empty());
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -12,9 +12,12 @@
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/RocksEngine.h"
+#include "kvstore/Part.h"
+#include "base/NebulaKeyUtils.h"
 #include "network/NetworkUtils.h"
 
 DECLARE_uint32(heartbeat_interval);
+DECLARE_string(adjacency_cache_spaces);
 
 namespace nebula {
 namespace kvstore {
@@ -373,6 +376,129 @@ TEST(NebulaStoreTest, ThreeCopiesTest) {
 }
 
 
+
+TEST(NebulaStoreTest, AdjacencyCacheIgnoresIndexKeysTest) {
+    FLAGS_adjacency_cache_spaces = "1";
+    fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+    auto partMan = std::make_unique<MemPartManager>();
+    partMan->partsMap_[1][0] = PartMeta();
+
+    KVOptions options;
+    options.dataPaths_ = {folly::stringPrintf("%s/disk1", rootPath.path())};
+    options.partMan_ = std::move(partMan);
+    auto store = std::make_unique<NebulaStore>(std::move(options),
+                                               ioThreadPool,
+                                               HostAddr(0, 0));
+    store->init();
+    sleep(1);
+
+    auto partRet = store->part(1, 0);
+    ASSERT_TRUE(ok(partRet));
+    auto* cache = value(partRet)->adjacencyCache();
+    ASSERT_NE(nullptr, cache);
+    while (!cache->ready()) {
+        usleep(10000);
+    }
+
+    // Index keys as long as the edge keys, 32 and 40 bytes
+    auto intValue = NebulaKeyUtils::encodeIndexValue(10L);
+    std::vector<std::string> indexKeys = {
+        NebulaKeyUtils::vertexIndexKey(0, 3001, "a", intValue, 1),
+        NebulaKeyUtils::vertexIndexKey(0, 3001, "abcdefghi", intValue, 1),
+    };
+    EXPECT_EQ(32UL, indexKeys[0].size());
+    EXPECT_EQ(40UL, indexKeys[1].size());
+
+    std::vector<KV> data;
+    for (auto& key : indexKeys) {
+        data.emplace_back(key, "");
+    }
+    data.emplace_back(NebulaKeyUtils::edgeKey(0, 1, 101, 0, 2, 0), "");
+    {
+        folly::Baton<true, std::atomic> baton;
+        store->asyncMultiPut(1, 0, std::move(data), [&] (ResultCode code) {
+            EXPECT_EQ(ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+    EXPECT_EQ(1UL, cache->size());
+
+    // Removing them does not invalidate the cache either
+    {
+        folly::Baton<true, std::atomic> baton;
+        store->asyncMultiRemove(1, 0, indexKeys, [&] (ResultCode code) {
+            EXPECT_EQ(ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+    EXPECT_TRUE(cache->ready());
+    std::vector<AdjacencyCache::Edge> edges;
+    ASSERT_TRUE(cache->getEdges(1, 101, &edges));
+    ASSERT_EQ(1UL, edges.size());
+    EXPECT_EQ(2, edges[0].dst_);
+    FLAGS_adjacency_cache_spaces = "";
+}
+
+TEST(NebulaStoreTest, GuardedRemoveTest) {
+    fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+    auto partMan = std::make_unique<MemPartManager>();
+    partMan->partsMap_[1][0] = PartMeta();
+
+    KVOptions options;
+    options.dataPaths_ = {folly::stringPrintf("%s/disk1", rootPath.path())};
+    options.partMan_ = std::move(partMan);
+    auto store = std::make_unique<NebulaStore>(std::move(options),
+                                               ioThreadPool,
+                                               HostAddr(0, 0));
+    store->init();
+    sleep(1);
+
+    std::vector<KV> data = {{"row_1", "v1"}, {"key_1", ""}, {"key_2", ""}, {"key_3", ""}};
+    {
+        folly::Baton<true, std::atomic> baton;
+        store->asyncMultiPut(1, 0, std::move(data), [&] (ResultCode code) {
+            EXPECT_EQ(ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+
+    auto guarded = [] (std::string key, std::string prefix, KV guard) {
+        GuardedKey k;
+        k.key = std::move(key);
+        k.prefix = std::move(prefix);
+        k.guard = std::move(guard);
+        return k;
+    };
+    auto remove = [&] (std::vector<GuardedKey> keys) {
+        folly::Baton<true, std::atomic> baton;
+        store->asyncGuardedRemove(1, 0, std::move(keys), [&] (ResultCode code) {
+            EXPECT_EQ(ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    };
+    auto exists = [&] (const std::string& key) {
+        std::string value;
+        return store->get(1, 0, key, &value) == ResultCode::SUCCEEDED;
+    };
+
+    // The guard of key_2 has changed since, and so it is kept
+    remove({guarded("key_1", "row_", {"row_1", "v1"}),
+            guarded("key_2", "row_", {"row_1", "v0"}),
+            guarded("key_3", "none_", {"", ""})});
+    EXPECT_FALSE(exists("key_1"));
+    EXPECT_TRUE(exists("key_2"));
+    EXPECT_FALSE(exists("key_3"));
+    EXPECT_TRUE(exists("row_1"));
+
+    // Nothing to remove at all
+    remove({guarded("key_2", "row_", {"", ""})});
+    EXPECT_TRUE(exists("key_2"));
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -9,6 +9,7 @@
 #include <rocksdb/db.h>
 #include <folly/lang/Bits.h>
 #include "fs/TempDir.h"
+#include "base/NebulaKeyUtils.h"
 #include "kvstore/RocksEngine.h"
 
 namespace nebula {
@@ -198,6 +199,122 @@ TEST(RocksEngineTest, CompactTest) {
     EXPECT_EQ(ResultCode::SUCCEEDED, engine->compact());
 }
 
+
+TEST(RocksEngineTest, MultiColumnFamiliesTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_MultiColumnFamiliesTest.XXXXXX");
+    PartitionID partId = 1;
+    VertexID vId = 10;
+    auto vertexKey = NebulaKeyUtils::vertexKey(partId, vId, 3001, 0);
+    auto outEdgeKey = NebulaKeyUtils::edgeKey(partId, vId, 101, 0, 20, 0);
+    auto inEdgeKey = NebulaKeyUtils::edgeKey(partId, vId, -101, 0, 30, 0);
+    std::vector<KV> data;
+    data.emplace_back(vertexKey, "vertex");
+    data.emplace_back(outEdgeKey, "out_edge");
+    data.emplace_back(inEdgeKey, "in_edge");
+    data.emplace_back("__system__key", "system");
+
+    auto countKeys = [] (RocksEngine* engine, rocksdb::ColumnFamilyHandle* handle) {
+        std::unique_ptr<rocksdb::Iterator> iter(
+            engine->db_->NewIterator(rocksdb::ReadOptions(), handle));
+        int32_t num = 0;
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            num++;
+        }
+        return num;
+    };
+
+    auto checkData = [&] (RocksEngine* engine) {
+        for (auto& kv : data) {
+            std::string val;
+            EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(kv.first, &val));
+            EXPECT_EQ(kv.second, val);
+        }
+        // All the keys of the vertex, in key order
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->prefix(NebulaKeyUtils::prefix(partId, vId), &iter));
+        std::vector<std::string> keys;
+        while (iter->valid()) {
+            keys.emplace_back(iter->key().str());
+            iter->next();
+        }
+        std::vector<std::string> expected{vertexKey, outEdgeKey, inEdgeKey};
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(expected, keys);
+
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->prefix(NebulaKeyUtils::prefix(partId, vId, 101), &iter));
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(outEdgeKey, iter->key().str());
+        iter->next();
+        EXPECT_FALSE(iter->valid());
+    };
+
+    {
+        LOG(INFO) << "Write data with the default layout";
+        auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(data));
+        engine->addPart(partId);
+        checkData(engine.get());
+    }
+    {
+        LOG(INFO) << "Reopen with the multi column family layout";
+        auto engine = std::make_unique<RocksEngine>(0, rootPath.path(), nullptr, nullptr, true);
+        ASSERT_EQ(4UL, engine->handles_.size());
+        // system keys: __system__key, the part and the layout
+        EXPECT_EQ(3, countKeys(engine.get(), engine->handles_[0]));
+        EXPECT_EQ(1, countKeys(engine.get(), engine->handles_[1]));
+        EXPECT_EQ(1, countKeys(engine.get(), engine->handles_[2]));
+        EXPECT_EQ(1, countKeys(engine.get(), engine->handles_[3]));
+        EXPECT_EQ(std::vector<PartitionID>{partId}, engine->allParts());
+        checkData(engine.get());
+
+        // A scan telling what it is looking for only seeks one column family
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->prefix(NebulaKeyUtils::prefix(partId, vId, 3001), &iter,
+                                 ScanType::VERTEX));
+        EXPECT_EQ(nullptr, dynamic_cast<RocksMergedIter*>(iter.get()));
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(vertexKey, iter->key().str());
+        iter->next();
+        EXPECT_FALSE(iter->valid());
+
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->prefix(NebulaKeyUtils::prefix(partId, vId, 101), &iter,
+                                 ScanType::EDGE));
+        EXPECT_EQ(nullptr, dynamic_cast<RocksMergedIter*>(iter.get()));
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(outEdgeKey, iter->key().str());
+        iter->next();
+        EXPECT_FALSE(iter->valid());
+
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->prefix(NebulaKeyUtils::prefix(partId, vId), &iter, ScanType::EDGE));
+        std::vector<std::string> keys;
+        while (iter->valid()) {
+            keys.emplace_back(iter->key().str());
+            iter->next();
+        }
+        std::vector<std::string> expected{outEdgeKey, inEdgeKey};
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(expected, keys);
+
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->removePrefix(NebulaKeyUtils::prefix(partId, vId, -101)));
+        std::string val;
+        EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get(inEdgeKey, &val));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put(inEdgeKey, "in_edge"));
+    }
+    {
+        LOG(INFO) << "Back to the default layout";
+        auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+        ASSERT_EQ(1UL, engine->handles_.size());
+        EXPECT_EQ(5, countKeys(engine.get(), engine->handles_[0]));
+        checkData(engine.get());
+    }
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -0,0 +1,136 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "kvstore/wal/BufferArena.h"
+#include "kvstore/wal/FileBasedWal.h"
+
+DEFINE_int32(wal_buffers_budget_mb, 2048,
+             "The memory shared by the WAL buffers of all the partitions, "
+             "appending logs blocks when it is exhausted. 0 means unlimited");
+DEFINE_int32(wal_buffer_idle_secs, 60,
+             "Flush the WAL buffer of a partition once it has not been appended "
+             "for this long");
+
+namespace nebula {
+namespace wal {
+
+// static
+BufferArena& BufferArena::get() {
+    static BufferArena arena;
+    return arena;
+}
+
+
+void BufferArena::addWal(std::weak_ptr<FileBasedWal> wal) {
+    std::lock_guard<std::mutex> g(lock_);
+    wals_.emplace_back(std::move(wal));
+}
+
+
+std::vector<std::shared_ptr<FileBasedWal>> BufferArena::wals() {
+    std::vector<std::shared_ptr<FileBasedWal>> wals;
+    std::lock_guard<std::mutex> g(lock_);
+    wals.reserve(wals_.size());
+    auto it = wals_.begin();
+    while (it != wals_.end()) {
+        auto wal = it->lock();
+        if (wal == nullptr) {
+            it = wals_.erase(it);
+        } else {
+            wals.emplace_back(std::move(wal));
+            ++it;
+        }
+    }
+    return wals;
+}
+
+
+void BufferArena::acquire(size_t bytes) {
+    size_t budget = FLAGS_wal_buffers_budget_mb * 1024L * 1024L;
+    // A log larger than the budget still goes through, when nothing else is buffered
+    auto used = used_.load();
+    if (budget == 0 || used == 0 || used + bytes <= budget) {
+        used_ += bytes;
+        return;
+    }
+
+    numBackPressure_++;
+    VLOG(1) << "The WAL buffers are exhausted, " << used
+            << " bytes are used, need to wait for the flush";
+    auto start = std::chrono::steady_clock::now();
+    flushHottest(used + bytes - budget);
+    {
+        std::unique_lock<std::mutex> g(lock_);
+        while (used_.load() != 0 && used_.load() + bytes > budget) {
+            if (releasedCV_.wait_for(g, std::chrono::milliseconds(100))
+                    == std::cv_status::timeout) {
+                // The flushed ones were appended again meanwhile
+                g.unlock();
+                flushHottest(used_.load() + bytes - budget);
+                g.lock();
+            }
+        }
+    }
+    used_ += bytes;
+
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    backPressureMs_ += waited;
+    if (listener_) {
+        listener_(waited);
+    }
+}
+
+
+void BufferArena::release(size_t bytes) {
+    CHECK_GE(used_.load(), bytes);
+    used_ -= bytes;
+    {
+        // Make sure no one misses the notification between checking and waiting
+        std::lock_guard<std::mutex> g(lock_);
+    }
+    releasedCV_.notify_all();
+}
+
+
+void BufferArena::flushHottest(size_t bytes) {
+    std::vector<std::pair<size_t, std::shared_ptr<FileBasedWal>>> active;
+    for (auto& wal : wals()) {
+        auto size = wal->activeBufferSize();
+        if (size > 0) {
+            active.emplace_back(size, std::move(wal));
+        }
+    }
+    std::sort(active.begin(), active.end(), [] (const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+
+    size_t flushed = 0;
+    for (auto& wal : active) {
+        if (flushed >= bytes) {
+            break;
+        }
+        flushed += wal.second->flushActiveBuffer();
+    }
+    VLOG(2) << "Flushed " << flushed << " bytes of WAL buffers";
+}
+
+
+void BufferArena::flushIdleWals(BufferFlusher* flusher) {
+    int64_t idleMs = FLAGS_wal_buffer_idle_secs * 1000L;
+    for (auto& wal : wals()) {
+        if (wal->flusher() == flusher && wal->idleMs() >= idleMs) {
+            auto flushed = wal->flushActiveBuffer();
+            if (flushed > 0) {
+                VLOG(2) << "Flushed " << flushed << " bytes of the idle WAL " << wal->dir();
+            }
+        }
+    }
+}
+
+}  // namespace wal
+}  // namespace nebula
@@ -0,0 +1,85 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WAL_BUFFERARENA_H_
+#define WAL_BUFFERARENA_H_
+
+#include "base/Base.h"
+
+namespace nebula {
+namespace wal {
+
+class FileBasedWal;
+class BufferFlusher;
+
+/**
+ * Process-wide budget for the in-memory buffers of all the WALs.
+ *
+ * Every log appended is charged to the arena, and credited back once the
+ * buffer holding it has been flushed. When the budget is exhausted, appending
+ * blocks until the WALs with the largest active buffers, i.e. the hottest
+ * partitions, have flushed them. The WALs idle for a while flush their buffers
+ * as well, so idle partitions hold no buffer at all.
+ * */
+class BufferArena final {
+public:
+    static BufferArena& get();
+
+    void addWal(std::weak_ptr<FileBasedWal> wal);
+
+    // Charge the bytes of a new log, block while the budget is exhausted
+    void acquire(size_t bytes);
+
+    // Credit the bytes of a buffer which has been flushed or dropped
+    void release(size_t bytes);
+
+    // Flush the active buffers of the WALs using the flusher, which have
+    // not been appended for wal_buffer_idle_secs
+    void flushIdleWals(BufferFlusher* flusher);
+
+    // Called with the milliseconds each blocked append has waited, so that
+    // the daemon could report the back-pressure
+    void setBackPressureListener(std::function<void(int64_t)> listener) {
+        listener_ = std::move(listener);
+    }
+
+    size_t used() const {
+        return used_.load();
+    }
+
+    int64_t numBackPressure() const {
+        return numBackPressure_.load();
+    }
+
+    int64_t backPressureMs() const {
+        return backPressureMs_.load();
+    }
+
+private:
+    BufferArena() = default;
+
+    // Live WALs, the expired ones are dropped meanwhile
+    std::vector<std::shared_ptr<FileBasedWal>> wals();
+
+    // Flush the largest active buffers until about "bytes" are on the way out
+    void flushHottest(size_t bytes);
+
+private:
+    std::atomic<size_t> used_{0};
+
+    std::mutex lock_;
+    std::condition_variable releasedCV_;
+    std::list<std::weak_ptr<FileBasedWal>> wals_;
+
+    std::atomic<int64_t> numBackPressure_{0};
+    std::atomic<int64_t> backPressureMs_{0};
+    std::function<void(int64_t)> listener_;
+};
+
+}  // namespace wal
+}  // namespace nebula
+
+#endif  // WAL_BUFFERARENA_H_
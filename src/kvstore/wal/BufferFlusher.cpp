@@ -7,10 +7,18 @@
 #include "base/Base.h"
 #include "kvstore/wal/BufferFlusher.h"
 #include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/BufferArena.h"
 
 namespace nebula {
 namespace wal {
 
+namespace {
+
+constexpr auto kIdleSweepInterval = std::chrono::seconds(1);
+
+}  // Anonymous namespace
+
+
 BufferFlusher::BufferFlusher()
     : flushThread_("Buffer flusher",
                    std::bind(&BufferFlusher::flushLoop, this)) {
@@ -53,7 +61,16 @@ bool BufferFlusher::flushBuffer(std::shared_ptr<FileBasedWal> wal,
 void BufferFlusher::flushLoop() {
     LOG(INFO) << "Buffer flusher loop started";
 
+    // The idle partitions release their buffers on a timer rather than only when
+    // the queue drains, since the budget is tight exactly when it does not.
+    auto lastSweep = std::chrono::steady_clock::now();
     while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep >= kIdleSweepInterval) {
+            BufferArena::get().flushIdleWals(this);
+            lastSweep = now;
+        }
+
         decltype(buffers_)::value_type bufferPair;
         {
             std::unique_lock<std::mutex> g(buffersLock_);
@@ -63,15 +80,14 @@ void BufferFlusher::flushLoop() {
                                " so exiting the flush loop";
                     break;
                 }
-                // Otherwise need to wait
-                bufferReadyCV_.wait(g, [this] {
+                // Otherwise need to wait, until the next sweep at most
+                bufferReadyCV_.wait_until(g, lastSweep + kIdleSweepInterval, [this] {
                     return !buffers_.empty() || stopped_;
                 });
                 continue;
-            } else {
-                bufferPair = std::move(buffers_.front());
-                buffers_.pop();
             }
+            bufferPair = std::move(buffers_.front());
+            buffers_.pop();
         }
         bufferPair.first->flushBuffer(bufferPair.second);
     }
@@ -8,13 +8,28 @@
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/FileBasedWalIterator.h"
 #include "kvstore/wal/BufferFlusher.h"
+#include "kvstore/wal/BufferArena.h"
+#include "kvstore/wal/WalFileReader.h"
 #include "fs/FileUtils.h"
 
+DEFINE_int32(wal_index_interval_kb, 64,
+             "Index one log id every so many kilobytes of the WAL files, so that"
+             " locating a log scans no more than that");
+
 namespace nebula {
 namespace wal {
 
 using nebula::fs::FileUtils;
 
+namespace {
+
+int64_t steadyNowInMSec() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // Anonymous namespace
+
 /**********************************************
  *
  * Implementation of FileBasedWal
@@ -26,8 +41,10 @@ std::shared_ptr<FileBasedWal> FileBasedWal::getWal(
         FileBasedWalPolicy policy,
         BufferFlusher* flusher,
         PreProcessor preProcessor) {
-    return std::shared_ptr<FileBasedWal>(
+    auto wal = std::shared_ptr<FileBasedWal>(
         new FileBasedWal(dir, std::move(policy), flusher, std::move(preProcessor)));
+    BufferArena::get().addWal(wal);
+    return wal;
 }
 
 
@@ -64,10 +81,12 @@ FileBasedWal::~FileBasedWal() {
     if (!buffers_.empty()) {
         // There should be only one left
         CHECK_EQ(buffers_.size(), 1UL);
-        if (buffers_.back()->freeze()) {
-            flushBuffer(buffers_.back());
-        }
+        // It might have been frozen already, but refused by the stopped flusher
+        buffers_.back()->freeze();
+        flushBuffer(buffers_.back());
     }
+    // Persist the index of the last file as well
+    closeCurrFile();
 
     // Close the last file
     closeCurrFile();
@@ -234,6 +253,7 @@ void FileBasedWal::scanAllWalFiles() {
 
         // We now get all necessary info
         close(fd);
+        loadIndex(info);
         walFiles_.insert(std::make_pair(startIdFromName, info));
     }
 
@@ -259,6 +279,7 @@ void FileBasedWal::scanAllWalFiles() {
                 LOG(INFO) << "Removing the wal file \""
                           << it->second->path() << "\"";
                 unlink(it->second->path());
+                unlink(it->second->indexPath().c_str());
                 it = walFiles_.erase(it);
             }
         }
@@ -266,6 +287,95 @@ void FileBasedWal::scanAllWalFiles() {
 }
 
 
+void FileBasedWal::loadIndex(WalFileInfoPtr info) {
+    std::vector<std::pair<LogID, int64_t>> index;
+    int fd = open(info->indexPath().c_str(), O_RDONLY);
+    if (fd >= 0) {
+        // The index file is a sequence of <LogID> <int64_t offset>
+        std::pair<LogID, int64_t> entry;
+        while (read(fd, &entry.first, sizeof(LogID)) == sizeof(LogID)
+                && read(fd, &entry.second, sizeof(int64_t)) == sizeof(int64_t)) {
+            if (entry.second >= static_cast<int64_t>(info->size())
+                    || (!index.empty() && entry.first <= index.back().first)) {
+                break;
+            }
+            index.emplace_back(entry);
+        }
+        close(fd);
+    }
+
+    WalFileReader reader(info->path());
+    if (!reader.valid()) {
+        return;
+    }
+    // Verify the last indexed entry, the index would be rebuilt from scratch
+    // if it is stale
+    int64_t pos = 0;
+    if (!index.empty()) {
+        if (reader.readEntry(index.back().second)
+                && reader.logId() == index.back().first) {
+            pos = index.back().second;
+        } else {
+            LOG(WARNING) << "The index of \"" << info->path()
+                         << "\" does not match the wal file, rebuild it";
+            index.clear();
+        }
+    }
+    info->setIndex(std::move(index));
+
+    // Index the rest of the file, i.e. the file which was not closed properly
+    int64_t lastIndexed = info->lastIndexedOffset();
+    while (pos < static_cast<int64_t>(info->size()) && reader.readEntry(pos)) {
+        if (lastIndexed < 0 || pos - lastIndexed >= FLAGS_wal_index_interval_kb * 1024L) {
+            info->addIndex(reader.logId(), pos);
+            lastIndexed = pos;
+        }
+        pos = reader.nextPos();
+    }
+}
+
+
+void FileBasedWal::writeIndex(WalFileInfoPtr info) {
+    auto index = info->index();
+    std::string data;
+    data.reserve(index.size() * (sizeof(LogID) + sizeof(int64_t)));
+    for (auto& entry : index) {
+        data.append(reinterpret_cast<const char*>(&entry.first), sizeof(LogID));
+        data.append(reinterpret_cast<const char*>(&entry.second), sizeof(int64_t));
+    }
+
+    // Write to a temp file then rename, so the index is never half written
+    auto path = info->indexPath();
+    auto tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open file \"" << tmpPath << "\" ("
+                   << errno << "): " << strerror(errno);
+        return;
+    }
+    const char* start = data.data();
+    size_t size = data.size();
+    while (size > 0) {
+        ssize_t res = write(fd, start, size);
+        if (res < 0) {
+            LOG(ERROR) << "Failed to write file \"" << tmpPath << "\" ("
+                       << errno << "): " << strerror(errno);
+            close(fd);
+            unlink(tmpPath.c_str());
+            return;
+        }
+        size -= res;
+        start += res;
+    }
+    close(fd);
+    if (rename(tmpPath.c_str(), path.c_str()) < 0) {
+        LOG(ERROR) << "Failed to rename \"" << tmpPath << "\" ("
+                   << errno << "): " << strerror(errno);
+        unlink(tmpPath.c_str());
+    }
+}
+
+
 void FileBasedWal::closeCurrFile() {
     if (currFd_ < 0) {
         // Already closed
@@ -280,6 +390,7 @@ void FileBasedWal::closeCurrFile() {
     currInfo_->setMTime(time(nullptr));
     DCHECK_EQ(currInfo_->size(), FileUtils::fileSize(currInfo_->path()))
         << currInfo_->path() << " size does not match";
+    writeIndex(currInfo_);
     currInfo_.reset();
 }
 
@@ -314,7 +425,8 @@ void FileBasedWal::prepareNewFile(LogID startLogId) {
 void FileBasedWal::dumpCord(Cord& cord,
                             LogID firstId,
                             LogID lastId,
-                            TermID lastTerm) {
+                            TermID lastTerm,
+                            const std::vector<std::pair<LogID, int64_t>>& index) {
     if (cord.size() <= 0) {
         return;
     }
@@ -343,6 +455,10 @@ void FileBasedWal::dumpCord(Cord& cord,
         LOG(FATAL) << "Failed to flush the wal file";
     } else {
         // Succeeded writing all buffered content, adjust the file size
+        // and the index, whose offsets are relative to the cord
+        for (auto& entry : index) {
+            currInfo_->addIndex(entry.first, currInfo_->size() + entry.second);
+        }
         currInfo_->setSize(currInfo_->size() + cord.size());
         currInfo_->setLastId(lastId);
         currInfo_->setLastTerm(lastTerm);
@@ -363,24 +479,36 @@ void FileBasedWal::flushBuffer(BufferPtr buffer) {
 
     Cord cord;
     LogID firstIdInCord = buffer->firstLogId();
-    auto accessFn = [&cord, &firstIdInCord, this] (
+    // Offsets in the cord of the logs to index
+    std::vector<std::pair<LogID, int64_t>> index;
+    int64_t lastIndexed = currFd_ >= 0 ? currInfo_->lastIndexedOffset() : -1;
+    int64_t indexInterval = FLAGS_wal_index_interval_kb * 1024L;
+    auto accessFn = [&cord, &firstIdInCord, &index, &lastIndexed, indexInterval, this] (
             LogID id,
             TermID term,
             ClusterID cluster,
             const std::string& log) {
+        size_t currSize = currFd_ >= 0 ? currInfo_->size() : 0;
+        int64_t offset = currSize + cord.size();
+        if (lastIndexed < 0 || offset - lastIndexed >= indexInterval) {
+            index.emplace_back(id, cord.size());
+            lastIndexed = offset;
+        }
+
         cord << id << term << int32_t(log.size()) << cluster;
         cord.write(log.data(), log.size());
         cord << int32_t(log.size());
 
-        size_t currSize = currFd_ >= 0 ? currInfo_->size() : 0;
         if (currSize + cord.size() > maxFileSize_) {
-            dumpCord(cord, firstIdInCord, id, term);
+            dumpCord(cord, firstIdInCord, id, term, index);
             // Reset the cord
             cord.clear();
+            index.clear();
             firstIdInCord = id + 1;
 
             // Need to close the current file and create a new file
             closeCurrFile();
+            lastIndexed = -1;
         }
     };
 
@@ -389,7 +517,7 @@ void FileBasedWal::flushBuffer(BufferPtr buffer) {
 
     // Dump the rest if any
     if (!cord.empty()) {
-        dumpCord(cord, firstIdInCord, lastLog.first, lastLog.second);
+        dumpCord(cord, firstIdInCord, lastLog.first, lastLog.second, index);
     }
 
     // Flush the wal file
@@ -404,10 +532,43 @@ void FileBasedWal::flushBuffer(BufferPtr buffer) {
         CHECK_EQ(buffer.get(), buffers_.front().get());
         buffers_.pop_front();
     }
+    BufferArena::get().release(buffer->size());
     slotReadyCV_.notify_one();
 }
 
 
+size_t FileBasedWal::activeBufferSize() const {
+    std::lock_guard<std::mutex> g(buffersMutex_);
+    if (buffers_.empty() || buffers_.back()->frozen()) {
+        return 0;
+    }
+    return buffers_.back()->size();
+}
+
+
+size_t FileBasedWal::flushActiveBuffer() {
+    BufferPtr buffer;
+    {
+        std::lock_guard<std::mutex> g(buffersMutex_);
+        if (buffers_.empty()) {
+            return 0;
+        }
+        buffer = buffers_.back();
+    }
+    // An empty buffer is never flushed, so it must not be frozen either
+    if (buffer->empty() || !buffer->freeze()) {
+        return 0;
+    }
+    flusher_->flushBuffer(shared_from_this(), buffer);
+    return buffer->size();
+}
+
+
+int64_t FileBasedWal::idleMs() const {
+    return steadyNowInMSec() - lastAppendTime_.load();
+}
+
+
 BufferPtr FileBasedWal::createNewBuffer(
         LogID firstId,
         std::unique_lock<std::mutex>& guard) {
@@ -449,31 +610,36 @@ bool FileBasedWal::appendLogInternal(BufferPtr& buffer,
         return false;
     }
 
-    if (buffer &&
-        (buffer->size() +
-         msg.size() +
-         sizeof(ClusterID) +
-         sizeof(TermID) +
-         sizeof(LogID) > maxBufferSize_)) {
-        // Freeze the current buffer
-        if (buffer->freeze()) {
-            flusher_->flushBuffer(shared_from_this(), buffer);
+    size_t logSize = msg.size() + sizeof(ClusterID) + sizeof(TermID) + sizeof(LogID);
+    BufferArena::get().acquire(logSize);
+
+    while (true) {
+        if (buffer && buffer->size() + logSize > maxBufferSize_) {
+            // Freeze the current buffer
+            if (buffer->freeze()) {
+                flusher_->flushBuffer(shared_from_this(), buffer);
+            }
+            buffer.reset();
         }
-        buffer.reset();
-    }
 
-    // Create a new buffer if needed
-    if (!buffer) {
-        std::unique_lock<std::mutex> guard(buffersMutex_);
-        buffer = createNewBuffer(id, guard);
-    }
+        // Create a new buffer if needed
+        if (!buffer) {
+            std::unique_lock<std::mutex> guard(buffersMutex_);
+            buffer = createNewBuffer(id, guard);
+        }
 
-    DCHECK_EQ(
-        id,
-        static_cast<int64_t>(buffer->firstLogId() + buffer->numLogs()));
-    buffer->push(term, cluster, std::move(msg));
+        DCHECK_EQ(
+            id,
+            static_cast<int64_t>(buffer->firstLogId() + buffer->numLogs()));
+        if (buffer->push(term, cluster, std::move(msg))) {
+            break;
+        }
+        // The buffer has been frozen by the arena meanwhile
+        buffer.reset();
+    }
     lastLogId_ = id;
     lastLogTerm_ = term;
+    lastAppendTime_ = steadyNowInMSec();
 
     return true;
 }
@@ -558,6 +724,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
         }
         while (it != buffers_.end()) {
             (*it)->markInvalid();
+            BufferArena::get().release((*it)->size());
             it = buffers_.erase(it);
         }
 
@@ -584,7 +751,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
         }
     }
 
-    int fd{-1};
+    WalFileInfoPtr info;
     while (!foundTarget) {
         LOG(WARNING) << "Need to rollback from files."
                         " This is an expensive operation."
@@ -612,6 +779,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
             // Need to remove the file
             VLOG(2) << "Removing file " << it->second->path();
             unlink(it->second->path());
+            unlink(it->second->indexPath().c_str());
             it = walFiles_.erase(it);
         }
 
@@ -622,50 +790,26 @@ bool FileBasedWal::rollbackToLog(LogID id) {
             break;
         }
 
-        fd = open(walFiles_.rbegin()->second->path(), O_RDONLY);
-        CHECK_GE(fd, 0) << "Failed to open file \""
-                        << walFiles_.rbegin()->second->path()
-                        << "\" (" << errno << "): "
-                        << strerror(errno);
+        info = walFiles_.rbegin()->second;
         lastLogId_ = id;
         break;
     }
 
-    // Find the current log entry
-    if (fd >= 0) {
-        size_t pos = 0;
+    // Find the current log entry, starting from the closest indexed one
+    if (info != nullptr) {
+        WalFileReader reader(info->path());
+        CHECK(reader.valid());
+        int64_t pos = info->indexedOffset(lastLogId_);
         while (true) {
-            LogID logId;
-            // Read the logID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&logId),
-                           sizeof(LogID),
-                           pos),
-                     static_cast<ssize_t>(sizeof(LogID)));
-            // Read the termID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&lastLogTerm_),
-                           sizeof(TermID),
-                           pos + sizeof(LogID)),
-                     static_cast<ssize_t>(sizeof(TermID)));
-            // Read the log length
-            int32_t msgLen = 0;
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&msgLen),
-                           sizeof(int32_t),
-                           pos + sizeof(LogID) + sizeof(TermID)),
-                     static_cast<ssize_t>(sizeof(int32_t)));
-            if (logId == lastLogId_) {
+            CHECK(reader.readEntry(pos)) << "Failed to find the log " << lastLogId_
+                                         << " in \"" << info->path() << "\"";
+            if (reader.logId() == lastLogId_) {
+                lastLogTerm_ = reader.logTerm();
                 foundTarget = true;
                 break;
             }
-            pos += sizeof(LogID)
-                   + sizeof(TermID)
-                   + sizeof(int32_t) * 2
-                   + msgLen
-                   + sizeof(ClusterID);
+            pos = reader.nextPos();
         }
-        close(fd);
     }
 
     CHECK(foundTarget);
@@ -117,6 +117,24 @@ public:
     // Dump a buffer into a WAL file
     void flushBuffer(BufferPtr buffer);
 
+    // Bytes in the buffer being appended
+    size_t activeBufferSize() const;
+
+    // Freeze the buffer being appended and hand it to the flusher,
+    // return its size, or 0 if there was nothing to flush
+    size_t flushActiveBuffer();
+
+    // Milliseconds since the last log was appended
+    int64_t idleMs() const;
+
+    BufferFlusher* flusher() const {
+        return flusher_;
+    }
+
+    const std::string& dir() const {
+        return dir_;
+    }
+
 
 private:
     /***************************************
@@ -134,11 +152,18 @@ private:
     // Scan all WAL files
     void scanAllWalFiles();
 
-    // Dump a Cord to the current file
+    // Load the persisted index of the WAL file, and index the rest of it
+    void loadIndex(WalFileInfoPtr info);
+    // Persist the index of the WAL file, once the file is closed
+    void writeIndex(WalFileInfoPtr info);
+
+    // Dump a Cord to the current file, the offsets in the index are
+    // relative to the beginning of the cord
     void dumpCord(Cord& cord,
                   LogID firstId,
                   LogID lastId,
-                  TermID lastTerm);
+                  TermID lastTerm,
+                  const std::vector<std::pair<LogID, int64_t>>& index);
 
     // Close down the current wal file
     void closeCurrFile();
@@ -196,6 +221,8 @@ private:
     mutable std::mutex buffersMutex_;
     // There is a vacancy for a new buffer
     std::condition_variable slotReadyCV_;
+    // When the last log was appended, in milliseconds of the steady clock
+    std::atomic<int64_t> lastAppendTime_{0};
 
     mutable std::mutex flushMutex_;
     PreProcessor preProcessor_;
@@ -8,6 +8,7 @@
 #include "kvstore/wal/FileBasedWalIterator.h"
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/WalFileInfo.h"
+#include "kvstore/wal/WalFileReader.h"
 
 namespace nebula {
 namespace wal {
@@ -54,28 +55,30 @@ FileBasedWalIterator::FileBasedWalIterator(
 
     if (firstIdInBuffer_ > currId_) {
         // We need to read from the WAL files
-        wal_->accessAllWalInfo([this] (WalFileInfoPtr info) {
+        int64_t startPos = 0;
+        wal_->accessAllWalInfo([this, &startPos] (WalFileInfoPtr info) {
             if (lastId_ >= info->firstId()) {
-                int fd = open(info->path(), O_RDONLY);
-                if (fd < 0) {
-                    LOG(ERROR) << "Failed to open wal file \""
-                               << info->path()
-                               << "\" (" << errno << "): "
-                               << strerror(errno);
+                auto reader = std::make_unique<WalFileReader>(info->path());
+                if (!reader->valid()) {
                     currId_ = lastId_ + 1;
                     return false;
                 }
-                fds_.push_front(fd);
+                readers_.push_front(std::move(reader));
                 idRanges_.push_front(
                     std::make_pair(info->firstId(), info->lastId()));
             }
             if (info->firstId() <= currId_) {
-                // Go no further
+                // Go no further, the index tells where to look for currId_
+                startPos = info->indexedOffset(currId_);
                 return false;
             } else {
                 return true;
             }
         });
+        if (currId_ > lastId_) {
+            // Failed to open the wal files
+            return;
+        }
 
         if (idRanges_.empty() || idRanges_.front().first > currId_) {
             LOG(ERROR) << "LogID " << currId_
@@ -86,49 +89,23 @@ FileBasedWalIterator::FileBasedWalIterator(
 
         nextFirstId_ = getFirstIdInNextFile();
         CHECK_LE(currId_, idRanges_.front().second);
-    }
 
-    if (!idRanges_.empty()) {
         // Find the correct position in the first WAL file
-        currPos_ = 0;
+        currPos_ = startPos;
         while (true) {
-            LogID logId;
-            // Read the logID
-            int fd = fds_.front();
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&logId),
-                           sizeof(LogID),
-                           currPos_),
-                     static_cast<ssize_t>(sizeof(LogID)));
-            // Read the termID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currTerm_),
-                           sizeof(TermID),
-                           currPos_ + sizeof(LogID)),
-                     static_cast<ssize_t>(sizeof(TermID)));
-            // Read the log length
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currMsgLen_),
-                           sizeof(int32_t),
-                           currPos_ + sizeof(LogID) + sizeof(TermID)),
-                     static_cast<ssize_t>(sizeof(int32_t)));
-            if (logId == currId_) {
+            CHECK(readers_.front()->readEntry(currPos_))
+                << "Failed to read the log " << currId_ << " at " << currPos_;
+            if (readers_.front()->logId() == currId_) {
                 break;
             }
-            currPos_ += sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t) * 2
-                        + currMsgLen_
-                        + sizeof(ClusterID);
+            currPos_ = readers_.front()->nextPos();
         }
+        currTerm_ = readers_.front()->logTerm();
     }
 }
 
 
 FileBasedWalIterator::~FileBasedWalIterator() {
-    for (auto& fd : fds_) {
-        close(fd);
-    }
 }
 
 
@@ -143,8 +120,7 @@ LogIterator& FileBasedWalIterator::operator++() {
                     << nextFirstId_
                     << ", so need to move to the next file";
             // Close the current file
-            CHECK_EQ(close(fds_.front()), 0);
-            fds_.pop_front();
+            readers_.pop_front();
             idRanges_.pop_front();
 
             if (idRanges_.empty()) {
@@ -161,34 +137,14 @@ LogIterator& FileBasedWalIterator::operator++() {
             currPos_ = 0;
         } else {
             // Move to the next log
-            currPos_ += sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t) * 2
-                        + currMsgLen_
-                        + sizeof(ClusterID);
+            currPos_ = readers_.front()->nextPos();
         }
 
-        LogID logId;
-        int fd = fds_.front();
-        // Read the logID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&logId),
-                       sizeof(LogID),
-                       currPos_),
-                 static_cast<ssize_t>(sizeof(LogID)));
-        CHECK_EQ(currId_, logId);
-        // Read the termID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currTerm_),
-                       sizeof(TermID),
-                       currPos_ + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(TermID)));
-        // Read the log length
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currMsgLen_),
-                       sizeof(int32_t),
-                       currPos_ + sizeof(TermID) + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(int32_t)));
+        // The entry is parsed out of the read-ahead block
+        CHECK(readers_.front()->readEntry(currPos_))
+            << "Failed to read the log " << currId_ << " at " << currPos_;
+        CHECK_EQ(currId_, readers_.front()->logId());
+        currTerm_ = readers_.front()->logTerm();
     } else if (currId_ <= lastId_) {
         // Need to adjust nextFirstId_, in case we just start
         // reading buffers
@@ -239,22 +195,8 @@ ClusterID FileBasedWalIterator::logSource() const {
         return buffers_.front()->getCluster(currIdx_);
     } else {
         // Retrieve from the file
-        DCHECK(!fds_.empty());
-
-        ClusterID cluster = 0;
-        CHECK_EQ(pread(fds_.front(),
-                       &(cluster),
-                       sizeof(ClusterID),
-                       currPos_
-                        + sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t)),
-                 static_cast<ssize_t>(sizeof(ClusterID)))
-            << "Failed to read. Curr position is " << currPos_
-            << ", expected read length is " << sizeof(ClusterID)
-            << " (errno: " << errno << "): " << strerror(errno);
-
-        return cluster;
+        DCHECK(!readers_.empty());
+        return readers_.front()->logSource();
     }
 }
 
@@ -266,23 +208,8 @@ folly::StringPiece FileBasedWalIterator::logMsg() const {
         return buffers_.front()->getLog(currIdx_);
     } else {
         // Retrieve from the file
-        DCHECK(!fds_.empty());
-
-        currLog_.resize(currMsgLen_);
-        CHECK_EQ(pread(fds_.front(),
-                       &(currLog_[0]),
-                       currMsgLen_,
-                       currPos_
-                        + sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t)
-                        + sizeof(ClusterID)),
-                 static_cast<ssize_t>(currMsgLen_))
-            << "Failed to read. Curr position is " << currPos_
-            << ", expected read length is " << currMsgLen_
-            << " (errno: " << errno << "): " << strerror(errno);
-
-        return currLog_;
+        DCHECK(!readers_.empty());
+        return readers_.front()->logMsg();
     }
 }
 
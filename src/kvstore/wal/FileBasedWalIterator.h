@@ -10,6 +10,7 @@
 #include "base/Base.h"
 #include "base/LogIterator.h"
 #include "kvstore/wal/InMemoryLogBuffer.h"
+#include "kvstore/wal/WalFileReader.h"
 
 namespace nebula {
 namespace wal {
@@ -67,10 +68,8 @@ private:
 
     // [firstId, lastId]
     std::list<std::pair<LogID, LogID>> idRanges_;
-    std::list<int> fds_;
+    std::list<std::unique_ptr<WalFileReader>> readers_;
     int64_t currPos_{0};
-    int32_t currMsgLen_{0};
-    mutable std::string currLog_;
 };
 
 }  // namespace wal
@@ -10,16 +10,20 @@
 namespace nebula {
 namespace wal {
 
-void InMemoryLogBuffer::push(TermID term,
+bool InMemoryLogBuffer::push(TermID term,
                              ClusterID cluster,
                              std::string&& msg) {
     folly::RWSpinLock::WriteHolder wh(&accessLock_);
+    if (frozen_) {
+        return false;
+    }
 
     totalLen_ += msg.size()
                  + sizeof(TermID)
                  + sizeof(ClusterID)
                  + sizeof(LogID);
     logs_.emplace_back(term, cluster, std::move(msg));
+    return true;
 }
 
 
@@ -81,11 +85,18 @@ const folly::StringPiece InMemoryLogBuffer::getLog(size_t idx) const {
 
 
 bool InMemoryLogBuffer::freeze() {
+    // Serialized with push(), so nothing is pushed once frozen
+    folly::RWSpinLock::WriteHolder wh(&accessLock_);
     bool expected = false;
     return frozen_.compare_exchange_strong(expected, true);
 }
 
 
+bool InMemoryLogBuffer::frozen() const {
+    return frozen_.load();
+}
+
+
 void InMemoryLogBuffer::rollover() {
     rollover_ = true;
 }
@@ -20,8 +20,9 @@ public:
     explicit InMemoryLogBuffer(LogID firstLogId)
         : firstLogId_(firstLogId) {}
 
-    // Push a new message to the end of the buffer
-    void push(TermID term, ClusterID cluster, std::string&& msg);
+    // Push a new message to the end of the buffer, return false
+    // and leave msg untouched if the buffer has been frozen
+    bool push(TermID term, ClusterID cluster, std::string&& msg);
 
     size_t size() const;
     size_t numLogs() const;
@@ -50,6 +51,7 @@ public:
 
     // Mark the buffer ready for persistence
     bool freeze();
+    bool frozen() const;
 
     void rollover();
     bool needToRollover() const;
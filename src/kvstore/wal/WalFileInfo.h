@@ -61,6 +61,48 @@ public:
         size_ = size;
     }
 
+    // The sparse log id -> offset index is persisted next to the file,
+    // i.e. "<first id>.idx"
+    std::string indexPath() const {
+        return fullpath_.substr(0, fullpath_.rfind('.')) + ".idx";
+    }
+
+    void addIndex(LogID id, int64_t offset) {
+        std::lock_guard<std::mutex> g(indexLock_);
+        if (index_.empty() || index_.back().first < id) {
+            index_.emplace_back(id, offset);
+        }
+    }
+
+    // The offset of the closest indexed log no later than the given id,
+    // from where to look for the log
+    int64_t indexedOffset(LogID id) const {
+        std::lock_guard<std::mutex> g(indexLock_);
+        auto it = std::upper_bound(index_.begin(), index_.end(), id,
+                                   [] (LogID target, const auto& entry) {
+            return target < entry.first;
+        });
+        if (it == index_.begin()) {
+            return 0;
+        }
+        return (--it)->second;
+    }
+
+    // -1 if nothing is indexed yet
+    int64_t lastIndexedOffset() const {
+        std::lock_guard<std::mutex> g(indexLock_);
+        return index_.empty() ? -1 : index_.back().second;
+    }
+
+    std::vector<std::pair<LogID, int64_t>> index() const {
+        std::lock_guard<std::mutex> g(indexLock_);
+        return index_;
+    }
+    void setIndex(std::vector<std::pair<LogID, int64_t>> index) {
+        std::lock_guard<std::mutex> g(indexLock_);
+        index_ = std::move(index);
+    }
+
 private:
     const std::string fullpath_;
     const LogID firstLogId_;
@@ -68,6 +110,10 @@ private:
     TermID lastLogTerm_;
     time_t mtime_;
     size_t size_;
+
+    // Sorted by log id, one entry every wal_index_interval_kb
+    std::vector<std::pair<LogID, int64_t>> index_;
+    mutable std::mutex indexLock_;
 };
 
 
@@ -0,0 +1,98 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "kvstore/wal/WalFileReader.h"
+
+DEFINE_int32(wal_read_ahead_kb, 1024,
+             "The block size reading WAL files sequentially, i.e. when"
+             " followers are catching up");
+
+namespace nebula {
+namespace wal {
+
+WalFileReader::WalFileReader(const char* path) : path_(path) {
+    fd_ = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        LOG(ERROR) << "Failed to open wal file \"" << path
+                   << "\" (" << errno << "): " << strerror(errno);
+        return;
+    }
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+
+WalFileReader::~WalFileReader() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+
+bool WalFileReader::readEntry(int64_t pos) {
+    const char* p = read(pos, kHeaderSize);
+    if (p == nullptr) {
+        return false;
+    }
+    int32_t msgLen;
+    memcpy(&msgLen, p + sizeof(LogID) + sizeof(TermID), sizeof(int32_t));
+    if (msgLen < 0) {
+        LOG(ERROR) << "Bad log length " << msgLen << " at " << pos
+                   << " in \"" << path_ << "\"";
+        return false;
+    }
+
+    // Read the whole entry, the block might have been moved
+    p = read(pos, kHeaderSize + msgLen + kFooterSize);
+    if (p == nullptr) {
+        return false;
+    }
+    pos_ = pos;
+    memcpy(&logId_, p, sizeof(LogID));
+    memcpy(&logTerm_, p + sizeof(LogID), sizeof(TermID));
+    memcpy(&cluster_, p + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t), sizeof(ClusterID));
+    logMsg_.reset(p + kHeaderSize, msgLen);
+    return true;
+}
+
+
+const char* WalFileReader::read(int64_t pos, size_t len) {
+    if (pos >= blockPos_ && pos + len <= blockPos_ + blockLen_) {
+        return &block_[pos - blockPos_];
+    }
+    if (pos + len > fileSize_) {
+        // The file might have been appended meanwhile
+        struct stat st;
+        if (fstat(fd_, &st) < 0 || pos + len > static_cast<size_t>(st.st_size)) {
+            return nullptr;
+        }
+        fileSize_ = st.st_size;
+    }
+
+    size_t size = std::max(len, static_cast<size_t>(FLAGS_wal_read_ahead_kb) * 1024);
+    if (block_.size() < size) {
+        block_.resize(size);
+    }
+    blockPos_ = pos;
+    blockLen_ = 0;
+    while (blockLen_ < len) {
+        ssize_t res = pread(fd_, &block_[blockLen_], size - blockLen_, pos + blockLen_);
+        if (res < 0) {
+            LOG(ERROR) << "Failed to read \"" << path_ << "\" at " << pos + blockLen_
+                       << " (" << errno << "): " << strerror(errno);
+            return nullptr;
+        }
+        if (res == 0) {
+            // End of file
+            return nullptr;
+        }
+        blockLen_ += res;
+    }
+    return &block_[0];
+}
+
+}  // namespace wal
+}  // namespace nebula
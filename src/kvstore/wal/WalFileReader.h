@@ -0,0 +1,93 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WAL_WALFILEREADER_H_
+#define WAL_WALFILEREADER_H_
+
+#include "base/Base.h"
+
+namespace nebula {
+namespace wal {
+
+/**
+ * Sequential reader of a WAL file
+ *
+ * Each entry in a WAL file is laid out as
+ *   <LogID> <TermID> <int32_t msgLen> <ClusterID> <msg> <int32_t msgLen>
+ *
+ * Instead of a few preads per entry, the reader fetches large blocks
+ * (wal_read_ahead_kb) and parses the entries out of them, so iterating
+ * a file costs one syscall per block
+ */
+class WalFileReader final {
+public:
+    static constexpr size_t kHeaderSize = sizeof(LogID)
+                                          + sizeof(TermID)
+                                          + sizeof(int32_t)
+                                          + sizeof(ClusterID);
+    static constexpr size_t kFooterSize = sizeof(int32_t);
+
+    explicit WalFileReader(const char* path);
+    ~WalFileReader();
+
+    bool valid() const {
+        return fd_ >= 0;
+    }
+
+    // Parse the entry starting at the given position. Return false if
+    // the file ends before the entry does
+    bool readEntry(int64_t pos);
+
+    LogID logId() const {
+        return logId_;
+    }
+
+    TermID logTerm() const {
+        return logTerm_;
+    }
+
+    ClusterID logSource() const {
+        return cluster_;
+    }
+
+    // It is valid until the next readEntry()
+    folly::StringPiece logMsg() const {
+        return logMsg_;
+    }
+
+    // The position of the current entry and the next one
+    int64_t pos() const {
+        return pos_;
+    }
+    int64_t nextPos() const {
+        return pos_ + kHeaderSize + logMsg_.size() + kFooterSize;
+    }
+
+private:
+    // Make sure [pos, pos + len) is in the block, return nullptr if the file
+    // is shorter than that
+    const char* read(int64_t pos, size_t len);
+
+private:
+    const std::string path_;
+    int fd_{-1};
+    size_t fileSize_{0};
+
+    std::string block_;
+    int64_t blockPos_{0};
+    size_t blockLen_{0};
+
+    int64_t pos_{0};
+    LogID logId_{-1};
+    TermID logTerm_{-1};
+    ClusterID cluster_{0};
+    folly::StringPiece logMsg_;
+};
+
+}  // namespace wal
+}  // namespace nebula
+
+#endif  // WAL_WALFILEREADER_H_
@@ -8,8 +8,14 @@
 #include <gtest/gtest.h>
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/BufferFlusher.h"
+#include "kvstore/wal/BufferArena.h"
 #include "fs/TempDir.h"
 
+DECLARE_int32(wal_buffers_budget_mb);
+DECLARE_int32(wal_buffer_idle_secs);
+DECLARE_int32(wal_index_interval_kb);
+DECLARE_int32(wal_read_ahead_kb);
+
 namespace nebula {
 namespace wal {
 
@@ -115,7 +121,7 @@ TEST(FileBasedWal, CacheOverflow) {
     wal.reset();
 
     // Check the number of files
-    auto files = FileUtils::listAllFilesInDir(walDir.path());
+    auto files = FileUtils::listAllFilesInDir(walDir.path(), false, "*.wal");
     ASSERT_EQ(11, files.size());
 
     // Now let's open it to read
@@ -249,7 +255,7 @@ TEST(FileBasedWal, RollbackToFile) {
     wal.reset();
 
     // Check the number of files
-    auto files = FileUtils::listAllFilesInDir(walDir.path());
+    auto files = FileUtils::listAllFilesInDir(walDir.path(), false, "*.wal");
     ASSERT_EQ(2, files.size());
 
     // Now let's open it to read
@@ -426,6 +432,192 @@ TEST(FileBasedWal, BackAndForth) {
     ASSERT_EQ(0, FileUtils::listAllFilesInDir(walDir.path(), false, "*.wal").size());
 }
 
+
+TEST(FileBasedWal, SharedBufferBudget) {
+    // Each buffer could hold 4MB, but all the WALs share 2MB
+    FLAGS_wal_buffers_budget_mb = 2;
+    FileBasedWalPolicy policy;
+    policy.bufferSize = 4;
+
+    std::vector<std::unique_ptr<TempDir>> walDirs;
+    std::vector<std::shared_ptr<FileBasedWal>> wals;
+    for (int i = 0; i < 4; i++) {
+        walDirs.emplace_back(std::make_unique<TempDir>("/tmp/testWal.XXXXXX"));
+        wals.emplace_back(FileBasedWal::getWal(walDirs.back()->path(),
+                                               policy,
+                                               flusher.get(),
+                                               [](LogID, TermID, ClusterID, const std::string&) {
+                                                   return true;
+                                               }));
+    }
+
+    auto numBackPressure = BufferArena::get().numBackPressure();
+    // Append about 2MB to each WAL
+    for (int i = 1; i <= 2000; i++) {
+        for (auto& wal : wals) {
+            ASSERT_TRUE(wal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                                       folly::stringPrintf(kLongMsg, i)));
+        }
+        ASSERT_GE(2UL * 1024 * 1024 + 1024, BufferArena::get().used());
+    }
+    ASSERT_LT(numBackPressure, BufferArena::get().numBackPressure());
+
+    for (auto& wal : wals) {
+        auto it = wal->iterator(1, 2000);
+        LogID id = 1;
+        while (it->valid()) {
+            ASSERT_EQ(id, it->logId());
+            ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+            ++(*it);
+            ++id;
+        }
+        ASSERT_EQ(2001, id);
+    }
+    FLAGS_wal_buffers_budget_mb = 2048;
+}
+
+
+TEST(FileBasedWal, FlushIdleBuffer) {
+    FLAGS_wal_buffer_idle_secs = 1;
+    FileBasedWalPolicy policy;
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    policy,
+                                    flusher.get(),
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 10; i++) {
+        ASSERT_TRUE(wal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                                   folly::stringPrintf("Test string %02d", i)));
+    }
+    ASSERT_LT(0UL, wal->activeBufferSize());
+
+    // The flusher checks the idle WALs every second
+    sleep(3);
+    ASSERT_EQ(0UL, wal->activeBufferSize());
+    ASSERT_EQ(0UL, wal->accessAllBuffers([] (BufferPtr) { return true; }));
+
+    // Go on appending to a new buffer
+    ASSERT_TRUE(wal->appendLog(11 /*id*/, 1 /*term*/, 0 /*cluster*/, "Test string 11"));
+    auto it = wal->iterator(1, 11);
+    LogID id = 1;
+    while (it->valid()) {
+        ASSERT_EQ(folly::stringPrintf("Test string %02ld", id), it->logMsg());
+        ++(*it);
+        ++id;
+    }
+    ASSERT_EQ(12, id);
+    FLAGS_wal_buffer_idle_secs = 60;
+}
+
+
+TEST(FileBasedWal, FlushIdleBufferUnderLoad) {
+    FLAGS_wal_buffer_idle_secs = 1;
+    FileBasedWalPolicy policy;
+    policy.bufferSize = 1;
+    TempDir idleDir("/tmp/testWal.XXXXXX");
+    TempDir busyDir("/tmp/testWal.XXXXXX");
+    auto getWal = [&] (const char* dir) {
+        return FileBasedWal::getWal(dir,
+                                    policy,
+                                    flusher.get(),
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    };
+    auto idleWal = getWal(idleDir.path());
+    auto busyWal = getWal(busyDir.path());
+    for (int i = 1; i <= 10; i++) {
+        ASSERT_TRUE(idleWal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                                       folly::stringPrintf("Test string %02d", i)));
+    }
+    ASSERT_LT(0UL, idleWal->activeBufferSize());
+
+    // Keep the flusher busy with the full buffers of the other WAL meanwhile
+    LogID id = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 100; i++) {
+            ++id;
+            ASSERT_TRUE(busyWal->appendLog(id /*id*/, 1 /*term*/, 0 /*cluster*/,
+                                           folly::stringPrintf(kLongMsg, id)));
+        }
+    }
+    ASSERT_EQ(0UL, idleWal->activeBufferSize());
+    FLAGS_wal_buffer_idle_secs = 60;
+}
+
+
+TEST(FileBasedWal, IndexedRead) {
+    // Index one log every 4KB, and read 16KB each time
+    FLAGS_wal_index_interval_kb = 4;
+    FLAGS_wal_read_ahead_kb = 16;
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1;
+    policy.bufferSize = 1;
+
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    policy,
+                                    flusher.get(),
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 5000; i++) {
+        ASSERT_TRUE(wal->appendLog(i /*id*/, 1 /*term*/, i % 3 /*cluster*/,
+                                   folly::stringPrintf(kLongMsg, i)));
+    }
+    sleep(1);
+    wal.reset();
+
+    // Every wal file has its index persisted
+    auto files = FileUtils::listAllFilesInDir(walDir.path(), false, "*.wal");
+    ASSERT_LT(1UL, files.size());
+    ASSERT_EQ(files.size(),
+              FileUtils::listAllFilesInDir(walDir.path(), false, "*.idx").size());
+
+    // A broken index is rebuilt
+    auto idxFile = FileUtils::joinPath(walDir.path(),
+                                       folly::stringPrintf("%019d.idx", 1));
+    int fd = open(idxFile.c_str(), O_WRONLY | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    int64_t garbage[] = {1, 4096};
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(garbage)), write(fd, garbage, sizeof(garbage)));
+    close(fd);
+
+    wal = FileBasedWal::getWal(walDir.path(),
+                               policy,
+                               flusher.get(),
+                               [](LogID, TermID, ClusterID, const std::string&) {
+                                   return true;
+                               });
+    ASSERT_EQ(5000, wal->lastLogId());
+
+    // Start from anywhere, i.e. a lagging follower
+    for (LogID start : {1L, 2L, 999L, 1000L, 2500L, 4999L, 5000L}) {
+        auto it = wal->iterator(start, 5000);
+        LogID id = start;
+        while (it->valid()) {
+            ASSERT_EQ(id, it->logId());
+            ASSERT_EQ(1, it->logTerm());
+            ASSERT_EQ(id % 3, it->logSource());
+            ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+            ++(*it);
+            ++id;
+        }
+        ASSERT_EQ(5001, id);
+    }
+
+    // Rollback locates the log through the index as well
+    ASSERT_TRUE(wal->rollbackToLog(2345));
+    ASSERT_EQ(2345, wal->lastLogId());
+    ASSERT_EQ(1, wal->lastLogTerm());
+
+    FLAGS_wal_index_interval_kb = 64;
+    FLAGS_wal_read_ahead_kb = 1024;
+}
+
 }  // namespace wal
 }  // namespace nebula
 
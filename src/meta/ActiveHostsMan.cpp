@@ -42,6 +42,7 @@ bool ActiveHostsMan::updateHostInfo(const HostAddr& hostAddr, const HostInfo& in
                               MetaServiceUtils::hostValOnline());
         } else {
             it->second.lastHBTimeInSec_ = info.lastHBTimeInSec_;
+            it->second.partStats_ = info.partStats_;
         }
     }
     if (kvstore_ != nullptr && !data.empty()) {
@@ -76,6 +77,19 @@ std::vector<HostAddr> ActiveHostsMan::getActiveHosts() {
     return hosts;
 }
 
+std::unordered_map<HostAddr, std::vector<cpp2::PartStats>>
+ActiveHostsMan::getPartStats(GraphSpaceID spaceId) {
+    std::unordered_map<HostAddr, std::vector<cpp2::PartStats>> stats;
+    folly::RWSpinLock::ReadHolder rh(&lock_);
+    for (auto& entry : hostsMap_) {
+        auto it = entry.second.partStats_.find(spaceId);
+        if (it != entry.second.partStats_.end()) {
+            stats.emplace(entry.first, it->second);
+        }
+    }
+    return stats;
+}
+
 void ActiveHostsMan::loadHostMap() {
     if (kvstore_ == nullptr) {
         return;
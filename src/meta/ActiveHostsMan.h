@@ -32,6 +32,8 @@ struct HostInfo {
     }
 
     int64_t lastHBTimeInSec_ = 0;
+    // The load of the parts on the host, reported by the last heartbeat
+    std::unordered_map<GraphSpaceID, std::vector<cpp2::PartStats>> partStats_;
 };
 
 class ActiveHostsMan final {
@@ -59,6 +61,9 @@ public:
 
     std::vector<HostAddr> getActiveHosts();
 
+    // Return the part stats of the space reported by each active host
+    std::unordered_map<HostAddr, std::vector<cpp2::PartStats>> getPartStats(GraphSpaceID spaceId);
+
     void reset() {
         folly::RWSpinLock::WriteHolder rh(&lock_);
         hostsMap_.clear();
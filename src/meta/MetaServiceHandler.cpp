@@ -33,6 +33,8 @@
 #include "meta/processors/admin/HBProcessor.h"
 #include "meta/processors/usersMan/AuthenticationProcessor.h"
 #include "meta/processors/admin/BalanceProcessor.h"
+#include "meta/processors/admin/LeaderBalanceProcessor.h"
+#include "meta/processors/admin/GetMetaChangesProcessor.h"
 #include "meta/processors/configMan/RegConfigProcessor.h"
 #include "meta/processors/configMan/GetConfigProcessor.h"
 #include "meta/processors/configMan/SetConfigProcessor.h"
@@ -196,6 +198,12 @@ MetaServiceHandler::future_heartBeat(const cpp2::HBReq& req) {
     RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::GetMetaChangesResp>
+MetaServiceHandler::future_getMetaChanges(const cpp2::GetMetaChangesReq& req) {
+    auto* processor = GetMetaChangesProcessor::instance(kvstore_);
+    RETURN_FUTURE(processor);
+}
+
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_createUser(const cpp2::CreateUserReq& req) {
     auto* processor = CreateUserProcessor::instance(kvstore_);
@@ -262,6 +270,12 @@ MetaServiceHandler::future_balance(const cpp2::BalanceReq& req) {
     RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::ExecResp>
+MetaServiceHandler::future_leaderBalance(const cpp2::LeaderBalanceReq& req) {
+    auto* processor = LeaderBalanceProcessor::instance(kvstore_);
+    RETURN_FUTURE(processor);
+}
+
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_regConfig(const cpp2::RegConfigReq &req) {
     auto* processor = RegConfigProcessor::instance(kvstore_);
@@ -140,9 +140,15 @@ public:
     folly::Future<cpp2::HBResp>
     future_heartBeat(const cpp2::HBReq& req) override;
 
+    folly::Future<cpp2::GetMetaChangesResp>
+    future_getMetaChanges(const cpp2::GetMetaChangesReq& req) override;
+
     folly::Future<cpp2::BalanceResp>
     future_balance(const cpp2::BalanceReq& req) override;
 
+    folly::Future<cpp2::ExecResp>
+    future_leaderBalance(const cpp2::LeaderBalanceReq& req) override;
+
     folly::Future<cpp2::ExecResp>
     future_regConfig(const cpp2::RegConfigReq &req) override;
 
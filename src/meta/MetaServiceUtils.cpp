@@ -20,6 +20,8 @@ const std::string kIndexTable  = "__index__";   // NOLINT
 const std::string kUsersTable  = "__users__";    // NOLINT
 const std::string kRolesTable  = "__roles__";    // NOLINT
 const std::string kConfigsTable = "__configs__"; // NOLINT
+const std::string kMetaVersionKey = "__meta_version__"; // NOLINT
+const std::string kMetaChangesTable = "__meta_changes__"; // NOLINT
 
 
 const std::string kHostOnline = "Online";       // NOLINT
@@ -302,6 +304,13 @@ cpp2::ErrorCode MetaServiceUtils::alterColumnDefs(std::vector<nebula::cpp2::Colu
             auto colName = col.get_name();
             for (auto it = cols.begin(); it != cols.end(); ++it) {
                 if (colName == it->get_name()) {
+                    // The index on the column should be dropped first
+                    if (prop.get_indexes() &&
+                        std::find(prop.get_indexes()->begin(), prop.get_indexes()->end(),
+                                  colName) != prop.get_indexes()->end()) {
+                        LOG(WARNING) << "Column can't be dropped, an index on it : " << colName;
+                        return cpp2::ErrorCode::E_NOT_DROP;
+                    }
                     // Check if there is a TTL on the column to be deleted
                     if (!prop.get_ttl_col() ||
                         (prop.get_ttl_col() && (*prop.get_ttl_col() != colName))) {
@@ -353,6 +362,31 @@ cpp2::ErrorCode MetaServiceUtils::alterSchemaProp(std::vector<nebula::cpp2::Colu
         }
     }
 
+    if (alterSchemaProp.__isset.inbound_props) {
+        // The in-edges inserted before carry no props, so they could only be dropped
+        if (*alterSchemaProp.get_inbound_props()) {
+            LOG(WARNING) << "inbound_props could only be enabled when creating the edge";
+            return cpp2::ErrorCode::E_UNSUPPORTED;
+        }
+        schemaProp.set_inbound_props(false);
+    }
+
+    if (alterSchemaProp.__isset.indexes) {
+        // The data written before is not indexed, so the indexes could only be dropped
+        std::vector<std::string> indexes;
+        if (schemaProp.get_indexes()) {
+            indexes = *schemaProp.get_indexes();
+        }
+        for (auto& index : *alterSchemaProp.get_indexes()) {
+            if (std::find(indexes.begin(), indexes.end(), index) == indexes.end()) {
+                LOG(WARNING) << "Index " << index
+                             << " could only be created along with the schema";
+                return cpp2::ErrorCode::E_UNSUPPORTED;
+            }
+        }
+        schemaProp.set_indexes(*alterSchemaProp.get_indexes());
+    }
+
     // Disable implicit TTL mode
     if ((schemaProp.get_ttl_duration() && (*schemaProp.get_ttl_duration() != 0)) &&
         (!schemaProp.get_ttl_col() || (schemaProp.get_ttl_col() &&
@@ -545,5 +579,34 @@ cpp2::ConfigItem MetaServiceUtils::parseConfigValue(folly::StringPiece rawData)
     return item;
 }
 
+const std::string& MetaServiceUtils::metaVersionKey() {
+    return kMetaVersionKey;
+}
+
+std::string MetaServiceUtils::metaVersionVal(int64_t version) {
+    return std::string(reinterpret_cast<const char*>(&version), sizeof(version));
+}
+
+int64_t MetaServiceUtils::parseMetaVersion(folly::StringPiece rawVal) {
+    return *reinterpret_cast<const int64_t*>(rawVal.data());
+}
+
+std::string MetaServiceUtils::metaChangeKey(int64_t version) {
+    std::string key;
+    key.reserve(kMetaChangesTable.size() + sizeof(int64_t));
+    key.append(kMetaChangesTable.data(), kMetaChangesTable.size());
+    auto bigEndianVer = folly::Endian::big(version);
+    key.append(reinterpret_cast<const char*>(&bigEndianVer), sizeof(bigEndianVer));
+    return key;
+}
+
+std::string MetaServiceUtils::metaChangeVal(GraphSpaceID spaceId) {
+    return std::string(reinterpret_cast<const char*>(&spaceId), sizeof(spaceId));
+}
+
+GraphSpaceID MetaServiceUtils::parseMetaChangeSpace(folly::StringPiece rawVal) {
+    return *reinterpret_cast<const GraphSpaceID*>(rawVal.data());
+}
+
 }  // namespace meta
 }  // namespace nebula
@@ -138,6 +138,19 @@ public:
     static ConfigName parseConfigKey(folly::StringPiece rawData);
 
     static cpp2::ConfigItem parseConfigValue(folly::StringPiece rawData);
+
+    static const std::string& metaVersionKey();
+
+    static std::string metaVersionVal(int64_t version);
+
+    static int64_t parseMetaVersion(folly::StringPiece rawVal);
+
+    // The version is big endian, so the changes are sorted by it
+    static std::string metaChangeKey(int64_t version);
+
+    static std::string metaChangeVal(GraphSpaceID spaceId);
+
+    static GraphSpaceID parseMetaChangeSpace(folly::StringPiece rawVal);
 };
 
 }  // namespace meta
@@ -0,0 +1,89 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "meta/MetaVersionMan.h"
+#include "meta/MetaServiceUtils.h"
+#include "meta/processors/Common.h"
+
+DEFINE_int64(meta_change_log_size, 10000, "The number of the latest meta changes kept");
+
+namespace nebula {
+namespace meta {
+
+void MetaVersionMan::multiPut(kvstore::KVStore* kv,
+                              GraphSpaceID spaceId,
+                              std::vector<kvstore::KV> data,
+                              kvstore::KVCallback cb) {
+    // The versions are issued in order while holding the lock, so the version
+    // in kvstore never goes back
+    folly::SharedMutex::WriteHolder wHolder(LockUtils::versionLock());
+    // The versions issued by this host, which might not be applied yet
+    static int64_t lastVersion = 0;
+    lastVersion = std::max(lastVersion, getVersion(kv)) + 1;
+    data.emplace_back(MetaServiceUtils::metaVersionKey(),
+                      MetaServiceUtils::metaVersionVal(lastVersion));
+    data.emplace_back(MetaServiceUtils::metaChangeKey(lastVersion),
+                      MetaServiceUtils::metaChangeVal(spaceId));
+    kv->asyncMultiPut(kDefaultSpaceId, kDefaultPartId, std::move(data), std::move(cb));
+
+    auto expired = lastVersion - FLAGS_meta_change_log_size;
+    if (expired > 0) {
+        kv->asyncRemoveRange(kDefaultSpaceId,
+                             kDefaultPartId,
+                             MetaServiceUtils::metaChangeKey(0),
+                             MetaServiceUtils::metaChangeKey(expired + 1),
+                             [] (kvstore::ResultCode code) {
+            if (code != kvstore::ResultCode::SUCCEEDED) {
+                LOG(WARNING) << "Remove the expired meta changes failed, code "
+                             << static_cast<int32_t>(code);
+            }
+        });
+    }
+}
+
+int64_t MetaVersionMan::getVersion(kvstore::KVStore* kv) {
+    std::string val;
+    auto ret = kv->get(kDefaultSpaceId, kDefaultPartId, MetaServiceUtils::metaVersionKey(), &val);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return 0;
+    }
+    return MetaServiceUtils::parseMetaVersion(val);
+}
+
+StatusOr<std::vector<GraphSpaceID>> MetaVersionMan::getChanges(kvstore::KVStore* kv,
+                                                               int64_t since,
+                                                               int64_t& version) {
+    version = getVersion(kv);
+    if (since <= 0 || since > version) {
+        return Status::Error("Unknown meta version %ld", since);
+    }
+    if (version - since > FLAGS_meta_change_log_size) {
+        return Status::Error("The meta changes since version %ld are expired", since);
+    }
+    std::vector<GraphSpaceID> spaces;
+    if (since == version) {
+        return spaces;
+    }
+    auto start = MetaServiceUtils::metaChangeKey(since + 1);
+    auto end = MetaServiceUtils::metaChangeKey(version + 1);
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kv->range(kDefaultSpaceId, kDefaultPartId, start, end, &iter);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return Status::Error("Scan the meta changes failed, code %d", static_cast<int32_t>(ret));
+    }
+    std::unordered_set<GraphSpaceID> changed;
+    while (iter->valid()) {
+        auto spaceId = MetaServiceUtils::parseMetaChangeSpace(iter->val());
+        if (changed.emplace(spaceId).second) {
+            spaces.emplace_back(spaceId);
+        }
+        iter->next();
+    }
+    return spaces;
+}
+
+}  // namespace meta
+}  // namespace nebula
@@ -0,0 +1,53 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef META_METAVERSIONMAN_H_
+#define META_METAVERSIONMAN_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "kvstore/KVStore.h"
+
+namespace nebula {
+namespace meta {
+
+/**
+ * The meta data cached by the clients, i.e. the spaces, the parts allocation and
+ * the schemas, has a version. Each change to them bumps the version and records
+ * the space changed, so a client could reload only the spaces changed since the
+ * version it loaded, rather than everything.
+ *
+ * Only the latest FLAGS_meta_change_log_size changes are kept, the clients falling
+ * further behind have to reload everything.
+ * */
+class MetaVersionMan final {
+public:
+    MetaVersionMan() = delete;
+
+    /**
+     * Write the data along with a new version recording the change of the space.
+     * The data could be empty, to record a change already applied, e.g. a removal.
+     * */
+    static void multiPut(kvstore::KVStore* kv,
+                         GraphSpaceID spaceId,
+                         std::vector<kvstore::KV> data,
+                         kvstore::KVCallback cb);
+
+    static int64_t getVersion(kvstore::KVStore* kv);
+
+    /**
+     * Return the spaces changed after the version `since', and the current version.
+     * Return Error if the changes are no longer kept, or `since' is unknown.
+     * */
+    static StatusOr<std::vector<GraphSpaceID>> getChanges(kvstore::KVStore* kv,
+                                                          int64_t since,
+                                                          int64_t& version);
+};
+
+}  // namespace meta
+}  // namespace nebula
+
+#endif  // META_METAVERSIONMAN_H_
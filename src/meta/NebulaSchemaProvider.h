@@ -58,7 +58,7 @@ public:
 
     void setProp(nebula::cpp2::SchemaProp schemaProp);
 
-    const nebula::cpp2::SchemaProp getProp() const;
+    const nebula::cpp2::SchemaProp getProp() const override;
 
 protected:
     NebulaSchemaProvider() = default;
@@ -55,6 +55,9 @@ public:
 
     virtual StatusOr<EdgeType> toEdgeType(GraphSpaceID space, folly::StringPiece typeName) = 0;
 
+    // Whether the keys in the space are written without version
+    virtual StatusOr<bool> isSingleVersion(GraphSpaceID space) = 0;
+
     virtual void init(MetaClient *client = nullptr) = 0;
 
 protected:
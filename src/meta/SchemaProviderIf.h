@@ -99,6 +99,9 @@ public:
     virtual std::shared_ptr<const Field> field(int64_t index) const = 0;
     virtual std::shared_ptr<const Field> field(const folly::StringPiece name) const = 0;
 
+    // Schema level properties, such as ttl_duration and ttl_col
+    virtual const nebula::cpp2::SchemaProp getProp() const = 0;
+
     /******************************************
      *
      * Iterator implementation
@@ -165,6 +165,15 @@ StatusOr<EdgeType> ServerBasedSchemaManager::toEdgeType(GraphSpaceID space,
     return metaClient_->getEdgeTypeByNameFromCache(space, typeName.str());
 }
 
+StatusOr<bool> ServerBasedSchemaManager::isSingleVersion(GraphSpaceID space) {
+    CHECK(metaClient_);
+    auto ret = metaClient_->getSpacePropertiesFromCache(space);
+    if (!ret.ok()) {
+        return ret.status();
+    }
+    return ret.value().get_single_version();
+}
+
 }  // namespace meta
 }  // namespace nebula
 
@@ -56,6 +56,8 @@ public:
 
     StatusOr<EdgeType> toEdgeType(GraphSpaceID space, folly::StringPiece typeName) override;
 
+    StatusOr<bool> isSingleVersion(GraphSpaceID space) override;
+
     void init(MetaClient *client) override;
 
 private:
@@ -9,7 +9,8 @@
 #include "network/NetworkUtils.h"
 #include "meta/NebulaSchemaProvider.h"
 
-DEFINE_int32(load_data_interval_secs, 2 * 60, "Load data interval");
+DEFINE_int32(load_data_interval_secs, 10, "Load data interval, only the changed spaces "
+                                          "are reloaded each time");
 DEFINE_int32(heartbeat_interval_secs, 10, "Heartbeat interval");
 
 namespace nebula {
@@ -96,6 +97,25 @@ void MetaClient::loadData() {
         LOG(ERROR) << "The threads number in ioThreadPool should be greater than 0";
         return;
     }
+    // Ask for the spaces changed since the version loaded, and only reload them.
+    // The older metad knows nothing about the versions, reload all then.
+    bool fullReload = true;
+    int64_t version = 0;
+    std::unordered_set<GraphSpaceID> changed;
+    auto changesRet = getMetaChanges(metaVersion_).get();
+    if (changesRet.ok()) {
+        auto& changes = changesRet.value();
+        version = changes.get_version();
+        if (ready_ && !changes.get_full_reload() && version == metaVersion_) {
+            VLOG(3) << "The meta version " << version << " is not changed";
+            return;
+        }
+        fullReload = !ready_ || changes.get_full_reload();
+        changed.insert(changes.get_spaces().begin(), changes.get_spaces().end());
+    } else {
+        VLOG(1) << "Get meta changes failed, reload all, status:" << changesRet.status();
+    }
+
     auto ret = listSpaces().get();
     if (!ret.ok()) {
         LOG(ERROR) << "List space failed, status:" << ret.status();
@@ -108,9 +128,44 @@ void MetaClient::loadData() {
     decltype(spaceNewestTagVerMap_) spaceNewestTagVerMap;
     decltype(spaceNewestEdgeVerMap_) spaceNewestEdgeVerMap;
 
+    std::unordered_set<GraphSpaceID> reserved;
+    if (!fullReload) {
+        // Keep the spaces neither changed nor dropped
+        for (auto& space : ret.value()) {
+            if (changed.count(space.first) == 0) {
+                reserved.emplace(space.first);
+            }
+        }
+        auto isReserved = [&reserved] (const auto& entry) {
+            return reserved.count(entry.first.first) > 0;
+        };
+        folly::RWSpinLock::ReadHolder holder(localCacheLock_);
+        for (auto& entry : localCache_) {
+            if (reserved.count(entry.first) > 0) {
+                cache.emplace(entry);
+            }
+        }
+        std::copy_if(spaceTagIndexByName_.begin(), spaceTagIndexByName_.end(),
+                     std::inserter(spaceTagIndexByName, spaceTagIndexByName.end()),
+                     isReserved);
+        std::copy_if(spaceEdgeIndexByName_.begin(), spaceEdgeIndexByName_.end(),
+                     std::inserter(spaceEdgeIndexByName, spaceEdgeIndexByName.end()),
+                     isReserved);
+        std::copy_if(spaceNewestTagVerMap_.begin(), spaceNewestTagVerMap_.end(),
+                     std::inserter(spaceNewestTagVerMap, spaceNewestTagVerMap.end()),
+                     isReserved);
+        std::copy_if(spaceNewestEdgeVerMap_.begin(), spaceNewestEdgeVerMap_.end(),
+                     std::inserter(spaceNewestEdgeVerMap, spaceNewestEdgeVerMap.end()),
+                     isReserved);
+    }
+
     for (auto space : ret.value()) {
         auto spaceId = space.first;
-        auto r = getPartsAlloc(spaceId).get();
+        spaceIndexByName.emplace(space.second, spaceId);
+        if (cache.find(spaceId) != cache.end()) {
+            continue;
+        }
+        auto r = getSpaceAlloc(spaceId).get();
         if (!r.ok()) {
             LOG(ERROR) << "Get parts allocation failed for spaceId " << spaceId
                        << ", status " << r.status();
@@ -118,8 +173,12 @@ void MetaClient::loadData() {
         }
 
         auto spaceCache = std::make_shared<SpaceInfoCache>();
-        auto partsAlloc = r.value();
+        PartsAlloc partsAlloc;
+        for (auto& p : r.value().get_parts()) {
+            partsAlloc.emplace(p.first, to(p.second));
+        }
         spaceCache->spaceName = space.second;
+        spaceCache->properties_ = r.value().get_properties();
         spaceCache->partsOnHost_ = reverse(partsAlloc);
         spaceCache->partsAlloc_ = std::move(partsAlloc);
         VLOG(2) << "Load space " << spaceId
@@ -136,7 +195,6 @@ void MetaClient::loadData() {
         }
 
         cache.emplace(spaceId, spaceCache);
-        spaceIndexByName.emplace(space.second, spaceId);
     }
     decltype(localCache_) oldCache;
     {
@@ -150,8 +208,12 @@ void MetaClient::loadData() {
         spaceNewestEdgeVerMap_ = std::move(spaceNewestEdgeVerMap);
     }
     diff(oldCache, localCache_);
+    // Only move forward after the load succeeded, so the failed changes would be retried
+    metaVersion_ = version;
     ready_ = true;
-    LOG(INFO) << "Load data completed!";
+    LOG(INFO) << "Load data completed, "
+              << (fullReload ? "all spaces" : folly::stringPrintf("%zu spaces", changed.size()))
+              << " loaded, meta version " << version;
 }
 
 void MetaClient::addLoadDataTask() {
@@ -336,6 +398,8 @@ Status MetaClient::handleResponse(const RESP& resp) {
             return Status::CfgImmutable();
         case cpp2::ErrorCode::E_CONFLICT:
             return Status::Error("conflict!");
+        case cpp2::ErrorCode::E_BALANCER_RUNNING:
+            return Status::Error("The balancer is running!");
         case cpp2::ErrorCode::E_LEADER_CHANGED: {
             HostAddr leader(resp.get_leader().get_ip(), resp.get_leader().get_port());
             {
@@ -440,11 +504,13 @@ void MetaClient::diff(const LocalCache& oldCache, const LocalCache& newCache) {
 /// ================================== public methods =================================
 
 folly::Future<StatusOr<GraphSpaceID>>
-MetaClient::createSpace(std::string name, int32_t partsNum, int32_t replicaFactor) {
+MetaClient::createSpace(std::string name, int32_t partsNum, int32_t replicaFactor,
+                        bool singleVersion) {
     cpp2::SpaceProperties properties;
     properties.set_space_name(std::move(name));
     properties.set_partition_num(partsNum);
     properties.set_replica_factor(replicaFactor);
+    properties.set_single_version(singleVersion);
     cpp2::CreateSpaceReq req;
     req.set_properties(std::move(properties));
     return getResponse(std::move(req), [] (auto client, auto request) {
@@ -549,6 +615,18 @@ MetaClient::getPartsAlloc(GraphSpaceID spaceId) {
 }
 
 
+folly::Future<StatusOr<cpp2::GetPartsAllocResp>>
+MetaClient::getSpaceAlloc(GraphSpaceID spaceId) {
+    cpp2::GetPartsAllocReq req;
+    req.set_space_id(spaceId);
+    return getResponse(std::move(req), [] (auto client, auto request) {
+                    return client->future_getPartsAlloc(request);
+                }, [] (cpp2::GetPartsAllocResp&& resp) -> cpp2::GetPartsAllocResp {
+                    return std::move(resp);
+                });
+}
+
+
 StatusOr<GraphSpaceID>
 MetaClient::getSpaceIdByNameFromCache(const std::string& name) {
     if (!ready_) {
@@ -763,6 +841,20 @@ int32_t MetaClient::partsNum(GraphSpaceID spaceId) {
 }
 
 
+StatusOr<cpp2::SpaceProperties>
+MetaClient::getSpacePropertiesFromCache(GraphSpaceID spaceId) {
+    if (!ready_) {
+        return Status::Error("Not ready!");
+    }
+    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
+    auto it = localCache_.find(spaceId);
+    if (it == localCache_.end()) {
+        return Status::SpaceNotFound();
+    }
+    return it->second->properties_;
+}
+
+
 folly::Future<StatusOr<TagID>>
 MetaClient::createTagSchema(GraphSpaceID spaceId, std::string name, nebula::cpp2::Schema schema) {
     cpp2::CreateTagReq req;
@@ -990,6 +1082,14 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
     thriftHost.set_ip(localHost_.first);
     thriftHost.set_port(localHost_.second);
     req.set_host(std::move(thriftHost));
+    {
+        folly::RWSpinLock::ReadHolder holder(listenerLock_);
+        if (listener_ != nullptr) {
+            PartStatsMap stats;
+            listener_->fetchPartStats(stats);
+            req.set_part_stats(std::move(stats));
+        }
+    }
     return getResponse(std::move(req), [] (auto client, auto request) {
         return client->future_heartBeat(request);
     }, [] (cpp2::HBResp&& resp) -> bool {
@@ -1006,6 +1106,36 @@ folly::Future<StatusOr<int64_t>> MetaClient::balance() {
     }, true);
 }
 
+folly::Future<StatusOr<cpp2::BalanceResp>> MetaClient::showBalance(int64_t balanceId) {
+    cpp2::BalanceReq req;
+    req.set_id(balanceId);
+    return getResponse(std::move(req), [] (auto client, auto request) {
+        return client->future_balance(request);
+    }, [] (cpp2::BalanceResp&& resp) -> cpp2::BalanceResp {
+        return std::move(resp);
+    }, true);
+}
+
+folly::Future<StatusOr<cpp2::GetMetaChangesResp>>
+MetaClient::getMetaChanges(int64_t sinceVersion) {
+    cpp2::GetMetaChangesReq req;
+    req.set_since_version(sinceVersion);
+    return getResponse(std::move(req), [] (auto client, auto request) {
+        return client->future_getMetaChanges(request);
+    }, [] (cpp2::GetMetaChangesResp&& resp) -> cpp2::GetMetaChangesResp {
+        return std::move(resp);
+    });
+}
+
+folly::Future<StatusOr<bool>> MetaClient::balanceLeader() {
+    cpp2::LeaderBalanceReq req;
+    return getResponse(std::move(req), [] (auto client, auto request) {
+        return client->future_leaderBalance(request);
+    }, [] (cpp2::ExecResp&& resp) -> bool {
+        return resp.code == cpp2::ErrorCode::SUCCEEDED;
+    }, true);
+}
+
 folly::Future<StatusOr<bool>>
 MetaClient::regConfig(const std::vector<cpp2::ConfigItem>& items) {
     cpp2::RegConfigReq req;
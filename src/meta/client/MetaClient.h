@@ -23,6 +23,7 @@ namespace meta {
 using PartsAlloc = std::unordered_map<PartitionID, std::vector<HostAddr>>;
 using SpaceIdName = std::pair<GraphSpaceID, std::string>;
 using HostStatus = std::pair<HostAddr, std::string>;
+using PartStatsMap = std::unordered_map<GraphSpaceID, std::vector<cpp2::PartStats>>;
 
 // struct for in cache
 using TagIDSchemas = std::unordered_map<std::pair<TagID, SchemaVer>,
@@ -32,6 +33,7 @@ using EdgeTypeSchemas = std::unordered_map<std::pair<EdgeType, SchemaVer>,
 
 struct SpaceInfoCache {
     std::string spaceName;
+    cpp2::SpaceProperties properties_;
     PartsAlloc partsAlloc_;
     std::unordered_map<HostAddr, std::vector<PartitionID>> partsOnHost_;
     TagIDSchemas tagSchemas_;
@@ -80,6 +82,8 @@ public:
     virtual void onPartAdded(const PartMeta& partMeta) = 0;
     virtual void onPartRemoved(GraphSpaceID spaceId, PartitionID partId) = 0;
     virtual void onPartUpdated(const PartMeta& partMeta) = 0;
+    // Collect the load of the parts on the local host, sent along with heartbeats
+    virtual void fetchPartStats(PartStatsMap& stats) = 0;
 };
 
 class MetaClient {
@@ -111,7 +115,8 @@ public:
      * TODO(dangleptr): Use one struct to represent space description.
      * */
     folly::Future<StatusOr<GraphSpaceID>>
-    createSpace(std::string name, int32_t partsNum, int32_t replicaFactor);
+    createSpace(std::string name, int32_t partsNum, int32_t replicaFactor,
+                bool singleVersion = false);
 
     folly::Future<StatusOr<std::vector<SpaceIdName>>>
     listSpaces();
@@ -197,6 +202,17 @@ public:
     folly::Future<StatusOr<int64_t>>
     balance();
 
+    folly::Future<StatusOr<bool>>
+    balanceLeader();
+
+    // Return the status and the progress of the balance plan
+    folly::Future<StatusOr<cpp2::BalanceResp>>
+    showBalance(int64_t balanceId);
+
+    // Get the spaces changed since the meta version given
+    folly::Future<StatusOr<cpp2::GetMetaChangesResp>>
+    getMetaChanges(int64_t sinceVersion);
+
     // Operations for config
     folly::Future<StatusOr<bool>>
     regConfig(const std::vector<cpp2::ConfigItem>& items);
@@ -241,6 +257,8 @@ public:
 
     int32_t partsNum(GraphSpaceID spaceId);
 
+    StatusOr<cpp2::SpaceProperties> getSpacePropertiesFromCache(GraphSpaceID spaceId);
+
     StatusOr<std::shared_ptr<const SchemaProviderIf>>
     getTagSchemaFromCache(GraphSpaceID spaceId, TagID tagID, SchemaVer ver = -1);
 
@@ -261,6 +279,9 @@ protected:
     void addLoadCfgTask();
     void updateGflagsValue(const ConfigItem& item);
 
+    // The parts allocation of the space, along with its properties
+    folly::Future<StatusOr<cpp2::GetPartsAllocResp>> getSpaceAlloc(GraphSpaceID spaceId);
+
     bool loadSchemas(GraphSpaceID spaceId,
                      std::shared_ptr<SpaceInfoCache> spaceInfoCache,
                      SpaceTagNameIdMap &tagNameIdMap,
@@ -330,6 +351,8 @@ private:
     folly::RWSpinLock     listenerLock_;
     bool                  sendHeartBeat_ = false;
     std::atomic_bool      ready_{false};
+    // The meta version of the local cache, only accessed in bgThread_
+    int64_t               metaVersion_{0};
     MetaConfigMap         metaConfigMap_;
     folly::RWSpinLock     configCacheLock_;
     cpp2::ConfigModule    gflagsModule_{cpp2::ConfigModule::UNKNOWN};
@@ -129,6 +129,11 @@ protected:
      * */
     void doPut(std::vector<kvstore::KV> data);
 
+    /**
+     * Put the data changing the space, and bump the meta version along with it.
+     * */
+    void doPut(std::vector<kvstore::KV> data, GraphSpaceID changedSpace);
+
     StatusOr<std::unique_ptr<kvstore::KVIterator>> doPrefix(const std::string& key);
 
     /**
@@ -162,6 +167,11 @@ protected:
      **/
      void doMultiRemove(std::vector<std::string> keys);
 
+    /**
+     * Remove the keys of the space, then bump the meta version.
+     * */
+    void doMultiRemove(std::vector<std::string> keys, GraphSpaceID changedSpace);
+
     /**
      * Get all hosts
      * */
@@ -5,6 +5,7 @@
  */
 
 #include "meta/MetaServiceUtils.h"
+#include "meta/MetaVersionMan.h"
 #include "meta/processors/BaseProcessor.h"
 
 namespace nebula {
@@ -22,6 +23,18 @@ void BaseProcessor<RESP>::doPut(std::vector<kvstore::KV> data) {
 }
 
 
+template<typename RESP>
+void BaseProcessor<RESP>::doPut(std::vector<kvstore::KV> data, GraphSpaceID changedSpace) {
+    MetaVersionMan::multiPut(kvstore_,
+                             changedSpace,
+                             std::move(data),
+                             [this] (kvstore::ResultCode code) {
+        this->resp_.set_code(to(code));
+        this->onFinished();
+    });
+}
+
+
 template<typename RESP>
 StatusOr<std::unique_ptr<kvstore::KVIterator>>
 BaseProcessor<RESP>::doPrefix(const std::string& key) {
@@ -85,6 +98,31 @@ void BaseProcessor<RESP>::doMultiRemove(std::vector<std::string> keys) {
 }
 
 
+template<typename RESP>
+void BaseProcessor<RESP>::doMultiRemove(std::vector<std::string> keys,
+                                        GraphSpaceID changedSpace) {
+    kvstore_->asyncMultiRemove(kDefaultSpaceId,
+                               kDefaultPartId,
+                               std::move(keys),
+                               [this, changedSpace] (kvstore::ResultCode code) {
+        if (code != kvstore::ResultCode::SUCCEEDED) {
+            this->resp_.set_code(to(code));
+            this->onFinished();
+            return;
+        }
+        // Bump the version after the removal applied, so any client seeing the
+        // new version would see the removal too
+        MetaVersionMan::multiPut(this->kvstore_,
+                                 changedSpace,
+                                 {},
+                                 [this] (kvstore::ResultCode c) {
+            this->resp_.set_code(to(c));
+            this->onFinished();
+        });
+    });
+}
+
+
 template<typename RESP>
 void BaseProcessor<RESP>::doRemoveRange(const std::string& start,
                                         const std::string& end) {
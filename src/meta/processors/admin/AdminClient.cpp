@@ -6,6 +6,7 @@
 
 #include "meta/processors/admin/AdminClient.h"
 #include "meta/MetaServiceUtils.h"
+#include "meta/MetaVersionMan.h"
 #include "meta/processors/Common.h"
 
 DEFINE_int32(max_retry_times_admin_op, 3, "max retry times for admin request!");
@@ -147,10 +148,10 @@ folly::Future<Status> AdminClient::updateMeta(GraphSpaceID spaceId,
     std::vector<kvstore::KV> data;
     data.emplace_back(MetaServiceUtils::partKey(spaceId, partId),
                       MetaServiceUtils::partVal(thriftPeers));
-    kv_->asyncMultiPut(kDefaultSpaceId,
-                       kDefaultPartId,
-                       std::move(data),
-                       [this, p = std::move(pro)] (kvstore::ResultCode code) mutable {
+    MetaVersionMan::multiPut(kv_,
+                             spaceId,
+                             std::move(data),
+                             [this, p = std::move(pro)] (kvstore::ResultCode code) mutable {
         if (code == kvstore::ResultCode::SUCCEEDED) {
             p.setValue(Status::OK());
         } else {
@@ -9,6 +9,10 @@
 #include "meta/processors/Common.h"
 
 DEFINE_uint32(task_concurrency, 10, "The tasks number could be invoked simultaneously");
+DEFINE_uint32(task_concurrency_per_src_host, 2,
+              "The tasks number could be invoked simultaneously moving parts out of one host");
+DEFINE_uint32(task_concurrency_per_dst_host, 2,
+              "The tasks number could be invoked simultaneously moving parts into one host");
 
 namespace nebula {
 namespace meta {
@@ -42,61 +46,94 @@ void BalancePlan::dispatchTasks() {
 void BalancePlan::invoke() {
     status_ = Status::IN_PROGRESS;
     dispatchTasks();
+    runningBuckets_.assign(buckets_.size(), false);
+    startedTasks_.assign(tasks_.size(), false);
     for (size_t i = 0; i < buckets_.size(); i++) {
-        for (size_t j = 0; j < buckets_[i].size(); j++) {
-            auto taskIndex = buckets_[i][j];
-            tasks_[taskIndex].onFinished_ = [this, i, j]() {
-                bool finished = false;
-                {
-                    std::lock_guard<std::mutex> lg(lock_);
-                    finishedTaskNum_++;
-                    if (finishedTaskNum_ == tasks_.size()) {
-                        finished = true;
-                        if (status_ == Status::IN_PROGRESS) {
-                            status_ = Status::SUCCEEDED;
-                        }
-                    }
-                }
-                if (finished) {
-                    CHECK_EQ(j, this->buckets_[i].size() - 1);
-                    saveInStore(true);
-                    onFinished_();
-                } else {
-                    if (j + 1 < this->buckets_[i].size()) {
-                        auto& task = this->tasks_[this->buckets_[i][j + 1]];
-                        task.invoke();
-                    }
-                }
-            };  // onFinished
-            tasks_[taskIndex].onError_ = [this, i, j]() {
-                bool finished = false;
-                {
-                    std::lock_guard<std::mutex> lg(lock_);
-                    finishedTaskNum_++;
-                    status_ = Status::FAILED;
-                    if (finishedTaskNum_ == tasks_.size()) {
-                        finished = true;
-                    }
-                }
-                if (finished) {
-                    CHECK_EQ(j, this->buckets_[i].size() - 1);
-                    saveInStore(true);
-                    onFinished_();
-                } else {
-                    if (j + 1 < this->buckets_[i].size()) {
-                        auto& task = this->tasks_[this->buckets_[i][j + 1]];
-                        task.invoke();
-                    }
-                }
-            };  // onError
-        }  // for (auto j = 0; j < buckets_[i].size(); j++)
-    }  // for (auto i = 0; i < buckets_.size(); i++)
+        for (auto taskIndex : buckets_[i]) {
+            tasks_[taskIndex].onFinished_ = [this, i, taskIndex]() {
+                onTaskFinished(i, taskIndex, true);
+            };
+            tasks_[taskIndex].onError_ = [this, i, taskIndex]() {
+                onTaskFinished(i, taskIndex, false);
+            };
+        }
+    }
 
     saveInStore(true);
-    for (auto& bucket : buckets_) {
-        if (!bucket.empty()) {
-            tasks_[bucket[0]].invoke();
+    std::vector<int32_t> picked;
+    {
+        std::lock_guard<std::mutex> lg(lock_);
+        picked = pickTasks();
+    }
+    for (auto taskIndex : picked) {
+        tasks_[taskIndex].invoke();
+    }
+}
+
+std::vector<int32_t> BalancePlan::pickTasks() {
+    CHECK(!lock_.try_lock());
+    int32_t srcLimit = std::max(1U, FLAGS_task_concurrency_per_src_host);
+    int32_t dstLimit = std::max(1U, FLAGS_task_concurrency_per_dst_host);
+    std::vector<int32_t> picked;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        if (runningBuckets_[i]) {
+            continue;
         }
+        // The parts having an earlier task waiting for the hosts
+        std::unordered_set<std::pair<GraphSpaceID, PartitionID>> blocked;
+        for (auto taskIndex : buckets_[i]) {
+            if (startedTasks_[taskIndex]) {
+                continue;
+            }
+            auto& task = tasks_[taskIndex];
+            auto part = std::make_pair(task.spaceId_, task.partId_);
+            if (blocked.count(part) > 0) {
+                continue;
+            }
+            if (srcTasks_[task.src_] >= srcLimit || dstTasks_[task.dst_] >= dstLimit) {
+                blocked.emplace(std::move(part));
+                continue;
+            }
+            srcTasks_[task.src_]++;
+            dstTasks_[task.dst_]++;
+            startedTasks_[taskIndex] = true;
+            runningBuckets_[i] = true;
+            picked.emplace_back(taskIndex);
+            break;
+        }
+    }
+    return picked;
+}
+
+void BalancePlan::onTaskFinished(size_t bucketIndex, int32_t taskIndex, bool succeeded) {
+    bool finished = false;
+    std::vector<int32_t> picked;
+    {
+        std::lock_guard<std::mutex> lg(lock_);
+        finishedTaskNum_++;
+        if (!succeeded) {
+            status_ = Status::FAILED;
+        }
+        auto& task = tasks_[taskIndex];
+        srcTasks_[task.src_]--;
+        dstTasks_[task.dst_]--;
+        runningBuckets_[bucketIndex] = false;
+        if (finishedTaskNum_ == tasks_.size()) {
+            finished = true;
+            if (status_ == Status::IN_PROGRESS) {
+                status_ = Status::SUCCEEDED;
+            }
+        } else {
+            picked = pickTasks();
+        }
+    }
+    if (finished) {
+        saveInStore(true);
+        onFinished_();
+        return;
+    }
+    for (auto index : picked) {
+        tasks_[index].invoke();
     }
 }
 
@@ -128,7 +165,7 @@ bool BalancePlan::saveInStore(bool onlyPlan) {
     return true;
 }
 
-bool BalancePlan::recovery() {
+bool BalancePlan::recovery(bool resume) {
     if (kv_) {
         const auto& prefix = BalanceTask::prefix(id_);
         std::unique_ptr<kvstore::KVIterator> iter;
@@ -153,12 +190,14 @@ bool BalancePlan::recovery() {
                 auto tup = BalanceTask::parseVal(iter->val());
                 task.status_ = std::get<0>(tup);
                 task.ret_ = std::get<1>(tup);
-                if (task.ret_ == BalanceTask::Result::FAILED) {
+                if (resume && task.ret_ == BalanceTask::Result::FAILED) {
                     // Resume the failed task.
                     task.ret_ = BalanceTask::Result::IN_PROGRESS;
                 }
                 task.startTimeMs_ = std::get<2>(tup);
                 task.endTimeMs_ = std::get<3>(tup);
+                task.copiedBytes_ = std::get<4>(tup);
+                task.totalBytes_ = std::get<5>(tup);
             }
             tasks_.emplace_back(std::move(task));
             iter->next();
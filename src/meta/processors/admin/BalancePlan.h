@@ -20,6 +20,7 @@ class BalancePlan {
     FRIEND_TEST(BalanceTest, NormalTest);
     FRIEND_TEST(BalanceTest, RecoveryTest);
     FRIEND_TEST(BalanceTest, DispatchTasksTest);
+    FRIEND_TEST(BalanceTest, HostConcurrencyTest);
 
 public:
     enum class Status : uint8_t {
@@ -60,7 +61,11 @@ public:
     }
 
 private:
-    bool recovery();
+    /**
+     * Load the tasks from kvstore. When resume is true, the failed tasks will be
+     * invoked again from the step they failed.
+     * */
+    bool recovery(bool resume = true);
 
     std::string planKey() const;
 
@@ -68,6 +73,16 @@ private:
 
     void dispatchTasks();
 
+    /**
+     * Pick the next task of each idle bucket, as long as its src and dst hosts
+     * are running fewer tasks than FLAGS_task_concurrency_per_src_host and
+     * FLAGS_task_concurrency_per_dst_host. Tasks of the same part keep their order.
+     * Called with lock_ held, the picked tasks should be invoked after releasing it.
+     * */
+    std::vector<int32_t> pickTasks();
+
+    void onTaskFinished(size_t bucketIndex, int32_t taskIndex, bool succeeded);
+
     static const std::string& prefix();
 
     static BalanceID id(const folly::StringPiece& rawKey);
@@ -87,6 +102,11 @@ private:
     // List of task index in tasks_;
     using Bucket = std::vector<int32_t>;
     std::vector<Bucket> buckets_;
+    std::vector<bool> runningBuckets_;
+    std::vector<bool> startedTasks_;
+    // The number of running tasks on each host, as src and as dst
+    std::unordered_map<HostAddr, int32_t> srcTasks_;
+    std::unordered_map<HostAddr, int32_t> dstTasks_;
 };
 
 }  // namespace meta
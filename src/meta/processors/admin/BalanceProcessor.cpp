@@ -19,8 +19,15 @@ void BalanceProcessor::process(const cpp2::BalanceReq& req) {
         return;
     }
     if (req.get_id() != nullptr) {
-        LOG(ERROR) << "Unsupport show status for specific balance plan, id=" << *req.get_id();
-        resp_.set_code(cpp2::ErrorCode::E_UNSUPPORTED);
+        auto ret = Balancer::instance(kvstore_)->show(*req.get_id());
+        if (!ret.ok()) {
+            LOG(ERROR) << ret.status();
+            resp_.set_code(cpp2::ErrorCode::E_NOT_FOUND);
+            onFinished();
+            return;
+        }
+        resp_ = std::move(ret).value();
+        resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
         onFinished();
         return;
     }
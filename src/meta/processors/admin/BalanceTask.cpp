@@ -76,11 +76,15 @@ void BalanceTask::invoke() {
         }
         case Status::CATCH_UP_DATA: {
             LOG(INFO) << taskIdStr_ << "Waiting for the data catch up.";
+            if (kv_ != nullptr) {
+                updateProgress(ActiveHostsMan::instance()->getPartStats(spaceId_));
+            }
             SAVE_STATE();
             client_->waitingForCatchUpData(spaceId_, partId_).thenValue([this](auto&& resp) {
                 if (!resp.ok()) {
                     ret_ = Result::FAILED;
                 } else {
+                    copiedBytes_ = totalBytes_;
                     status_ = Status::MEMBER_CHANGE;
                 }
                 invoke();
@@ -131,7 +135,7 @@ void BalanceTask::invoke() {
         }
         case Status::END: {
             LOG(INFO) << taskIdStr_ <<  "Part has been moved successfully!";
-            endTimeMs_ = time::WallClock::fastNowInSec();
+            endTimeMs_ = time::WallClock::fastNowInMilliSec();
             SAVE_STATE();
             onFinished_();
             break;
@@ -148,6 +152,82 @@ void BalanceTask::rollback() {
     }
 }
 
+void BalanceTask::updateProgress(
+        const std::unordered_map<HostAddr, std::vector<cpp2::PartStats>>& stats) {
+    auto partSize = [this, &stats] (const HostAddr& host) -> int64_t {
+        auto it = stats.find(host);
+        if (it == stats.end()) {
+            return -1;
+        }
+        for (auto& partStats : it->second) {
+            if (partStats.get_part_id() == partId_) {
+                return partStats.get_disk_size();
+            }
+        }
+        return -1;
+    };
+    // The part has been removed from src once the task is done, keep the last total then
+    auto total = partSize(src_);
+    if (total >= 0) {
+        totalBytes_ = total;
+    }
+    if (status_ > Status::CATCH_UP_DATA) {
+        copiedBytes_ = totalBytes_;
+    } else if (status_ >= Status::ADD_LEARNER) {
+        auto copied = partSize(dst_);
+        if (copied >= 0) {
+            copiedBytes_ = std::min(copied, totalBytes_);
+        }
+    }
+}
+
+int64_t BalanceTask::etaSecs() const {
+    if (status_ > Status::CATCH_UP_DATA || copiedBytes_ >= totalBytes_) {
+        return 0;
+    }
+    if (copiedBytes_ <= 0 || startTimeMs_ <= 0) {
+        return -1;
+    }
+    auto elapsedMs = time::WallClock::fastNowInMilliSec() - startTimeMs_;
+    return elapsedMs * (totalBytes_ - copiedBytes_) / copiedBytes_ / 1000;
+}
+
+std::string BalanceTask::statusStr(Status status) {
+    switch (status) {
+        case Status::START:
+            return "START";
+        case Status::CHANGE_LEADER:
+            return "CHANGE_LEADER";
+        case Status::ADD_PART_ON_DST:
+            return "ADD_PART_ON_DST";
+        case Status::ADD_LEARNER:
+            return "ADD_LEARNER";
+        case Status::CATCH_UP_DATA:
+            return "CATCH_UP_DATA";
+        case Status::MEMBER_CHANGE:
+            return "MEMBER_CHANGE";
+        case Status::UPDATE_PART_META:
+            return "UPDATE_PART_META";
+        case Status::REMOVE_PART_ON_SRC:
+            return "REMOVE_PART_ON_SRC";
+        case Status::END:
+            return "END";
+    }
+    return "UNKNOWN";
+}
+
+std::string BalanceTask::resultStr(Result result) {
+    switch (result) {
+        case Result::SUCCEEDED:
+            return "SUCCEEDED";
+        case Result::FAILED:
+            return "FAILED";
+        case Result::IN_PROGRESS:
+            return "IN_PROGRESS";
+    }
+    return "UNKNOWN";
+}
+
 bool BalanceTask::saveInStore() {
     if (kv_) {
         std::vector<kvstore::KV> data;
@@ -190,6 +270,8 @@ std::string BalanceTask::taskVal() {
     str.append(reinterpret_cast<const char*>(&ret_), sizeof(ret_));
     str.append(reinterpret_cast<const char*>(&startTimeMs_), sizeof(startTimeMs_));
     str.append(reinterpret_cast<const char*>(&endTimeMs_), sizeof(endTimeMs_));
+    str.append(reinterpret_cast<const char*>(&copiedBytes_), sizeof(copiedBytes_));
+    str.append(reinterpret_cast<const char*>(&totalBytes_), sizeof(totalBytes_));
     return str;
 }
 
@@ -216,7 +298,7 @@ BalanceTask::parseKey(const folly::StringPiece& rawKey) {
     return std::make_tuple(balanceId, spaceId, partId, src, dst);
 }
 
-std::tuple<BalanceTask::Status, BalanceTask::Result, int64_t, int64_t>
+std::tuple<BalanceTask::Status, BalanceTask::Result, int64_t, int64_t, int64_t, int64_t>
 BalanceTask::parseVal(const folly::StringPiece& rawVal) {
     int32_t offset = 0;
     auto status = *reinterpret_cast<const BalanceTask::Status*>(rawVal.begin() + offset);
@@ -226,7 +308,15 @@ BalanceTask::parseVal(const folly::StringPiece& rawVal) {
     auto start = *reinterpret_cast<const int64_t*>(rawVal.begin() + offset);
     offset += sizeof(int64_t);
     auto end = *reinterpret_cast<const int64_t*>(rawVal.begin() + offset);
-    return std::make_tuple(status, ret, start, end);
+    offset += sizeof(int64_t);
+    // The tasks persisted by the old version have no progress
+    int64_t copied = 0, total = 0;
+    if (rawVal.size() >= offset + 2 * sizeof(int64_t)) {
+        copied = *reinterpret_cast<const int64_t*>(rawVal.begin() + offset);
+        offset += sizeof(int64_t);
+        total = *reinterpret_cast<const int64_t*>(rawVal.begin() + offset);
+    }
+    return std::make_tuple(status, ret, start, end, copied, total);
 }
 
 }  // namespace meta
@@ -20,10 +20,13 @@ namespace meta {
 
 class BalanceTask {
     friend class BalancePlan;
+    friend class Balancer;
     FRIEND_TEST(BalanceTaskTest, SimpleTest);
+    FRIEND_TEST(BalanceTaskTest, ProgressTest);
     FRIEND_TEST(BalanceTest, BalancePlanTest);
     FRIEND_TEST(BalanceTest, NormalTest);
     FRIEND_TEST(BalanceTest, RecoveryTest);
+    FRIEND_TEST(BalanceTest, HostConcurrencyTest);
 
 public:
     BalanceTask() = default;
@@ -79,6 +82,19 @@ private:
 
     bool saveInStore();
 
+    /**
+     * Estimate the bytes copied to dst by the part sizes reported by the hosts,
+     * the size on src is taken as the total.
+     * */
+    void updateProgress(const std::unordered_map<HostAddr, std::vector<cpp2::PartStats>>& stats);
+
+    // Return -1 if unknown
+    int64_t etaSecs() const;
+
+    static std::string statusStr(Status status);
+
+    static std::string resultStr(Result result);
+
     std::string taskKey();
 
     std::string taskVal();
@@ -88,7 +104,8 @@ private:
     static std::tuple<BalanceID, GraphSpaceID, PartitionID, HostAddr, HostAddr>
     parseKey(const folly::StringPiece& rawKey);
 
-    static std::tuple<BalanceTask::Status, BalanceTask::Result, int64_t, int64_t>
+    // <status, result, startTimeMs, endTimeMs, copiedBytes, totalBytes>
+    static std::tuple<BalanceTask::Status, BalanceTask::Result, int64_t, int64_t, int64_t, int64_t>
     parseVal(const folly::StringPiece& rawVal);
 
 private:
@@ -104,6 +121,9 @@ private:
     Result       ret_ = Result::IN_PROGRESS;
     int64_t      startTimeMs_ = 0;
     int64_t      endTimeMs_ = 0;
+    // Checkpoint of the data copied to dst, persisted along with the status
+    int64_t      copiedBytes_ = 0;
+    int64_t      totalBytes_ = 0;
     std::function<void()> onFinished_;
     std::function<void()> onError_;
 };
@@ -11,12 +11,28 @@
 #include "meta/ActiveHostsMan.h"
 #include "meta/MetaServiceUtils.h"
 
+DEFINE_bool(balance_by_load, true,
+            "Balance the parts by the load reported by heartbeats instead of by the number, "
+            "if any load reported");
+DEFINE_int64(balance_data_budget_mb, 100 * 1024,
+             "The max data moved for balancing the load in one balance plan, in MB");
+DEFINE_double(balance_disk_weight, 0.5,
+              "The weight of the disk size in the load of a part, the rest is of the qps");
+DEFINE_double(balance_load_tolerance, 0.1,
+              "Stop balancing the load once the gap between the hosts is within "
+              "this ratio of the average load");
+DEFINE_int32(leader_balance_interval_secs, 600,
+             "Interval to balance the leaders in the background, 0 to disable it");
+DEFINE_uint32(leader_balance_max_trans, 100, "The max leaders transferred in one leader balance");
+DEFINE_uint32(leader_balance_concurrency, 4,
+              "The leaders could be transferred simultaneously in leader balance");
+
 namespace nebula {
 namespace meta {
 
 StatusOr<BalanceID> Balancer::balance() {
-    bool expected = false;
-    if (running_.compare_exchange_strong(expected, true)) {
+    auto expected = State::IDLE;
+    if (state_.compare_exchange_strong(expected, State::BALANCING)) {
         if (!recovery()) {
             LOG(ERROR) << "Recovery balancer failed!";
             return Status::Error("Can't do balance because there is one corruptted balance plan!");
@@ -32,7 +48,90 @@ StatusOr<BalanceID> Balancer::balance() {
         executor_->add(std::bind(&BalancePlan::invoke, plan_.get()));
         return plan_->id();
     }
-    return Status::Error("balance running");
+    return Status::Error(expected == State::LEADER_BALANCING ? "leader balance running"
+                                                              : "balance running");
+}
+
+StatusOr<cpp2::BalanceResp> Balancer::show(BalanceID id) {
+    if (kv_ == nullptr) {
+        return Status::Error("No kvstore");
+    }
+    // Load the plan from kvstore instead of touching the running one,
+    // each task is persisted whenever it steps forward.
+    BalancePlan plan(id, kv_, nullptr);
+    std::string val;
+    auto ret = kv_->get(kDefaultSpaceId, kDefaultPartId, plan.planKey(), &val);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return Status::Error("Balance plan %ld not found", id);
+    }
+    if (!plan.recovery(false)) {
+        return Status::Error("Can't load the tasks of plan %ld", id);
+    }
+    auto planStatus = BalancePlan::status(val);
+
+    cpp2::BalanceResp resp;
+    resp.set_id(id);
+    switch (planStatus) {
+        case BalancePlan::Status::NOT_START:
+            resp.set_status("NOT_START");
+            break;
+        case BalancePlan::Status::IN_PROGRESS:
+            resp.set_status("IN_PROGRESS");
+            break;
+        case BalancePlan::Status::SUCCEEDED:
+            resp.set_status("SUCCEEDED");
+            break;
+        case BalancePlan::Status::FAILED:
+            resp.set_status("FAILED");
+            break;
+    }
+    auto toThriftHost = [] (const HostAddr& host) {
+        nebula::cpp2::HostAddr tHost;
+        tHost.set_ip(host.first);
+        tHost.set_port(host.second);
+        return tHost;
+    };
+    std::unordered_map<GraphSpaceID,
+                       std::unordered_map<HostAddr, std::vector<cpp2::PartStats>>> stats;
+    int64_t copiedBytes = 0, totalBytes = 0, etaSecs = 0;
+    std::vector<cpp2::BalanceTaskProgress> tasks;
+    for (auto& task : plan.tasks_) {
+        if (planStatus == BalancePlan::Status::IN_PROGRESS
+                && task.ret_ == BalanceTask::Result::IN_PROGRESS) {
+            auto it = stats.find(task.spaceId_);
+            if (it == stats.end()) {
+                it = stats.emplace(task.spaceId_,
+                                   ActiveHostsMan::instance()->getPartStats(task.spaceId_)).first;
+            }
+            task.updateProgress(it->second);
+        }
+        cpp2::BalanceTaskProgress progress;
+        progress.set_space_id(task.spaceId_);
+        progress.set_part_id(task.partId_);
+        progress.set_src(toThriftHost(task.src_));
+        progress.set_dst(toThriftHost(task.dst_));
+        progress.set_status(BalanceTask::statusStr(task.status_));
+        progress.set_result(BalanceTask::resultStr(task.ret_));
+        progress.set_bytes_copied(task.copiedBytes_);
+        progress.set_total_bytes(task.totalBytes_);
+        auto taskEta = task.ret_ == BalanceTask::Result::IN_PROGRESS ? task.etaSecs() : 0;
+        progress.set_eta_secs(taskEta);
+        progress.set_start_time(task.startTimeMs_);
+        progress.set_end_time(task.endTimeMs_);
+        tasks.emplace_back(std::move(progress));
+
+        copiedBytes += task.copiedBytes_;
+        totalBytes += task.totalBytes_;
+        // The tasks run concurrently, the plan finishes along with the slowest one
+        if (etaSecs >= 0) {
+            etaSecs = taskEta < 0 ? -1 : std::max(etaSecs, taskEta);
+        }
+    }
+    resp.set_tasks(std::move(tasks));
+    resp.set_bytes_copied(copiedBytes);
+    resp.set_total_bytes(totalBytes);
+    resp.set_eta_secs(etaSecs);
+    return resp;
 }
 
 bool Balancer::recovery() {
@@ -62,10 +161,10 @@ bool Balancer::recovery() {
         CHECK_EQ(1, corruptedPlans.size());
         plan_ = std::make_unique<BalancePlan>(corruptedPlans[0], kv_, client_.get());
         plan_->onFinished_ = [this] () {
-            bool expected = true;
-            auto &running = this->running_;   // Get the reference before the captured `this' lost
+            auto expected = State::BALANCING;
+            auto &state = this->state_;   // Get the reference before the captured `this' lost
             plan_.reset();
-            CHECK(running.compare_exchange_strong(expected, false));
+            CHECK(state.compare_exchange_strong(expected, State::IDLE));
         };
         if (!plan_->recovery()) {
             LOG(ERROR) << "Can't recovery plan " << corruptedPlans[0];
@@ -76,37 +175,44 @@ bool Balancer::recovery() {
     return true;
 }
 
+StatusOr<std::vector<GraphSpaceID>> Balancer::allSpaces() {
+    std::vector<GraphSpaceID> spaces;
+    folly::SharedMutex::ReadHolder rHolder(LockUtils::spaceLock());
+    auto prefix = MetaServiceUtils::spacePrefix();
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kv_->prefix(kDefaultSpaceId, kDefaultPartId, prefix, &iter);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return Status::Error("Can't access kvstore, ret = %d", static_cast<int32_t>(ret));
+    }
+    while (iter->valid()) {
+        auto spaceId = MetaServiceUtils::spaceId(iter->key());
+        spaces.push_back(spaceId);
+        iter->next();
+    }
+    return spaces;
+}
+
 Status Balancer::buildBalancePlan() {
     CHECK(!plan_) << "plan should be nullptr now";
-    std::vector<GraphSpaceID> spaces;
-    {
-        // Get all spaces
-        folly::SharedMutex::ReadHolder rHolder(LockUtils::spaceLock());
-        auto prefix = MetaServiceUtils::spacePrefix();
-        std::unique_ptr<kvstore::KVIterator> iter;
-        auto ret = kv_->prefix(kDefaultSpaceId, kDefaultPartId, prefix, &iter);
-        if (ret != kvstore::ResultCode::SUCCEEDED) {
-            running_ = false;
-            return Status::Error("Can't access kvstore, ret = %d", static_cast<int32_t>(ret));
-        }
-        while (iter->valid()) {
-            auto spaceId = MetaServiceUtils::spaceId(iter->key());
-            spaces.push_back(spaceId);
-            iter->next();
-        }
+    auto spacesRet = allSpaces();
+    if (!spacesRet.ok()) {
+        state_ = State::IDLE;
+        return spacesRet.status();
     }
+    auto spaces = std::move(spacesRet).value();
     plan_ = std::make_unique<BalancePlan>(time::WallClock::fastNowInSec(), kv_, client_.get());
+    int64_t budget = FLAGS_balance_data_budget_mb * 1024 * 1024;
     for (auto spaceId : spaces) {
-        auto tasks = genTasks(spaceId);
+        auto tasks = genTasks(spaceId, budget);
         for (auto& task : tasks) {
             plan_->addTask(std::move(task));
         }
     }
     plan_->onFinished_ = [this] () {
-        bool expected = true;
-        auto &running = this->running_;   // Get the reference before the captured `this' lost
+        auto expected = State::BALANCING;
+        auto &state = this->state_;   // Get the reference before the captured `this' lost
         plan_.reset();
-        CHECK(running.compare_exchange_strong(expected, false));
+        CHECK(state.compare_exchange_strong(expected, State::IDLE));
     };
     if (plan_->tasks_.empty()) {
         plan_->onFinished_();
@@ -119,7 +225,7 @@ Status Balancer::buildBalancePlan() {
     return Status::OK();
 }
 
-std::vector<BalanceTask> Balancer::genTasks(GraphSpaceID spaceId) {
+std::vector<BalanceTask> Balancer::genTasks(GraphSpaceID spaceId, int64_t& budget) {
     CHECK(!!plan_) << "plan should not be nullptr";
     std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
     int32_t totalParts = 0;
@@ -166,6 +272,14 @@ std::vector<BalanceTask> Balancer::genTasks(GraphSpaceID spaceId) {
         LOG(INFO) << "Too few hosts, no need for balance!";
         return tasks;
     }
+    if (FLAGS_balance_by_load) {
+        auto loads = getPartLoads(spaceId);
+        if (!loads.empty()) {
+            balancePartsByLoad(plan_->id_, spaceId, newHostParts, loads, budget, tasks);
+            return tasks;
+        }
+        LOG(INFO) << "No load reported for space " << spaceId << ", balance by the parts number";
+    }
     balanceParts(plan_->id_, spaceId, newHostParts, totalParts, tasks);
     return tasks;
 }
@@ -234,6 +348,320 @@ void Balancer::balanceParts(BalanceID balanceId,
     }
 }
 
+HostPartLoads Balancer::getPartLoads(GraphSpaceID spaceId) {
+    HostPartLoads loads;
+    auto stats = ActiveHostsMan::instance()->getPartStats(spaceId);
+    int64_t totalSize = 0;
+    int64_t totalQps = 0;
+    for (auto& entry : stats) {
+        for (auto& partStats : entry.second) {
+            totalSize += partStats.get_disk_size();
+            totalQps += partStats.get_read_qps() + partStats.get_write_qps();
+        }
+    }
+    if (totalSize == 0 && totalQps == 0) {
+        return loads;
+    }
+    // Only weigh what has been measured
+    double diskWeight = FLAGS_balance_disk_weight;
+    if (totalQps == 0) {
+        diskWeight = 1.0;
+    } else if (totalSize == 0) {
+        diskWeight = 0.0;
+    }
+    for (auto& entry : stats) {
+        auto& hostLoads = loads[entry.first];
+        for (auto& partStats : entry.second) {
+            PartLoad load;
+            load.size_ = partStats.get_disk_size();
+            if (totalSize > 0) {
+                load.load_ += diskWeight * partStats.get_disk_size() / totalSize;
+            }
+            if (totalQps > 0) {
+                auto qps = partStats.get_read_qps() + partStats.get_write_qps();
+                load.load_ += (1.0 - diskWeight) * qps / totalQps;
+            }
+            hostLoads.emplace(partStats.get_part_id(), load);
+        }
+    }
+    return loads;
+}
+
+void Balancer::balancePartsByLoad(BalanceID balanceId,
+                                  GraphSpaceID spaceId,
+                                  std::unordered_map<HostAddr,
+                                                     std::vector<PartitionID>>& newHostParts,
+                                  HostPartLoads& loads,
+                                  int64_t& budget,
+                                  std::vector<BalanceTask>& tasks) {
+    // The replicas without load reported, e.g. the ones just moved from the lost hosts,
+    // are taken as loaded as the average of the other replicas of the part.
+    std::unordered_map<PartitionID, std::pair<PartLoad, int32_t>> partSums;
+    for (auto& hostEntry : loads) {
+        for (auto& partEntry : hostEntry.second) {
+            auto& sum = partSums[partEntry.first];
+            sum.first.load_ += partEntry.second.load_;
+            sum.first.size_ += partEntry.second.size_;
+            sum.second++;
+        }
+    }
+    auto loadOf = [&] (const HostAddr& host, PartitionID partId) -> const PartLoad& {
+        auto& hostLoads = loads[host];
+        auto it = hostLoads.find(partId);
+        if (it == hostLoads.end()) {
+            PartLoad load;
+            auto sumIt = partSums.find(partId);
+            if (sumIt != partSums.end()) {
+                load.load_ = sumIt->second.first.load_ / sumIt->second.second;
+                load.size_ = sumIt->second.first.size_ / sumIt->second.second;
+            }
+            it = hostLoads.emplace(partId, load).first;
+        }
+        return it->second;
+    };
+
+    std::unordered_map<HostAddr, double> hostLoads;
+    double totalLoad = 0;
+    for (auto& entry : newHostParts) {
+        auto& hostLoad = hostLoads[entry.first];
+        for (auto partId : entry.second) {
+            hostLoad += loadOf(entry.first, partId).load_;
+        }
+        totalLoad += hostLoad;
+    }
+    auto tolerance = FLAGS_balance_load_tolerance * totalLoad / newHostParts.size();
+    // Each move should narrow the gap between the two hosts by minStep at least,
+    // so it won't go back and forth on the rounding errors.
+    auto minStep = std::max(tolerance, 1e-9);
+    LOG(INFO) << "The expect avg load is " << totalLoad / newHostParts.size()
+              << ", the data could be moved is " << budget << " bytes";
+
+    while (true) {
+        std::vector<std::pair<HostAddr, double>> hosts(hostLoads.begin(), hostLoads.end());
+        std::sort(hosts.begin(), hosts.end(), [](const auto& l, const auto& r) {
+            return l.second < r.second;
+        });
+        auto& from = hosts.back();
+        auto& partsFrom = newHostParts[from.first];
+        bool moved = false;
+        // Try the least loaded host first
+        for (size_t i = 0; i + 1 < hosts.size() && !moved; i++) {
+            auto& to = hosts[i];
+            auto gap = from.second - to.second;
+            if (gap <= tolerance) {
+                break;
+            }
+            // Moving a part of load l reduces the sum of the squared loads of the two hosts
+            // by 2l(gap - l), so the best part is the one with load closest to gap/2.
+            auto& partsTo = newHostParts[to.first];
+            PartitionID bestPart = -1;
+            double bestDist = (gap - minStep) / 2;
+            for (auto partId : partsFrom) {
+                if (std::find(partsTo.begin(), partsTo.end(), partId) != partsTo.end()) {
+                    continue;
+                }
+                const auto& load = loadOf(from.first, partId);
+                if (load.size_ > budget) {
+                    continue;
+                }
+                auto dist = std::abs(load.load_ - gap / 2);
+                if (dist < bestDist) {
+                    bestPart = partId;
+                    bestDist = dist;
+                }
+            }
+            if (bestPart == -1) {
+                continue;
+            }
+            auto load = loadOf(from.first, bestPart);
+            VLOG(1) << from.first << "->" << to.first << ": " << bestPart
+                    << ", load " << load.load_ << ", size " << load.size_;
+            partsFrom.erase(std::find(partsFrom.begin(), partsFrom.end(), bestPart));
+            partsTo.emplace_back(bestPart);
+            loads[from.first].erase(bestPart);
+            loads[to.first][bestPart] = load;
+            hostLoads[from.first] -= load.load_;
+            hostLoads[to.first] += load.load_;
+            budget -= load.size_;
+            tasks.emplace_back(balanceId,
+                               spaceId,
+                               bestPart,
+                               from.first,
+                               to.first,
+                               kv_,
+                               client_.get());
+            moved = true;
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    LOG(INFO) << "Balance tasks num: " << tasks.size() << ", the data could still be moved is "
+              << budget << " bytes";
+    for (auto& task : tasks) {
+        LOG(INFO) << task.taskIdStr();
+    }
+}
+
+Status Balancer::leaderBalance() {
+    auto expected = State::IDLE;
+    if (!state_.compare_exchange_strong(expected, State::LEADER_BALANCING)) {
+        return Status::Error(expected == State::BALANCING ? "balance running"
+                                                          : "leader balance running");
+    }
+    auto* store = dynamic_cast<kvstore::NebulaStore*>(kv_);
+    if (store != nullptr && !store->isLeader(kDefaultSpaceId, kDefaultPartId)) {
+        state_ = State::IDLE;
+        return Status::Error("Not the leader of meta");
+    }
+    auto spacesRet = allSpaces();
+    if (!spacesRet.ok()) {
+        state_ = State::IDLE;
+        return spacesRet.status();
+    }
+
+    auto activeHosts = ActiveHostsMan::instance()->getActiveHosts();
+    // <space, part, from, to>
+    std::vector<std::tuple<GraphSpaceID, PartitionID, HostAddr, HostAddr>> allTrans;
+    for (auto spaceId : spacesRet.value()) {
+        if (allTrans.size() >= FLAGS_leader_balance_max_trans) {
+            break;
+        }
+        std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
+        int32_t totalParts = 0;
+        getHostParts(spaceId, hostParts, totalParts);
+        // Only the active hosts could take over the leaders
+        for (auto it = hostParts.begin(); it != hostParts.end();) {
+            if (std::find(activeHosts.begin(), activeHosts.end(), it->first) == activeHosts.end()) {
+                it = hostParts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        std::unordered_map<HostAddr, std::vector<PartitionID>> leaderParts;
+        for (auto& entry : ActiveHostsMan::instance()->getPartStats(spaceId)) {
+            if (hostParts.find(entry.first) == hostParts.end()) {
+                continue;
+            }
+            for (auto& partStats : entry.second) {
+                if (partStats.get_is_leader()) {
+                    leaderParts[entry.first].emplace_back(partStats.get_part_id());
+                }
+            }
+        }
+        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>> trans;
+        balanceLeaders(hostParts,
+                       leaderParts,
+                       FLAGS_leader_balance_max_trans - allTrans.size(),
+                       trans);
+        for (auto& t : trans) {
+            allTrans.emplace_back(spaceId, std::get<0>(t), std::get<1>(t), std::get<2>(t));
+        }
+    }
+    if (allTrans.empty()) {
+        LOG(INFO) << "The leaders are balanced";
+        state_ = State::IDLE;
+        return Status::OK();
+    }
+
+    LOG(INFO) << "Transfer " << allTrans.size() << " leaders";
+    executor_->add([this, allTrans = std::move(allTrans)] () {
+        // Transfer a few leaders at a time, so the hosts won't be busy on the elections
+        size_t batchSize = std::max(FLAGS_leader_balance_concurrency, 1U);
+        for (size_t i = 0; i < allTrans.size(); i += batchSize) {
+            std::vector<folly::Future<Status>> futures;
+            for (size_t j = i; j < std::min(allTrans.size(), i + batchSize); j++) {
+                auto& t = allTrans[j];
+                VLOG(1) << "Transfer the leader of [" << std::get<0>(t) << ", " << std::get<1>(t)
+                        << "] from " << std::get<2>(t) << " to " << std::get<3>(t);
+                futures.emplace_back(client_->transLeader(std::get<0>(t),
+                                                          std::get<1>(t),
+                                                          std::get<2>(t),
+                                                          std::get<3>(t)));
+            }
+            auto results = folly::collectAll(futures).get();
+            for (auto& result : results) {
+                if (result.hasException()) {
+                    LOG(WARNING) << "Transfer leader failed: " << result.exception().what();
+                } else if (!result.value().ok()) {
+                    LOG(WARNING) << "Transfer leader failed: " << result.value();
+                }
+            }
+        }
+        LOG(INFO) << "Leader balance finished";
+        state_ = State::IDLE;
+    });
+    return Status::OK();
+}
+
+void Balancer::startLeaderBalance() {
+    if (FLAGS_leader_balance_interval_secs <= 0) {
+        LOG(INFO) << "Leader balance in the background is disabled";
+        return;
+    }
+    CHECK(bgThread_.start());
+    bgThread_.addRepeatTask(FLAGS_leader_balance_interval_secs * 1000, [this] () {
+        auto status = leaderBalance();
+        if (!status.ok()) {
+            VLOG(1) << "Skip the leader balance: " << status;
+        }
+    });
+}
+
+void Balancer::balanceLeaders(
+        const std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts,
+        std::unordered_map<HostAddr, std::vector<PartitionID>>& leaderParts,
+        size_t maxTrans,
+        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>>& trans) {
+    size_t totalLeaders = 0;
+    for (auto& entry : hostParts) {
+        totalLeaders += leaderParts[entry.first].size();
+    }
+    if (hostParts.empty() || totalLeaders == 0) {
+        return;
+    }
+    auto avgLoad = static_cast<double>(totalLeaders) / hostParts.size();
+    size_t minLoad = std::floor(avgLoad);
+    size_t maxLoad = std::ceil(avgLoad);
+    while (trans.size() < maxTrans) {
+        std::vector<std::pair<HostAddr, size_t>> hosts;
+        for (auto& entry : hostParts) {
+            hosts.emplace_back(entry.first, leaderParts[entry.first].size());
+        }
+        std::sort(hosts.begin(), hosts.end(), [](const auto& l, const auto& r) {
+            return l.second < r.second;
+        });
+        if (hosts.back().second <= maxLoad && hosts.front().second >= minLoad) {
+            break;
+        }
+        bool moved = false;
+        // Move from the host leading the most parts to the peer leading the fewest,
+        // as long as it narrows the gap between them
+        for (auto from = hosts.rbegin(); from != hosts.rend() && !moved; ++from) {
+            auto& partsFrom = leaderParts[from->first];
+            for (auto to = hosts.begin();
+                 to != hosts.end() && to->second + 1 < from->second && !moved;
+                 ++to) {
+                const auto& peerParts = hostParts.at(to->first);
+                for (auto it = partsFrom.begin(); it != partsFrom.end(); ++it) {
+                    auto partId = *it;
+                    if (std::find(peerParts.begin(), peerParts.end(), partId) == peerParts.end()) {
+                        continue;
+                    }
+                    partsFrom.erase(it);
+                    leaderParts[to->first].emplace_back(partId);
+                    trans.emplace_back(partId, from->first, to->first);
+                    moved = true;
+                    break;
+                }
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+}
+
 void Balancer::getHostParts(GraphSpaceID spaceId,
                             std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts,
                             int32_t& totalParts) {
@@ -12,12 +12,22 @@
 #include "kvstore/KVStore.h"
 #include "network/NetworkUtils.h"
 #include "time/WallClock.h"
+#include "thread/GenericWorker.h"
 #include "meta/processors/admin/AdminClient.h"
 #include "meta/processors/admin/BalanceTask.h"
 #include "meta/processors/admin/BalancePlan.h"
 
 namespace nebula {
 namespace meta {
+
+// The load of one part replica. The loads of all replicas in a space sum up to 1
+struct PartLoad {
+    double  load_{0};
+    int64_t size_{0};
+};
+
+using HostPartLoads = std::unordered_map<HostAddr, std::unordered_map<PartitionID, PartLoad>>;
+
 /**
 There are two interfaces public:
  * Balance:  it will construct a balance plan and invoked it. If last balance plan is not succeeded, it will
@@ -29,22 +39,32 @@ Some notes:
 1. Balance will generate balance plan according to current active hosts and parts allocation
 2. For the plan, we hope after moving the least parts , it will reach a reasonable state.
 3. Only one balance plan could be invoked at the same time.
-4. Each balance plan has one id, and we could show the status by "balance id" command
-   and after FO, we could resume the balance plan by type "balance" again.
+4. Each balance plan has one id, and we could show the status by "balance data id" command
+   and after FO, we could resume the balance plan by type "balance data" again.
 5. Each balance plan contains many balance tasks, the task represents the minimum movement unit.
 6. We save the whole balancePlan state in kvstore to do failover.
 7. Each balance task contains serval steps. And it should be executed step by step.
 8. One task failed will result in the whole balance plan failed.
 9. Currently, we hope tasks for the same part could be invoked serially
+10. If the hosts report the load of the parts by heartbeats, the parts are balanced
+    by load instead of by number, see balancePartsByLoad.
+11. The tasks running on the same host are limited, both as src and as dst, see
+    BalancePlan::pickTasks. The data copied to the new replica is throttled by
+    the storage hosts with FLAGS_learner_catch_up_rate_mb.
+
+Besides, the leaders are balanced by leaderBalance, on demand or periodically. It only
+transfers the leaders among the replicas, so no data is moved.
  * */
 class Balancer {
     FRIEND_TEST(BalanceTest, BalancePartsTest);
+    FRIEND_TEST(BalanceTest, BalancePartsByLoadTest);
+    FRIEND_TEST(BalanceTest, BalanceLeadersTest);
     FRIEND_TEST(BalanceTest, NormalTest);
     FRIEND_TEST(BalanceTest, RecoveryTest);
 
 public:
     static Balancer* instance(kvstore::KVStore* kv) {
-        static std::unique_ptr<AdminClient> client(new AdminClient());
+        static std::unique_ptr<AdminClient> client(new AdminClient(kv));
         static std::unique_ptr<Balancer> balancer(new Balancer(kv, std::move(client)));
         return balancer.get();
     }
@@ -56,6 +76,25 @@ public:
      * */
     StatusOr<BalanceID> balance();
 
+    /**
+     * Return the status of the balance plan and the progress of its tasks. The bytes
+     * copied are estimated by the part sizes reported by the heartbeats, so is the
+     * time to finish.
+     * */
+    StatusOr<cpp2::BalanceResp> show(BalanceID id);
+
+    /**
+     * Transfer the leaders so that each active host leads about the same number of parts
+     * in every space. The current leaders are known from the heartbeats.
+     * Return Error if a balance plan or another leader balance is running.
+     * */
+    Status leaderBalance();
+
+    /**
+     * Run leaderBalance every FLAGS_leader_balance_interval_secs in the background.
+     * */
+    void startLeaderBalance();
+
     /**
      * TODO(heng): Rollback some specific balance id
      */
@@ -102,7 +141,10 @@ private:
      * */
     Status buildBalancePlan();
 
-    std::vector<BalanceTask> genTasks(GraphSpaceID spaceId);
+    StatusOr<std::vector<GraphSpaceID>> allSpaces();
+
+    // `budget' is the bytes could still be moved for balancing the load
+    std::vector<BalanceTask> genTasks(GraphSpaceID spaceId, int64_t& budget);
 
     void getHostParts(GraphSpaceID spaceId,
                       std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts,
@@ -127,13 +169,50 @@ private:
     std::vector<std::pair<HostAddr, int32_t>>
     sortedHostsByParts(const std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts);
 
+    /**
+     * Build the loads of the parts in the space from the stats reported by heartbeats.
+     * Return empty if no stats reported.
+     * */
+    HostPartLoads getPartLoads(GraphSpaceID spaceId);
+
+    /**
+     * Move the parts from the most loaded host to the least loaded ones greedily,
+     * each move picks the part which reduces the variance of the hosts' loads most,
+     * until the loads are within FLAGS_balance_load_tolerance or the bytes moved
+     * would exceed the budget.
+     * */
+    void balancePartsByLoad(BalanceID balanceId,
+                            GraphSpaceID spaceId,
+                            std::unordered_map<HostAddr, std::vector<PartitionID>>& newHostParts,
+                            HostPartLoads& loads,
+                            int64_t& budget,
+                            std::vector<BalanceTask>& tasks);
+
+    /**
+     * Move the leaders from the hosts leading the most parts to the peers leading
+     * the fewest, until every host leads floor(avg) to ceil(avg) parts, or no peer could
+     * take over, or maxTrans leaders are moved. Each transfer is <part, from, to>.
+     * */
+    void balanceLeaders(const std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts,
+                        std::unordered_map<HostAddr, std::vector<PartitionID>>& leaderParts,
+                        size_t maxTrans,
+                        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>>& trans);
+
 private:
-    std::atomic_bool  running_{false};
+    // The data balance and the leader balance never run at the same time
+    enum class State : uint8_t {
+        IDLE,
+        BALANCING,
+        LEADER_BALANCING,
+    };
+
+    std::atomic<State> state_{State::IDLE};
     kvstore::KVStore* kv_ = nullptr;
     std::unique_ptr<AdminClient> client_{nullptr};
     // Current running plan.
     std::unique_ptr<BalancePlan> plan_{nullptr};
     std::unique_ptr<folly::Executor> executor_;
+    thread::GenericWorker bgThread_;
 };
 
 }  // namespace meta
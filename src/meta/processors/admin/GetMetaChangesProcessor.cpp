@@ -0,0 +1,29 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "meta/processors/admin/GetMetaChangesProcessor.h"
+#include "meta/MetaVersionMan.h"
+
+namespace nebula {
+namespace meta {
+
+void GetMetaChangesProcessor::process(const cpp2::GetMetaChangesReq& req) {
+    int64_t version = 0;
+    auto ret = MetaVersionMan::getChanges(kvstore_, req.get_since_version(), version);
+    resp_.set_version(version);
+    if (!ret.ok()) {
+        VLOG(2) << ret.status() << ", the client should reload all";
+        resp_.set_full_reload(true);
+    } else {
+        resp_.set_full_reload(false);
+        resp_.set_spaces(std::move(ret).value());
+    }
+    resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
+    onFinished();
+}
+
+}  // namespace meta
+}  // namespace nebula
@@ -0,0 +1,31 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef META_GETMETACHANGESPROCESSOR_H_
+#define META_GETMETACHANGESPROCESSOR_H_
+
+#include "meta/processors/BaseProcessor.h"
+
+namespace nebula {
+namespace meta {
+
+class GetMetaChangesProcessor : public BaseProcessor<cpp2::GetMetaChangesResp> {
+public:
+    static GetMetaChangesProcessor* instance(kvstore::KVStore* kvstore) {
+        return new GetMetaChangesProcessor(kvstore);
+    }
+
+    void process(const cpp2::GetMetaChangesReq& req);
+
+private:
+    explicit GetMetaChangesProcessor(kvstore::KVStore* kvstore)
+            : BaseProcessor<cpp2::GetMetaChangesResp>(kvstore) {}
+};
+
+}  // namespace meta
+}  // namespace nebula
+
+#endif  // META_GETMETACHANGESPROCESSOR_H_
@@ -32,6 +32,9 @@ void HBProcessor::process(const cpp2::HBReq& req) {
     LOG(INFO) << "Receive heartbeat from " << host;
     HostInfo info;
     info.lastHBTimeInSec_ = time::WallClock::fastNowInSec();
+    if (req.get_part_stats() != nullptr) {
+        info.partStats_ = *req.get_part_stats();
+    }
     if (!ActiveHostsMan::instance()->updateHostInfo(host, info)) {
         resp_.set_code(cpp2::ErrorCode::E_LEADER_CHANGED);
     }
@@ -0,0 +1,35 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+
+#include "meta/processors/admin/LeaderBalanceProcessor.h"
+#include "meta/processors/admin/Balancer.h"
+
+namespace nebula {
+namespace meta {
+
+void LeaderBalanceProcessor::process(const cpp2::LeaderBalanceReq& req) {
+    UNUSED(req);
+    auto hosts = ActiveHostsMan::instance()->getActiveHosts();
+    if (hosts.empty()) {
+        LOG(ERROR) << "There is no active hosts";
+        resp_.set_code(cpp2::ErrorCode::E_NO_HOSTS);
+        onFinished();
+        return;
+    }
+    auto status = Balancer::instance(kvstore_)->leaderBalance();
+    if (!status.ok()) {
+        LOG(INFO) << "Can't balance the leaders: " << status;
+        resp_.set_code(cpp2::ErrorCode::E_BALANCER_RUNNING);
+        onFinished();
+        return;
+    }
+    resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
+    onFinished();
+}
+
+}  // namespace meta
+}  // namespace nebula
@@ -69,7 +69,7 @@ void CreateSpaceProcessor::process(const cpp2::CreateSpaceReq& req) {
     }
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     resp_.set_id(to(spaceId, EntryType::SPACE));
-    doPut(std::move(data));
+    doPut(std::move(data), spaceId);
 }
 
 
@@ -44,7 +44,7 @@ void DropSpaceProcessor::process(const cpp2::DropSpaceReq& req) {
     // delete related role data.
     // TODO(boshengchen) delete related role data under the space
     // TODO(YT) delete Tag/Edge under the space
-    doMultiRemove(std::move(deleteKeys));
+    doMultiRemove(std::move(deleteKeys), spaceId);
     // TODO(YT) delete part files of the space
 }
 
@@ -30,6 +30,10 @@ void GetPartsAllocProcessor::process(const cpp2::GetPartsAllocReq& req) {
         iter->next();
     }
     resp_.set_parts(std::move(parts));
+    auto spaceRet = doGet(MetaServiceUtils::spaceKey(spaceId));
+    if (spaceRet.ok()) {
+        resp_.set_properties(MetaServiceUtils::parseSpace(spaceRet.value()));
+    }
     onFinished();
 }
 
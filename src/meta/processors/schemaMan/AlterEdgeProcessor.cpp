@@ -74,7 +74,7 @@ void AlterEdgeProcessor::process(const cpp2::AlterEdgeReq& req) {
                       MetaServiceUtils::schemaEdgeVal(req.get_edge_name(), schema));
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     resp_.set_id(to(edgeType, EntryType::EDGE));
-    doPut(std::move(data));
+    doPut(std::move(data), req.get_space_id());
 }
 
 }  // namespace meta
@@ -74,7 +74,7 @@ void AlterTagProcessor::process(const cpp2::AlterTagReq& req) {
                       MetaServiceUtils::schemaTagVal(req.get_tag_name(), schema));
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     resp_.set_id(to(tagId, EntryType::TAG));
-    doPut(std::move(data));
+    doPut(std::move(data), req.get_space_id());
 }
 
 
@@ -45,7 +45,7 @@ void CreateEdgeProcessor::process(const cpp2::CreateEdgeReq& req) {
     LOG(INFO) << "Create Edge  " << req.get_edge_name() << ", edgeType " << edgeType;
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     resp_.set_id(to(edgeType, EntryType::EDGE));
-    doPut(std::move(data));
+    doPut(std::move(data), req.get_space_id());
 }
 
 }  // namespace meta
@@ -45,7 +45,7 @@ void CreateTagProcessor::process(const cpp2::CreateTagReq& req) {
                       MetaServiceUtils::schemaTagVal(req.get_tag_name(), req.get_schema()));
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     resp_.set_id(to(tagId, EntryType::TAG));
-    doPut(std::move(data));
+    doPut(std::move(data), req.get_space_id());
 }
 
 }  // namespace meta
@@ -20,7 +20,7 @@ void DropEdgeProcessor::process(const cpp2::DropEdgeReq& req) {
     }
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     LOG(INFO) << "Drop Edge " << req.get_edge_name();
-    doMultiRemove(std::move(ret.value()));
+    doMultiRemove(std::move(ret.value()), req.get_space_id());
 }
 
 StatusOr<std::vector<std::string>> DropEdgeProcessor::getEdgeKeys(GraphSpaceID id,
@@ -21,7 +21,7 @@ void DropTagProcessor::process(const cpp2::DropTagReq& req) {
     }
     resp_.set_code(cpp2::ErrorCode::SUCCEEDED);
     LOG(INFO) << "Drop Tag " << req.get_tag_name();
-    doMultiRemove(std::move(ret.value()));
+    doMultiRemove(std::move(ret.value()), req.get_space_id());
 }
 
 StatusOr<std::vector<std::string>> DropTagProcessor::getTagKeys(GraphSpaceID id,
@@ -38,6 +38,33 @@ TEST(ActiveHostsManTest, NormalTest) {
     }
 }
 
+TEST(ActiveHostsManTest, PartStatsTest) {
+    auto now = time::WallClock::fastNowInSec();
+    ActiveHostsMan ahMan(1, 1);
+    for (auto i = 0; i < 2; i++) {
+        HostInfo info(now);
+        cpp2::PartStats stats;
+        stats.set_part_id(i + 1);
+        stats.set_disk_size(1024 * (i + 1));
+        stats.set_is_leader(i == 0);
+        info.partStats_[1].emplace_back(std::move(stats));
+        ahMan.updateHostInfo(HostAddr(0, i), info);
+    }
+    // The host without stats reported, e.g. the graph host
+    ahMan.updateHostInfo(HostAddr(0, 2), HostInfo(now));
+
+    auto stats = ahMan.getPartStats(1);
+    ASSERT_EQ(2, stats.size());
+    ASSERT_EQ(1, stats[HostAddr(0, 1)].size());
+    ASSERT_EQ(2, stats[HostAddr(0, 1)][0].get_part_id());
+    ASSERT_EQ(2048, stats[HostAddr(0, 1)][0].get_disk_size());
+    ASSERT_TRUE(ahMan.getPartStats(2).empty());
+
+    // The stats are replaced by the latest heartbeat
+    ahMan.updateHostInfo(HostAddr(0, 1), HostInfo(now + 1));
+    ASSERT_EQ(1, ahMan.getPartStats(1).size());
+}
+
 TEST(ActiveHostsManTest, MergeHostInfo) {
     fs::TempDir rootPath("/tmp/ActiveHostsMergeTest.XXXXXX");
     std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path()));
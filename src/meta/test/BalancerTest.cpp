@@ -13,6 +13,8 @@
 #include "meta/processors/partsMan/CreateSpaceProcessor.h"
 
 DECLARE_uint32(task_concurrency);
+DECLARE_uint32(task_concurrency_per_src_host);
+DECLARE_uint32(task_concurrency_per_dst_host);
 
 namespace nebula {
 namespace meta {
@@ -121,6 +123,58 @@ TEST(BalanceTaskTest, SimpleTest) {
     LOG(INFO) << "Test finished!";
 }
 
+TEST(BalanceTaskTest, ProgressTest) {
+    auto genStats = [] (int64_t srcSize, int64_t dstSize) {
+        std::unordered_map<HostAddr, std::vector<cpp2::PartStats>> stats;
+        cpp2::PartStats partStats;
+        partStats.set_part_id(1);
+        partStats.set_disk_size(srcSize);
+        stats[HostAddr(0, 0)].emplace_back(partStats);
+        partStats.set_disk_size(dstSize);
+        stats[HostAddr(1, 0)].emplace_back(std::move(partStats));
+        return stats;
+    };
+    BalanceTask task(0, 0, 1, HostAddr(0, 0), HostAddr(1, 0), nullptr, nullptr);
+    {
+        // Nothing copied before the learner is added
+        task.status_ = BalanceTask::Status::ADD_PART_ON_DST;
+        task.updateProgress(genStats(100, 10));
+        EXPECT_EQ(100, task.totalBytes_);
+        EXPECT_EQ(0, task.copiedBytes_);
+        EXPECT_EQ(-1, task.etaSecs());
+    }
+    {
+        task.status_ = BalanceTask::Status::CATCH_UP_DATA;
+        task.startTimeMs_ = time::WallClock::fastNowInMilliSec() - 10 * 1000;
+        task.updateProgress(genStats(100, 50));
+        EXPECT_EQ(50, task.copiedBytes_);
+        auto eta = task.etaSecs();
+        EXPECT_LE(9, eta);
+        EXPECT_GE(11, eta);
+    }
+    {
+        // The part has been removed from src, keep the last total
+        task.status_ = BalanceTask::Status::END;
+        task.updateProgress({});
+        EXPECT_EQ(100, task.totalBytes_);
+        EXPECT_EQ(100, task.copiedBytes_);
+        EXPECT_EQ(0, task.etaSecs());
+    }
+    {
+        // The progress is persisted along with the status
+        auto tup = BalanceTask::parseVal(task.taskVal());
+        EXPECT_EQ(BalanceTask::Status::END, std::get<0>(tup));
+        EXPECT_EQ(100, std::get<4>(tup));
+        EXPECT_EQ(100, std::get<5>(tup));
+        // The value persisted by the old version has no progress
+        auto oldVal = task.taskVal().substr(0, 18);
+        tup = BalanceTask::parseVal(oldVal);
+        EXPECT_EQ(BalanceTask::Status::END, std::get<0>(tup));
+        EXPECT_EQ(0, std::get<4>(tup));
+        EXPECT_EQ(0, std::get<5>(tup));
+    }
+}
+
 TEST(BalanceTest, BalancePartsTest) {
     auto* balancer = Balancer::instance(nullptr);
     auto dump = [](const std::unordered_map<HostAddr, std::vector<PartitionID>>& hostParts,
@@ -240,6 +294,125 @@ TEST(BalanceTest, BalancePartsTest) {
     }
 }
 
+TEST(BalanceTest, BalancePartsByLoadTest) {
+    auto* balancer = Balancer::instance(nullptr);
+    auto genLoads = [] () {
+        HostPartLoads loads;
+        loads[HostAddr(0, 0)][1] = PartLoad{0.3, 100};
+        loads[HostAddr(0, 0)][2] = PartLoad{0.3, 100};
+        loads[HostAddr(1, 0)][3] = PartLoad{0.1, 10};
+        loads[HostAddr(1, 0)][4] = PartLoad{0.1, 10};
+        loads[HostAddr(2, 0)][5] = PartLoad{0.1, 10};
+        loads[HostAddr(2, 0)][6] = PartLoad{0.1, 10};
+        return loads;
+    };
+    auto genHostParts = [] () {
+        std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
+        hostParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2});
+        hostParts.emplace(HostAddr(1, 0), std::vector<PartitionID>{3, 4});
+        hostParts.emplace(HostAddr(2, 0), std::vector<PartitionID>{5, 6});
+        return hostParts;
+    };
+    {
+        // The parts number is balanced, but the load is not
+        auto hostParts = genHostParts();
+        auto loads = genLoads();
+        int64_t budget = 1000;
+        std::vector<BalanceTask> tasks;
+        balancer->balancePartsByLoad(0, 0, hostParts, loads, budget, tasks);
+        EXPECT_EQ(2, tasks.size());
+        EXPECT_EQ(1000 - 100 - 10, budget);
+        std::vector<double> hostLoads;
+        for (auto& entry : hostParts) {
+            double hostLoad = 0;
+            for (auto partId : entry.second) {
+                hostLoad += loads[entry.first][partId].load_;
+            }
+            hostLoads.emplace_back(hostLoad);
+        }
+        auto minmax = std::minmax_element(hostLoads.begin(), hostLoads.end());
+        EXPECT_GE(0.1 + 1e-6, *minmax.second - *minmax.first);
+    }
+    {
+        // The heavy parts are too large to be moved within the budget
+        auto hostParts = genHostParts();
+        auto loads = genLoads();
+        int64_t budget = 50;
+        std::vector<BalanceTask> tasks;
+        balancer->balancePartsByLoad(0, 0, hostParts, loads, budget, tasks);
+        EXPECT_EQ(0, tasks.size());
+        EXPECT_EQ(50, budget);
+        EXPECT_EQ(2, hostParts[HostAddr(0, 0)].size());
+    }
+    {
+        // The part on the new host has no load reported yet
+        auto hostParts = genHostParts();
+        hostParts[HostAddr(2, 0)].emplace_back(1);
+        hostParts.emplace(HostAddr(3, 0), std::vector<PartitionID>{});
+        auto loads = genLoads();
+        int64_t budget = 1000;
+        std::vector<BalanceTask> tasks;
+        balancer->balancePartsByLoad(0, 0, hostParts, loads, budget, tasks);
+        EXPECT_FALSE(tasks.empty());
+        EXPECT_FALSE(hostParts[HostAddr(3, 0)].empty());
+        for (auto& entry : hostParts) {
+            std::unordered_set<PartitionID> parts(entry.second.begin(), entry.second.end());
+            EXPECT_EQ(parts.size(), entry.second.size());
+        }
+    }
+}
+
+TEST(BalanceTest, BalanceLeadersTest) {
+    auto* balancer = Balancer::instance(nullptr);
+    auto genHostParts = [] () {
+        std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
+        hostParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2, 3, 4, 5, 6});
+        hostParts.emplace(HostAddr(1, 0), std::vector<PartitionID>{1, 2, 3, 4, 5, 6});
+        hostParts.emplace(HostAddr(2, 0), std::vector<PartitionID>{1, 2, 3, 4, 5, 6});
+        return hostParts;
+    };
+    {
+        // All leaders are on the first host
+        auto hostParts = genHostParts();
+        std::unordered_map<HostAddr, std::vector<PartitionID>> leaderParts;
+        leaderParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2, 3, 4, 5, 6});
+        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>> trans;
+        balancer->balanceLeaders(hostParts, leaderParts, 100, trans);
+        EXPECT_EQ(4, trans.size());
+        for (auto& entry : hostParts) {
+            EXPECT_EQ(2, leaderParts[entry.first].size());
+        }
+    }
+    {
+        // Only one leader could be moved each round
+        auto hostParts = genHostParts();
+        std::unordered_map<HostAddr, std::vector<PartitionID>> leaderParts;
+        leaderParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2, 3, 4, 5, 6});
+        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>> trans;
+        balancer->balanceLeaders(hostParts, leaderParts, 1, trans);
+        EXPECT_EQ(1, trans.size());
+        EXPECT_EQ(5, leaderParts[HostAddr(0, 0)].size());
+    }
+    {
+        // The leader could only be moved to a host holding the part
+        std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
+        hostParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2, 3, 4});
+        hostParts.emplace(HostAddr(1, 0), std::vector<PartitionID>{1, 2});
+        hostParts.emplace(HostAddr(2, 0), std::vector<PartitionID>{3, 4});
+        std::unordered_map<HostAddr, std::vector<PartitionID>> leaderParts;
+        leaderParts.emplace(HostAddr(0, 0), std::vector<PartitionID>{1, 2, 3, 4});
+        std::vector<std::tuple<PartitionID, HostAddr, HostAddr>> trans;
+        balancer->balanceLeaders(hostParts, leaderParts, 100, trans);
+        EXPECT_EQ(2, trans.size());
+        EXPECT_EQ(2, leaderParts[HostAddr(0, 0)].size());
+        for (auto& t : trans) {
+            const auto& peerParts = hostParts[std::get<2>(t)];
+            EXPECT_NE(peerParts.end(),
+                      std::find(peerParts.begin(), peerParts.end(), std::get<0>(t)));
+        }
+    }
+}
+
 TEST(BalanceTest, DispatchTasksTest) {
     {
         FLAGS_task_concurrency = 10;
@@ -290,6 +463,54 @@ TEST(BalanceTest, DispatchTasksTest) {
     }
 }
 
+TEST(BalanceTest, HostConcurrencyTest) {
+    FLAGS_task_concurrency = 10;
+    FLAGS_task_concurrency_per_src_host = 2;
+    FLAGS_task_concurrency_per_dst_host = 1;
+    BalancePlan plan(0L, nullptr, nullptr);
+    std::vector<Status> sts(7, Status::OK());
+    std::unique_ptr<FaultInjector> injector(new TestFaultInjector(std::move(sts)));
+    auto client = std::make_unique<AdminClient>(std::move(injector));
+    // All parts are moved out of one host, into two hosts
+    for (int i = 0; i < 10; i++) {
+        BalanceTask task(0, 0, i, HostAddr(0, 0), HostAddr(i % 2 + 1, 0), nullptr, nullptr);
+        task.client_ = client.get();
+        plan.addTask(std::move(task));
+    }
+    folly::Baton<true, std::atomic> b;
+    plan.onFinished_ = [&plan, &b] () {
+        ASSERT_EQ(BalancePlan::Status::SUCCEEDED, plan.status_);
+        ASSERT_EQ(10, plan.finishedTaskNum_);
+        b.post();
+    };
+    {
+        std::lock_guard<std::mutex> lg(plan.lock_);
+        plan.dispatchTasks();
+        plan.runningBuckets_.assign(plan.buckets_.size(), false);
+        plan.startedTasks_.assign(plan.tasks_.size(), false);
+        auto picked = plan.pickTasks();
+        ASSERT_EQ(2, picked.size());
+        ASSERT_EQ(2, plan.srcTasks_[HostAddr(0, 0)]);
+        ASSERT_EQ(1, plan.dstTasks_[HostAddr(1, 0)]);
+        ASSERT_EQ(1, plan.dstTasks_[HostAddr(2, 0)]);
+        // Nothing more before any task finished
+        ASSERT_TRUE(plan.pickTasks().empty());
+        plan.buckets_.clear();
+        plan.srcTasks_.clear();
+        plan.dstTasks_.clear();
+    }
+    plan.invoke();
+    b.wait();
+    for (auto& entry : plan.srcTasks_) {
+        ASSERT_EQ(0, entry.second);
+    }
+    for (auto& entry : plan.dstTasks_) {
+        ASSERT_EQ(0, entry.second);
+    }
+    FLAGS_task_concurrency_per_src_host = 2;
+    FLAGS_task_concurrency_per_dst_host = 2;
+}
+
 TEST(BalanceTest, BalancePlanTest) {
     {
         LOG(INFO) << "Test with all tasks succeeded, only one bucket!";
@@ -418,6 +639,19 @@ TEST(BalanceTest, NormalTest) {
     auto balanceId = ret.value();
     sleep(1);
     LOG(INFO) << "Rebalance finished!";
+    {
+        auto showRet = balancer.show(balanceId);
+        ASSERT_TRUE(showRet.ok()) << showRet.status();
+        auto resp = std::move(showRet).value();
+        ASSERT_EQ("SUCCEEDED", resp.get_status());
+        ASSERT_EQ(6, resp.get_tasks().size());
+        for (auto& task : resp.get_tasks()) {
+            ASSERT_EQ("END", task.get_status());
+            ASSERT_EQ("SUCCEEDED", task.get_result());
+        }
+        ASSERT_EQ(0, resp.get_eta_secs());
+        ASSERT_FALSE(balancer.show(balanceId + 1).ok());
+    }
     {
         const auto& prefix = BalancePlan::prefix();
         std::unique_ptr<kvstore::KVIterator> iter;
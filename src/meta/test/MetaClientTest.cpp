@@ -393,6 +393,10 @@ public:
         partChanged++;
     }
 
+    void fetchPartStats(PartStatsMap& stats) override {
+        UNUSED(stats);
+    }
+
     HostAddr getLocalHost() {
         return HostAddr(0, 0);
     }
@@ -33,6 +33,7 @@
 #include "meta/processors/customKV/RemoveProcessor.h"
 #include "meta/processors/customKV/RemoveRangeProcessor.h"
 #include "meta/processors/customKV/ScanProcessor.h"
+#include "meta/processors/admin/GetMetaChangesProcessor.h"
 
 namespace nebula {
 namespace meta {
@@ -249,6 +250,9 @@ TEST(ProcessorTest, CreateSpaceTest) {
         for (auto it = hostsParts.begin(); it != hostsParts.end(); it++) {
             ASSERT_EQ(6, it->second.size());
         }
+        ASSERT_EQ("default_space", resp.properties.space_name);
+        ASSERT_EQ(8, resp.properties.partition_num);
+        ASSERT_EQ(3, resp.properties.replica_factor);
     }
     {
         cpp2::DropSpaceReq req;
@@ -1486,6 +1490,96 @@ TEST(ProcessorTest, AlterEdgeTest) {
     }
 }
 
+TEST(ProcessorTest, MetaChangesTest) {
+    fs::TempDir rootPath("/tmp/MetaChangesTest.XXXXXX");
+    auto kv = TestUtils::initKV(rootPath.path());
+    TestUtils::createSomeHosts(kv.get());
+
+    auto getChanges = [&kv] (int64_t since) {
+        cpp2::GetMetaChangesReq req;
+        req.set_since_version(since);
+        auto* processor = GetMetaChangesProcessor::instance(kv.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        return std::move(f).get();
+    };
+    int64_t version = 0;
+    {
+        // Nothing loaded yet
+        auto resp = getChanges(0);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, resp.code);
+        ASSERT_TRUE(resp.full_reload);
+        version = resp.version;
+    }
+    for (auto i = 0; i < 2; i++) {
+        cpp2::SpaceProperties properties;
+        properties.set_space_name(folly::stringPrintf("space_%d", i));
+        properties.set_partition_num(9);
+        properties.set_replica_factor(1);
+        cpp2::CreateSpaceReq req;
+        req.set_properties(std::move(properties));
+        auto* processor = CreateSpaceProcessor::instance(kv.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, resp.code);
+    }
+    {
+        auto resp = getChanges(0);
+        ASSERT_TRUE(resp.full_reload);
+        ASSERT_EQ(version + 2, resp.version);
+        version = resp.version;
+    }
+    {
+        // Unchanged
+        auto resp = getChanges(version);
+        ASSERT_FALSE(resp.full_reload);
+        ASSERT_EQ(version, resp.version);
+        ASSERT_TRUE(resp.spaces.empty());
+    }
+    {
+        // Unknown version
+        auto resp = getChanges(version + 1);
+        ASSERT_TRUE(resp.full_reload);
+    }
+    {
+        nebula::cpp2::Schema schema;
+        decltype(schema.columns) cols;
+        cols.emplace_back(TestUtils::columnDef(0, SupportedType::INT));
+        schema.set_columns(std::move(cols));
+        cpp2::CreateTagReq req;
+        req.set_space_id(2);
+        req.set_tag_name("tag_0");
+        req.set_schema(std::move(schema));
+        auto* processor = CreateTagProcessor::instance(kv.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, resp.code);
+    }
+    {
+        auto resp = getChanges(version);
+        ASSERT_FALSE(resp.full_reload);
+        ASSERT_EQ(version + 1, resp.version);
+        ASSERT_EQ(std::vector<GraphSpaceID>{2}, resp.spaces);
+    }
+    {
+        cpp2::DropSpaceReq req;
+        req.set_space_name("space_0");
+        auto* processor = DropSpaceProcessor::instance(kv.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, resp.code);
+    }
+    {
+        auto resp = getChanges(version);
+        ASSERT_FALSE(resp.full_reload);
+        ASSERT_EQ(version + 2, resp.version);
+        ASSERT_EQ((std::vector<GraphSpaceID>{2, 1}), resp.spaces);
+    }
+}
+
 }  // namespace meta
 }  // namespace nebula
 
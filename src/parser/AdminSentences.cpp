@@ -62,6 +62,9 @@ std::string SpaceOptItem::toString() const {
             return folly::stringPrintf("partition_num = %ld", boost::get<int64_t>(optValue_));
         case REPLICA_FACTOR:
             return folly::stringPrintf("replica_factor = %ld", boost::get<int64_t>(optValue_));
+        case SINGLE_VERSION:
+            return folly::stringPrintf("single_version = %s",
+                                       boost::get<bool>(optValue_) ? "true" : "false");
         default:
              FLOG_FATAL("Space parameter illegal");
     }
@@ -132,4 +135,18 @@ std::string ConfigSentence::toString() const {
     return "Unknown";
 }
 
+std::string BalanceSentence::toString() const {
+    switch (subType_) {
+        case SubType::kLeader:
+            return std::string("BALANCE LEADER");
+        case SubType::kData:
+            return std::string("BALANCE DATA");
+        case SubType::kShowBalancePlan:
+            return folly::stringPrintf("BALANCE DATA %ld", balanceId_);
+        default:
+            FLOG_FATAL("Type illegal");
+    }
+    return "Unknown";
+}
+
 }   // namespace nebula
@@ -125,10 +125,10 @@ private:
 
 class SpaceOptItem final {
 public:
-    using Value = boost::variant<int64_t, std::string>;
+    using Value = boost::variant<int64_t, std::string, bool>;
 
     enum OptionType : uint8_t {
-        PARTITION_NUM, REPLICA_FACTOR
+        PARTITION_NUM, REPLICA_FACTOR, SINGLE_VERSION
     };
 
     SpaceOptItem(OptionType op, std::string val) {
@@ -141,6 +141,11 @@ public:
         optValue_ = val;
     }
 
+    SpaceOptItem(OptionType op, bool val) {
+        optType_ = op;
+        optValue_ = val;
+    }
+
     int64_t asInt() {
         return boost::get<int64_t>(optValue_);
     }
@@ -157,6 +162,10 @@ public:
         return optValue_.which() == 1;
     }
 
+    bool isBool() {
+        return optValue_.which() == 2;
+    }
+
     int64_t get_partition_num() {
         if (isInt()) {
             return asInt();
@@ -175,6 +184,15 @@ public:
         }
     }
 
+    bool get_single_version() {
+        if (isBool()) {
+            return boost::get<bool>(optValue_);
+        } else {
+            LOG(ERROR) << "single_version value illegal.";
+            return false;
+        }
+    }
+
     OptionType getOptType() {
         return optType_;
     }
@@ -349,6 +367,42 @@ private:
     std::unique_ptr<ConfigRowItem>  configItem_;
 };
 
+class BalanceSentence final : public Sentence {
+public:
+    enum class SubType : uint32_t {
+        kUnknown,
+        kLeader,
+        kData,
+        kShowBalancePlan,
+    };
+
+    explicit BalanceSentence(SubType subType) {
+        kind_ = Kind::kBalance;
+        subType_ = std::move(subType);
+    }
+
+    // Show the status of the balance plan
+    explicit BalanceSentence(int64_t id) {
+        kind_ = Kind::kBalance;
+        subType_ = SubType::kShowBalancePlan;
+        balanceId_ = id;
+    }
+
+    std::string toString() const override;
+
+    SubType subType() const {
+        return subType_;
+    }
+
+    int64_t balanceId() const {
+        return balanceId_;
+    }
+
+private:
+    SubType                         subType_{SubType::kUnknown};
+    int64_t                         balanceId_{0};
+};
+
 }   // namespace nebula
 
 #endif  // PARSER_ADMINSENTENCES_H_
@@ -70,8 +70,10 @@ std::string OverClause::toString() const {
         buf += " AS ";
         buf += *alias_;
     }
-    if (isReversely_) {
+    if (isReversely()) {
         buf += " REVERSELY";
+    } else if (isBidirect()) {
+        buf += " BIDIRECT";
     }
     return buf;
 }
@@ -106,16 +106,31 @@ private:
 
 class OverClause final {
 public:
+    // Out-edges by default, in-edges with `REVERSELY', both with `BIDIRECT'
+    enum class Direction : uint8_t {
+        kOut,
+        kIn,
+        kBoth,
+    };
+
     explicit OverClause(std::string *edge,
                         std::string *alias = nullptr,
-                        bool isReversely = false) {
+                        Direction direction = Direction::kOut) {
         edge_.reset(edge);
         alias_.reset(alias);
-        isReversely_ = isReversely;
+        direction_ = direction;
+    }
+
+    Direction direction() const {
+        return direction_;
     }
 
     bool isReversely() const {
-        return isReversely_;
+        return direction_ == Direction::kIn;
+    }
+
+    bool isBidirect() const {
+        return direction_ == Direction::kBoth;
     }
 
     std::string* edge() const {
@@ -129,7 +144,7 @@ public:
     std::string toString() const;
 
 private:
-    bool                                        isReversely_{false};
+    Direction                                   direction_{Direction::kOut};
     std::unique_ptr<std::string>                edge_;
     std::unique_ptr<std::string>                alias_;
 };
@@ -17,6 +17,12 @@ std::string SchemaPropItem::toString() const {
         case TTL_COL:
             return folly::stringPrintf("ttl_col = %s",
                                        boost::get<std::string>(propValue_).c_str());
+        case INBOUND_PROPS:
+            return folly::stringPrintf("inbound_props = %s",
+                                       boost::get<bool>(propValue_) ? "true" : "false");
+        case INDEXES:
+            return folly::stringPrintf("indexes = \"%s\"",
+                                       boost::get<std::string>(propValue_).c_str());
         default:
             FLOG_FATAL("Schema property type illegal");
     }
@@ -81,7 +81,9 @@ public:
 
     enum PropType : uint8_t {
         TTL_DURATION,
-        TTL_COL
+        TTL_COL,
+        INBOUND_PROPS,
+        INDEXES,
     };
 
     SchemaPropItem(PropType op, int64_t val) {
@@ -117,6 +119,32 @@ public:
         }
     }
 
+    StatusOr<bool> getInboundProps() {
+        if (isBool()) {
+            return asBool();
+        } else {
+            LOG(ERROR) << "Inbound_props value illegal: " << propValue_;
+            return Status::Error("Inbound_props value illegal");
+        }
+    }
+
+    // The columns indexed, separated by commas
+    StatusOr<std::vector<std::string>> getIndexes() {
+        if (!isString()) {
+            LOG(ERROR) << "Indexes value illegal: " << propValue_;
+            return Status::Error("Indexes value illegal");
+        }
+        std::vector<std::string> indexes;
+        folly::split(",", asString(), indexes, true);
+        for (auto& index : indexes) {
+            index = folly::trimWhitespace(index).str();
+            if (index.empty()) {
+                return Status::Error("Indexes value illegal");
+            }
+        }
+        return indexes;
+    }
+
     PropType getPropType() {
         return propType_;
     }
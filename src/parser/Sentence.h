@@ -54,6 +54,7 @@ public:
         kIngest,
         kOrderBy,
         kConfig,
+        kBalance,
     };
 
     Kind kind() const {
@@ -144,6 +144,18 @@ public:
         op_ = op;
     }
 
+    Operator op() const {
+        return op_;
+    }
+
+    Sentence* left() const {
+        return left_.get();
+    }
+
+    Sentence* right() const {
+        return right_.get();
+    }
+
     std::string toString() const override;
 
 private:
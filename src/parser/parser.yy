@@ -89,17 +89,18 @@ class GraphScanner;
 /* keywords */
 %token KW_GO KW_AS KW_TO KW_OR KW_USE KW_SET KW_FROM KW_WHERE KW_ALTER
 %token KW_MATCH KW_INSERT KW_VALUES KW_YIELD KW_RETURN KW_CREATE KW_VERTEX
-%token KW_EDGE KW_EDGES KW_UPDATE KW_STEPS KW_OVER KW_UPTO KW_REVERSELY KW_SPACE KW_DELETE KW_FIND
+%token KW_EDGE KW_EDGES KW_UPDATE KW_STEPS KW_OVER KW_UPTO KW_REVERSELY KW_BIDIRECT KW_SPACE KW_DELETE KW_FIND
 %token KW_INT KW_BIGINT KW_DOUBLE KW_STRING KW_BOOL KW_TAG KW_TAGS KW_UNION KW_INTERSECT KW_MINUS
 %token KW_NO KW_OVERWRITE KW_IN KW_DESCRIBE KW_DESC KW_SHOW KW_HOSTS KW_TIMESTAMP KW_ADD
-%token KW_PARTITION_NUM KW_REPLICA_FACTOR KW_DROP KW_REMOVE KW_SPACES
+%token KW_PARTITION_NUM KW_REPLICA_FACTOR KW_SINGLE_VERSION KW_DROP KW_REMOVE KW_SPACES
 %token KW_IF KW_NOT KW_EXISTS KW_WITH KW_FIRSTNAME KW_LASTNAME KW_EMAIL KW_PHONE KW_USER KW_USERS
 %token KW_PASSWORD KW_CHANGE KW_ROLE KW_GOD KW_ADMIN KW_GUEST KW_GRANT KW_REVOKE KW_ON
 %token KW_ROLES KW_BY KW_DOWNLOAD KW_HDFS
 %token KW_VARIABLES KW_GET KW_DECLARE KW_GRAPH KW_META KW_STORAGE
-%token KW_TTL_DURATION KW_TTL_COL
+%token KW_TTL_DURATION KW_TTL_COL KW_INBOUND_PROPS KW_INDEXES
 %token KW_ORDER KW_ASC
 %token KW_DISTINCT
+%token KW_BALANCE KW_LEADER KW_DATA
 /* symbols */
 %token L_PAREN R_PAREN L_BRACKET R_BRACKET L_BRACE R_BRACE COMMA
 %token PIPE OR AND LT LE GT GE EQ NE PLUS MINUS MUL DIV MOD NOT NEG ASSIGN
@@ -187,6 +188,7 @@ class GraphScanner;
 %type <sentence> grant_sentence revoke_sentence
 %type <sentence> download_sentence
 %type <sentence> set_config_sentence get_config_sentence
+%type <sentence> balance_sentence
 %type <sentence> sentence
 %type <sentences> sentences
 
@@ -215,6 +217,9 @@ unreserved_keyword
      | KW_GOD                { $$ = new std::string("god"); }
      | KW_ADMIN              { $$ = new std::string("admin"); }
      | KW_GUEST              { $$ = new std::string("guest"); }
+     | KW_BALANCE            { $$ = new std::string("balance"); }
+     | KW_LEADER             { $$ = new std::string("leader"); }
+     | KW_DATA               { $$ = new std::string("data"); }
      ;
 
 primary_expression
@@ -501,13 +506,19 @@ over_clause
         $$ = new OverClause($2);
     }
     | KW_OVER name_label KW_REVERSELY {
-        $$ = new OverClause($2, nullptr, true);
+        $$ = new OverClause($2, nullptr, OverClause::Direction::kIn);
+    }
+    | KW_OVER name_label KW_BIDIRECT {
+        $$ = new OverClause($2, nullptr, OverClause::Direction::kBoth);
     }
     | KW_OVER name_label KW_AS name_label {
         $$ = new OverClause($2, $4);
     }
     | KW_OVER name_label KW_AS name_label KW_REVERSELY {
-        $$ = new OverClause($2, $4, true);
+        $$ = new OverClause($2, $4, OverClause::Direction::kIn);
+    }
+    | KW_OVER name_label KW_AS name_label KW_BIDIRECT {
+        $$ = new OverClause($2, $4, OverClause::Direction::kBoth);
     }
     ;
 
@@ -591,6 +602,13 @@ create_schema_prop_list
         $$ = new SchemaPropItem(SchemaPropItem::TTL_COL, *$3);
         delete $3;
     }
+    | KW_INBOUND_PROPS ASSIGN BOOL {
+        $$ = new SchemaPropItem(SchemaPropItem::INBOUND_PROPS, $3);
+    }
+    | KW_INDEXES ASSIGN STRING {
+        $$ = new SchemaPropItem(SchemaPropItem::INDEXES, *$3);
+        delete $3;
+    }
     ;
 
 create_tag_sentence
@@ -672,6 +690,13 @@ alter_schema_prop_item
         $$ = new SchemaPropItem(SchemaPropItem::TTL_COL, *$3);
         delete $3;
     }
+    | KW_INBOUND_PROPS ASSIGN BOOL {
+        $$ = new SchemaPropItem(SchemaPropItem::INBOUND_PROPS, $3);
+    }
+    | KW_INDEXES ASSIGN STRING {
+        $$ = new SchemaPropItem(SchemaPropItem::INDEXES, *$3);
+        delete $3;
+    }
     ;
 
 create_edge_sentence
@@ -1232,6 +1257,9 @@ space_opt_list
     | KW_REPLICA_FACTOR ASSIGN INTEGER {
         $$ = new SpaceOptItem(SpaceOptItem::REPLICA_FACTOR, $3);
     }
+    | KW_SINGLE_VERSION ASSIGN BOOL {
+        $$ = new SpaceOptItem(SpaceOptItem::SINGLE_VERSION, $3);
+    }
     // TODO(YT) Create Spaces for different engines
     // KW_ENGINE_TYPE ASSIGN name_label
     ;
@@ -1379,6 +1407,18 @@ mutate_sentence
     | download_sentence { $$ = $1; }
     ;
 
+balance_sentence
+    : KW_BALANCE KW_LEADER {
+        $$ = new BalanceSentence(BalanceSentence::SubType::kLeader);
+    }
+    | KW_BALANCE KW_DATA {
+        $$ = new BalanceSentence(BalanceSentence::SubType::kData);
+    }
+    | KW_BALANCE KW_DATA INTEGER {
+        $$ = new BalanceSentence($3);
+    }
+    ;
+
 maintain_sentence
     : create_tag_sentence { $$ = $1; }
     | create_edge_sentence { $$ = $1; }
@@ -1408,6 +1448,7 @@ maintain_sentence
     | revoke_sentence { $$ = $1; }
     | get_config_sentence { $$ = $1; }
     | set_config_sentence { $$ = $1; }
+    | balance_sentence { $$ = $1; }
     ;
 
 sentence
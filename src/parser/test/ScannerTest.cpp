@@ -207,6 +207,8 @@ TEST(Scanner, Basic) {
         CHECK_SEMANTIC_TYPE("upto", TokenType::KW_UPTO),
         CHECK_SEMANTIC_TYPE("REVERSELY", TokenType::KW_REVERSELY),
         CHECK_SEMANTIC_TYPE("reversely", TokenType::KW_REVERSELY),
+        CHECK_SEMANTIC_TYPE("BIDIRECT", TokenType::KW_BIDIRECT),
+        CHECK_SEMANTIC_TYPE("bidirect", TokenType::KW_BIDIRECT),
         CHECK_SEMANTIC_TYPE("SPACE", TokenType::KW_SPACE),
         CHECK_SEMANTIC_TYPE("space", TokenType::KW_SPACE),
         CHECK_SEMANTIC_TYPE("SPACES", TokenType::KW_SPACES),
@@ -256,6 +258,9 @@ TEST(Scanner, Basic) {
         CHECK_SEMANTIC_TYPE("REPLICA_FACTOR", TokenType::KW_REPLICA_FACTOR),
         CHECK_SEMANTIC_TYPE("replica_factor", TokenType::KW_REPLICA_FACTOR),
         CHECK_SEMANTIC_TYPE("Replica_factor", TokenType::KW_REPLICA_FACTOR),
+        CHECK_SEMANTIC_TYPE("SINGLE_VERSION", TokenType::KW_SINGLE_VERSION),
+        CHECK_SEMANTIC_TYPE("single_version", TokenType::KW_SINGLE_VERSION),
+        CHECK_SEMANTIC_TYPE("Single_version", TokenType::KW_SINGLE_VERSION),
         CHECK_SEMANTIC_TYPE("DROP", TokenType::KW_DROP),
         CHECK_SEMANTIC_TYPE("drop", TokenType::KW_DROP),
         CHECK_SEMANTIC_TYPE("Drop", TokenType::KW_DROP),
@@ -340,6 +345,10 @@ TEST(Scanner, Basic) {
         CHECK_SEMANTIC_TYPE("TTL_COL", TokenType::KW_TTL_COL),
         CHECK_SEMANTIC_TYPE("ttl_col", TokenType::KW_TTL_COL),
         CHECK_SEMANTIC_TYPE("Ttl_col", TokenType::KW_TTL_COL),
+        CHECK_SEMANTIC_TYPE("INBOUND_PROPS", TokenType::KW_INBOUND_PROPS),
+        CHECK_SEMANTIC_TYPE("inbound_props", TokenType::KW_INBOUND_PROPS),
+        CHECK_SEMANTIC_TYPE("INDEXES", TokenType::KW_INDEXES),
+        CHECK_SEMANTIC_TYPE("indexes", TokenType::KW_INDEXES),
         CHECK_SEMANTIC_TYPE("DOWNLOAD", TokenType::KW_DOWNLOAD),
         CHECK_SEMANTIC_TYPE("download", TokenType::KW_DOWNLOAD),
         CHECK_SEMANTIC_TYPE("Download", TokenType::KW_DOWNLOAD),
@@ -355,6 +364,15 @@ TEST(Scanner, Basic) {
         CHECK_SEMANTIC_TYPE("VARIABLES", TokenType::KW_VARIABLES),
         CHECK_SEMANTIC_TYPE("variables", TokenType::KW_VARIABLES),
         CHECK_SEMANTIC_TYPE("Variables", TokenType::KW_VARIABLES),
+        CHECK_SEMANTIC_TYPE("BALANCE", TokenType::KW_BALANCE),
+        CHECK_SEMANTIC_TYPE("balance", TokenType::KW_BALANCE),
+        CHECK_SEMANTIC_TYPE("Balance", TokenType::KW_BALANCE),
+        CHECK_SEMANTIC_TYPE("LEADER", TokenType::KW_LEADER),
+        CHECK_SEMANTIC_TYPE("leader", TokenType::KW_LEADER),
+        CHECK_SEMANTIC_TYPE("Leader", TokenType::KW_LEADER),
+        CHECK_SEMANTIC_TYPE("DATA", TokenType::KW_DATA),
+        CHECK_SEMANTIC_TYPE("data", TokenType::KW_DATA),
+        CHECK_SEMANTIC_TYPE("Data", TokenType::KW_DATA),
 
         CHECK_SEMANTIC_TYPE("_type", TokenType::TYPE_PROP),
         CHECK_SEMANTIC_TYPE("_id", TokenType::ID_PROP),
@@ -5,6 +5,7 @@
  */
 #include "storage/AddEdgesProcessor.h"
 #include "base/NebulaKeyUtils.h"
+#include "storage/CommonUtils.h"
 #include <algorithm>
 #include <limits>
 #include "time/WallClock.h"
@@ -18,17 +19,135 @@ void AddEdgesProcessor::process(const cpp2::AddEdgesRequest& req) {
         std::numeric_limits<int64_t>::max() - time::WallClock::fastNowInMicroSec();
     callingNum_ = req.parts.size();
     CHECK_NOTNULL(kvstore_);
+    auto singleVersionRet = schemaMan_->isSingleVersion(spaceId);
+    if (!singleVersionRet.ok()) {
+        LOG(ERROR) << "Can't find space " << spaceId << ", " << singleVersionRet.status();
+        for (auto& pe : req.parts) {
+            pushResultCode(cpp2::ErrorCode::E_SPACE_NOT_FOUND, pe.first);
+        }
+        onFinished();
+        return;
+    }
+    auto singleVersion = singleVersionRet.value();
+    // Whether the props are copied to the in-edges, by edge type. The in-edges
+    // of the edge types with ttl keep them too, to expire along with the out-edges.
+    std::unordered_map<EdgeType, bool> inboundProps;
+    auto keepProps = [&] (EdgeType edgeType) {
+        if (edgeType > 0) {
+            return true;
+        }
+        auto it = inboundProps.find(edgeType);
+        if (it == inboundProps.end()) {
+            auto schema = schemaMan_->getEdgeSchema(spaceId, -edgeType);
+            auto keep = CommonUtils::hasInboundProps(schema.get())
+                     || CommonUtils::hasTTL(schema.get());
+            it = inboundProps.emplace(edgeType, keep).first;
+        }
+        return it->second;
+    };
+    // The newest schemas and the props indexed, by edge type. Only the out-edges are indexed.
+    std::unordered_map<EdgeType, std::shared_ptr<const meta::SchemaProviderIf>> edgeSchemas;
+    auto schemaOf = [&] (EdgeType edgeType) -> const meta::SchemaProviderIf* {
+        auto it = edgeSchemas.find(edgeType);
+        if (it == edgeSchemas.end()) {
+            it = edgeSchemas.emplace(edgeType, schemaMan_->getEdgeSchema(spaceId, edgeType)).first;
+        }
+        return it->second.get();
+    };
+    std::unordered_map<EdgeType, std::vector<std::string>> edgeIndexes;
+    auto indexesOf = [&] (EdgeType edgeType) -> const std::vector<std::string>& {
+        auto it = edgeIndexes.find(edgeType);
+        if (it == edgeIndexes.end()) {
+            it = edgeIndexes.emplace(edgeType, CommonUtils::indexedProps(schemaOf(edgeType))).first;
+        }
+        return it->second;
+    };
+    auto prefixOf = [] (PartitionID partId, const cpp2::EdgeKey& edgeKey) {
+        return NebulaKeyUtils::prefix(partId, edgeKey.src, edgeKey.edge_type,
+                                      edgeKey.ranking, edgeKey.dst);
+    };
     std::for_each(req.parts.begin(), req.parts.end(), [&](auto& partEdges){
         auto partId = partEdges.first;
+        // An edge written more than once in the batch is only indexed by its
+        // last row, against the row written before the batch
+        std::unordered_map<std::string, const cpp2::Edge*> lastEdges;
+        for (auto& edge : partEdges.second) {
+            if (edge.key.edge_type > 0 && !indexesOf(edge.key.edge_type).empty()) {
+                lastEdges[prefixOf(partId, edge.key)] = &edge;
+            }
+        }
         std::vector<kvstore::KV> data;
+        std::vector<std::string> removed;
         std::for_each(partEdges.second.begin(), partEdges.second.end(), [&](auto& edge){
-            auto key = NebulaKeyUtils::edgeKey(partId, edge.key.src, edge.key.edge_type,
-                                               edge.key.ranking, edge.key.dst, version);
-            data.emplace_back(std::move(key), std::move(edge.get_props()));
+            auto key = singleVersion
+                ? NebulaKeyUtils::edgeKey(partId, edge.key.src, edge.key.edge_type,
+                                          edge.key.ranking, edge.key.dst)
+                : NebulaKeyUtils::edgeKey(partId, edge.key.src, edge.key.edge_type,
+                                          edge.key.ranking, edge.key.dst, version);
+            if (edge.key.edge_type > 0) {
+                const auto& indexes = indexesOf(edge.key.edge_type);
+                if (!indexes.empty() && lastEdges[prefixOf(partId, edge.key)] == &edge) {
+                    indexEdge(spaceId, partId, edge.key, edge.get_props(),
+                              schemaOf(edge.key.edge_type), indexes, data, removed);
+                }
+            }
+            // Unless the edge type has inbound_props or a ttl set, props are only
+            // kept on the out-edge, and the in-edge is a bare reverse index.
+            if (keepProps(edge.key.edge_type)) {
+                data.emplace_back(std::move(key), std::move(edge.get_props()));
+            } else {
+                data.emplace_back(std::move(key), "");
+            }
         });
-        doPut(spaceId, partId, std::move(data));
+        doPutAndRemove(spaceId, partId, std::move(data), std::move(removed));
     });
 }
 
+void AddEdgesProcessor::indexEdge(GraphSpaceID spaceId,
+                                  PartitionID partId,
+                                  const cpp2::EdgeKey& edgeKey,
+                                  const std::string& props,
+                                  const meta::SchemaProviderIf* schema,
+                                  const std::vector<std::string>& indexes,
+                                  std::vector<kvstore::KV>& data,
+                                  std::vector<std::string>& removed) {
+    auto reader = RowReader::getEdgePropReader(schemaMan_, props, spaceId, edgeKey.edge_type);
+    if (reader == nullptr) {
+        VLOG(3) << "Bad row of edge " << edgeKey.src << "->" << edgeKey.dst
+                << ", type " << edgeKey.edge_type << ", not indexed";
+        return;
+    }
+    // The newest row written before
+    std::unique_ptr<RowReader> oldReader;
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto prefix = NebulaKeyUtils::prefix(partId, edgeKey.src, edgeKey.edge_type,
+                                         edgeKey.ranking, edgeKey.dst);
+    if (kvstore_->prefix(spaceId, partId, prefix, &iter) == kvstore::ResultCode::SUCCEEDED
+            && iter && iter->valid()) {
+        oldReader = RowReader::getEdgePropReader(schemaMan_, iter->val(),
+                                                 spaceId, edgeKey.edge_type);
+    }
+    auto indexKeyValue = CommonUtils::indexKeyValue(schema, reader.get());
+    for (auto& prop : indexes) {
+        auto value = CommonUtils::indexValue(reader.get(), prop);
+        if (!value.ok()) {
+            VLOG(3) << "Edge type " << edgeKey.edge_type << ": " << value.status();
+            continue;
+        }
+        if (oldReader != nullptr) {
+            auto oldValue = CommonUtils::indexValue(oldReader.get(), prop);
+            if (oldValue.ok() && oldValue.value() != value.value()) {
+                removed.emplace_back(NebulaKeyUtils::edgeIndexKey(partId, edgeKey.edge_type, prop,
+                                                                  oldValue.value(), edgeKey.src,
+                                                                  edgeKey.ranking, edgeKey.dst));
+            }
+        }
+        data.emplace_back(NebulaKeyUtils::edgeIndexKey(partId, edgeKey.edge_type, prop,
+                                                       value.value(), edgeKey.src,
+                                                       edgeKey.ranking, edgeKey.dst),
+                          indexKeyValue);
+    }
+}
+
 }  // namespace storage
 }  // namespace nebula
@@ -24,6 +24,20 @@ public:
 private:
     explicit AddEdgesProcessor(kvstore::KVStore* kvstore, meta::SchemaManager* schemaMan)
             : BaseProcessor<cpp2::ExecResponse>(kvstore, schemaMan) {}
+
+    /**
+     * Append the index keys of the out-edge props to data, and the ones of the
+     * props written before to removed if they changed. The schema is the
+     * newest one of the edge type, which defines the ttl.
+     * */
+    void indexEdge(GraphSpaceID spaceId,
+                   PartitionID partId,
+                   const cpp2::EdgeKey& edgeKey,
+                   const std::string& props,
+                   const meta::SchemaProviderIf* schema,
+                   const std::vector<std::string>& indexes,
+                   std::vector<kvstore::KV>& data,
+                   std::vector<std::string>& removed);
 };
 
 }  // namespace storage
@@ -6,6 +6,7 @@
 
 #include "storage/AddVerticesProcessor.h"
 #include "base/NebulaKeyUtils.h"
+#include "storage/CommonUtils.h"
 #include <algorithm>
 #include <limits>
 #include "time/WallClock.h"
@@ -21,21 +22,109 @@ void AddVerticesProcessor::process(const cpp2::AddVerticesRequest& req) {
     auto spaceId = req.get_space_id();
     callingNum_ = partVertices.size();
     CHECK_NOTNULL(kvstore_);
+    auto singleVersionRet = schemaMan_->isSingleVersion(spaceId);
+    if (!singleVersionRet.ok()) {
+        LOG(ERROR) << "Can't find space " << spaceId << ", " << singleVersionRet.status();
+        for (auto& pv : partVertices) {
+            pushResultCode(cpp2::ErrorCode::E_SPACE_NOT_FOUND, pv.first);
+        }
+        onFinished();
+        return;
+    }
+    auto singleVersion = singleVersionRet.value();
+    // The newest schemas and the props indexed, by tag
+    std::unordered_map<TagID, std::shared_ptr<const meta::SchemaProviderIf>> tagSchemas;
+    auto schemaOf = [&] (TagID tagId) -> const meta::SchemaProviderIf* {
+        auto it = tagSchemas.find(tagId);
+        if (it == tagSchemas.end()) {
+            it = tagSchemas.emplace(tagId, schemaMan_->getTagSchema(spaceId, tagId)).first;
+        }
+        return it->second.get();
+    };
+    std::unordered_map<TagID, std::vector<std::string>> tagIndexes;
+    auto indexesOf = [&] (TagID tagId) -> const std::vector<std::string>& {
+        auto it = tagIndexes.find(tagId);
+        if (it == tagIndexes.end()) {
+            it = tagIndexes.emplace(tagId, CommonUtils::indexedProps(schemaOf(tagId))).first;
+        }
+        return it->second;
+    };
     std::for_each(partVertices.begin(), partVertices.end(), [&](auto& pv) {
         auto partId = pv.first;
         const auto& vertices = pv.second;
+        // The tag of a vertex written more than once in the batch is only indexed
+        // by its last row, against the row written before the batch
+        std::unordered_map<std::string, const cpp2::Tag*> lastTags;
+        for (auto& v : vertices) {
+            for (auto& tag : v.get_tags()) {
+                if (!indexesOf(tag.get_tag_id()).empty()) {
+                    lastTags[NebulaKeyUtils::prefix(partId, v.get_id(), tag.get_tag_id())] = &tag;
+                }
+            }
+        }
         std::vector<kvstore::KV> data;
+        std::vector<std::string> removed;
         std::for_each(vertices.begin(), vertices.end(), [&](auto& v){
             const auto& tags = v.get_tags();
             std::for_each(tags.begin(), tags.end(), [&](auto& tag) {
-                auto key = NebulaKeyUtils::vertexKey(partId, v.get_id(),
-                                                     tag.get_tag_id(), now);
+                auto key = singleVersion
+                    ? NebulaKeyUtils::vertexKey(partId, v.get_id(), tag.get_tag_id())
+                    : NebulaKeyUtils::vertexKey(partId, v.get_id(), tag.get_tag_id(), now);
+                // The index keys go along with the data in the same log
+                const auto& indexes = indexesOf(tag.get_tag_id());
+                if (!indexes.empty()
+                        && lastTags[NebulaKeyUtils::prefix(partId, v.get_id(),
+                                                           tag.get_tag_id())] == &tag) {
+                    indexVertex(spaceId, partId, v.get_id(), tag.get_tag_id(), tag.get_props(),
+                                schemaOf(tag.get_tag_id()), indexes, data, removed);
+                }
                 data.emplace_back(std::move(key), std::move(tag.get_props()));
             });
         });
-        doPut(spaceId, partId, std::move(data));
+        doPutAndRemove(spaceId, partId, std::move(data), std::move(removed));
     });
 }
 
+void AddVerticesProcessor::indexVertex(GraphSpaceID spaceId,
+                                       PartitionID partId,
+                                       VertexID vId,
+                                       TagID tagId,
+                                       const std::string& props,
+                                       const meta::SchemaProviderIf* schema,
+                                       const std::vector<std::string>& indexes,
+                                       std::vector<kvstore::KV>& data,
+                                       std::vector<std::string>& removed) {
+    auto reader = RowReader::getTagPropReader(schemaMan_, props, spaceId, tagId);
+    if (reader == nullptr) {
+        VLOG(3) << "Bad row of vId " << vId << ", tagId " << tagId << ", not indexed";
+        return;
+    }
+    // The newest row written before
+    std::unique_ptr<RowReader> oldReader;
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto prefix = NebulaKeyUtils::prefix(partId, vId, tagId);
+    auto ret = kvstore_->prefix(spaceId, partId, prefix, &iter, kvstore::ScanType::VERTEX);
+    if (ret == kvstore::ResultCode::SUCCEEDED && iter && iter->valid()) {
+        oldReader = RowReader::getTagPropReader(schemaMan_, iter->val(), spaceId, tagId);
+    }
+    auto indexKeyValue = CommonUtils::indexKeyValue(schema, reader.get());
+    for (auto& prop : indexes) {
+        auto value = CommonUtils::indexValue(reader.get(), prop);
+        if (!value.ok()) {
+            VLOG(3) << "vId " << vId << ", tagId " << tagId << ": " << value.status();
+            continue;
+        }
+        if (oldReader != nullptr) {
+            auto oldValue = CommonUtils::indexValue(oldReader.get(), prop);
+            if (oldValue.ok() && oldValue.value() != value.value()) {
+                removed.emplace_back(NebulaKeyUtils::vertexIndexKey(partId, tagId, prop,
+                                                                    oldValue.value(), vId));
+            }
+        }
+        data.emplace_back(NebulaKeyUtils::vertexIndexKey(partId, tagId, prop, value.value(), vId),
+                          indexKeyValue);
+    }
+}
+
 }  // namespace storage
 }  // namespace nebula
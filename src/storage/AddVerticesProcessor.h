@@ -25,6 +25,21 @@ public:
 private:
     explicit AddVerticesProcessor(kvstore::KVStore* kvstore, meta::SchemaManager* schemaMan)
             : BaseProcessor<cpp2::ExecResponse>(kvstore, schemaMan) {}
+
+    /**
+     * Append the index keys of the tag props to data, and the ones of the
+     * props written before to removed if they changed. The schema is the
+     * newest one of the tag, which defines the ttl.
+     * */
+    void indexVertex(GraphSpaceID spaceId,
+                     PartitionID partId,
+                     VertexID vId,
+                     TagID tagId,
+                     const std::string& props,
+                     const meta::SchemaProviderIf* schema,
+                     const std::vector<std::string>& indexes,
+                     std::vector<kvstore::KV>& data,
+                     std::vector<std::string>& removed);
 };
 
 
@@ -9,6 +9,8 @@
 
 #include "base/Base.h"
 #include "storage/BaseProcessor.h"
+#include "kvstore/NebulaStore.h"
+#include "kvstore/Part.h"
 
 namespace nebula {
 namespace storage {
@@ -20,12 +22,56 @@ public:
     }
 
     void process(const cpp2::TransLeaderReq& req) {
-        UNUSED(req);
+        auto spaceId = req.get_space_id();
+        auto partId = req.get_part_id();
+        auto partRet = kvstore_->part(spaceId, partId);
+        if (!ok(partRet)) {
+            LOG(ERROR) << "Space " << spaceId << ", part " << partId << " not found";
+            onFinished(to(error(partRet)));
+            return;
+        }
+        auto part = value(partRet);
+        // The new leader is given by its storage service address
+        auto& newLeader = req.get_new_leader();
+        auto target = kvstore::NebulaStore::getRaftAddr(HostAddr(newLeader.get_ip(),
+                                                                 newLeader.get_port()));
+        part->transferLeader(target).then([this, part] (raftex::cpp2::ErrorCode code) {
+            switch (code) {
+                case raftex::cpp2::ErrorCode::SUCCEEDED: {
+                    onFinished(cpp2::ErrorCode::SUCCEEDED);
+                    break;
+                }
+                case raftex::cpp2::ErrorCode::E_NOT_A_LEADER: {
+                    auto leader = kvstore::NebulaStore::getStoreAddr(part->leader());
+                    if (leader != HostAddr(0, 0)) {
+                        nebula::cpp2::HostAddr addr;
+                        addr.set_ip(leader.first);
+                        addr.set_port(leader.second);
+                        resp_.set_leader(std::move(addr));
+                    }
+                    onFinished(cpp2::ErrorCode::E_LEADER_CHANGED);
+                    break;
+                }
+                default: {
+                    LOG(ERROR) << "Failed to transfer the leader of part " << part->partitionId()
+                               << ", error " << static_cast<int32_t>(code);
+                    onFinished(cpp2::ErrorCode::E_UNKNOWN);
+                    break;
+                }
+            }
+        });
     }
 
 private:
     explicit TransLeaderProcessor(kvstore::KVStore* kvstore)
             : BaseProcessor<cpp2::AdminExecResp>(kvstore, nullptr) {}
+
+    // AdminExecResp carries the code itself, instead of the ResponseCommon
+    void onFinished(cpp2::ErrorCode code) {
+        resp_.set_code(code);
+        promise_.setValue(std::move(resp_));
+        delete this;
+    }
 };
 
 class AddPartProcessor : public BaseProcessor<cpp2::AdminExecResp> {
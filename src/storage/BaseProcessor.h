@@ -50,6 +50,14 @@ protected:
 
     void doPut(GraphSpaceID spaceId, PartitionID partId, std::vector<kvstore::KV> data);
 
+    /**
+     * Remove the keys and put the data in one log, e.g. the stale index keys of the data.
+     * */
+    void doPutAndRemove(GraphSpaceID spaceId,
+                        PartitionID partId,
+                        std::vector<kvstore::KV> data,
+                        std::vector<std::string> keys);
+
     nebula::cpp2::ColumnDef columnDef(std::string name, nebula::cpp2::SupportedType type) {
         nebula::cpp2::ColumnDef column;
         column.set_name(std::move(name));
@@ -70,6 +78,12 @@ protected:
         }
     }
 
+    /**
+     * Check whether the part could serve reads here, otherwise push the
+     * failure along with the leader to resend the request to.
+     * */
+    bool checkReadable(GraphSpaceID spaceId, PartitionID partId, int64_t maxStalenessMs);
+
 protected:
     kvstore::KVStore*       kvstore_ = nullptr;
     meta::SchemaManager*    schemaMan_ = nullptr;
@@ -16,6 +16,7 @@ cpp2::ErrorCode BaseProcessor<RESP>::to(kvstore::ResultCode code) {
     case kvstore::ResultCode::SUCCEEDED:
         return cpp2::ErrorCode::SUCCEEDED;
     case kvstore::ResultCode::ERR_LEADER_CHANGED:
+    case kvstore::ResultCode::ERR_LEADER_LEASE_EXPIRED:
         return cpp2::ErrorCode::E_LEADER_CHANGED;
     case kvstore::ResultCode::ERR_SPACE_NOT_FOUND:
         return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
@@ -27,14 +28,46 @@ cpp2::ErrorCode BaseProcessor<RESP>::to(kvstore::ResultCode code) {
 }
 
 
+template<typename RESP>
+bool BaseProcessor<RESP>::checkReadable(GraphSpaceID spaceId,
+                                        PartitionID partId,
+                                        int64_t maxStalenessMs) {
+    auto code = kvstore_->checkReadable(spaceId, partId, maxStalenessMs);
+    if (code == kvstore::ResultCode::SUCCEEDED) {
+        return true;
+    }
+    cpp2::ResultCode thriftRet;
+    thriftRet.set_code(to(code));
+    thriftRet.set_part_id(partId);
+    // The leader whose lease expired is left for the client to find out again
+    if (code == kvstore::ResultCode::ERR_LEADER_CHANGED) {
+        auto addrRet = kvstore_->partLeader(spaceId, partId);
+        if (ok(addrRet) && value(addrRet) != HostAddr(0, 0)) {
+            nebula::cpp2::HostAddr leader;
+            leader.set_ip(value(addrRet).first);
+            leader.set_port(value(addrRet).second);
+            thriftRet.set_leader(leader);
+        }
+    }
+    result_.failed_codes.emplace_back(std::move(thriftRet));
+    return false;
+}
+
+
 template<typename RESP>
 void BaseProcessor<RESP>::doPut(GraphSpaceID spaceId,
                                 PartitionID partId,
                                 std::vector<kvstore::KV> data) {
-    this->kvstore_->asyncMultiPut(spaceId,
-                                  partId,
-                                  std::move(data),
-                                  [spaceId, partId, this](kvstore::ResultCode code) {
+    doPutAndRemove(spaceId, partId, std::move(data), {});
+}
+
+
+template<typename RESP>
+void BaseProcessor<RESP>::doPutAndRemove(GraphSpaceID spaceId,
+                                         PartitionID partId,
+                                         std::vector<kvstore::KV> data,
+                                         std::vector<std::string> keys) {
+    auto cb = [spaceId, partId, this](kvstore::ResultCode code) {
         VLOG(3) << "partId:" << partId << ", code:" << static_cast<int32_t>(code);
 
         cpp2::ResultCode thriftResult;
@@ -64,7 +97,16 @@ void BaseProcessor<RESP>::doPut(GraphSpaceID spaceId,
         if (finished) {
             this->onFinished();
         }
-    });
+    };
+    if (keys.empty()) {
+        this->kvstore_->asyncMultiPut(spaceId, partId, std::move(data), std::move(cb));
+    } else {
+        this->kvstore_->asyncMultiPutAndRemove(spaceId,
+                                               partId,
+                                               std::move(data),
+                                               std::move(keys),
+                                               std::move(cb));
+    }
 }
 
 }  // namespace storage
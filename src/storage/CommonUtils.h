@@ -8,7 +8,11 @@
 #define STORAGE_COMMON_H_
 
 #include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
 #include "filter/Expressions.h"
+#include "filter/CompiledExpression.h"
+#include "dataman/RowReader.h"
+#include "time/WallClock.h"
 
 namespace nebula {
 namespace storage {
@@ -120,6 +124,287 @@ struct EdgeContext {
     std::vector<PropContext> props_;
 };
 
+// What one slot of the compiled filter reads
+struct FilterSlot {
+    // The props in key are read from the edge key
+    PropContext::PropInKeyType pikType_ = PropContext::PropInKeyType::NONE;
+    // The tag of a source prop, empty for the edge props
+    std::string tagName_;
+    std::string propName_;
+    nebula::cpp2::SupportedType type_ = nebula::cpp2::SupportedType::UNKNOWN;
+};
+
+/**
+ * Feeds the compiled filter with the props of one edge and its source vertex.
+ * The edge props are read by field index, which is looked up once per schema
+ * version rather than once per edge.
+ * */
+class EdgeFilterAccessor final : public CompiledExpression::PropAccessor {
+public:
+    explicit EdgeFilterAccessor(const std::vector<FilterSlot>* slots)
+        : slots_(slots) {}
+
+    void reset(RowReader* reader, folly::StringPiece key, FilterContext* fcontext) {
+        reader_ = reader;
+        key_ = key;
+        fcontext_ = fcontext;
+        if (reader_ == nullptr || reader_->getSchema() == schema_) {
+            return;
+        }
+        schema_ = reader_->getSchema();
+        indexes_.clear();
+        for (auto& slot : *slots_) {
+            bool onEdge = slot.pikType_ == PropContext::PropInKeyType::NONE
+                            && slot.tagName_.empty();
+            indexes_.emplace_back(onEdge ? schema_->getFieldIndex(slot.propName_) : -1);
+        }
+    }
+
+    int64_t getInt(int32_t slot) const override {
+        const auto& s = (*slots_)[slot];
+        switch (s.pikType_) {
+            case PropContext::PropInKeyType::SRC:
+                return NebulaKeyUtils::getSrcId(key_);
+            case PropContext::PropInKeyType::DST:
+                return NebulaKeyUtils::getDstId(key_);
+            case PropContext::PropInKeyType::TYPE:
+                return NebulaKeyUtils::getEdgeType(key_);
+            case PropContext::PropInKeyType::RANK:
+                return NebulaKeyUtils::getRank(key_);
+            case PropContext::PropInKeyType::NONE:
+                break;
+        }
+        if (!s.tagName_.empty()) {
+            return boost::get<int64_t>(tagProp(s));
+        }
+        int64_t v = 0;
+        ResultType ret;
+        switch (s.type_) {
+            case nebula::cpp2::SupportedType::VID:
+                ret = reader_->getVid(indexes_[slot], v);
+                break;
+            case nebula::cpp2::SupportedType::TIMESTAMP:
+                ret = reader_->getTimestamp(indexes_[slot], v);
+                break;
+            default:
+                ret = reader_->getInt(indexes_[slot], v);
+                break;
+        }
+        CHECK(ret == ResultType::SUCCEEDED) << "Bad value for prop " << s.propName_;
+        return v;
+    }
+
+    double getDouble(int32_t slot) const override {
+        const auto& s = (*slots_)[slot];
+        if (!s.tagName_.empty()) {
+            return boost::get<double>(tagProp(s));
+        }
+        double v = 0.0;
+        auto ret = reader_->getDouble(indexes_[slot], v);
+        CHECK(ret == ResultType::SUCCEEDED) << "Bad value for prop " << s.propName_;
+        return v;
+    }
+
+    bool getBool(int32_t slot) const override {
+        const auto& s = (*slots_)[slot];
+        if (!s.tagName_.empty()) {
+            return boost::get<bool>(tagProp(s));
+        }
+        bool v = false;
+        auto ret = reader_->getBool(indexes_[slot], v);
+        CHECK(ret == ResultType::SUCCEEDED) << "Bad value for prop " << s.propName_;
+        return v;
+    }
+
+    folly::StringPiece getString(int32_t slot) const override {
+        const auto& s = (*slots_)[slot];
+        if (!s.tagName_.empty()) {
+            return boost::get<std::string>(tagProp(s));
+        }
+        folly::StringPiece v;
+        auto ret = reader_->getString(indexes_[slot], v);
+        CHECK(ret == ResultType::SUCCEEDED) << "Bad value for prop " << s.propName_;
+        return v;
+    }
+
+private:
+    const VariantType& tagProp(const FilterSlot& slot) const {
+        auto it = fcontext_->tagFilters_.find(std::make_pair(slot.tagName_, slot.propName_));
+        CHECK(it != fcontext_->tagFilters_.end());
+        return it->second;
+    }
+
+private:
+    const std::vector<FilterSlot>* slots_;
+    RowReader* reader_ = nullptr;
+    folly::StringPiece key_;
+    FilterContext* fcontext_ = nullptr;
+    // The field indexes of the edge props in schema_, -1 for the others
+    const meta::SchemaProviderIf* schema_ = nullptr;
+    std::vector<int64_t> indexes_;
+};
+
+class CommonUtils final {
+public:
+    static StatusOr<CompiledExpression::Type> toCompiledType(nebula::cpp2::SupportedType type) {
+        switch (type) {
+            case nebula::cpp2::SupportedType::BOOL:
+                return CompiledExpression::kBool;
+            case nebula::cpp2::SupportedType::INT:
+            case nebula::cpp2::SupportedType::VID:
+            case nebula::cpp2::SupportedType::TIMESTAMP:
+                return CompiledExpression::kInt;
+            case nebula::cpp2::SupportedType::FLOAT:
+            case nebula::cpp2::SupportedType::DOUBLE:
+                return CompiledExpression::kDouble;
+            case nebula::cpp2::SupportedType::STRING:
+                return CompiledExpression::kString;
+            default:
+                return Status::Error("Unsupported type %d", static_cast<int32_t>(type));
+        }
+    }
+
+    /**
+     * Returns true if the edge keeps a copy of its props on the in-edges,
+     * otherwise the in-edges are bare reverse indexes of the out-edges.
+     * */
+    static bool hasInboundProps(const meta::SchemaProviderIf* schema) {
+        if (schema == nullptr) {
+            return false;
+        }
+        const auto schemaProp = schema->getProp();
+        return schemaProp.get_inbound_props() && *schemaProp.get_inbound_props();
+    }
+
+    /**
+     * The props indexed by the secondary indexes defined on the schema.
+     * */
+    static std::vector<std::string> indexedProps(const meta::SchemaProviderIf* schema) {
+        if (schema == nullptr) {
+            return {};
+        }
+        const auto schemaProp = schema->getProp();
+        if (!schemaProp.get_indexes()) {
+            return {};
+        }
+        return *schemaProp.get_indexes();
+    }
+
+    /**
+     * Read the prop of the row, encoded as the value of its index keys.
+     * */
+    static StatusOr<std::string> indexValue(RowReader* reader, const std::string& prop) {
+        auto& vType = reader->getSchema()->getFieldType(prop);
+        auto ret = ResultType::SUCCEEDED;
+        VariantType value;
+        switch (vType.type) {
+            case nebula::cpp2::SupportedType::BOOL: {
+                bool v = false;
+                ret = reader->getBool(prop, v);
+                value = v;
+                break;
+            }
+            case nebula::cpp2::SupportedType::INT:
+            case nebula::cpp2::SupportedType::TIMESTAMP: {
+                int64_t v = 0;
+                ret = reader->getInt(prop, v);
+                value = v;
+                break;
+            }
+            case nebula::cpp2::SupportedType::VID: {
+                VertexID v = 0;
+                ret = reader->getVid(prop, v);
+                value = v;
+                break;
+            }
+            case nebula::cpp2::SupportedType::FLOAT:
+            case nebula::cpp2::SupportedType::DOUBLE: {
+                double v = 0.0;
+                ret = reader->getDouble(prop, v);
+                value = v;
+                break;
+            }
+            case nebula::cpp2::SupportedType::STRING: {
+                folly::StringPiece v;
+                ret = reader->getString(prop, v);
+                value = v.toString();
+                break;
+            }
+            default:
+                return Status::Error("Unsupported index type %d", static_cast<int32_t>(vType.type));
+        }
+        if (ret != ResultType::SUCCEEDED) {
+            return Status::Error("Read prop `%s' failed", prop.c_str());
+        }
+        return NebulaKeyUtils::encodeIndexValue(value);
+    }
+
+    /**
+     * Returns true if the schema defines a ttl, i.e. the ttl_col and a positive ttl_duration.
+     * */
+    static bool hasTTL(const meta::SchemaProviderIf* schema) {
+        if (schema == nullptr) {
+            return false;
+        }
+        const auto schemaProp = schema->getProp();
+        return schemaProp.get_ttl_duration() && *schemaProp.get_ttl_duration() > 0
+            && schemaProp.get_ttl_col() && !schemaProp.get_ttl_col()->empty();
+    }
+
+    /**
+     * Returns true if the row has outlived the ttl defined on its schema,
+     * that is, the ttl_col value plus ttl_duration (both in seconds) is earlier
+     * than now. Rows whose schema has no ttl, or whose ttl_col could not be read,
+     * never expire.
+     * */
+    static bool checkDataExpiredForTTL(const meta::SchemaProviderIf* schema,
+                                       RowReader* reader) {
+        if (reader == nullptr || !hasTTL(schema)) {
+            return false;
+        }
+        const auto schemaProp = schema->getProp();
+        int64_t ttlDuration = *schemaProp.get_ttl_duration();
+        int64_t ttlValue = 0;
+        auto ret = reader->getInt(*schemaProp.get_ttl_col(), ttlValue);
+        if (ret != ResultType::SUCCEEDED) {
+            VLOG(3) << "Skip ttl check, bad value for ttl_col " << *schemaProp.get_ttl_col();
+            return false;
+        }
+        return ttlValue + ttlDuration < time::WallClock::fastNowInSec();
+    }
+
+    /**
+     * The value of the index keys of the row. It is the ttl_col value if the
+     * schema has a ttl, so the compaction drops the index keys once the row has
+     * expired, without reading the row. Otherwise it is empty.
+     * */
+    static std::string indexKeyValue(const meta::SchemaProviderIf* schema, RowReader* reader) {
+        if (reader == nullptr || !hasTTL(schema)) {
+            return "";
+        }
+        const auto schemaProp = schema->getProp();
+        int64_t ttlValue = 0;
+        if (reader->getInt(*schemaProp.get_ttl_col(), ttlValue) != ResultType::SUCCEEDED) {
+            return "";
+        }
+        return std::string(reinterpret_cast<const char*>(&ttlValue), sizeof(int64_t));
+    }
+
+    /**
+     * Returns true if the index key has outlived the ttl of its schema, by the
+     * ttl_col value kept as its value. The index keys written without it never expire.
+     * */
+    static bool checkIndexExpiredForTTL(const meta::SchemaProviderIf* schema,
+                                        folly::StringPiece val) {
+        if (val.size() != sizeof(int64_t) || !hasTTL(schema)) {
+            return false;
+        }
+        const auto schemaProp = schema->getProp();
+        auto ttlValue = NebulaKeyUtils::readInt<int64_t>(val.data(), val.size());
+        return ttlValue + *schemaProp.get_ttl_duration() < time::WallClock::fastNowInSec();
+    }
+};
+
 }  // namespace storage
 }  // namespace nebula
 #endif  // STORAGE_COMMON_H_
@@ -10,6 +10,7 @@
 #include "base/Base.h"
 #include "base/NebulaKeyUtils.h"
 #include "kvstore/CompactionFilter.h"
+#include "storage/CommonUtils.h"
 
 namespace nebula {
 namespace storage {
@@ -28,16 +29,18 @@ public:
             if (!schemaValid(spaceId, key)) {
                 return true;
             }
-            if (!ttlValid(spaceId, val)) {
-                VLOG(3) << "TTL invalid for key " << key;
+            // The newest version is recorded even if it has expired, so the older
+            // ones are dropped along with it rather than coming back.
+            if (!singleVersion(spaceId) && filterVersions(key)) {
+                VLOG(3) << "Extra versions has been filtered!";
                 return true;
             }
-            if (filterVersions(key)) {
-                VLOG(3) << "Extra versions has been filtered!";
+            if (!ttlValid(spaceId, key, val)) {
+                VLOG(3) << "TTL invalid for key " << key;
                 return true;
             }
         } else if (NebulaKeyUtils::isIndexKey(key)) {
-            if (!indexValid(key)) {
+            if (!indexValid(spaceId, key, val)) {
                 VLOG(3) << "Index invalid for the key " << key;
                 return true;
             }
@@ -70,9 +73,32 @@ public:
         return true;
     }
 
-    bool ttlValid(GraphSpaceID, const folly::StringPiece&) const {
-        // TODO(heng): Implement ttl filter after ttl schema pr merged in
-        return true;
+    bool ttlValid(GraphSpaceID spaceId,
+                  const folly::StringPiece& key,
+                  const folly::StringPiece& val) const {
+        if (val.empty()) {
+            return true;
+        }
+        std::shared_ptr<const meta::SchemaProviderIf> schema;
+        std::unique_ptr<RowReader> reader;
+        if (NebulaKeyUtils::isVertex(key)) {
+            auto tagId = NebulaKeyUtils::getTagId(key);
+            schema = schemaMan_->getTagSchema(spaceId, tagId);
+            if (!CommonUtils::hasTTL(schema.get())) {
+                return true;
+            }
+            reader = RowReader::getTagPropReader(schemaMan_, val, spaceId, tagId);
+        } else {
+            // In-edges carry the properties only if the edge type has inbound_props
+            // or a ttl, which are in the schema of the out-edges then.
+            auto edgeType = std::abs(NebulaKeyUtils::getEdgeType(key));
+            schema = schemaMan_->getEdgeSchema(spaceId, edgeType);
+            if (!CommonUtils::hasTTL(schema.get())) {
+                return true;
+            }
+            reader = RowReader::getEdgePropReader(schemaMan_, val, spaceId, edgeType);
+        }
+        return !CommonUtils::checkDataExpiredForTTL(schema.get(), reader.get());
     }
 
     bool filterVersions(const folly::StringPiece& key) const {
@@ -85,12 +111,62 @@ public:
         return false;
     }
 
-    bool indexValid(const folly::StringPiece&) const {
+    /**
+     * The index entries outlive the props they index, once the index or its
+     * schema is dropped. The entries of the rows with ttl carry the ttl_col value,
+     * so they are dropped once the rows expire. The other stale entries of live
+     * indexes are removed when overwritten, or by the scans running into them.
+     * */
+    bool indexValid(GraphSpaceID spaceId,
+                    const folly::StringPiece& key,
+                    const folly::StringPiece& val) const {
+        auto schemaId = NebulaKeyUtils::getIndexSchemaId(key);
+        std::shared_ptr<const meta::SchemaProviderIf> schema;
+        if (NebulaKeyUtils::isEdgeIndex(key)) {
+            auto ret = schemaMan_->getNewestEdgeSchemaVer(spaceId, schemaId);
+            if (ret.ok() && ret.value() == -1) {
+                VLOG(3) << "Space " << spaceId << ", EdgeType " << schemaId << " invalid";
+                return false;
+            }
+            schema = schemaMan_->getEdgeSchema(spaceId, schemaId);
+        } else {
+            auto ret = schemaMan_->getNewestTagSchemaVer(spaceId, schemaId);
+            if (ret.ok() && ret.value() == -1) {
+                VLOG(3) << "Space " << spaceId << ", Tag " << schemaId << " invalid";
+                return false;
+            }
+            schema = schemaMan_->getTagSchema(spaceId, schemaId);
+        }
+        if (schema == nullptr) {
+            // Unknown yet, keep it
+            return true;
+        }
+        auto indexes = CommonUtils::indexedProps(schema.get());
+        auto prop = NebulaKeyUtils::getIndexProp(key);
+        if (std::find(indexes.begin(), indexes.end(), prop) == indexes.end()) {
+            return false;
+        }
+        if (CommonUtils::checkIndexExpiredForTTL(schema.get(), val)) {
+            VLOG(3) << "Space " << spaceId << ", the row of the index key has expired";
+            return false;
+        }
         return true;
     }
 
+    bool singleVersion(GraphSpaceID spaceId) const {
+        // One filter instance only serves one space, so look it up once.
+        if (!singleVersionChecked_) {
+            auto ret = schemaMan_->isSingleVersion(spaceId);
+            singleVersion_ = ret.ok() && ret.value();
+            singleVersionChecked_ = true;
+        }
+        return singleVersion_;
+    }
+
 private:
     mutable std::string lastKeyWithNoVerison_;
+    mutable bool singleVersionChecked_ = false;
+    mutable bool singleVersion_ = false;
     meta::SchemaManager* schemaMan_ = nullptr;
 };
 
@@ -0,0 +1,174 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/IndexScanner.h"
+#include "base/NebulaKeyUtils.h"
+#include "dataman/RowReader.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+// static
+std::string IndexScanner::prefixSuccessor(std::string prefix) {
+    while (!prefix.empty()) {
+        auto& c = prefix.back();
+        if (static_cast<uint8_t>(c) != 0xFF) {
+            ++c;
+            return prefix;
+        }
+        prefix.pop_back();
+    }
+    // All 0xFF, no upper bound
+    return prefix;
+}
+
+// static
+std::pair<std::string, std::string> IndexScanner::range(PartitionID partId,
+                                                        const cpp2::LookUpIndexRequest& req) {
+    auto prefix = NebulaKeyUtils::indexPrefix(partId, req.get_is_edge(),
+                                              req.get_schema_id(), req.get_prop());
+    // The encoded values are not prefixes of each other, so all keys of one
+    // value share the prefix of P + value
+    std::string start;
+    if (req.__isset.lower) {
+        start = prefix + req.get_lower();
+        if (!req.get_include_lower()) {
+            start = prefixSuccessor(std::move(start));
+        }
+    } else {
+        start = prefix;
+    }
+    std::string end;
+    if (req.__isset.upper) {
+        end = prefix + req.get_upper();
+        if (req.get_include_upper()) {
+            end = prefixSuccessor(std::move(end));
+        }
+    } else {
+        end = prefixSuccessor(prefix);
+    }
+    return std::make_pair(std::move(start), std::move(end));
+}
+
+kvstore::ResultCode IndexScanner::scan(PartitionID partId, OnHit onHit) {
+    auto r = range(partId, req_);
+    if (r.first >= r.second) {
+        return kvstore::ResultCode::SUCCEEDED;
+    }
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kvstore_->range(req_.get_space_id(), partId, r.first, r.second, &iter);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return ret;
+    }
+    // The stale keys, each one guarded by the row it was checked against
+    std::vector<kvstore::GuardedKey> stale;
+    for (; iter->valid(); iter->next()) {
+        auto key = iter->key();
+        kvstore::GuardedKey guard;
+        auto valid = req_.get_is_edge() ? checkEdge(partId, key, guard)
+                                        : checkVertex(partId, key, guard);
+        if (valid) {
+            onHit(key);
+        } else {
+            VLOG(3) << "Skip the stale index key of part " << partId;
+            if (!guard.prefix.empty()) {
+                guard.key = key.str();
+                stale.emplace_back(std::move(guard));
+            }
+        }
+    }
+    if (!stale.empty()) {
+        removeStale(partId, std::move(stale));
+    }
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+bool IndexScanner::checkVertex(PartitionID partId,
+                               folly::StringPiece key,
+                               kvstore::GuardedKey& guard) {
+    auto spaceId = req_.get_space_id();
+    auto tagId = req_.get_schema_id();
+    auto vId = NebulaKeyUtils::getIndexVertexId(key);
+    auto prefix = NebulaKeyUtils::prefix(partId, vId, tagId);
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kvstore_->prefix(spaceId, partId, prefix, &iter, kvstore::ScanType::VERTEX);
+    if (ret != kvstore::ResultCode::SUCCEEDED || !iter) {
+        return false;
+    }
+    if (iter->valid()) {
+        auto reader = RowReader::getTagPropReader(schemaMan_, iter->val(), spaceId, tagId);
+        if (reader == nullptr) {
+            // Not sure the key is stale
+            return false;
+        }
+        auto schema = schemaMan_->getTagSchema(spaceId, tagId);
+        if (checkRow(key, reader.get(), schema.get())) {
+            return true;
+        }
+        guard.guard = std::make_pair(iter->key().str(), iter->val().str());
+    }
+    guard.prefix = std::move(prefix);
+    guard.type = kvstore::ScanType::VERTEX;
+    return false;
+}
+
+bool IndexScanner::checkEdge(PartitionID partId,
+                             folly::StringPiece key,
+                             kvstore::GuardedKey& guard) {
+    auto spaceId = req_.get_space_id();
+    auto edgeType = req_.get_schema_id();
+    auto prefix = NebulaKeyUtils::prefix(partId,
+                                         NebulaKeyUtils::getIndexSrcId(key),
+                                         edgeType,
+                                         NebulaKeyUtils::getIndexRank(key),
+                                         NebulaKeyUtils::getIndexDstId(key));
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kvstore_->prefix(spaceId, partId, prefix, &iter, kvstore::ScanType::EDGE);
+    if (ret != kvstore::ResultCode::SUCCEEDED || !iter) {
+        return false;
+    }
+    if (iter->valid()) {
+        auto reader = RowReader::getEdgePropReader(schemaMan_, iter->val(), spaceId, edgeType);
+        if (reader == nullptr) {
+            // Not sure the key is stale
+            return false;
+        }
+        auto schema = schemaMan_->getEdgeSchema(spaceId, edgeType);
+        if (checkRow(key, reader.get(), schema.get())) {
+            return true;
+        }
+        guard.guard = std::make_pair(iter->key().str(), iter->val().str());
+    }
+    guard.prefix = std::move(prefix);
+    guard.type = kvstore::ScanType::EDGE;
+    return false;
+}
+
+bool IndexScanner::checkRow(folly::StringPiece key,
+                            RowReader* reader,
+                            const meta::SchemaProviderIf* schema) {
+    if (CommonUtils::checkDataExpiredForTTL(schema, reader)) {
+        return false;
+    }
+    auto value = CommonUtils::indexValue(reader, req_.get_prop());
+    return value.ok() && value.value() == NebulaKeyUtils::getIndexValue(key);
+}
+
+void IndexScanner::removeStale(PartitionID partId, std::vector<kvstore::GuardedKey> stale) {
+    VLOG(1) << "Remove " << stale.size() << " stale index keys of part " << partId;
+    kvstore_->asyncGuardedRemove(
+        req_.get_space_id(), partId, std::move(stale),
+        [partId] (kvstore::ResultCode code) {
+            if (code != kvstore::ResultCode::SUCCEEDED) {
+                VLOG(1) << "Failed to remove the stale index keys of part " << partId
+                        << ", code " << static_cast<int32_t>(code);
+            }
+        });
+}
+
+}  // namespace storage
+}  // namespace nebula
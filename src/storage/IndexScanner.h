@@ -0,0 +1,72 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_INDEXSCANNER_H_
+#define STORAGE_INDEXSCANNER_H_
+
+#include "base/Base.h"
+#include "kvstore/KVStore.h"
+#include "meta/SchemaManager.h"
+#include "dataman/RowReader.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Scan the index keys of one part within the range of a LookUpIndexRequest.
+ *
+ * The index keys are only removed when the props are overwritten, so the keys
+ * of the expired rows, or left behind by concurrent overwrites, might be found.
+ * Each hit is checked against the newest row of its vertex or edge before reported.
+ * The stale ones are removed in the background, unless the row changes meanwhile.
+ * */
+class IndexScanner final {
+public:
+    using OnHit = std::function<void(folly::StringPiece key)>;
+
+    IndexScanner(kvstore::KVStore* kvstore,
+                 meta::SchemaManager* schemaMan,
+                 const cpp2::LookUpIndexRequest& req)
+        : kvstore_(kvstore)
+        , schemaMan_(schemaMan)
+        , req_(req) {}
+
+    kvstore::ResultCode scan(PartitionID partId, OnHit onHit);
+
+    /**
+     * The keys range [start, end) of the index on the part, given the bounds
+     * of the request.
+     * */
+    static std::pair<std::string, std::string> range(PartitionID partId,
+                                                     const cpp2::LookUpIndexRequest& req);
+
+    // The smallest string greater than all strings with the prefix
+    static std::string prefixSuccessor(std::string prefix);
+
+private:
+    /**
+     * Whether the index key matches the newest row of its vertex or edge. If it
+     * does not, the guard is set to the row, unless the row could not be read.
+     * */
+    bool checkVertex(PartitionID partId, folly::StringPiece key, kvstore::GuardedKey& guard);
+
+    bool checkEdge(PartitionID partId, folly::StringPiece key, kvstore::GuardedKey& guard);
+
+    // Whether the index key matches the row, which has not expired
+    bool checkRow(folly::StringPiece key, RowReader* reader, const meta::SchemaProviderIf* schema);
+
+    void removeStale(PartitionID partId, std::vector<kvstore::GuardedKey> stale);
+
+private:
+    kvstore::KVStore*                   kvstore_ = nullptr;
+    meta::SchemaManager*                schemaMan_ = nullptr;
+    const cpp2::LookUpIndexRequest&     req_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_INDEXSCANNER_H_
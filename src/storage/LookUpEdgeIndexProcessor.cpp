@@ -0,0 +1,61 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/LookUpEdgeIndexProcessor.h"
+#include "base/NebulaKeyUtils.h"
+#include "storage/CommonUtils.h"
+#include "storage/IndexScanner.h"
+
+namespace nebula {
+namespace storage {
+
+void LookUpEdgeIndexProcessor::process(const cpp2::LookUpIndexRequest& req) {
+    auto spaceId = req.get_space_id();
+    auto edgeType = req.get_schema_id();
+    auto schema = schemaMan_->getEdgeSchema(spaceId, edgeType);
+    auto indexes = CommonUtils::indexedProps(schema.get());
+    if (!req.get_is_edge()
+            || std::find(indexes.begin(), indexes.end(), req.get_prop()) == indexes.end()) {
+        LOG(ERROR) << "No index on the prop " << req.get_prop()
+                   << " of edge type " << edgeType;
+        for (auto& p : req.get_parts()) {
+            this->pushResultCode(cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND, p.first);
+        }
+        this->onFinished();
+        return;
+    }
+
+    cpp2::EdgePropRequest edgeReq;
+    edgeReq.set_space_id(spaceId);
+    edgeReq.set_edge_type(edgeType);
+    IndexScanner scanner(kvstore_, schemaMan_, req);
+    for (auto& p : req.get_parts()) {
+        auto partId = p.first;
+        if (!this->checkReadable(spaceId, partId, req.get_max_staleness_ms())) {
+            continue;
+        }
+        std::vector<cpp2::EdgeKey> edges;
+        auto ret = scanner.scan(partId, [&edges, edgeType] (folly::StringPiece key) {
+            cpp2::EdgeKey edgeKey;
+            edgeKey.set_src(NebulaKeyUtils::getIndexSrcId(key));
+            edgeKey.set_edge_type(edgeType);
+            edgeKey.set_ranking(NebulaKeyUtils::getIndexRank(key));
+            edgeKey.set_dst(NebulaKeyUtils::getIndexDstId(key));
+            edges.emplace_back(std::move(edgeKey));
+        });
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            this->pushResultCode(this->to(ret), partId);
+            continue;
+        }
+        edgeReq.parts.emplace(partId, std::move(edges));
+    }
+    edgeReq.set_return_columns(req.get_return_columns());
+    edgeReq.set_max_staleness_ms(req.get_max_staleness_ms());
+    QueryEdgePropsProcessor::process(edgeReq);
+}
+
+}  // namespace storage
+}  // namespace nebula
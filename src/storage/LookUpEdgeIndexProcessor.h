@@ -0,0 +1,36 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_LOOKUPEDGEINDEXPROCESSOR_H_
+#define STORAGE_LOOKUPEDGEINDEXPROCESSOR_H_
+
+#include "base/Base.h"
+#include "storage/QueryEdgePropsProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Find the out-edges by the index on an edge prop, and return their props
+ * the same way as getEdgeProps.
+ * */
+class LookUpEdgeIndexProcessor : public QueryEdgePropsProcessor {
+public:
+    static LookUpEdgeIndexProcessor* instance(kvstore::KVStore* kvstore,
+                                              meta::SchemaManager* schemaMan) {
+        return new LookUpEdgeIndexProcessor(kvstore, schemaMan);
+    }
+
+    void process(const cpp2::LookUpIndexRequest& req);
+
+private:
+    explicit LookUpEdgeIndexProcessor(kvstore::KVStore* kvstore, meta::SchemaManager* schemaMan)
+        : QueryEdgePropsProcessor(kvstore, schemaMan) {}
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_LOOKUPEDGEINDEXPROCESSOR_H_
@@ -0,0 +1,54 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/LookUpVertexIndexProcessor.h"
+#include "base/NebulaKeyUtils.h"
+#include "storage/CommonUtils.h"
+#include "storage/IndexScanner.h"
+
+namespace nebula {
+namespace storage {
+
+void LookUpVertexIndexProcessor::process(const cpp2::LookUpIndexRequest& req) {
+    auto spaceId = req.get_space_id();
+    auto schema = schemaMan_->getTagSchema(spaceId, req.get_schema_id());
+    auto indexes = CommonUtils::indexedProps(schema.get());
+    if (req.get_is_edge()
+            || std::find(indexes.begin(), indexes.end(), req.get_prop()) == indexes.end()) {
+        LOG(ERROR) << "No index on the prop " << req.get_prop()
+                   << " of tag " << req.get_schema_id();
+        for (auto& p : req.get_parts()) {
+            this->pushResultCode(cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND, p.first);
+        }
+        this->onFinished();
+        return;
+    }
+
+    cpp2::VertexPropRequest vertexReq;
+    vertexReq.set_space_id(spaceId);
+    IndexScanner scanner(kvstore_, schemaMan_, req);
+    for (auto& p : req.get_parts()) {
+        auto partId = p.first;
+        if (!this->checkReadable(spaceId, partId, req.get_max_staleness_ms())) {
+            continue;
+        }
+        std::vector<VertexID> vIds;
+        auto ret = scanner.scan(partId, [&vIds] (folly::StringPiece key) {
+            vIds.emplace_back(NebulaKeyUtils::getIndexVertexId(key));
+        });
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            this->pushResultCode(this->to(ret), partId);
+            continue;
+        }
+        vertexReq.parts.emplace(partId, std::move(vIds));
+    }
+    vertexReq.set_return_columns(req.get_return_columns());
+    vertexReq.set_max_staleness_ms(req.get_max_staleness_ms());
+    QueryVertexPropsProcessor::process(vertexReq);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,39 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_LOOKUPVERTEXINDEXPROCESSOR_H_
+#define STORAGE_LOOKUPVERTEXINDEXPROCESSOR_H_
+
+#include "base/Base.h"
+#include "storage/QueryVertexPropsProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Find the vertices by the index on a tag prop, and return their props
+ * the same way as getProps.
+ * */
+class LookUpVertexIndexProcessor : public QueryVertexPropsProcessor {
+public:
+    static LookUpVertexIndexProcessor* instance(kvstore::KVStore* kvstore,
+                                                meta::SchemaManager* schemaMan,
+                                                folly::Executor* executor) {
+        return new LookUpVertexIndexProcessor(kvstore, schemaMan, executor);
+    }
+
+    void process(const cpp2::LookUpIndexRequest& req);
+
+private:
+    explicit LookUpVertexIndexProcessor(kvstore::KVStore* kvstore,
+                                        meta::SchemaManager* schemaMan,
+                                        folly::Executor* executor)
+        : QueryVertexPropsProcessor(kvstore, schemaMan, executor) {}
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_LOOKUPVERTEXINDEXPROCESSOR_H_
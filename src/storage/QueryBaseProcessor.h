@@ -8,6 +8,7 @@
 #define STORAGE_QUERYBASEPROCESSOR_H_
 
 #include "base/Base.h"
+#include "base/Arena.h"
 #include "storage/BaseProcessor.h"
 #include "storage/Collector.h"
 #include "filter/Expressions.h"
@@ -39,6 +40,51 @@ struct Bucket {
 
 using OneVertexResp = std::tuple<PartitionID, VertexID, kvstore::ResultCode>;
 
+/**
+ * The state shared by the vertices of one bucket. The readers are bound to a
+ * tag or an edge once per request, and re-pointed at every row of it. The
+ * scratch buffers of the rows, e.g. the RowWriters, are taken from the arena,
+ * which is released in one shot once the bucket is done.
+ * */
+class BucketContext final {
+public:
+    BucketContext(meta::SchemaManager* schemaMan, GraphSpaceID space)
+        : schemaMan_(schemaMan), space_(space) {}
+
+    BoundRowReader* tagReader(TagID tagId) {
+        auto& reader = tags_[tagId];
+        if (reader == nullptr) {
+            reader = BoundRowReader::bindTag(schemaMan_, space_, tagId);
+        }
+        return reader.get();
+    }
+
+    BoundRowReader* edgeReader(EdgeType edgeType) {
+        auto& reader = edges_[edgeType];
+        if (reader == nullptr) {
+            reader = BoundRowReader::bindEdge(schemaMan_, space_, edgeType);
+        }
+        return reader.get();
+    }
+
+    Arena* arena() {
+        return &arena_;
+    }
+
+    // The buckets evaluate the compiled filter concurrently, each with its own registers
+    CompiledExpression::Registers* filterRegisters() {
+        return &filterRegs_;
+    }
+
+private:
+    meta::SchemaManager* schemaMan_;
+    GraphSpaceID space_;
+    std::unordered_map<TagID, std::unique_ptr<BoundRowReader>> tags_;
+    std::unordered_map<EdgeType, std::unique_ptr<BoundRowReader>> edges_;
+    Arena arena_;
+    CompiledExpression::Registers filterRegs_;
+};
+
 template<typename REQ, typename RESP>
 class QueryBaseProcessor : public BaseProcessor<RESP> {
 public:
@@ -73,7 +119,8 @@ protected:
                       Collector* collector);
 
     virtual kvstore::ResultCode processVertex(PartitionID partID,
-                                              VertexID vId) = 0;
+                                              VertexID vId,
+                                              BucketContext* bctx) = 0;
 
     virtual void onProcessFinished(int32_t retNum) = 0;
 
@@ -83,7 +130,8 @@ protected:
                             TagID tagId,
                             const std::vector<PropContext>& props,
                             FilterContext* fcontext,
-                            Collector* collector);
+                            Collector* collector,
+                            BucketContext* bctx);
     /**
      * Collect props for one vertex edge.
      * */
@@ -93,6 +141,17 @@ protected:
                                EdgeType edgeType,
                                const std::vector<PropContext>& props,
                                FilterContext* fcontext,
+                               EdgeProcessor proc,
+                               BucketContext* bctx);
+
+    /**
+     * Serve the edges from the partition's adjacency cache, returns false if
+     * the cache is not available.
+     * */
+    bool collectEdgesFromCache(PartitionID partId,
+                               VertexID vId,
+                               EdgeType edgeType,
+                               const std::vector<PropContext>& props,
                                EdgeProcessor proc);
 
     std::vector<Bucket> genBuckets(const cpp2::GetNeighborsRequest& req);
@@ -103,11 +162,39 @@ protected:
 
     bool checkExp(const Expression* exp);
 
+    /**
+     * Compile the filter against the newest schemas, so that each edge is
+     * filtered without building the getters. exp_ is still evaluated
+     * when the filter could not be compiled.
+     * */
+    void compileExp();
+
+    /**
+     * Whether the edges scanned carry props, i.e. the out-edges,
+     * or the in-edges of an edge type with inbound_props set.
+     * */
+    bool hasEdgeProps() const {
+        return type_ == BoundType::OUT_BOUND || inboundProps_;
+    }
+
+    // The schema of the in-edges is the one of the out-edges
+    EdgeType edgeSchemaType() const {
+        return std::abs(edgeContext_.edgeType_);
+    }
+
 protected:
     GraphSpaceID  spaceId_;
     BoundType     type_;
+    // Keys of the space carry no version, so no need to skip older versions.
+    bool          singleVersion_ = false;
+    // Only edge keys are needed, so the adjacency cache could serve the edges.
+    bool          keyPropsOnly_ = false;
+    // The in-edges scanned keep a copy of the props.
+    bool          inboundProps_ = false;
     std::unique_ptr<ExpressionContext> expCtx_;
     std::unique_ptr<Expression> exp_;
+    std::unique_ptr<CompiledExpression> compiledExp_;
+    std::vector<FilterSlot> filterSlots_;
     std::vector<TagContext> tagContexts_;
     EdgeContext edgeContext_;
     folly::Executor* executor_ = nullptr;
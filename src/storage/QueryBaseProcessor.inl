@@ -8,6 +8,7 @@
 #include <algorithm>
 #include "dataman/RowReader.h"
 #include "dataman/RowWriter.h"
+#include "kvstore/Part.h"
 
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
@@ -36,9 +37,19 @@ bool QueryBaseProcessor<REQ, RESP>::validOperation(nebula::cpp2::SupportedType v
 
 template<typename REQ, typename RESP>
 cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ& req) {
+    auto singleVersionRet = this->schemaMan_->isSingleVersion(spaceId_);
+    if (!singleVersionRet.ok()) {
+        VLOG(3) << "Can't find spaceId " << spaceId_;
+        return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    singleVersion_ = singleVersionRet.value();
     if (req.__isset.edge_type) {
         edgeContext_.edgeType_ = req.edge_type;
     }
+    if (type_ == BoundType::IN_BOUND) {
+        auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeSchemaType());
+        inboundProps_ = CommonUtils::hasInboundProps(schema.get());
+    }
     // Handle the case for query edges which should return some columns by default.
     int32_t index = edgeContext_.props_.size();
     std::unordered_map<TagID, int32_t> tagIndex;
@@ -82,10 +93,9 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ&
                 if (it != kPropsInKey_.end()) {
                     prop.pikType_ = it->second;
                     prop.type_.type = nebula::cpp2::SupportedType::INT;
-                } else if (type_ == BoundType::OUT_BOUND) {
-                    // Only outBound have properties on edge.
-                    auto schema = this->schemaMan_->getEdgeSchema(spaceId_,
-                                                                  edgeContext_.edgeType_);
+                } else if (hasEdgeProps()) {
+                    // Only outBound, or inBound with the props copied, have properties on edge.
+                    auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeSchemaType());
                     if (!schema) {
                         return cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
                     }
@@ -95,7 +105,7 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ&
                     }
                     prop.type_ = ftype;
                 } else {
-                    VLOG(3) << "InBound has none props, skip it!";
+                    VLOG(3) << "InBound has none props without inbound_props, skip it!";
                     break;
                 }
                 if (col.__isset.stat && !validOperation(prop.type_.type, col.stat)) {
@@ -131,10 +141,87 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ&
             LOG(FATAL) << "Unsupport get input prop " << prop;
             return false;
         };
+        compileExp();
+    }
+    keyPropsOnly_ = exp_ == nullptr;
+    for (auto& prop : edgeContext_.props_) {
+        if (prop.pikType_ == PropContext::PropInKeyType::NONE) {
+            keyPropsOnly_ = false;
+        }
+    }
+    if (keyPropsOnly_ && hasEdgeProps()) {
+        // Expired edges could only be told by their props.
+        auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeSchemaType());
+        if (schema != nullptr && CommonUtils::hasTTL(schema.get())) {
+            keyPropsOnly_ = false;
+        }
     }
     return cpp2::ErrorCode::SUCCEEDED;
 }
 
+template<typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::compileExp() {
+    auto resolver = [this] (const Expression* exp) -> StatusOr<CompiledExpression::Prop> {
+        FilterSlot slot;
+        switch (exp->kind()) {
+            case Expression::kEdgeRank:
+                slot.pikType_ = PropContext::PropInKeyType::RANK;
+                slot.type_ = nebula::cpp2::SupportedType::INT;
+                break;
+            case Expression::kEdgeDstId:
+                slot.pikType_ = PropContext::PropInKeyType::DST;
+                slot.type_ = nebula::cpp2::SupportedType::INT;
+                break;
+            case Expression::kEdgeSrcId:
+                slot.pikType_ = PropContext::PropInKeyType::SRC;
+                slot.type_ = nebula::cpp2::SupportedType::INT;
+                break;
+            case Expression::kEdgeProp: {
+                auto* edgeExp = static_cast<const EdgePropertyExpression*>(exp);
+                auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeSchemaType());
+                if (schema == nullptr) {
+                    return Status::Error("No schema for edge %d", edgeContext_.edgeType_);
+                }
+                slot.propName_ = edgeExp->prop();
+                slot.type_ = schema->getFieldType(slot.propName_).get_type();
+                break;
+            }
+            case Expression::kSourceProp: {
+                auto* sourceExp = static_cast<const SourcePropertyExpression*>(exp);
+                auto tagRet = this->schemaMan_->toTagID(spaceId_, sourceExp->tag());
+                if (!tagRet.ok()) {
+                    return tagRet.status();
+                }
+                auto schema = this->schemaMan_->getTagSchema(spaceId_, tagRet.value());
+                if (schema == nullptr) {
+                    return Status::Error("No schema for tag %s", sourceExp->tag().c_str());
+                }
+                slot.tagName_ = sourceExp->tag();
+                slot.propName_ = sourceExp->prop();
+                slot.type_ = schema->getFieldType(slot.propName_).get_type();
+                break;
+            }
+            default:
+                return Status::Error("Unsupported expression kind %d",
+                                     static_cast<int32_t>(exp->kind()));
+        }
+        auto type = CommonUtils::toCompiledType(slot.type_);
+        if (!type.ok()) {
+            return type.status();
+        }
+        filterSlots_.emplace_back(std::move(slot));
+        return CompiledExpression::Prop{static_cast<int32_t>(filterSlots_.size() - 1),
+                                        type.value()};
+    };
+    auto ret = CompiledExpression::compile(exp_.get(), std::move(resolver));
+    if (!ret.ok()) {
+        VLOG(1) << "Evaluate the filter without compiling: " << ret.status();
+        filterSlots_.clear();
+        return;
+    }
+    compiledExp_ = std::move(ret).value();
+}
+
 template<typename REQ, typename RESP>
 bool QueryBaseProcessor<REQ, RESP>::checkExp(const Expression* exp) {
     switch (exp->kind()) {
@@ -208,8 +295,9 @@ bool QueryBaseProcessor<REQ, RESP>::checkExp(const Expression* exp) {
             return true;
         }
         case Expression::kEdgeProp: {
-            if (type_ != BoundType::OUT_BOUND) {
-                VLOG(1) << "Only support filter on out bound props";
+            if (!hasEdgeProps()) {
+                VLOG(1) << "Only support filter on out bound props, "
+                        << "or the in bound ones with inbound_props";
                 return false;
             }
             if (edgeContext_.edgeType_ == -1) {
@@ -218,7 +306,7 @@ bool QueryBaseProcessor<REQ, RESP>::checkExp(const Expression* exp) {
             }
             auto* edgeExp = static_cast<const EdgePropertyExpression*>(exp);
             const auto& propName = edgeExp->prop();
-            auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeContext_.edgeType_);
+            auto schema = this->schemaMan_->getEdgeSchema(spaceId_, edgeSchemaType());
             if (!schema) {
                 VLOG(1) << "Cant find edgeType " << edgeContext_.edgeType_;
                 return false;
@@ -312,10 +400,12 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
                             TagID tagId,
                             const std::vector<PropContext>& props,
                             FilterContext* fcontext,
-                            Collector* collector) {
+                            Collector* collector,
+                            BucketContext* bctx) {
     auto prefix = NebulaKeyUtils::prefix(partId, vId, tagId);
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter,
+                                      kvstore::ScanType::VERTEX);
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         VLOG(3) << "Error! ret = " << static_cast<int32_t>(ret) << ", spaceId " << spaceId_;
         return ret;
@@ -323,8 +413,16 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
     // Will decode the properties according to the schema version
     // stored along with the properties
     if (iter && iter->valid()) {
-        auto reader = RowReader::getTagPropReader(this->schemaMan_, iter->val(), spaceId_, tagId);
-        this->collectProps(reader.get(), iter->key(), props, fcontext, collector);
+        auto* reader = bctx->tagReader(tagId);
+        if (!reader->reset(iter->val())) {
+            VLOG(3) << "Bad row of partId " << partId << ", vId " << vId << ", tagId " << tagId;
+            return ret;
+        }
+        if (CommonUtils::checkDataExpiredForTTL(reader->latestSchema(), reader)) {
+            VLOG(3) << "Expired partId " << partId << ", vId " << vId << ", tagId " << tagId;
+            return ret;
+        }
+        this->collectProps(reader, iter->key(), props, fcontext, collector);
     } else {
         VLOG(3) << "Missed partId " << partId << ", vId " << vId << ", tagId " << tagId;
     }
@@ -338,13 +436,24 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
                                                EdgeType edgeType,
                                                const std::vector<PropContext>& props,
                                                FilterContext* fcontext,
-                                               EdgeProcessor proc) {
+                                               EdgeProcessor proc,
+                                               BucketContext* bctx) {
+    // The props of the in-edges, if any, are in the schema of the out-edges
+    auto* edgeReader = bctx->edgeReader(std::abs(edgeType));
+    // The edges with ttl are read to tell the expired ones, even if no props are asked for
+    bool withTTL = edgeReader != nullptr && CommonUtils::hasTTL(edgeReader->latestSchema());
+    if (keyPropsOnly_ && !withTTL
+            && collectEdgesFromCache(partId, vId, edgeType, props, proc)) {
+        return kvstore::ResultCode::SUCCEEDED;
+    }
     auto prefix = NebulaKeyUtils::prefix(partId, vId, edgeType);
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter,
+                                      kvstore::ScanType::EDGE);
     if (ret != kvstore::ResultCode::SUCCEEDED || !iter) {
         return ret;
     }
+    EdgeFilterAccessor accessor(&filterSlots_);
     EdgeRanking lastRank  = -1;
     VertexID    lastDstId = 0;
     bool        firstLoop = true;
@@ -353,21 +462,43 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
         auto val = iter->val();
         auto rank = NebulaKeyUtils::getRank(key);
         auto dstId = NebulaKeyUtils::getDstId(key);
-        if (!firstLoop && rank == lastRank && lastDstId == dstId) {
-            VLOG(3) << "Only get the latest version for each edge.";
-            continue;
+        // Single-version spaces have exactly one key per edge, nothing to skip.
+        if (!singleVersion_) {
+            if (!firstLoop && rank == lastRank && lastDstId == dstId) {
+                VLOG(3) << "Only get the latest version for each edge.";
+                continue;
+            }
+            lastRank = rank;
+            lastDstId = dstId;
+            firstLoop = false;
         }
-        lastRank = rank;
-        lastDstId = dstId;
-        std::unique_ptr<RowReader> reader;
-        if (type_ == BoundType::OUT_BOUND && !val.empty()) {
-            reader = RowReader::getEdgePropReader(this->schemaMan_, val, spaceId_, edgeType);
-            if (exp_ != nullptr) {
+        RowReader* reader = nullptr;
+        if ((hasEdgeProps() || withTTL) && !val.empty()) {
+            if (!edgeReader->reset(val)) {
+                VLOG(3) << "Bad row of edge " << vId << "-> " << dstId << "@" << rank;
+                continue;
+            }
+            // The ttl is defined on the newest schema of the edge type.
+            if (CommonUtils::checkDataExpiredForTTL(edgeReader->latestSchema(), edgeReader)) {
+                VLOG(3) << "Expired edge " << vId << "-> " << dstId << "@" << rank;
+                continue;
+            }
+        }
+        if (hasEdgeProps() && !val.empty()) {
+            reader = edgeReader;
+            if (compiledExp_ != nullptr) {
+                accessor.reset(reader, key, fcontext);
+                if (!compiledExp_->test(accessor, bctx->filterRegisters())) {
+                    VLOG(1) << "Filter the edge "
+                            << vId << "-> " << dstId << "@" << rank << ":" << edgeType;
+                    continue;
+                }
+            } else if (exp_ != nullptr) {
                 // TODO(heng): We could remove the lock with one filter one bucket.
                 std::lock_guard<std::mutex> lg(this->lock_);
                 auto& getters = expCtx_->getters();
                 getters.getEdgeProp = [&] (const std::string &prop) -> VariantType {
-                    auto res = RowReader::getPropByName(reader.get(), prop);
+                    auto res = RowReader::getPropByName(reader, prop);
                     CHECK(ok(res));
                     return value(std::move(res));
                 };
@@ -390,14 +521,35 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
                 }
             }
         }
-        proc(reader.get(), key, props);
-        if (firstLoop) {
-            firstLoop = false;
-        }
+        proc(reader, key, props);
     }
     return ret;
 }
 
+template<typename REQ, typename RESP>
+bool QueryBaseProcessor<REQ, RESP>::collectEdgesFromCache(PartitionID partId,
+                                                          VertexID vId,
+                                                          EdgeType edgeType,
+                                                          const std::vector<PropContext>& props,
+                                                          EdgeProcessor proc) {
+    auto partRet = this->kvstore_->part(spaceId_, partId);
+    if (!ok(partRet)) {
+        return false;
+    }
+    auto* cache = value(partRet)->adjacencyCache();
+    std::vector<kvstore::AdjacencyCache::Edge> edges;
+    if (cache == nullptr || !cache->getEdges(vId, edgeType, &edges)) {
+        return false;
+    }
+    VLOG(3) << "Hit the adjacency cache, vertex " << vId << ", " << edges.size() << " edges";
+    for (auto& edge : edges) {
+        // Props in key are all the same whether the key has a version or not
+        auto key = NebulaKeyUtils::edgeKey(partId, vId, edgeType, edge.rank_, edge.dst_);
+        proc(nullptr, key, props);
+    }
+    return true;
+}
+
 template<typename REQ, typename RESP>
 folly::Future<std::vector<OneVertexResp>>
 QueryBaseProcessor<REQ, RESP>::asyncProcessBucket(Bucket bucket) {
@@ -406,10 +558,11 @@ QueryBaseProcessor<REQ, RESP>::asyncProcessBucket(Bucket bucket) {
     executor_->add([this, p = std::move(pro), b = std::move(bucket)] () mutable {
         std::vector<OneVertexResp> codes;
         codes.reserve(b.vertices_.size());
+        BucketContext bctx(this->schemaMan_, spaceId_);
         for (auto& pv : b.vertices_) {
             codes.emplace_back(pv.first,
                                pv.second,
-                               processVertex(pv.first, pv.second));
+                               processVertex(pv.first, pv.second, &bctx));
         }
         p.setValue(std::move(codes));
     });
@@ -470,8 +623,21 @@ void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req
         return;
     }
 
+    // Parts which could not serve the reads here are answered right away
+    const auto* readableReq = &req;
+    cpp2::GetNeighborsRequest readable;
+    for (auto& p : req.get_parts()) {
+        if (!this->checkReadable(spaceId_, p.first, req.get_max_staleness_ms())) {
+            if (readableReq == &req) {
+                readable = req;
+                readableReq = &readable;
+            }
+            readable.parts.erase(p.first);
+        }
+    }
+
     // const auto& filter = req.get_filter();
-    auto buckets = genBuckets(req);
+    auto buckets = genBuckets(*readableReq);
     std::vector<folly::Future<std::vector<OneVertexResp>>> results;
     for (auto& bucket : buckets) {
         results.emplace_back(asyncProcessBucket(std::move(bucket)));
@@ -6,6 +6,7 @@
 
 #include "storage/QueryBoundProcessor.h"
 #include <algorithm>
+#include <folly/lang/Bits.h>
 #include "time/Duration.h"
 #include "dataman/RowReader.h"
 #include "dataman/RowWriter.h"
@@ -14,17 +15,22 @@ namespace nebula {
 namespace storage {
 
 kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId,
-                                                       VertexID vId) {
+                                                       VertexID vId,
+                                                       BucketContext* bctx) {
+    if (dstIdsOnly_) {
+        return collectDstIds(partId, vId, bctx);
+    }
     FilterContext fcontext;
     cpp2::VertexData vResp;
     vResp.set_vertex_id(vId);
     if (!tagContexts_.empty()) {
-        RowWriter writer;
+        RowWriter writer(nullptr, bctx->arena());
         PropsCollector collector(&writer);
         for (auto& tc : tagContexts_) {
             VLOG(3) << "partId " << partId << ", vId " << vId
                     << ", tagId " << tc.tagId_ << ", prop size " << tc.props_.size();
-            auto ret = collectVertexProps(partId, vId, tc.tagId_, tc.props_, &fcontext, &collector);
+            auto ret = collectVertexProps(partId, vId, tc.tagId_, tc.props_,
+                                          &fcontext, &collector, bctx);
             if (ret != kvstore::ResultCode::SUCCEEDED) {
                 return ret;
             }
@@ -47,7 +53,7 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId,
                                     [&, this] (RowReader* reader,
                                                folly::StringPiece key,
                                                const std::vector<PropContext>& props) {
-                                        RowWriter writer(rsWriter.schema());
+                                        RowWriter writer(rsWriter.schema(), bctx->arena());
                                         PropsCollector collector(&writer);
                                         this->collectProps(reader,
                                                            key,
@@ -55,7 +61,8 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId,
                                                            &fcontext,
                                                            &collector);
                                         rsWriter.addRow(writer);
-                                    });
+                                    },
+                                    bctx);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
             return ret;
         }
@@ -70,7 +77,47 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId,
 }
 
 
+kvstore::ResultCode QueryBoundProcessor::collectDstIds(PartitionID partId,
+                                                       VertexID vId,
+                                                       BucketContext* bctx) {
+    std::vector<VertexID> dstIds;
+    FilterContext fcontext;
+    auto ret = collectEdgeProps(partId, vId,
+                                edgeContext_.edgeType_,
+                                edgeContext_.props_,
+                                &fcontext,
+                                [&dstIds] (RowReader*,
+                                           folly::StringPiece key,
+                                           const std::vector<PropContext>&) {
+                                    dstIds.emplace_back(NebulaKeyUtils::getDstId(key));
+                                },
+                                bctx);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        return ret;
+    }
+    if (!dstIds.empty()) {
+        std::lock_guard<std::mutex> lg(this->lock_);
+        dstIds_.insert(dstIds_.end(), dstIds.begin(), dstIds.end());
+    }
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+
 void QueryBoundProcessor::onProcessFinished(int32_t retNum) {
+    if (dstIdsOnly_) {
+        std::sort(dstIds_.begin(), dstIds_.end());
+        dstIds_.erase(std::unique(dstIds_.begin(), dstIds_.end()), dstIds_.end());
+        std::string packed;
+        packed.resize(dstIds_.size() * sizeof(VertexID));
+        auto* p = &packed[0];
+        for (auto id : dstIds_) {
+            id = folly::Endian::little(id);
+            memcpy(p, &id, sizeof(VertexID));
+            p += sizeof(VertexID);
+        }
+        resp_.set_dst_ids(std::move(packed));
+        return;
+    }
     resp_.set_vertices(std::move(vertices_));
     if (!this->tagContexts_.empty()) {
         nebula::cpp2::Schema respTag;
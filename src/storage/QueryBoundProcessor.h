@@ -27,6 +27,11 @@ public:
         return new QueryBoundProcessor(kvstore, schemaMan, executor, type);
     }
 
+    void process(const cpp2::GetNeighborsRequest& req) {
+        dstIdsOnly_ = req.get_dst_ids_only();
+        QueryBaseProcessor<cpp2::GetNeighborsRequest, cpp2::QueryResponse>::process(req);
+    }
+
 protected:
     explicit QueryBoundProcessor(kvstore::KVStore* kvstore,
                                  meta::SchemaManager* schemaMan,
@@ -36,12 +41,21 @@ protected:
                              cpp2::QueryResponse>(kvstore, schemaMan, executor, type) {}
 
     kvstore::ResultCode processVertex(PartitionID partID,
-                                      VertexID vId) override;
+                                      VertexID vId,
+                                      BucketContext* bctx) override;
 
     void onProcessFinished(int32_t retNum) override;
 
+private:
+    kvstore::ResultCode collectDstIds(PartitionID partId,
+                                      VertexID vId,
+                                      BucketContext* bctx);
+
 private:
     std::vector<cpp2::VertexData> vertices_;
+    // Only return the dst ids, packed into the response
+    bool dstIdsOnly_ = false;
+    std::vector<VertexID> dstIds_;
 
 protected:
     // Indicate the request only get vertex props.
@@ -25,12 +25,18 @@ kvstore::ResultCode QueryEdgePropsProcessor::collectEdgesProps(
     auto ret = kvstore_->prefix(spaceId_, partId, prefix, &iter);
     // Only use the latest version.
     if (iter && iter->valid()) {
-        RowWriter writer(rsWriter.schema());
-        PropsCollector collector(&writer);
         auto reader = RowReader::getEdgePropReader(schemaMan_,
                                                    iter->val(),
                                                    spaceId_,
                                                    edgeKey.edge_type);
+        auto schema = schemaMan_->getEdgeSchema(spaceId_, edgeKey.edge_type);
+        if (CommonUtils::checkDataExpiredForTTL(schema.get(), reader.get())) {
+            VLOG(3) << "Expired edge " << edgeKey.src << "-> " << edgeKey.dst
+                    << "@" << edgeKey.ranking;
+            return ret;
+        }
+        RowWriter writer(rsWriter.schema());
+        PropsCollector collector(&writer);
         this->collectProps(reader.get(), iter->key(), props, nullptr, &collector);
         rsWriter.addRow(writer);
 
@@ -62,7 +68,10 @@ void QueryEdgePropsProcessor::process(const cpp2::EdgePropRequest& req) {
     RowSetWriter rsWriter;
     std::for_each(req.get_parts().begin(), req.get_parts().end(), [&](auto& partE) {
         auto partId = partE.first;
-        kvstore::ResultCode ret;
+        if (!this->checkReadable(spaceId_, partId, req.get_max_staleness_ms())) {
+            return;
+        }
+        kvstore::ResultCode ret = kvstore::ResultCode::SUCCEEDED;
         for (auto& edgeKey : partE.second) {
             ret = this->collectEdgesProps(partId, edgeKey, this->edgeContext_.props_, rsWriter);
             if (ret != kvstore::ResultCode::SUCCEEDED) {
@@ -23,11 +23,12 @@ public:
     // It is one new method for QueryBaseProcessor.process.
     void process(const cpp2::EdgePropRequest& req);
 
-private:
+protected:
     explicit QueryEdgePropsProcessor(kvstore::KVStore* kvstore, meta::SchemaManager* schemaMan)
         : QueryBaseProcessor<cpp2::EdgePropRequest,
                              cpp2::EdgePropResponse>(kvstore, schemaMan) {}
 
+private:
     kvstore::ResultCode collectEdgesProps(PartitionID partId,
                                           const cpp2::EdgeKey& edgeKey,
                                           std::vector<PropContext>& props,
@@ -35,7 +36,7 @@ private:
 
     void addDefaultProps();
 
-    kvstore::ResultCode processVertex(PartitionID, VertexID) override {
+    kvstore::ResultCode processVertex(PartitionID, VertexID, BucketContext*) override {
         LOG(FATAL) << "Unimplement!";
         return kvstore::ResultCode::SUCCEEDED;
     }
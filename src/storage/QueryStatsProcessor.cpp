@@ -67,7 +67,8 @@ void QueryStatsProcessor::calcResult(std::vector<PropContext>&& props) {
 
 
 kvstore::ResultCode QueryStatsProcessor::processVertex(PartitionID partId,
-                                                       VertexID vId) {
+                                                       VertexID vId,
+                                                       BucketContext* bctx) {
     FilterContext fcontext;
     for (auto& tc : tagContexts_) {
         auto ret = this->collectVertexProps(partId,
@@ -75,7 +76,8 @@ kvstore::ResultCode QueryStatsProcessor::processVertex(PartitionID partId,
                                             tc.tagId_,
                                             tc.props_,
                                             &fcontext,
-                                            &collector_);
+                                            &collector_,
+                                            bctx);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
             return ret;
         }
@@ -95,7 +97,8 @@ kvstore::ResultCode QueryStatsProcessor::processVertex(PartitionID partId,
                                                               props,
                                                               &fcontext,
                                                               &collector_);
-                                       });
+                                       },
+                                       bctx);
     }
     return kvstore::ResultCode::SUCCEEDED;
 }
@@ -32,7 +32,8 @@ private:
                              cpp2::QueryStatsResponse>(kvstore, schemaMan, executor, type) {}
 
     kvstore::ResultCode processVertex(PartitionID partID,
-                                      VertexID vId) override;
+                                      VertexID vId,
+                                      BucketContext* bctx) override;
 
     void onProcessFinished(int32_t retNum) override;
 
@@ -23,6 +23,7 @@ void QueryVertexPropsProcessor::process(const cpp2::VertexPropRequest& vertexReq
         tmpColumns.emplace_back(std::move(col));
     }
     req.set_return_columns(std::move(tmpColumns));
+    req.set_max_staleness_ms(vertexReq.get_max_staleness_ms());
     this->onlyVertexProps_ = true;
     QueryBoundProcessor::process(req);
 }
@@ -23,7 +23,7 @@ public:
 
     void process(const cpp2::VertexPropRequest& req);
 
-private:
+protected:
     explicit QueryVertexPropsProcessor(kvstore::KVStore* kvstore,
                                        meta::SchemaManager* schemaMan,
                                        folly::Executor* executor)
@@ -11,6 +11,8 @@
 #include "storage/QueryBoundProcessor.h"
 #include "storage/QueryVertexPropsProcessor.h"
 #include "storage/QueryEdgePropsProcessor.h"
+#include "storage/LookUpVertexIndexProcessor.h"
+#include "storage/LookUpEdgeIndexProcessor.h"
 #include "storage/QueryStatsProcessor.h"
 #include "storage/AdminProcessor.h"
 
@@ -66,6 +68,20 @@ StorageServiceHandler::future_getEdgeProps(const cpp2::EdgePropRequest& req) {
     RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::QueryResponse>
+StorageServiceHandler::future_lookUpVertexIndex(const cpp2::LookUpIndexRequest& req) {
+    auto* processor = LookUpVertexIndexProcessor::instance(kvstore_,
+                                                           schemaMan_,
+                                                           getThreadManager());
+    RETURN_FUTURE(processor);
+}
+
+folly::Future<cpp2::EdgePropResponse>
+StorageServiceHandler::future_lookUpEdgeIndex(const cpp2::LookUpIndexRequest& req) {
+    auto* processor = LookUpEdgeIndexProcessor::instance(kvstore_, schemaMan_);
+    RETURN_FUTURE(processor);
+}
+
 folly::Future<cpp2::ExecResponse>
 StorageServiceHandler::future_addVertices(const cpp2::AddVerticesRequest& req) {
     auto* processor = AddVerticesProcessor::instance(kvstore_, schemaMan_);
@@ -43,6 +43,12 @@ public:
     folly::Future<cpp2::EdgePropResponse>
     future_getEdgeProps(const cpp2::EdgePropRequest& req) override;
 
+    folly::Future<cpp2::QueryResponse>
+    future_lookUpVertexIndex(const cpp2::LookUpIndexRequest& req) override;
+
+    folly::Future<cpp2::EdgePropResponse>
+    future_lookUpEdgeIndex(const cpp2::LookUpIndexRequest& req) override;
+
     folly::Future<cpp2::ExecResponse>
     future_addVertices(const cpp2::AddVerticesRequest& req) override;
 
@@ -6,6 +6,26 @@
 
 #include "base/Base.h"
 #include "storage/client/StorageClient.h"
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+DEFINE_int32(storage_client_timeout_ms, 60 * 1000,
+             "Deadline of a request to the storage service, no more retries after it");
+DEFINE_int32(storage_client_retry_times, 3,
+             "Times to resend the parts whose leader changed or whose rpc failed");
+DEFINE_int32(storage_client_retry_interval_ms, 500,
+             "Interval to resend the parts whose leader is unknown, "
+             "e.g. while electing the new one");
+DEFINE_int32(storage_client_hedge_delay_ms, 0,
+             "Resend the read requests not answered in time to other replicas, "
+             "about the p95 latency of the requests is a good choice, 0 to disable");
+DEFINE_int32(storage_client_max_staleness_ms, 0,
+             "Reads are spread across the replicas, and served by the followers lagging "
+             "behind their leaders no longer than this. 0 to read from the leaders only");
+
+DEFINE_int32(storage_client_frontier_threads, 4,
+             "Threads to partition and dedup the large frontiers of the traversals");
+DEFINE_int32(storage_client_frontier_parallel_min, 100000,
+             "The frontiers smaller than this are partitioned on the calling thread");
 
 #define ID_HASH(id, numShards) \
     ((static_cast<uint64_t>(id)) % numShards + 1)
@@ -101,11 +121,170 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
         folly::EventBase* evb) {
     auto clusters = clusterIdsToHosts(
         space,
-        vertices,
+        std::move(vertices),
         [] (const VertexID& v) {
             return v;
-        });
+        },
+        FLAGS_storage_client_max_staleness_ms > 0);
+    return sendGetNeighbors(space, std::move(clusters), edgeType, isOutBound,
+                            std::move(filter), std::move(returnCols), false, evb);
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNeighbors(
+        GraphSpaceID space,
+        PartIds vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<cpp2::PropDef> returnCols,
+        folly::EventBase* evb) {
+    auto clusters = clusterPartsToHosts(space,
+                                        std::move(vertices),
+                                        FLAGS_storage_client_max_staleness_ms > 0);
+    return sendGetNeighbors(space, std::move(clusters), edgeType, isOutBound,
+                            std::move(filter), std::move(returnCols), false, evb);
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getDstIds(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        folly::EventBase* evb) {
+    std::vector<cpp2::PropDef> returnCols;
+    cpp2::PropDef pd;
+    pd.owner = cpp2::PropOwner::EDGE;
+    pd.name = "_dst";
+    returnCols.emplace_back(std::move(pd));
+    auto clusters = clusterIdsToHosts(
+        space,
+        std::move(vertices),
+        [] (const VertexID& v) {
+            return v;
+        },
+        FLAGS_storage_client_max_staleness_ms > 0);
+    return sendGetNeighbors(space, std::move(clusters), edgeType, isOutBound,
+                            "", std::move(returnCols), true, evb);
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getDstIds(
+        GraphSpaceID space,
+        PartIds vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        folly::EventBase* evb) {
+    std::vector<cpp2::PropDef> returnCols;
+    cpp2::PropDef pd;
+    pd.owner = cpp2::PropOwner::EDGE;
+    pd.name = "_dst";
+    returnCols.emplace_back(std::move(pd));
+    auto clusters = clusterPartsToHosts(space,
+                                        std::move(vertices),
+                                        FLAGS_storage_client_max_staleness_ms > 0);
+    return sendGetNeighbors(space, std::move(clusters), edgeType, isOutBound,
+                            "", std::move(returnCols), true, evb);
+}
+
+
+StorageClient::PartIds StorageClient::partitionIds(GraphSpaceID space,
+                                                   std::vector<VertexID> ids) const {
+    PartIds result;
+    if (ids.empty()) {
+        return result;
+    }
+    auto numParts = partsNum(space);
+    CHECK_GT(numParts, 0);
+    bool parallel = FLAGS_storage_client_frontier_threads > 1
+        && ids.size() >= static_cast<size_t>(FLAGS_storage_client_frontier_parallel_min);
+    size_t numSlices = parallel ? FLAGS_storage_client_frontier_threads : 1;
+    size_t sliceSize = (ids.size() + numSlices - 1) / numSlices;
+
+    // buckets[s][p] holds the ids of slice s which belong to partition p + 1
+    std::vector<std::vector<std::vector<VertexID>>> buckets(numSlices);
+    forEachSlice(numSlices, [&] (size_t s) {
+        auto begin = std::min(ids.size(), s * sliceSize);
+        auto end = std::min(ids.size(), begin + sliceSize);
+        auto& slice = buckets[s];
+        slice.resize(numParts);
+        for (auto& bucket : slice) {
+            bucket.reserve((end - begin) / numParts + 1);
+        }
+        for (auto i = begin; i < end; i++) {
+            slice[ID_HASH(ids[i], numParts) - 1].emplace_back(ids[i]);
+        }
+    }, parallel);
+
+    std::vector<std::vector<VertexID>> parts(numParts);
+    forEachSlice(numParts, [&] (size_t p) {
+        auto& part = parts[p];
+        if (numSlices == 1) {
+            part = std::move(buckets[0][p]);
+        } else {
+            size_t total = 0;
+            for (auto& slice : buckets) {
+                total += slice[p].size();
+            }
+            part.reserve(total);
+            for (auto& slice : buckets) {
+                part.insert(part.end(), slice[p].begin(), slice[p].end());
+                std::vector<VertexID>().swap(slice[p]);
+            }
+        }
+        std::sort(part.begin(), part.end());
+        part.erase(std::unique(part.begin(), part.end()), part.end());
+    }, parallel);
+
+    for (size_t p = 0; p < parts.size(); p++) {
+        if (!parts[p].empty()) {
+            result.emplace(p + 1, std::move(parts[p]));
+        }
+    }
+    return result;
+}
 
+
+void StorageClient::forEachSlice(size_t num,
+                                 const std::function<void(size_t)>& fn,
+                                 bool parallel) const {
+    if (!parallel || num <= 1) {
+        for (size_t i = 0; i < num; i++) {
+            fn(i);
+        }
+        return;
+    }
+    std::call_once(frontierPoolOnce_, [this] () {
+        frontierPool_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+            FLAGS_storage_client_frontier_threads,
+            std::make_shared<folly::NamedThreadFactory>("frontier"));
+    });
+    // One task per thread, each takes every numTasks-th slice
+    size_t numTasks = std::min(num, frontierPool_->numThreads());
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(numTasks);
+    for (size_t t = 0; t < numTasks; t++) {
+        futures.emplace_back(folly::via(frontierPool_.get(), [&fn, t, num, numTasks] () {
+            for (auto i = t; i < num; i += numTasks) {
+                fn(i);
+            }
+        }));
+    }
+    folly::collectAll(futures).wait();
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::sendGetNeighbors(
+        GraphSpaceID space,
+        std::unordered_map<HostAddr, PartIds> clusters,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<cpp2::PropDef> returnCols,
+        bool dstIdsOnly,
+        folly::EventBase* evb) {
+    auto maxStaleness = FLAGS_storage_client_max_staleness_ms;
     std::unordered_map<HostAddr, cpp2::GetNeighborsRequest> requests;
     for (auto& c : clusters) {
         auto& host = c.first;
@@ -116,6 +295,8 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
         req.set_edge_type(isOutBound ? edgeType : -edgeType);
         req.set_filter(filter);
         req.set_return_columns(returnCols);
+        req.set_max_staleness_ms(maxStaleness);
+        req.set_dst_ids_only(dstIdsOnly);
     }
 
     return collectResponse(
@@ -127,7 +308,8 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
             } else {
                 return client->future_getInBound(r);
             }
-        });
+        },
+        true);
 }
 
 
@@ -139,12 +321,14 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryStatsResponse>> StorageClient::n
         std::string filter,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
+    auto maxStaleness = FLAGS_storage_client_max_staleness_ms;
     auto clusters = clusterIdsToHosts(
         space,
         vertices,
         [] (const VertexID& v) {
             return v;
-        });
+        },
+        maxStaleness > 0);
 
     std::unordered_map<HostAddr, cpp2::GetNeighborsRequest> requests;
     for (auto& c : clusters) {
@@ -156,6 +340,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryStatsResponse>> StorageClient::n
         req.set_edge_type(isOutBound ? edgeType : -edgeType);
         req.set_filter(filter);
         req.set_return_columns(returnCols);
+        req.set_max_staleness_ms(maxStaleness);
     }
 
     return collectResponse(
@@ -167,7 +352,8 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryStatsResponse>> StorageClient::n
             } else {
                 return client->future_inBoundStats(r);
             }
-        });
+        },
+        true);
 }
 
 
@@ -176,12 +362,14 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         std::vector<VertexID> vertices,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
+    auto maxStaleness = FLAGS_storage_client_max_staleness_ms;
     auto clusters = clusterIdsToHosts(
         space,
         vertices,
         [] (const VertexID& v) {
             return v;
-        });
+        },
+        maxStaleness > 0);
 
     std::unordered_map<HostAddr, cpp2::VertexPropRequest> requests;
     for (auto& c : clusters) {
@@ -190,6 +378,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         req.set_space_id(space);
         req.set_parts(std::move(c.second));
         req.set_return_columns(returnCols);
+        req.set_max_staleness_ms(maxStaleness);
     }
 
     return collectResponse(
@@ -197,7 +386,8 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         [](cpp2::StorageServiceAsyncClient* client,
            const cpp2::VertexPropRequest& r) {
             return client->future_getProps(r);
-        });
+        },
+        true);
 }
 
 
@@ -206,12 +396,14 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         std::vector<cpp2::EdgeKey> edges,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
+    auto maxStaleness = FLAGS_storage_client_max_staleness_ms;
     auto clusters = clusterIdsToHosts(
         space,
         edges,
         [] (const cpp2::EdgeKey& v) {
             return v.get_src();
-        });
+        },
+        maxStaleness > 0);
 
     std::unordered_map<HostAddr, cpp2::EdgePropRequest> requests;
     for (auto& c : clusters) {
@@ -224,6 +416,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         }
         req.set_parts(std::move(c.second));
         req.set_return_columns(returnCols);
+        req.set_max_staleness_ms(maxStaleness);
     }
 
     return collectResponse(
@@ -231,7 +424,61 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         [](cpp2::StorageServiceAsyncClient* client,
            const cpp2::EdgePropRequest& r) {
             return client->future_getEdgeProps(r);
-        });
+        },
+        true);
+}
+
+
+std::unordered_map<HostAddr, cpp2::LookUpIndexRequest> StorageClient::lookUpIndexRequests(
+        GraphSpaceID space,
+        const cpp2::LookUpIndexRequest& req) {
+    auto maxStaleness = FLAGS_storage_client_max_staleness_ms;
+    PartIds parts;
+    auto num = partsNum(space);
+    for (PartitionID partId = 1; partId <= num; partId++) {
+        parts.emplace(partId, std::vector<VertexID>());
+    }
+    auto clusters = clusterPartsToHosts(space, std::move(parts), maxStaleness > 0);
+
+    std::unordered_map<HostAddr, cpp2::LookUpIndexRequest> requests;
+    for (auto& c : clusters) {
+        auto& host = c.first;
+        auto& r = requests.emplace(host, req).first->second;
+        r.set_space_id(space);
+        r.set_parts(std::move(c.second));
+        r.set_max_staleness_ms(maxStaleness);
+    }
+    return requests;
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::lookUpVertexIndex(
+        GraphSpaceID space,
+        cpp2::LookUpIndexRequest req,
+        folly::EventBase* evb) {
+    req.set_is_edge(false);
+    return collectResponse(
+        evb, lookUpIndexRequests(space, req),
+        [](cpp2::StorageServiceAsyncClient* client,
+           const cpp2::LookUpIndexRequest& r) {
+            return client->future_lookUpVertexIndex(r);
+        },
+        true);
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::lookUpEdgeIndex(
+        GraphSpaceID space,
+        cpp2::LookUpIndexRequest req,
+        folly::EventBase* evb) {
+    req.set_is_edge(true);
+    return collectResponse(
+        evb, lookUpIndexRequests(space, req),
+        [](cpp2::StorageServiceAsyncClient* client,
+           const cpp2::LookUpIndexRequest& r) {
+            return client->future_lookUpEdgeIndex(r);
+        },
+        true);
 }
 
 
@@ -9,8 +9,10 @@
 
 #include "base/Base.h"
 #include <gtest/gtest_prod.h>
+#include <folly/Try.h>
 #include <folly/futures/Future.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include "gen-cpp2/StorageServiceAsyncClient.h"
 #include "meta/client/MetaClient.h"
 #include "thrift/ThriftClientManager.h"
@@ -28,6 +30,11 @@ public:
 
     explicit StorageRpcResponse(size_t reqsSent) : totalReqsSent_(reqsSent) {}
 
+    // Some parts of a request have been resent to several hosts
+    void addReqsSent(size_t reqsSent) {
+        totalReqsSent_ += reqsSent;
+    }
+
     bool succeeded() const {
         return result_ == Result::ALL_SUCCEEDED;
     }
@@ -60,9 +67,23 @@ public:
         return responses_;
     }
 
+    // Take the responses of another request as if they were of this one
+    void merge(StorageRpcResponse&& other) {
+        totalReqsSent_ += other.totalReqsSent_;
+        failedReqs_ += other.failedReqs_;
+        if (!other.succeeded()) {
+            result_ = Result::PARTIAL_SUCCEEDED;
+        }
+        failedParts_.insert(other.failedParts_.begin(), other.failedParts_.end());
+        setLatency(other.maxLatency_);
+        responses_.insert(responses_.end(),
+                          std::make_move_iterator(other.responses_.begin()),
+                          std::make_move_iterator(other.responses_.end()));
+    }
+
 
 private:
-    const size_t totalReqsSent_;
+    size_t totalReqsSent_;
     size_t failedReqs_{0};
 
     Result result_{Result::ALL_SUCCEEDED};
@@ -79,8 +100,12 @@ private:
  */
 class StorageClient {
     FRIEND_TEST(StorageClientTest, LeaderChangeTest);
+    FRIEND_TEST(StorageClientTest, HedgeTest);
 
 public:
+    // The vertex ids grouped by their partitions
+    using PartIds = std::unordered_map<PartitionID, std::vector<VertexID>>;
+
     StorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
                   meta::MetaClient *client);
     ~StorageClient();
@@ -106,6 +131,42 @@ public:
         std::vector<storage::cpp2::PropDef> returnCols,
         folly::EventBase* evb = nullptr);
 
+    // Same as above, the vertices have been grouped by partitionIds()
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getNeighbors(
+        GraphSpaceID space,
+        PartIds vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        folly::EventBase* evb = nullptr);
+
+    // Only the dst ids of the edges are returned, packed in QueryResponse.dst_ids
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getDstIds(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        folly::EventBase* evb = nullptr);
+
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getDstIds(
+        GraphSpaceID space,
+        PartIds vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        folly::EventBase* evb = nullptr);
+
+    /**
+     * Group the ids by their partitions and drop the duplicates, so that the
+     * frontier of a traversal goes to the storage as is.
+     *
+     * Frontiers of storage_client_frontier_parallel_min ids or more are split
+     * among the frontier threads: each one scatters its slice into per-partition
+     * buckets, then the buckets of each partition are merged, sorted and made
+     * unique by one thread. The ids of each partition come out sorted.
+     * */
+    PartIds partitionIds(GraphSpaceID space, std::vector<VertexID> ids) const;
+
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryStatsResponse>> neighborStats(
         GraphSpaceID space,
         std::vector<VertexID> vertices,
@@ -127,7 +188,29 @@ public:
         std::vector<storage::cpp2::PropDef> returnCols,
         folly::EventBase* evb = nullptr);
 
+    // Look up the index of req on all parts of the space,
+    // the space_id and parts of req are filled here
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> lookUpVertexIndex(
+        GraphSpaceID space,
+        storage::cpp2::LookUpIndexRequest req,
+        folly::EventBase* evb = nullptr);
+
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::EdgePropResponse>> lookUpEdgeIndex(
+        GraphSpaceID space,
+        storage::cpp2::LookUpIndexRequest req,
+        folly::EventBase* evb = nullptr);
+
 protected:
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> sendGetNeighbors(
+        GraphSpaceID space,
+        std::unordered_map<HostAddr, PartIds> clusters,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        bool dstIdsOnly,
+        folly::EventBase* evb);
+
     // Calculate the partition id for the given vertex id
     PartitionID partId(GraphSpaceID spaceId, int64_t id) const;
 
@@ -166,34 +249,105 @@ protected:
     folly::SemiFuture<StorageRpcResponse<Response>> collectResponse(
         folly::EventBase* evb,
         std::unordered_map<HostAddr, Request> requests,
-        RemoteFunc&& remoteFunc);
+        RemoteFunc&& remoteFunc,
+        bool hedgeable = false);
+
+    /**
+     * The parts whose leader changed, or whose rpc failed, are resent to
+     * their leaders, until storage_client_retry_times or the deadline of
+     * the request is reached.
+     *
+     * When hedgeable, the requests not answered in storage_client_hedge_delay_ms
+     * are copied to other replicas of their parts, the first to answer all
+     * the parts wins.
+     * */
+    template<class Context>
+    void sendRequest(folly::EventBase* evb, std::shared_ptr<Context> context, int64_t reqId);
+
+    template<class Context>
+    void onResponse(folly::EventBase* evb,
+                    std::shared_ptr<Context> context,
+                    int64_t reqId,
+                    folly::Try<typename Context::ResponseType>&& val);
+
+    // Return false if the parts should not be resent any more
+    template<class Context>
+    bool resendParts(folly::EventBase* evb,
+                     std::shared_ptr<Context> context,
+                     typename Context::Attempt& attempt,
+                     const std::vector<PartitionID>& parts,
+                     bool hasResponse);
+
+    template<class Context>
+    void hedgeRequest(folly::EventBase* evb, std::shared_ptr<Context> context, int64_t reqId);
+
+    template<class Context>
+    void onHedgeResponse(std::shared_ptr<Context> context,
+                         int64_t reqId,
+                         folly::Try<typename Context::ResponseType>&& val);
 
     // Cluster given ids into the host they belong to
     // The method returns a map
     //  host_addr (A host, but in most case, the leader will be chosen)
     //      => (partition -> [ids that belong to the shard])
+    // When toReplicas is true, e.g. for the reads allowed to be served by
+    // followers, each partition goes to a random replica instead.
     template<class Container, class GetIdFunc>
     std::unordered_map<HostAddr,
                        std::unordered_map<PartitionID,
                                           std::vector<typename Container::value_type>
                                          >
                       >
-    clusterIdsToHosts(GraphSpaceID spaceId, Container ids, GetIdFunc f) const {
+    clusterIdsToHosts(GraphSpaceID spaceId,
+                      Container ids,
+                      GetIdFunc f,
+                      bool toReplicas = false) const {
         std::unordered_map<HostAddr,
                            std::unordered_map<PartitionID,
                                               std::vector<typename Container::value_type>
                                              >
                           > clusters;
+        std::unordered_map<PartitionID, HostAddr> partHosts;
         for (auto& id : ids) {
             PartitionID part = partId(spaceId, f(id));
-            auto partMeta = getPartMeta(spaceId, part);
+            auto it = partHosts.find(part);
+            if (it == partHosts.end()) {
+                auto partMeta = getPartMeta(spaceId, part);
+                CHECK_GT(partMeta.peers_.size(), 0U);
+                auto host = toReplicas
+                    ? partMeta.peers_[folly::Random::rand32(partMeta.peers_.size())]
+                    : this->leader(partMeta);
+                it = partHosts.emplace(part, host).first;
+            }
+            clusters[it->second][part].emplace_back(std::move(id));
+        }
+        return clusters;
+    }
+
+    // Same as clusterIdsToHosts, but looks up the host of each partition only once
+    std::unordered_map<HostAddr, PartIds> clusterPartsToHosts(GraphSpaceID spaceId,
+                                                              PartIds parts,
+                                                              bool toReplicas = false) const {
+        std::unordered_map<HostAddr, PartIds> clusters;
+        for (auto& part : parts) {
+            auto partMeta = getPartMeta(spaceId, part.first);
             CHECK_GT(partMeta.peers_.size(), 0U);
-            const auto& leader = this->leader(partMeta);
-            clusters[leader][part].emplace_back(std::move(id));
+            auto host = toReplicas
+                ? partMeta.peers_[folly::Random::rand32(partMeta.peers_.size())]
+                : this->leader(partMeta);
+            clusters[host].emplace(part.first, std::move(part.second));
         }
         return clusters;
     }
 
+    // Requests of req to the hosts of all parts of the space
+    std::unordered_map<HostAddr, storage::cpp2::LookUpIndexRequest> lookUpIndexRequests(
+        GraphSpaceID space,
+        const storage::cpp2::LookUpIndexRequest& req);
+
+    // Run fn(0) ... fn(num - 1), spread among the frontier threads when parallel
+    void forEachSlice(size_t num, const std::function<void(size_t)>& fn, bool parallel) const;
+
     virtual int32_t partsNum(GraphSpaceID spaceId) const {
         CHECK(client_ != nullptr);
         return client_->partsNum(spaceId);
@@ -211,6 +365,9 @@ private:
                         storage::cpp2::StorageServiceAsyncClient>> clientsMan_;
     mutable folly::RWSpinLock leadersLock_;
     std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr> leaders_;
+    // Partitions the large frontiers, created on the first one
+    mutable std::once_flag frontierPoolOnce_;
+    mutable std::unique_ptr<folly::CPUThreadPoolExecutor> frontierPool_;
 };
 
 }   // namespace storage
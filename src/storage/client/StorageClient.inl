@@ -5,6 +5,12 @@
  */
 
 #include <folly/Try.h>
+#include <folly/futures/Future.h>
+
+DECLARE_int32(storage_client_timeout_ms);
+DECLARE_int32(storage_client_retry_times);
+DECLARE_int32(storage_client_retry_interval_ms);
+DECLARE_int32(storage_client_hedge_delay_ms);
 
 namespace nebula {
 namespace storage {
@@ -14,9 +20,28 @@ namespace {
 template<class Request, class RemoteFunc, class Response>
 struct ResponseContext {
 public:
-    ResponseContext(size_t reqsSent, RemoteFunc&& remoteFunc)
+    using ResponseType = Response;
+
+    // One request to one host. A request is either sent for the first time,
+    // resent to the new leaders of its parts, or a hedged copy of another one.
+    struct Attempt {
+        HostAddr host;
+        Request request;
+        // How many times the parts in the request have been resent
+        int32_t retried{0};
+        // For a hedged copy, the id of the request it races with
+        int64_t hedgeOf{-1};
+        // For a hedged request, its copies and what they have answered
+        std::vector<int64_t> hedges;
+        std::vector<Response> hedgeResponses;
+    };
+
+    ResponseContext(size_t reqsSent, RemoteFunc&& remoteFunc, bool hedgeable)
         : resp(reqsSent)
-        , serverMethod(std::move(remoteFunc)) {}
+        , serverMethod(std::move(remoteFunc))
+        , hedgeable(hedgeable)
+        , deadline(std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(FLAGS_storage_client_timeout_ms)) {}
 
     // Return true if processed all responses
     bool finishSending() {
@@ -30,23 +55,35 @@ public:
         }
     }
 
-    std::pair<const Request*, bool> insertRequest(HostAddr host, Request&& req) {
+    // Return the id of the request
+    int64_t insertRequest(HostAddr host, Request&& req, int32_t retried, int64_t hedgeOf = -1) {
         std::lock_guard<std::mutex> g(lock_);
-        auto res = ongoingRequests_.emplace(host, std::move(req));
-        return std::make_pair(&res.first->second, res.second);
+        auto reqId = nextReqId_++;
+        Attempt attempt;
+        attempt.host = host;
+        attempt.request = std::move(req);
+        attempt.retried = retried;
+        attempt.hedgeOf = hedgeOf;
+        ongoingRequests_.emplace(reqId, std::move(attempt));
+        return reqId;
     }
 
-    const Request& findRequest(HostAddr host) {
+    // Return nullptr if the request has been done with, e.g. its hedged copies won
+    Attempt* findRequest(int64_t reqId) {
         std::lock_guard<std::mutex> g(lock_);
-        auto it = ongoingRequests_.find(host);
-        DCHECK(it != ongoingRequests_.end());
-        return it->second;
+        auto it = ongoingRequests_.find(reqId);
+        if (it == ongoingRequests_.end()) {
+            return nullptr;
+        }
+        return &it->second;
     }
 
     // Return true if processed all responses
-    bool removeRequest(HostAddr host) {
+    bool removeRequests(const std::vector<int64_t>& reqIds) {
         std::lock_guard<std::mutex> g(lock_);
-        ongoingRequests_.erase(host);
+        for (auto reqId : reqIds) {
+            ongoingRequests_.erase(reqId);
+        }
         if (finishSending_ && !fulfilled_ && ongoingRequests_.empty()) {
             fulfilled_ = true;
             return true;
@@ -55,15 +92,24 @@ public:
         }
     }
 
+    bool expired() const {
+        return std::chrono::steady_clock::now() >= deadline;
+    }
+
 
 public:
     folly::Promise<StorageRpcResponse<Response>> promise;
     StorageRpcResponse<Response> resp;
     RemoteFunc serverMethod;
+    // Whether the request could be sent to a replica other than the leader
+    const bool hedgeable;
+    // No more retries after the deadline
+    const std::chrono::steady_clock::time_point deadline;
 
 private:
     std::mutex lock_;
-    std::unordered_map<HostAddr, Request> ongoingRequests_;
+    std::unordered_map<int64_t, Attempt> ongoingRequests_;
+    int64_t nextReqId_{0};
     bool finishSending_{false};
     bool fulfilled_{false};
 };
@@ -75,9 +121,10 @@ template<class Request, class RemoteFunc, class Response>
 folly::SemiFuture<StorageRpcResponse<Response>> StorageClient::collectResponse(
         folly::EventBase* evb,
         std::unordered_map<HostAddr, Request> requests,
-        RemoteFunc&& remoteFunc) {
+        RemoteFunc&& remoteFunc,
+        bool hedgeable) {
     auto context = std::make_shared<ResponseContext<Request, RemoteFunc, Response>>(
-        requests.size(), std::move(remoteFunc));
+        requests.size(), std::move(remoteFunc), hedgeable);
 
     if (evb == nullptr) {
         DCHECK(!!ioThreadPool_);
@@ -85,68 +132,8 @@ folly::SemiFuture<StorageRpcResponse<Response>> StorageClient::collectResponse(
     }
 
     for (auto& req : requests) {
-        auto& host = req.first;
-        auto spaceId = req.second.get_space_id();
-        auto client = clientsMan_->client(host, evb);
-        // Result is a pair of <Request&, bool>
-        auto res = context->insertRequest(host, std::move(req.second));
-        DCHECK(res.second);
-        // Invoke the remote method
-        context->serverMethod(client.get(), *res.first)
-            // Future process code will be executed on the IO thread
-            // Since all requests are sent using the same eventbase, all then-callback
-            // will be executed on the same IO thread
-            .then(evb, [this, context, host, spaceId] (folly::Try<Response>&& val) {
-                auto& r = context->findRequest(host);
-                if (val.hasException()) {
-                    LOG(ERROR) << "Request to " << host << " failed: " << val.exception().what();
-                    for (auto& part : r.parts) {
-                        VLOG(3) << "Exception! Failed part " << part.first;
-                        context->resp.failedParts().emplace(
-                            part.first,
-                            storage::cpp2::ErrorCode::E_RPC_FAILURE);
-                        invalidLeader(spaceId, part.first);
-                    }
-                    context->resp.markFailure();
-                } else {
-                    auto resp = std::move(val.value());
-                    auto& result = resp.get_result();
-                    bool hasFailure{false};
-                    for (auto& code : result.get_failed_codes()) {
-                        VLOG(3) << "Failure! Failed part " << code.get_part_id()
-                                << ", failed code " << static_cast<int32_t>(code.get_code());
-                        hasFailure = true;
-                        if (code.get_code() == storage::cpp2::ErrorCode::E_LEADER_CHANGED) {
-                            auto* leader = code.get_leader();
-                            if (leader != nullptr
-                                    && leader->get_ip() != 0
-                                    && leader->get_port() != 0) {
-                                updateLeader(spaceId,
-                                             code.get_part_id(),
-                                             HostAddr(leader->get_ip(), leader->get_port()));
-                            }
-                        } else {
-                            // Simply keep the result
-                            context->resp.failedParts().emplace(code.get_part_id(),
-                                                                code.get_code());
-                        }
-                    }
-                    if (hasFailure) {
-                        context->resp.markFailure();
-                    }
-
-                    // Adjust the latency
-                    context->resp.setLatency(result.get_latency_in_us());
-
-                    // Keep the response
-                    context->resp.responses().emplace_back(std::move(resp));
-                }
-
-                if (context->removeRequest(host)) {
-                    // Received all responses
-                    context->promise.setValue(std::move(context->resp));
-                }
-            });
+        auto reqId = context->insertRequest(req.first, std::move(req.second), 0);
+        sendRequest(evb, context, reqId);
     }
     if (context->finishSending()) {
         // Received all responses, most likely, all rpc failed
@@ -156,6 +143,270 @@ folly::SemiFuture<StorageRpcResponse<Response>> StorageClient::collectResponse(
     return context->promise.getSemiFuture();
 }
 
+
+template<class Context>
+void StorageClient::sendRequest(folly::EventBase* evb,
+                                std::shared_ptr<Context> context,
+                                int64_t reqId) {
+    auto* attempt = context->findRequest(reqId);
+    if (attempt == nullptr) {
+        return;
+    }
+    auto client = clientsMan_->client(attempt->host, evb);
+    // The attempt could be removed by its response on the IO thread once sent,
+    // so nothing of it is read after sending
+    bool toHedge = context->hedgeable
+                && attempt->hedgeOf < 0
+                && FLAGS_storage_client_hedge_delay_ms > 0;
+    // Invoke the remote method
+    context->serverMethod(client.get(), attempt->request)
+        // Future process code will be executed on the IO thread
+        // Since all requests are sent using the same eventbase, all then-callback
+        // will be executed on the same IO thread
+        .then(evb, [this, evb, context, reqId] (
+                folly::Try<typename Context::ResponseType>&& val) {
+            onResponse(evb, context, reqId, std::move(val));
+        });
+
+    if (toHedge) {
+        folly::futures::sleep(std::chrono::milliseconds(FLAGS_storage_client_hedge_delay_ms))
+            .via(evb)
+            .thenValue([this, evb, context, reqId] (auto&&) {
+                hedgeRequest(evb, context, reqId);
+            });
+    }
+}
+
+
+template<class Context>
+void StorageClient::onResponse(folly::EventBase* evb,
+                               std::shared_ptr<Context> context,
+                               int64_t reqId,
+                               folly::Try<typename Context::ResponseType>&& val) {
+    auto* attempt = context->findRequest(reqId);
+    if (attempt == nullptr) {
+        VLOG(3) << "The request " << reqId << " has been answered by others";
+        return;
+    }
+    if (attempt->hedgeOf >= 0) {
+        onHedgeResponse(context, reqId, std::move(val));
+        return;
+    }
+
+    auto& host = attempt->host;
+    auto spaceId = attempt->request.get_space_id();
+    // Parts to send to their new leaders
+    std::vector<PartitionID> retryParts;
+    auto retryCode = storage::cpp2::ErrorCode::E_LEADER_CHANGED;
+    bool hasFailure{false};
+    bool hasResponse{false};
+    if (val.hasException()) {
+        LOG(ERROR) << "Request to " << host << " failed: " << val.exception().what();
+        retryCode = storage::cpp2::ErrorCode::E_RPC_FAILURE;
+        for (auto& part : attempt->request.parts) {
+            VLOG(3) << "Exception! Failed part " << part.first;
+            invalidLeader(spaceId, part.first);
+            retryParts.emplace_back(part.first);
+        }
+    } else {
+        auto resp = std::move(val.value());
+        auto& result = resp.get_result();
+        for (auto& code : result.get_failed_codes()) {
+            VLOG(3) << "Failure! Failed part " << code.get_part_id()
+                    << ", failed code " << static_cast<int32_t>(code.get_code());
+            if (code.get_code() == storage::cpp2::ErrorCode::E_LEADER_CHANGED) {
+                auto* leader = code.get_leader();
+                if (leader != nullptr
+                        && leader->get_ip() != 0
+                        && leader->get_port() != 0) {
+                    updateLeader(spaceId,
+                                 code.get_part_id(),
+                                 HostAddr(leader->get_ip(), leader->get_port()));
+                } else {
+                    invalidLeader(spaceId, code.get_part_id());
+                }
+                retryParts.emplace_back(code.get_part_id());
+            } else {
+                hasFailure = true;
+                // Simply keep the result
+                context->resp.failedParts().emplace(code.get_part_id(), code.get_code());
+            }
+        }
+        hasResponse = retryParts.size() < attempt->request.parts.size();
+
+        // Adjust the latency
+        context->resp.setLatency(result.get_latency_in_us());
+
+        // Keep the response
+        context->resp.responses().emplace_back(std::move(resp));
+    }
+
+    if (!retryParts.empty() &&
+            !resendParts(evb, context, *attempt, retryParts, hasResponse)) {
+        hasFailure = true;
+        for (auto part : retryParts) {
+            context->resp.failedParts().emplace(part, retryCode);
+        }
+    }
+    if (hasFailure) {
+        context->resp.markFailure();
+    }
+
+    // Its hedged copies are no longer needed
+    auto finished = std::move(attempt->hedges);
+    finished.emplace_back(reqId);
+    if (context->removeRequests(finished)) {
+        // Received all responses
+        context->promise.setValue(std::move(context->resp));
+    }
+}
+
+
+template<class Context>
+bool StorageClient::resendParts(folly::EventBase* evb,
+                                std::shared_ptr<Context> context,
+                                typename Context::Attempt& attempt,
+                                const std::vector<PartitionID>& parts,
+                                bool hasResponse) {
+    if (attempt.retried >= FLAGS_storage_client_retry_times) {
+        LOG(ERROR) << "Give up resending " << parts.size() << " parts to their leaders after "
+                   << attempt.retried << " retries";
+        return false;
+    }
+    if (context->expired()) {
+        LOG(ERROR) << "Give up resending " << parts.size() << " parts to their leaders, "
+                   << "the request has run out of time";
+        return false;
+    }
+
+    auto spaceId = attempt.request.get_space_id();
+    std::unordered_map<HostAddr, decltype(attempt.request.parts)> clusters;
+    for (auto part : parts) {
+        auto it = attempt.request.parts.find(part);
+        if (it == attempt.request.parts.end()) {
+            LOG(ERROR) << "Part " << part << " is not in the request to " << attempt.host;
+            return false;
+        }
+        auto partMeta = getPartMeta(spaceId, part);
+        CHECK_GT(partMeta.peers_.size(), 0U);
+        clusters[leader(partMeta)].emplace(part, std::move(it->second));
+    }
+    // The attempt is done with, the resent requests are copied from what is left
+    attempt.request.parts.clear();
+    // One request fails over to several, unless it has been answered partially
+    context->resp.addReqsSent(hasResponse ? clusters.size() : clusters.size() - 1);
+
+    // No leader has been told on rpc failures, wait for the election a while
+    auto delay = std::chrono::milliseconds(0);
+    for (auto& part : parts) {
+        folly::RWSpinLock::ReadHolder rh(leadersLock_);
+        if (leaders_.find(std::make_pair(spaceId, part)) == leaders_.end()) {
+            delay = std::chrono::milliseconds(FLAGS_storage_client_retry_interval_ms);
+            break;
+        }
+    }
+    for (auto& c : clusters) {
+        auto req = attempt.request;
+        req.set_parts(std::move(c.second));
+        VLOG(1) << "Resend " << req.parts.size() << " parts to " << c.first
+                << ", retried " << attempt.retried + 1 << " times";
+        auto reqId = context->insertRequest(c.first, std::move(req), attempt.retried + 1);
+        if (delay.count() == 0) {
+            sendRequest(evb, context, reqId);
+        } else {
+            folly::futures::sleep(delay)
+                .via(evb)
+                .thenValue([this, evb, context, reqId] (auto&&) {
+                    sendRequest(evb, context, reqId);
+                });
+        }
+    }
+    return true;
+}
+
+
+template<class Context>
+void StorageClient::hedgeRequest(folly::EventBase* evb,
+                                 std::shared_ptr<Context> context,
+                                 int64_t reqId) {
+    auto* attempt = context->findRequest(reqId);
+    if (attempt == nullptr || !attempt->hedges.empty()) {
+        return;
+    }
+    auto spaceId = attempt->request.get_space_id();
+    // Send the parts of the slow host to their other replicas
+    std::unordered_map<HostAddr, decltype(attempt->request.parts)> clusters;
+    for (auto& part : attempt->request.parts) {
+        auto partMeta = getPartMeta(spaceId, part.first);
+        std::vector<HostAddr> replicas;
+        for (auto& peer : partMeta.peers_) {
+            if (peer != attempt->host) {
+                replicas.emplace_back(peer);
+            }
+        }
+        if (replicas.empty()) {
+            VLOG(3) << "No other replica of part " << part.first << ", skip hedging";
+            return;
+        }
+        auto& replica = replicas[folly::Random::rand32(replicas.size())];
+        clusters[replica].emplace(part.first, part.second);
+    }
+
+    VLOG(1) << "Request to " << attempt->host << " has not been answered in "
+            << FLAGS_storage_client_hedge_delay_ms << "ms, hedge it to "
+            << clusters.size() << " replicas";
+    auto parts = std::move(attempt->request.parts);
+    auto base = attempt->request;
+    attempt->request.parts = std::move(parts);
+    std::vector<int64_t> hedges;
+    for (auto& c : clusters) {
+        auto req = base;
+        req.set_parts(std::move(c.second));
+        hedges.emplace_back(context->insertRequest(c.first, std::move(req), 0, reqId));
+    }
+    attempt->hedges = hedges;
+    for (auto hedgeId : hedges) {
+        sendRequest(evb, context, hedgeId);
+    }
+}
+
+
+template<class Context>
+void StorageClient::onHedgeResponse(std::shared_ptr<Context> context,
+                                    int64_t reqId,
+                                    folly::Try<typename Context::ResponseType>&& val) {
+    auto* attempt = context->findRequest(reqId);
+    auto* hedged = context->findRequest(attempt->hedgeOf);
+    if (hedged == nullptr) {
+        return;
+    }
+    if (val.hasException() || !val.value().get_result().get_failed_codes().empty()) {
+        // The hedged request is still on its way, just give up the copies
+        VLOG(1) << "Hedged request to " << attempt->host << " failed, wait for "
+                << hedged->host;
+        auto hedges = std::move(hedged->hedges);
+        hedged->hedges.clear();
+        hedged->hedgeResponses.clear();
+        context->removeRequests(hedges);
+        return;
+    }
+    hedged->hedgeResponses.emplace_back(std::move(val.value()));
+    if (hedged->hedgeResponses.size() < hedged->hedges.size()) {
+        return;
+    }
+
+    VLOG(1) << "Hedged requests win the one to " << hedged->host;
+    for (auto& resp : hedged->hedgeResponses) {
+        context->resp.setLatency(resp.get_result().get_latency_in_us());
+        context->resp.responses().emplace_back(std::move(resp));
+    }
+    auto finished = std::move(hedged->hedges);
+    finished.emplace_back(attempt->hedgeOf);
+    if (context->removeRequests(finished)) {
+        // Received all responses
+        context->promise.setValue(std::move(context->resp));
+    }
+}
+
 }   // namespace storage
 }   // namespace nebula
-
@@ -30,6 +30,15 @@ void AdHocSchemaManager::removeTagSchema(GraphSpaceID space, TagID tag) {
     tagSchemas_.erase(std::make_pair(space, tag));
 }
 
+void AdHocSchemaManager::setSingleVersion(GraphSpaceID space, bool singleVersion) {
+    folly::RWSpinLock::WriteHolder wh(spaceLock_);
+    if (singleVersion) {
+        singleVersionSpaces_.emplace(space);
+    } else {
+        singleVersionSpaces_.erase(space);
+    }
+}
+
 std::shared_ptr<const nebula::meta::SchemaProviderIf>
 AdHocSchemaManager::getTagSchema(folly::StringPiece spaceName,
                                  folly::StringPiece tagName,
@@ -182,6 +191,11 @@ StatusOr<EdgeType> AdHocSchemaManager::toEdgeType(GraphSpaceID space, folly::Str
     return -1;
 }
 
+StatusOr<bool> AdHocSchemaManager::isSingleVersion(GraphSpaceID space) {
+    folly::RWSpinLock::ReadHolder rh(spaceLock_);
+    return singleVersionSpaces_.find(space) != singleVersionSpaces_.end();
+}
+
 }  // namespace storage
 }  // namespace nebula
 
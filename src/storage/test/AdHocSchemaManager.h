@@ -31,6 +31,8 @@ public:
 
     void removeTagSchema(GraphSpaceID space, TagID tag);
 
+    void setSingleVersion(GraphSpaceID space, bool singleVersion);
+
     std::shared_ptr<const nebula::meta::SchemaProviderIf>
     getTagSchema(GraphSpaceID space,
                  TagID tag,
@@ -74,6 +76,9 @@ public:
     // This interface is disabled
     StatusOr<EdgeType> toEdgeType(GraphSpaceID space, folly::StringPiece typeName) override;
 
+    // Spaces are multi-version unless setSingleVersion is called
+    StatusOr<bool> isSingleVersion(GraphSpaceID space) override;
+
     void init(nebula::meta::MetaClient *client = nullptr) override {
         UNUSED(client);
     }
@@ -90,6 +95,9 @@ protected:
                        // version -> schema
                        std::map<SchemaVer, std::shared_ptr<const nebula::meta::SchemaProviderIf>>>
         edgeSchemas_;
+
+    folly::RWSpinLock spaceLock_;
+    std::unordered_set<GraphSpaceID> singleVersionSpaces_;
 };
 
 }  // namespace storage
@@ -18,7 +18,8 @@ namespace storage {
 TEST(AddEdgesTest, SimpleTest) {
     fs::TempDir rootPath("/tmp/AddEdgesTest.XXXXXX");
     std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
-    auto* processor = AddEdgesProcessor::instance(kv.get(), nullptr);
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto* processor = AddEdgesProcessor::instance(kv.get(), schemaMan.get());
 
     LOG(INFO) << "Build AddEdgesRequest...";
     cpp2::AddEdgesRequest req;
@@ -60,6 +61,93 @@ TEST(AddEdgesTest, SimpleTest) {
     }
 }
 
+TEST(AddEdgesTest, SingleVersionTest) {
+    fs::TempDir rootPath("/tmp/AddEdgesTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    static_cast<AdHocSchemaManager*>(schemaMan.get())->setSingleVersion(0, true);
+
+    auto addEdges = [&] (int32_t round) {
+        auto* processor = AddEdgesProcessor::instance(kv.get(), schemaMan.get());
+        cpp2::AddEdgesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (auto partId = 0; partId < 3; partId++) {
+            std::vector<cpp2::Edge> edges;
+            for (auto srcId = partId * 10; srcId < 10 * (partId + 1); srcId++) {
+                edges.emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                                   cpp2::EdgeKey(apache::thrift::FragileConstructor::FRAGILE,
+                                                 srcId, 101, srcId*100 + 2, 0),
+                                   folly::stringPrintf("%d_%d_%d", partId, srcId, round));
+            }
+            req.parts.emplace(partId, std::move(edges));
+        }
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    };
+
+    LOG(INFO) << "Write the same edges twice...";
+    addEdges(0);
+    addEdges(1);
+
+    LOG(INFO) << "Check only the latest value is kept...";
+    for (auto partId = 0; partId < 3; partId++) {
+        for (auto srcId = 10 * partId; srcId < 10 * (partId + 1); srcId++) {
+            auto prefix = NebulaKeyUtils::prefix(partId, srcId, 101);
+            std::unique_ptr<kvstore::KVIterator> iter;
+            EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, partId, prefix, &iter));
+            int num = 0;
+            while (iter->valid()) {
+                EXPECT_FALSE(NebulaKeyUtils::hasVersion(iter->key()));
+                EXPECT_EQ(srcId*100 + 2, NebulaKeyUtils::getDstId(iter->key()));
+                EXPECT_EQ(folly::stringPrintf("%d_%d_1", partId, srcId), iter->val());
+                num++;
+                iter->next();
+            }
+            EXPECT_EQ(1, num);
+        }
+    }
+}
+
+TEST(AddEdgesTest, InEdgeWithoutPropsTest) {
+    fs::TempDir rootPath("/tmp/AddEdgesTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto* processor = AddEdgesProcessor::instance(kv.get(), schemaMan.get());
+
+    LOG(INFO) << "Write the out-edge and the in-edge, both with props...";
+    cpp2::AddEdgesRequest req;
+    req.space_id = 0;
+    req.overwritable = true;
+    std::vector<cpp2::Edge> edges;
+    edges.emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                       cpp2::EdgeKey(apache::thrift::FragileConstructor::FRAGILE,
+                                     1, 101, 0, 2),
+                       "props");
+    edges.emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                       cpp2::EdgeKey(apache::thrift::FragileConstructor::FRAGILE,
+                                     2, -101, 0, 1),
+                       "props");
+    req.parts.emplace(0, std::move(edges));
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_codes.size());
+
+    LOG(INFO) << "Check only the out-edge keeps the props...";
+    auto checkVal = [&] (VertexID vId, EdgeType type, const std::string& expected) {
+        std::unique_ptr<kvstore::KVIterator> iter;
+        EXPECT_EQ(kvstore::ResultCode::SUCCEEDED,
+                  kv->prefix(0, 0, NebulaKeyUtils::prefix(0, vId, type), &iter));
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(expected, iter->val());
+    };
+    checkVal(1, 101, "props");
+    checkVal(2, -101, "");
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -18,7 +18,8 @@ namespace storage {
 TEST(AddVerticesTest, SimpleTest) {
     fs::TempDir rootPath("/tmp/AddVerticesTest.XXXXXX");
     std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
-    auto* processor = AddVerticesProcessor::instance(kv.get(), nullptr);
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto* processor = AddVerticesProcessor::instance(kv.get(), schemaMan.get());
 
     LOG(INFO) << "Build AddVerticesRequest...";
     cpp2::AddVerticesRequest req;
@@ -11,6 +11,10 @@
 #include "fs/TempDir.h"
 #include "storage/test/TestUtils.h"
 #include "storage/CompactionFilter.h"
+#include "storage/AddEdgesProcessor.h"
+#include "storage/AddVerticesProcessor.h"
+#include "storage/test/AdHocSchemaManager.h"
+#include "time/WallClock.h"
 #include "dataman/RowWriter.h"
 
 namespace nebula {
@@ -73,6 +77,27 @@ void mockData(kvstore::KVStore* kv) {
     }
 }
 
+static std::shared_ptr<meta::SchemaProviderIf> withTTL(
+        std::shared_ptr<meta::SchemaProviderIf> provider,
+        const std::string& ttlCol,
+        std::vector<std::string> indexes = {}) {
+    nebula::cpp2::Schema schema;
+    for (size_t i = 0; i < provider->getNumFields(); i++) {
+        nebula::cpp2::ColumnDef column;
+        column.name = provider->getFieldName(i);
+        column.type = provider->getFieldType(i);
+        schema.columns.emplace_back(std::move(column));
+    }
+    nebula::cpp2::SchemaProp prop;
+    prop.set_ttl_duration(100);
+    prop.set_ttl_col(ttlCol);
+    if (!indexes.empty()) {
+        prop.set_indexes(std::move(indexes));
+    }
+    schema.set_schema_prop(std::move(prop));
+    return std::make_shared<ResultSchemaProvider>(std::move(schema));
+}
+
 TEST(NebulaCompactionFilterTest, InvalidSchemaAndMutliVersionsFilterTest) {
     fs::TempDir rootPath("/tmp/NebulaCompactionFilterTest.XXXXXX");
     auto schemaMan = TestUtils::mockSchemaMan();
@@ -151,6 +176,232 @@ TEST(NebulaCompactionFilterTest, InvalidSchemaAndMutliVersionsFilterTest) {
     }
 }
 
+TEST(NebulaCompactionFilterTest, TTLFilterTest) {
+    fs::TempDir rootPath("/tmp/NebulaCompactionFilterTest.XXXXXX");
+    auto schemaMan = TestUtils::mockSchemaMan();
+    std::shared_ptr<kvstore::KVCompactionFilterFactory> cfFactory(
+                                    new NebulaCompactionFilterFactory(schemaMan.get()));
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path(),
+                                                           {0, 0},
+                                                           nullptr,
+                                                           false,
+                                                           cfFactory));
+    LOG(INFO) << "Write some data";
+    mockData(kv.get());
+    LOG(INFO) << "Set ttl on tag 3001 and edge 101, all the data written is out of date";
+    auto* adhoc = static_cast<AdHocSchemaManager*>(schemaMan.get());
+    adhoc->addTagSchema(0, 3001, withTTL(TestUtils::genTagSchemaProvider(3001, 3, 3),
+                                         "tag_3001_col_0"));
+    adhoc->addEdgeSchema(0, 101, withTTL(TestUtils::genEdgeSchemaProvider(10, 10), "col_0"));
+
+    auto* ns = static_cast<kvstore::NebulaStore*>(kv.get());
+    ns->compact(0);
+    LOG(INFO) << "Finish compaction, check data...";
+
+    auto count = [&](PartitionID partId, const std::string& prefix) {
+        std::unique_ptr<kvstore::KVIterator> iter;
+        EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, partId, prefix, &iter));
+        int32_t num = 0;
+        while (iter->valid()) {
+            iter->next();
+            num++;
+        }
+        return num;
+    };
+
+    for (auto partId = 0; partId < 3; partId++) {
+        for (auto vertexId = partId * 10; vertexId < (partId + 1) * 10; vertexId++) {
+            EXPECT_EQ(0, count(partId, NebulaKeyUtils::prefix(partId, vertexId, 3001)));
+            for (auto tagId = 3002; tagId < 3010; tagId++) {
+                EXPECT_EQ(1, count(partId, NebulaKeyUtils::prefix(partId, vertexId, tagId)));
+            }
+            EXPECT_EQ(0, count(partId, NebulaKeyUtils::prefix(partId, vertexId, 101)));
+            // In-edges written without props, before the ttl was set, are kept.
+            EXPECT_EQ(5, count(partId, NebulaKeyUtils::prefix(partId, vertexId, -101)));
+        }
+    }
+}
+
+TEST(NebulaCompactionFilterTest, TTLInEdgesTest) {
+    fs::TempDir rootPath("/tmp/NebulaCompactionFilterTest.XXXXXX");
+    auto schemaMan = TestUtils::mockSchemaMan();
+    static_cast<AdHocSchemaManager*>(schemaMan.get())->addEdgeSchema(
+        0, 101, withTTL(TestUtils::genEdgeSchemaProvider(10, 10), "col_0"));
+    std::shared_ptr<kvstore::KVCompactionFilterFactory> cfFactory(
+                                    new NebulaCompactionFilterFactory(schemaMan.get()));
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path(),
+                                                           {0, 0},
+                                                           nullptr,
+                                                           false,
+                                                           cfFactory));
+
+    LOG(INFO) << "Write the edges of src 1 expired, the ones of src 2 not";
+    {
+        cpp2::AddEdgesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (VertexID src = 1; src <= 2; src++) {
+            RowWriter writer;
+            writer << (src == 1 ? 0L : time::WallClock::fastNowInSec());
+            for (int64_t i = 1; i < 10; i++) {
+                writer << i;
+            }
+            for (auto i = 10; i < 20; i++) {
+                writer << folly::stringPrintf("string_col_%d", i);
+            }
+            auto props = writer.encode();
+            for (auto edgeType : {101, -101}) {
+                VertexID vId = edgeType > 0 ? src : src + 100;
+                cpp2::EdgeKey key;
+                key.set_src(vId);
+                key.set_edge_type(edgeType);
+                key.set_ranking(0);
+                key.set_dst(edgeType > 0 ? src + 100 : src);
+                req.parts[vId % 3].emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                                                std::move(key),
+                                                props);
+            }
+        }
+        auto* processor = AddEdgesProcessor::instance(kv.get(), schemaMan.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+
+    auto count = [&](PartitionID partId, const std::string& prefix) {
+        std::unique_ptr<kvstore::KVIterator> iter;
+        EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, partId, prefix, &iter));
+        int32_t num = 0;
+        while (iter->valid()) {
+            // The in-edges of the edge type with ttl keep the props
+            EXPECT_FALSE(iter->val().empty());
+            iter->next();
+            num++;
+        }
+        return num;
+    };
+
+    auto* ns = static_cast<kvstore::NebulaStore*>(kv.get());
+    ns->compact(0);
+    LOG(INFO) << "Finish compaction, check data...";
+    for (VertexID src = 1; src <= 2; src++) {
+        int32_t expected = src == 1 ? 0 : 1;
+        EXPECT_EQ(expected, count(src % 3, NebulaKeyUtils::prefix(src % 3, src, 101)));
+        VertexID dst = src + 100;
+        EXPECT_EQ(expected, count(dst % 3, NebulaKeyUtils::prefix(dst % 3, dst, -101)));
+    }
+}
+
+TEST(NebulaCompactionFilterTest, TTLNewestVersionTest) {
+    fs::TempDir rootPath("/tmp/NebulaCompactionFilterTest.XXXXXX");
+    auto schemaMan = TestUtils::mockSchemaMan();
+    static_cast<AdHocSchemaManager*>(schemaMan.get())->addEdgeSchema(
+        0, 101, withTTL(TestUtils::genEdgeSchemaProvider(10, 10), "col_0"));
+    std::shared_ptr<kvstore::KVCompactionFilterFactory> cfFactory(
+                                    new NebulaCompactionFilterFactory(schemaMan.get()));
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path(),
+                                                           {0, 0},
+                                                           nullptr,
+                                                           false,
+                                                           cfFactory));
+
+    LOG(INFO) << "Write the newest version expired, and an older one not";
+    std::vector<kvstore::KV> data;
+    for (int64_t version = 1; version <= 2; version++) {
+        RowWriter writer;
+        writer << (version == 1 ? 0L : time::WallClock::fastNowInSec());
+        for (int64_t i = 1; i < 10; i++) {
+            writer << i;
+        }
+        for (auto i = 10; i < 20; i++) {
+            writer << folly::stringPrintf("string_col_%d", i);
+        }
+        data.emplace_back(NebulaKeyUtils::edgeKey(0, 0, 101, 0, 1, version), writer.encode());
+    }
+    folly::Baton<true, std::atomic> baton;
+    kv->asyncMultiPut(0, 0, std::move(data), [&](kvstore::ResultCode code) {
+        EXPECT_EQ(code, kvstore::ResultCode::SUCCEEDED);
+        baton.post();
+    });
+    baton.wait();
+
+    auto* ns = static_cast<kvstore::NebulaStore*>(kv.get());
+    ns->compact(0);
+    LOG(INFO) << "Finish compaction, check data...";
+    // The older version must not come back in place of the expired one
+    std::unique_ptr<kvstore::KVIterator> iter;
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+              kv->prefix(0, 0, NebulaKeyUtils::prefix(0, 0, 101), &iter));
+    EXPECT_FALSE(iter->valid());
+}
+
+TEST(NebulaCompactionFilterTest, TTLIndexTest) {
+    fs::TempDir rootPath("/tmp/NebulaCompactionFilterTest.XXXXXX");
+    auto schemaMan = TestUtils::mockSchemaMan();
+    static_cast<AdHocSchemaManager*>(schemaMan.get())->addTagSchema(
+        0, 3001, withTTL(TestUtils::genTagSchemaProvider(3001, 3, 3),
+                         "tag_3001_col_0", {"tag_3001_col_1"}));
+    std::shared_ptr<kvstore::KVCompactionFilterFactory> cfFactory(
+                                    new NebulaCompactionFilterFactory(schemaMan.get()));
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path(),
+                                                           {0, 0},
+                                                           nullptr,
+                                                           false,
+                                                           cfFactory));
+
+    LOG(INFO) << "Write the vertices 1 to 3 expired, the others not";
+    {
+        cpp2::AddVerticesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (VertexID vId = 1; vId <= 6; vId++) {
+            RowWriter writer;
+            writer << (vId <= 3 ? 0L : time::WallClock::fastNowInSec());
+            for (int64_t i = 1; i < 3; i++) {
+                writer << vId * 10 + i;
+            }
+            for (auto i = 3; i < 6; i++) {
+                writer << folly::stringPrintf("tag_string_col_%d", i);
+            }
+            std::vector<cpp2::Tag> tags;
+            tags.emplace_back(apache::thrift::FragileConstructor::FRAGILE, 3001, writer.encode());
+            req.parts[vId % 3].emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                                            vId,
+                                            std::move(tags));
+        }
+        auto* processor = AddVerticesProcessor::instance(kv.get(), schemaMan.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+
+    auto indexedVertices = [&] () {
+        std::set<VertexID> vIds;
+        for (PartitionID partId = 0; partId < 3; partId++) {
+            auto prefix = NebulaKeyUtils::indexPrefix(partId, false, 3001, "tag_3001_col_1");
+            std::unique_ptr<kvstore::KVIterator> iter;
+            EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, partId, prefix, &iter));
+            while (iter->valid()) {
+                // The index keys of the rows with ttl carry the ttl_col value
+                EXPECT_EQ(sizeof(int64_t), iter->val().size());
+                vIds.emplace(NebulaKeyUtils::getIndexVertexId(iter->key()));
+                iter->next();
+            }
+        }
+        return vIds;
+    };
+    std::set<VertexID> expected = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(expected, indexedVertices());
+
+    auto* ns = static_cast<kvstore::NebulaStore*>(kv.get());
+    ns->compact(0);
+    LOG(INFO) << "Finish compaction, the index keys expire along with the rows";
+    expected = {4, 5, 6};
+    EXPECT_EQ(expected, indexedVertices());
+}
+
 }  // namespace storage
 }  // namespace nebula
 
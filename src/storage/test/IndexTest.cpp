@@ -0,0 +1,305 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include <rocksdb/db.h>
+#include "fs/TempDir.h"
+#include "storage/test/TestUtils.h"
+#include "storage/test/AdHocSchemaManager.h"
+#include "storage/AddVerticesProcessor.h"
+#include "storage/AddEdgesProcessor.h"
+#include "storage/LookUpVertexIndexProcessor.h"
+#include "storage/LookUpEdgeIndexProcessor.h"
+#include "dataman/RowSetReader.h"
+#include "dataman/RowReader.h"
+
+namespace nebula {
+namespace storage {
+
+static std::shared_ptr<meta::SchemaProviderIf> withIndexes(
+        std::shared_ptr<meta::SchemaProviderIf> provider,
+        std::vector<std::string> indexes) {
+    nebula::cpp2::Schema schema;
+    for (size_t i = 0; i < provider->getNumFields(); i++) {
+        nebula::cpp2::ColumnDef column;
+        column.name = provider->getFieldName(i);
+        column.type = provider->getFieldType(i);
+        schema.columns.emplace_back(std::move(column));
+    }
+    nebula::cpp2::SchemaProp prop;
+    prop.set_indexes(std::move(indexes));
+    schema.set_schema_prop(std::move(prop));
+    return std::make_shared<ResultSchemaProvider>(std::move(schema));
+}
+
+static std::unique_ptr<meta::SchemaManager> mockSchemaMan() {
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto* adHoc = static_cast<AdHocSchemaManager*>(schemaMan.get());
+    adHoc->addTagSchema(0, 3001, withIndexes(TestUtils::genTagSchemaProvider(3001, 3, 3),
+                                             {"tag_3001_col_0"}));
+    adHoc->addEdgeSchema(0, 101, withIndexes(TestUtils::genEdgeSchemaProvider(10, 10),
+                                             {"col_0"}));
+    return schemaMan;
+}
+
+// Add the rows of (vId, tag_3001_col_0) in one request
+static void addVertices(kvstore::KVStore* kv,
+                        meta::SchemaManager* schemaMan,
+                        const std::vector<std::pair<VertexID, int64_t>>& rows) {
+    cpp2::AddVerticesRequest req;
+    req.space_id = 0;
+    req.overwritable = true;
+    for (auto& row : rows) {
+        RowWriter writer;
+        writer << row.second;
+        for (int64_t i = 1; i < 3; i++) {
+            writer << i;
+        }
+        for (auto i = 3; i < 6; i++) {
+            writer << folly::stringPrintf("tag_string_col_%d", i);
+        }
+        std::vector<cpp2::Tag> tags;
+        tags.emplace_back(apache::thrift::FragileConstructor::FRAGILE, 3001, writer.encode());
+        req.parts[row.first % 3].emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                                              row.first,
+                                              std::move(tags));
+    }
+
+    auto* processor = AddVerticesProcessor::instance(kv, schemaMan);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(0, resp.result.failed_codes.size());
+}
+
+static void addVertex(kvstore::KVStore* kv,
+                      meta::SchemaManager* schemaMan,
+                      VertexID vId,
+                      int64_t col0) {
+    addVertices(kv, schemaMan, {{vId, col0}});
+}
+
+static std::string vertexIndexKey(VertexID vId, int64_t col0) {
+    return NebulaKeyUtils::vertexIndexKey(vId % 3, 3001, "tag_3001_col_0",
+                                          NebulaKeyUtils::encodeIndexValue(col0), vId);
+}
+
+static bool indexed(kvstore::KVStore* kv, VertexID vId, int64_t col0) {
+    std::string value;
+    return kv->get(0, vId % 3, vertexIndexKey(vId, col0), &value) == kvstore::ResultCode::SUCCEEDED;
+}
+
+static cpp2::LookUpIndexRequest buildRequest(int32_t schemaId, bool isEdge, std::string prop) {
+    cpp2::LookUpIndexRequest req;
+    req.set_space_id(0);
+    for (auto partId = 0; partId < 3; partId++) {
+        req.parts.emplace(partId, std::vector<VertexID>());
+    }
+    req.set_schema_id(schemaId);
+    req.set_is_edge(isEdge);
+    req.set_prop(std::move(prop));
+    return req;
+}
+
+static std::set<VertexID> lookUpVertices(kvstore::KVStore* kv,
+                                         meta::SchemaManager* schemaMan,
+                                         const cpp2::LookUpIndexRequest& req) {
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = LookUpVertexIndexProcessor::instance(kv, schemaMan, executor.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(0, resp.result.failed_codes.size());
+
+    std::set<VertexID> vIds;
+    auto provider = std::make_shared<ResultSchemaProvider>(resp.vertex_schema);
+    for (auto& vp : resp.vertices) {
+        auto reader = RowReader::getRowReader(vp.vertex_data, provider);
+        int64_t col0;
+        EXPECT_EQ(ResultType::SUCCEEDED, reader->getInt("tag_3001_col_0", col0));
+        vIds.emplace(vp.vertex_id);
+    }
+    return vIds;
+}
+
+TEST(IndexTest, VertexIndexTest) {
+    fs::TempDir rootPath("/tmp/IndexTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = mockSchemaMan();
+
+    LOG(INFO) << "Prepare data...";
+    for (VertexID vId = 0; vId < 30; vId++) {
+        addVertex(kv.get(), schemaMan.get(), vId, vId);
+    }
+    // Overwrite the indexed prop of vertex 5, the index key of the old value is removed
+    addVertex(kv.get(), schemaMan.get(), 5, 100);
+    EXPECT_FALSE(indexed(kv.get(), 5, 5));
+    EXPECT_TRUE(indexed(kv.get(), 5, 100));
+
+    LOG(INFO) << "Look up the values within [3, 10)...";
+    {
+        auto req = buildRequest(3001, false, "tag_3001_col_0");
+        req.set_lower(NebulaKeyUtils::encodeIndexValue(3L));
+        req.set_upper(NebulaKeyUtils::encodeIndexValue(10L));
+        req.set_include_upper(false);
+        req.set_return_columns({TestUtils::propDef(cpp2::PropOwner::SOURCE,
+                                                   "tag_3001_col_0", 3001)});
+        std::set<VertexID> expected = {3, 4, 6, 7, 8, 9};
+        EXPECT_EQ(expected, lookUpVertices(kv.get(), schemaMan.get(), req));
+    }
+    LOG(INFO) << "Look up the values greater than 29...";
+    {
+        auto req = buildRequest(3001, false, "tag_3001_col_0");
+        req.set_lower(NebulaKeyUtils::encodeIndexValue(29L));
+        req.set_include_lower(false);
+        req.set_return_columns({TestUtils::propDef(cpp2::PropOwner::SOURCE,
+                                                   "tag_3001_col_0", 3001)});
+        std::set<VertexID> expected = {5};
+        EXPECT_EQ(expected, lookUpVertices(kv.get(), schemaMan.get(), req));
+    }
+    LOG(INFO) << "Look up the prop not indexed...";
+    {
+        auto req = buildRequest(3001, false, "tag_3001_col_1");
+        auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+        auto* processor = LookUpVertexIndexProcessor::instance(kv.get(), schemaMan.get(),
+                                                               executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(3, resp.result.failed_codes.size());
+        EXPECT_EQ(cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND, resp.result.failed_codes[0].code);
+    }
+}
+
+TEST(IndexTest, RepeatedVertexTest) {
+    fs::TempDir rootPath("/tmp/IndexTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = mockSchemaMan();
+
+    addVertex(kv.get(), schemaMan.get(), 7, 70);
+    LOG(INFO) << "Write vertex 7 back and forth, and the new vertex 8 twice, in one batch";
+    addVertices(kv.get(), schemaMan.get(), {{7, 71}, {8, 80}, {7, 70}, {8, 81}});
+    // Only the last row of each vertex is indexed
+    EXPECT_TRUE(indexed(kv.get(), 7, 70));
+    EXPECT_FALSE(indexed(kv.get(), 7, 71));
+    EXPECT_FALSE(indexed(kv.get(), 8, 80));
+    EXPECT_TRUE(indexed(kv.get(), 8, 81));
+}
+
+TEST(IndexTest, StaleIndexKeysTest) {
+    fs::TempDir rootPath("/tmp/IndexTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = mockSchemaMan();
+
+    for (VertexID vId = 0; vId < 3; vId++) {
+        addVertex(kv.get(), schemaMan.get(), vId, vId);
+    }
+    LOG(INFO) << "Leave the index keys of value 10 behind, as concurrent overwrites would";
+    for (VertexID vId = 0; vId < 3; vId++) {
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMultiPut(0, vId % 3, {{vertexIndexKey(vId, 10), ""}},
+                          [&] (kvstore::ResultCode code) {
+            EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+
+    auto req = buildRequest(3001, false, "tag_3001_col_0");
+    req.set_lower(NebulaKeyUtils::encodeIndexValue(10L));
+    req.set_upper(NebulaKeyUtils::encodeIndexValue(10L));
+    req.set_return_columns({TestUtils::propDef(cpp2::PropOwner::SOURCE,
+                                               "tag_3001_col_0", 3001)});
+    EXPECT_TRUE(lookUpVertices(kv.get(), schemaMan.get(), req).empty());
+
+    LOG(INFO) << "The stale keys found by the look-up are removed in the background";
+    for (VertexID vId = 0; vId < 3; vId++) {
+        for (int32_t retry = 0; retry < 100 && indexed(kv.get(), vId, 10); retry++) {
+            usleep(10000);
+        }
+        EXPECT_FALSE(indexed(kv.get(), vId, 10));
+        EXPECT_TRUE(indexed(kv.get(), vId, vId));
+    }
+}
+
+TEST(IndexTest, EdgeIndexTest) {
+    fs::TempDir rootPath("/tmp/IndexTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = mockSchemaMan();
+
+    LOG(INFO) << "Prepare data...";
+    {
+        cpp2::AddEdgesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (VertexID src = 0; src < 10; src++) {
+            RowWriter writer;
+            writer << src * 10;
+            for (int64_t i = 1; i < 10; i++) {
+                writer << i;
+            }
+            for (auto i = 10; i < 20; i++) {
+                writer << folly::stringPrintf("string_col_%d", i);
+            }
+            cpp2::EdgeKey key;
+            key.set_src(src);
+            key.set_edge_type(101);
+            key.set_ranking(0);
+            key.set_dst(src + 100);
+            req.parts[src % 3].emplace_back(apache::thrift::FragileConstructor::FRAGILE,
+                                            std::move(key),
+                                            writer.encode());
+        }
+        auto* processor = AddEdgesProcessor::instance(kv.get(), schemaMan.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+
+    LOG(INFO) << "Look up the values less than 30...";
+    auto req = buildRequest(101, true, "col_0");
+    req.set_upper(NebulaKeyUtils::encodeIndexValue(30L));
+    req.set_include_upper(false);
+    req.set_return_columns({TestUtils::propDef(cpp2::PropOwner::EDGE, "col_0")});
+    auto* processor = LookUpEdgeIndexProcessor::instance(kv.get(), schemaMan.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(0, resp.result.failed_codes.size());
+
+    auto provider = std::make_shared<ResultSchemaProvider>(resp.schema);
+    RowSetReader rsReader(provider, resp.data);
+    auto iter = rsReader.begin();
+    std::set<VertexID> srcs;
+    while (iter) {
+        int64_t src;
+        int64_t dst;
+        int64_t col0;
+        EXPECT_EQ(ResultType::SUCCEEDED, iter->getInt("_src", src));
+        EXPECT_EQ(ResultType::SUCCEEDED, iter->getInt("_dst", dst));
+        EXPECT_EQ(ResultType::SUCCEEDED, iter->getInt("col_0", col0));
+        EXPECT_EQ(src + 100, dst);
+        EXPECT_EQ(src * 10, col0);
+        srcs.emplace(src);
+        ++iter;
+    }
+    std::set<VertexID> expected = {0, 1, 2};
+    EXPECT_EQ(expected, srcs);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
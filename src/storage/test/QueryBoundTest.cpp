@@ -21,7 +21,7 @@ DECLARE_int32(min_vertices_per_bucket);
 namespace nebula {
 namespace storage {
 
-void mockData(kvstore::KVStore* kv) {
+void mockData(kvstore::KVStore* kv, bool inboundProps = false) {
     for (auto partId = 0; partId < 3; partId++) {
         std::vector<kvstore::KV> data;
         for (auto vertexId = partId * 10; vertexId < (partId + 1) * 10; vertexId++) {
@@ -63,7 +63,18 @@ void mockData(kvstore::KVStore* kv) {
                     auto key = NebulaKeyUtils::edgeKey(partId, vertexId, -101,
                                                        0, srcId,
                                                        std::numeric_limits<int>::max() - version);
-                    data.emplace_back(std::move(key), "");
+                    if (!inboundProps) {
+                        data.emplace_back(std::move(key), "");
+                        continue;
+                    }
+                    RowWriter writer(nullptr);
+                    for (uint64_t numInt = 0; numInt < 10; numInt++) {
+                        writer << (srcId + numInt);
+                    }
+                    for (auto numString = 10; numString < 20; numString++) {
+                        writer << folly::stringPrintf("string_col_%d_%d", numString, version);
+                    }
+                    data.emplace_back(std::move(key), writer.encode());
                 }
             }
         }
@@ -224,6 +235,55 @@ TEST(QueryBoundTest, inBoundSimpleTest) {
     checkResponse(resp, 30, 2, 20001, 5, false);
 }
 
+TEST(QueryBoundTest, InBoundPropsTest) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    LOG(INFO) << "Prepare meta...";
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+
+    auto schemaMan = TestUtils::mockSchemaMan();
+    {
+        // Copy the props of edge 101 to its in-edges
+        auto provider = TestUtils::genEdgeSchemaProvider(10, 10);
+        nebula::cpp2::Schema schema;
+        for (size_t i = 0; i < provider->getNumFields(); i++) {
+            nebula::cpp2::ColumnDef column;
+            column.name = provider->getFieldName(i);
+            column.type = provider->getFieldType(i);
+            schema.columns.emplace_back(std::move(column));
+        }
+        nebula::cpp2::SchemaProp prop;
+        prop.set_inbound_props(true);
+        schema.set_schema_prop(std::move(prop));
+        static_cast<AdHocSchemaManager*>(schemaMan.get())->addEdgeSchema(
+            0, 101, std::make_shared<ResultSchemaProvider>(std::move(schema)));
+    }
+    mockData(kv.get(), true);
+
+    LOG(INFO) << "Build filter...";
+    auto* edgeProp = new std::string("col_0");
+    auto* alias = new std::string("e101");
+    auto* edgeExp = new EdgePropertyExpression(alias, edgeProp);
+    auto* priExp = new PrimaryExpression(20003L);
+    auto relExp = std::make_unique<RelationalExpression>(edgeExp,
+                                                         RelationalExpression::Operator::GE,
+                                                         priExp);
+    cpp2::GetNeighborsRequest req;
+    buildRequest(req, false);
+    req.set_filter(Expression::encode(relExp.get()));
+
+    LOG(INFO) << "Test QueryInBoundRequest with the edge props...";
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(),
+                                                    executor.get(), BoundType::IN_BOUND);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+
+    LOG(INFO) << "Check the results...";
+    // The props are read from the in-edges, the same as the out-edges
+    checkResponse(resp, 30, 12, 20003, 3, true);
+}
+
 TEST(QueryBoundTest, FilterTest_OnlyEdgeFilter) {
     fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
     LOG(INFO) << "Prepare meta...";
@@ -414,6 +474,134 @@ TEST(QueryBoundTest, FilterTest_InvalidFilter) {
     EXPECT_TRUE(nebula::storage::cpp2::ErrorCode::E_INVALID_FILTER
                     == resp.result.failed_codes[0].code);
 }
+
+TEST(QueryBoundTest, DstIdsOnlyTest) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+
+    auto getDstIds = [&] (bool outBound) {
+        cpp2::GetNeighborsRequest req;
+        buildRequest(req, outBound);
+        decltype(req.return_columns) cols;
+        cols.emplace_back(TestUtils::propDef(cpp2::PropOwner::EDGE, "_dst"));
+        req.set_return_columns(std::move(cols));
+        req.set_dst_ids_only(true);
+
+        auto* processor = QueryBoundProcessor::instance(
+            kv.get(), schemaMan.get(), executor.get(),
+            outBound ? BoundType::OUT_BOUND : BoundType::IN_BOUND);
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(nullptr, resp.get_vertices());
+        EXPECT_NE(nullptr, resp.get_dst_ids());
+
+        std::vector<VertexID> ids(resp.dst_ids.size() / sizeof(VertexID));
+        memcpy(ids.data(), resp.dst_ids.data(), resp.dst_ids.size());
+        return ids;
+    };
+
+    // Sorted and unique among all the vertices
+    std::vector<VertexID> expected;
+    for (VertexID dst = 10001; dst <= 10007; dst++) {
+        expected.emplace_back(dst);
+    }
+    EXPECT_EQ(expected, getDstIds(true));
+
+    expected.clear();
+    for (VertexID src = 20001; src <= 20005; src++) {
+        expected.emplace_back(src);
+    }
+    EXPECT_EQ(expected, getDstIds(false));
+}
+
+TEST(QueryBoundTest, TTLTest) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    {
+        // col_0 of all the edges is far in the past, so all of them have expired
+        auto provider = TestUtils::genEdgeSchemaProvider(10, 10);
+        nebula::cpp2::Schema schema;
+        for (size_t i = 0; i < provider->getNumFields(); i++) {
+            nebula::cpp2::ColumnDef column;
+            column.name = provider->getFieldName(i);
+            column.type = provider->getFieldType(i);
+            schema.columns.emplace_back(std::move(column));
+        }
+        nebula::cpp2::SchemaProp prop;
+        prop.set_ttl_duration(100);
+        prop.set_ttl_col("col_0");
+        schema.set_schema_prop(std::move(prop));
+        static_cast<AdHocSchemaManager*>(schemaMan.get())->addEdgeSchema(
+            0, 101, std::make_shared<ResultSchemaProvider>(std::move(schema)));
+    }
+    mockData(kv.get(), true);
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+
+    for (auto outBound : {true, false}) {
+        LOG(INFO) << "Read the " << (outBound ? "out" : "in") << "-edges keys only...";
+        cpp2::GetNeighborsRequest req;
+        buildRequest(req, outBound);
+        decltype(req.return_columns) cols;
+        cols.emplace_back(TestUtils::propDef(cpp2::PropOwner::EDGE, "_dst"));
+        req.set_return_columns(std::move(cols));
+        req.set_dst_ids_only(true);
+
+        auto* processor = QueryBoundProcessor::instance(
+            kv.get(), schemaMan.get(), executor.get(),
+            outBound ? BoundType::OUT_BOUND : BoundType::IN_BOUND);
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_TRUE(resp.dst_ids.empty());
+    }
+}
+
+TEST(QueryBoundTest, BucketContextTest) {
+    auto schemaMan = TestUtils::mockSchemaMan();
+    BucketContext bctx(schemaMan.get(), 0);
+    auto* reader = bctx.tagReader(3001);
+    ASSERT_EQ(reader, bctx.tagReader(3001));
+    ASSERT_NE(reader, bctx.tagReader(3002));
+
+    std::vector<std::string> rows;
+    for (int64_t vertexId = 0; vertexId < 10; vertexId++) {
+        RowWriter writer;
+        for (int64_t numInt = 0; numInt < 3; numInt++) {
+            writer << (vertexId + numInt);
+        }
+        for (auto numString = 3; numString < 6; numString++) {
+            writer << folly::stringPrintf("%ld_%d", vertexId, numString);
+        }
+        rows.emplace_back(writer.encode());
+    }
+    // One reader walks over all the rows, and the schema is looked up once
+    const meta::SchemaProviderIf* schema = nullptr;
+    for (int64_t vertexId = 0; vertexId < 10; vertexId++) {
+        ASSERT_TRUE(reader->reset(rows[vertexId]));
+        if (schema == nullptr) {
+            schema = reader->getSchema();
+        }
+        EXPECT_EQ(schema, reader->getSchema());
+        int64_t v;
+        EXPECT_EQ(ResultType::SUCCEEDED, reader->getInt("tag_3001_col_2", v));
+        EXPECT_EQ(vertexId + 2, v);
+        folly::StringPiece str;
+        EXPECT_EQ(ResultType::SUCCEEDED, reader->getString("tag_3001_col_4", str));
+        EXPECT_EQ(folly::stringPrintf("%ld_4", vertexId), str);
+    }
+    EXPECT_EQ(schemaMan->getTagSchema(0, 3001).get(), reader->latestSchema());
+
+    // No schema of the edge type
+    auto* edgeReader = bctx.edgeReader(102);
+    EXPECT_FALSE(edgeReader->reset(rows[0]));
+}
 }  // namespace storage
 }  // namespace nebula
 
@@ -14,10 +14,13 @@
 #include "dataman/RowWriter.h"
 #include "dataman/RowSetReader.h"
 #include "network/NetworkUtils.h"
+#include "time/WallClock.h"
 
 DECLARE_string(meta_server_addrs);
 DECLARE_int32(load_data_interval_secs);
 DECLARE_int32(heartbeat_interval_secs);
+DECLARE_int32(storage_client_hedge_delay_ms);
+DECLARE_int32(storage_client_frontier_parallel_min);
 
 namespace nebula {
 namespace storage {
@@ -306,6 +309,30 @@ private:
     nebula::cpp2::HostAddr leader_;
 };
 
+class TestStorageServiceLeader : public storage::cpp2::StorageServiceSvIf {
+public:
+    explicit TestStorageServiceLeader(int32_t latencyInUs, int32_t delayMs = 0)
+        : latencyInUs_(latencyInUs)
+        , delayMs_(delayMs) {}
+
+    folly::Future<cpp2::QueryResponse>
+    future_getOutBound(const cpp2::GetNeighborsRequest& req) override {
+        UNUSED(req);
+        storage::cpp2::QueryResponse resp;
+        storage::cpp2::ResponseCommon rc;
+        rc.set_latency_in_us(latencyInUs_);
+        resp.set_result(std::move(rc));
+        return folly::futures::sleep(std::chrono::milliseconds(delayMs_))
+            .thenValue([resp = std::move(resp)] (auto&&) mutable {
+                return std::move(resp);
+            });
+    }
+
+private:
+    int32_t latencyInUs_;
+    int32_t delayMs_;
+};
+
 class TestStorageClient : public StorageClient {
 public:
     explicit TestStorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool)
@@ -328,8 +355,12 @@ TEST(StorageClientTest, LeaderChangeTest) {
     IPv4 localIp;
     network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
 
+    auto leaderSc = std::make_unique<test::ServerContext>();
+    leaderSc->mockCommon("leader", 0, std::make_shared<TestStorageServiceLeader>(1));
+    LOG(INFO) << "Start the leader on " << leaderSc->port_;
+
     auto sc = std::make_unique<test::ServerContext>();
-    auto handler = std::make_shared<TestStorageServiceRetry>(localIp, 10010);
+    auto handler = std::make_shared<TestStorageServiceRetry>(localIp, leaderSc->port_);
     sc->mockCommon("storage", 0, handler);
     LOG(INFO) << "Start storage server on " << sc->port_;
 
@@ -341,13 +372,84 @@ TEST(StorageClientTest, LeaderChangeTest) {
     pm.peers_.emplace_back(HostAddr(localIp, sc->port_));
     tsc.parts_.emplace(1, std::move(pm));
 
-    folly::Baton<true, std::atomic> baton;
-    tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {}).via(threadPool.get()).then([&] {
-        baton.post();
-    });
-    baton.wait();
+    // The parts are resent to the new leader
+    auto resp = tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {}).get();
+    ASSERT_TRUE(resp.succeeded());
+    ASSERT_EQ(100, resp.completeness());
+    ASSERT_EQ(1, resp.responses().size());
     ASSERT_EQ(1, tsc.leaders_.size());
-    ASSERT_EQ(HostAddr(localIp, 10010), tsc.leaders_[std::make_pair(0, 1)]);
+    ASSERT_EQ(HostAddr(localIp, leaderSc->port_), tsc.leaders_[std::make_pair(0, 1)]);
+}
+
+TEST(StorageClientTest, HedgeTest) {
+    FLAGS_storage_client_hedge_delay_ms = 100;
+    IPv4 localIp;
+    network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
+
+    auto slowSc = std::make_unique<test::ServerContext>();
+    slowSc->mockCommon("slow", 0, std::make_shared<TestStorageServiceLeader>(1, 2000));
+    auto fastSc = std::make_unique<test::ServerContext>();
+    fastSc->mockCommon("fast", 0, std::make_shared<TestStorageServiceLeader>(2));
+
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    TestStorageClient tsc(threadPool);
+    PartMeta pm;
+    pm.spaceId_ = 0;
+    pm.partId_ = 1;
+    pm.peers_.emplace_back(HostAddr(localIp, slowSc->port_));
+    pm.peers_.emplace_back(HostAddr(localIp, fastSc->port_));
+    tsc.parts_.emplace(1, std::move(pm));
+    tsc.updateLeader(0, 1, HostAddr(localIp, slowSc->port_));
+
+    // The slow leader is raced by the other replica
+    auto start = time::WallClock::fastNowInMilliSec();
+    auto resp = tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {}).get();
+    ASSERT_TRUE(resp.succeeded());
+    ASSERT_EQ(1, resp.responses().size());
+    ASSERT_EQ(2, resp.maxLatency());
+    ASSERT_GT(2000, time::WallClock::fastNowInMilliSec() - start);
+    FLAGS_storage_client_hedge_delay_ms = 0;
+}
+
+TEST(StorageClientTest, PartitionIdsTest) {
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    TestStorageClient tsc(threadPool);
+    for (PartitionID partId = 1; partId <= 3; partId++) {
+        PartMeta pm;
+        pm.spaceId_ = 0;
+        pm.partId_ = partId;
+        tsc.parts_.emplace(partId, std::move(pm));
+    }
+    std::vector<VertexID> ids;
+    for (VertexID id = 999; id >= 0; id--) {
+        ids.emplace_back(id);
+        ids.emplace_back(id % 10);
+    }
+
+    auto check = [&] (const StorageClient::PartIds& parts) {
+        ASSERT_EQ(3, parts.size());
+        size_t total = 0;
+        for (auto& part : parts) {
+            auto& partIds = part.second;
+            ASSERT_TRUE(std::is_sorted(partIds.begin(), partIds.end()));
+            ASSERT_TRUE(std::adjacent_find(partIds.begin(), partIds.end()) == partIds.end());
+            for (auto id : partIds) {
+                ASSERT_EQ(part.first, id % 3 + 1);
+            }
+            total += partIds.size();
+        }
+        ASSERT_EQ(1000, total);
+    };
+
+    LOG(INFO) << "Partition on the calling thread";
+    check(tsc.partitionIds(0, ids));
+
+    LOG(INFO) << "Partition on the frontier threads";
+    FLAGS_storage_client_frontier_parallel_min = 1;
+    check(tsc.partitionIds(0, ids));
+    FLAGS_storage_client_frontier_parallel_min = 100000;
+
+    ASSERT_TRUE(tsc.partitionIds(0, {}).empty());
 }
 
 }  // namespace storage